@@ -202,7 +202,8 @@ package builder::SDL3 {
                 ' -Dmain=SDL_main -I' . $sharedir->child('include')->absolute .
                 ' -I' . $sharedir->child( 'include', 'SDL2' )->absolute;
             $lflags = ( $x64 ? '-m64' : '-m32' ) . ' -L' .
-                $sharedir->child('lib')->absolute . ' -lSDL2main -lSDL2 -lSDL2_mixer -mwindows ';
+                $sharedir->child('lib')->absolute .
+                ' -lSDL2main -lSDL2 -lSDL2_mixer -lSDL2_image -mwindows ';
 
 #' -Wl,--dynamicbase -Wl,--nxcompat -lm -ldinput8 -ldxguid -ldxerr8 -luser32 -lgdi32 -lwinmm -limm32 -lole32 -loleaut32 -lshell32 -lsetupapi -lversion -luuid ';
 # TODO: store in config file:
@@ -9,24 +9,19 @@ my $id = SDL_AddTimer( 10000, sub {...} );
 sub DrawChessBoard {
     my ($renderer) = @_;
     my ( $row, $column, $x );
-    my $rect = SDL3::Rect->new;
 
     # Get the Size of drawing surface
     SDL_RenderGetViewport( $renderer, my $darea = SDL3::Rect->new() );
+    my ( $w, $h ) = ( int( $darea->w / 8 ), int( $darea->h / 8 ) );
+    SDL_SetRenderDrawColor( $renderer, 0, 0, 0, 0xFF );
     for my $row ( 0 .. 7 ) {
         $column = $row % 2;
         $x      = $column;
         for ( ; $column < 4 + ( $row % 2 ); $column++ ) {
-            SDL_SetRenderDrawColor( $renderer, 0, 0, 0, 0xFF );
-            $rect = SDL3::Rect->new(
-                {   w => $darea->w / 8,
-                    h => $darea->h / 8,
-                    x => $x * $rect->w,
-                    y => $row * $rect->h
-                }
-            );
+
+            # No SDL3::Rect is allocated per square
+            SDL_RenderFillRectXYWH( $renderer, $x * $w, $row * $h, $w, $h );
             $x = $x + 2;
-            SDL_RenderFillRect( $renderer, $rect );
         }
     }
 }
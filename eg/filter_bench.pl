@@ -0,0 +1,49 @@
+use strictures 2;
+use lib '../lib';
+use SDL3 qw[:all];
+use Time::HiRes qw[time];
+$|++;
+
+# Throughput of the image filters in megapixels (of output) per second, with one thread and with
+# every thread, next to SDL_BlitScaled( ... ) doing the same resizes.
+my ( $w, $h, $runs ) = ( 1920, 1080, 5 );
+my $max = shift // SDL_GetCPUCount();
+srand 1;
+my $src = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+SDL_FillRect( $src, [ int rand $w, int rand $h, 1 + int rand 200, 1 + int rand 200 ], rand 2**32 )
+    for 1 .. 2000;
+my %dst = map {
+    $_->[0] => SDL_CreateRGBSurfaceWithFormat( 0, $_->[1], $_->[2], 32, SDL_PIXELFORMAT_ARGB8888 )
+} [ full => $w, $h ], [ down => $w / 2, $h / 2 ], [ up => $w * 3 / 2, $h * 3 / 2 ];
+my @tests = (
+    [ 'BlitScaled (down)', 'down', sub { SDL_BlitScaled( $src, undef, $dst{down}, undef ) } ],
+    [ 'BlitScaled (up)',   'up',   sub { SDL_BlitScaled( $src, undef, $dst{up},   undef ) } ],
+    (   map {
+            my ( $name, $filter ) = @$_;
+            [ "$name (down)", 'down', sub { SDL_ResampleSurface( $src, $dst{down}, $filter ) } ],
+                [ "$name (up)", 'up', sub { SDL_ResampleSurface( $src, $dst{up}, $filter ) } ]
+        } [ bilinear => SDL_RESAMPLE_BILINEAR ],
+        [ bicubic  => SDL_RESAMPLE_BICUBIC ],
+        [ lanczos3 => SDL_RESAMPLE_LANCZOS3 ]
+    ),
+    [ 'box blur r=4',      'full', sub { SDL_BoxBlurSurface( $src, $dst{full}, 4 ) } ],
+    [ 'gaussian sigma=3',  'full', sub { SDL_GaussianBlurSurface( $src, $dst{full}, 3 ) } ],
+    [ 'convolve 3x3',      'full', sub { SDL_ConvolveSurface( $src, $dst{full}, [ (1) x 9 ] ) } ],
+    [ 'convolve 5x5',      'full', sub { SDL_ConvolveSurface( $src, $dst{full}, [ (1) x 25 ] ) } ]
+);
+printf "%s kernel, %dx%d source\n%-20s %12s %12s\n", SDL_GetPixelKernel(), $w, $h, '', '1 thread',
+    "$max threads";
+for my $test (@tests) {
+    my ( $name, $size, $code ) = @$test;
+    my $mp = $dst{$size}->w * $dst{$size}->h / 1e6;
+    my @rates;
+    for my $threads ( 1, $max ) {
+        SDL_SetFilterThreads($threads);
+        $code->();    # Warm up
+        my $start = time;
+        $code->() for 1 .. $runs;
+        push @rates, $mp * $runs / ( time - $start );
+    }
+    printf "%-20s %7.1f MP/s %7.1f MP/s\n", $name, @rates;
+}
+SDL_FreeSurface($_) for $src, values %dst;
@@ -0,0 +1,43 @@
+use strictures 2;
+use lib '../lib';
+use SDL3 qw[:all];
+use SDL3::GFX qw[:gfx];
+use Time::HiRes qw[time];
+$|++;
+
+# Ten thousand drifting circles drawn with one GFX_Circles( ... ) call per frame, plus a few of
+# the other primitives. Prints the time spent building and drawing the batch.
+my ( $w, $h, $count ) = ( 800, 600, shift // 10_000 );
+SDL_Init(SDL_INIT_VIDEO);
+my $window   = SDL_CreateWindow( 'SDL3::GFX', SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED,
+    $w, $h, 0 );
+my $renderer = SDL_CreateRenderer( $window, -1, SDL_RENDERER_ACCELERATED );
+my $event    = SDL3::Event->new;
+my @dots     = map {
+    [   rand $w, rand $h, rand(2) - 1, rand(2) - 1, 1 + rand 4,
+        GFX_RGBA( ( map { int rand 256 } 1 .. 3 ), 160 )
+    ]
+} 1 .. $count;
+my ( $frames, $spent, $quit ) = ( 0, 0, 0 );
+while ( !$quit ) {
+    while ( SDL_PollEvent($event) ) { $quit = 1 if $event->type == SDL_QUIT }
+    SDL_SetRenderDrawColor( $renderer, 16, 16, 24, 255 );
+    SDL_RenderClear($renderer);
+    my $start = time;
+    for (@dots) {
+        $_->[0] = ( $_->[0] + $_->[2] ) % $w;
+        $_->[1] = ( $_->[1] + $_->[3] ) % $h;
+    }
+    GFX_Circles( $renderer, [ map { [ @$_[ 0, 1, 4 ], 0, $_->[5] ] } @dots ] );
+    $spent += time - $start;
+    GFX_RoundedRect( $renderer, 20, 20, 240, 90, 12, 0, 0x000000C0 );
+    GFX_Arc( $renderer, 65, 65, 30, -90, -90 + ( $frames * 3 % 360 ), 6, 0x40C0FFFF );
+    GFX_Polygon( $renderer, [ [ 120, 40 ], [ 240, 50 ], [ 180, 95 ] ], 2, 0xFFC040FF );
+    GFX_Line( $renderer, 20, $h - 20, $w - 20, 20, 3, 0xFFFFFF80 );
+    SDL_RenderPresent($renderer);
+    printf "%.2f ms per batch of %d circles\n", 1000 * $spent / $frames, $count
+        if ++$frames % 100 == 0;
+}
+SDL_DestroyRenderer($renderer);
+SDL_DestroyWindow($window);
+SDL_Quit();
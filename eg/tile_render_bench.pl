@@ -0,0 +1,49 @@
+use strictures 2;
+use lib '../lib';
+use SDL3 qw[:all];
+use Time::HiRes qw[time];
+use Digest::MD5 qw[md5_hex];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+$|++;
+
+# Scaling benchmark for the tile renderer: draws the same scene with 1..N threads, reports the
+# speedup over a single thread, and checks every run produces the exact same pixels.
+my ( $w, $h, $calls, $frames ) = ( 1920, 1080, 20_000, 10 );
+my $max = shift // SDL_GetCPUCount();
+my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+my $sprite  = SDL_CreateRGBSurfaceWithFormat( 0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888 );
+SDL_FillRect( $sprite, undef, 0x80FF8040 );
+SDL_SetSurfaceBlendMode( $sprite, SDL_BLENDMODE_BLEND );
+my ( $base_time, $base_md5 );
+for my $threads ( 1 .. $max ) {
+    my $tr     = SDL_CreateTileRenderer( $surface, $threads );
+    my $handle = SDL_TileRendererCreateTexture( $tr, $sprite );
+    my $start  = time;
+    for my $frame ( 1 .. $frames ) {
+        srand 1;    # Same scene every time
+        SDL_TileRendererSetDrawColor( $tr, 32, 32, 48, 255 );
+        SDL_TileRendererClear($tr);
+        SDL_TileRendererSetDrawBlendMode( $tr, SDL_BLENDMODE_BLEND );
+        for ( 1 .. $calls ) {
+            my ( $x, $y ) = ( int rand $w, int rand $h );
+            my $kind = int rand 4;
+            SDL_TileRendererSetDrawColor( $tr, map { int rand 256 } 1 .. 4 );
+            if    ( $kind == 0 ) { SDL_TileRendererFillRect( $tr, $x, $y, 40, 40 ) }
+            elsif ( $kind == 1 ) { SDL_TileRendererDrawRect( $tr, $x, $y, 80, 60 ) }
+            elsif ( $kind == 2 ) {
+                SDL_TileRendererDrawLine( $tr, $x, $y, int rand $w, int rand $h );
+            }
+            else { SDL_TileRendererCopy( $tr, $handle, 0, 0, 0, 0, $x, $y, 96, 96 ) }
+        }
+        SDL_TileRendererPresent($tr);
+    }
+    my $elapsed = ( time - $start ) / $frames;
+    my $md5     = md5_hex( buffer_to_scalar( $surface->pixels, $surface->pitch * $h ) );
+    $base_time //= $elapsed;
+    $base_md5  //= $md5;
+    printf "%2d thread%s: %7.2f ms/frame  %5.2fx  %s\n", $threads, $threads == 1 ? ' ' : 's',
+        $elapsed * 1000, $base_time / $elapsed, $md5 eq $base_md5 ? 'identical' : 'MISMATCH';
+    SDL_DestroyTileRenderer($tr);
+}
+SDL_FreeSurface($sprite);
+SDL_FreeSurface($surface);
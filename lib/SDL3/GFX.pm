@@ -0,0 +1,462 @@
+package SDL3::GFX 0.01 {
+    use strict;
+    use experimental 'signatures';
+    use base 'Exporter::Tiny';
+    use SDL3::Utils qw[attach define];
+    use SDL3;
+    use FFI::Platypus::Buffer qw[scalar_to_pointer];
+    #
+    our %EXPORT_TAGS;
+    #
+    define gfx => [
+        [   GFX_RGBA => sub ( $r, $g, $b, $a = 255 ) {
+                ( $r & 0xFF ) << 24 | ( $g & 0xFF ) << 16 | ( $b & 0xFF ) << 8 | ( $a & 0xFF );
+            }
+        ]
+    ];
+
+    # Every primitive draws into an SDL3::Surface or through an SDL3::Renderer
+    sub _target ($target) {
+        ref $target && $target->isa('SDL3::Renderer') ? ( undef, $target ) : ( $target, undef );
+    }
+
+    # [ [ ... ], ... ] or a (reference to a) string of packed items; returns the string and count
+    sub _items ( $template, $items ) {
+        my $packed = ref $items eq 'SCALAR' ? $$items : $items;
+        $packed = join '', map { pack $template, @$_ } @$items if ref $packed;
+        ( $packed, int( length($packed) / length pack $template ) );
+    }
+
+    # [ $x, $y, ... ] or [ [ $x, $y ], ... ]
+    sub _points ($points) {
+        pack 'f*', map { ref $_ ? @$_ : $_ } @$points;
+    }
+    my %template = (
+        Lines        => 'f5L',
+        Circles      => 'f4L',
+        Ellipses     => 'f5L',
+        Arcs         => 'f6L',
+        RoundedRects => 'f6L'
+    );
+    attach gfx => {
+        Bundle_GFX_Line => [
+            [   'SDL_Surface', 'SDL_Renderer', 'float', 'float', 'float', 'float', 'float',
+                'uint32'
+            ],
+            'int' => sub ( $inner, $target, @args ) { $inner->( _target($target), @args ) }
+        ],
+        Bundle_GFX_Circle => [
+            [ 'SDL_Surface', 'SDL_Renderer', 'float', 'float', 'float', 'float', 'uint32' ],
+            'int' => sub ( $inner, $target, @args ) { $inner->( _target($target), @args ) }
+        ],
+        Bundle_GFX_Ellipse => [
+            [   'SDL_Surface', 'SDL_Renderer', 'float', 'float', 'float', 'float', 'float',
+                'uint32'
+            ],
+            'int' => sub ( $inner, $target, @args ) { $inner->( _target($target), @args ) }
+        ],
+        Bundle_GFX_Arc => [
+            [   'SDL_Surface', 'SDL_Renderer', 'float', 'float', 'float', 'float', 'float', 'float',
+                'uint32'
+            ],
+            'int' => sub ( $inner, $target, @args ) { $inner->( _target($target), @args ) }
+        ],
+        Bundle_GFX_RoundedRect => [
+            [   'SDL_Surface', 'SDL_Renderer', 'float', 'float', 'float', 'float', 'float', 'float',
+                'uint32'
+            ],
+            'int' => sub ( $inner, $target, @args ) { $inner->( _target($target), @args ) }
+        ],
+        Bundle_GFX_Polygon => [
+            [ 'SDL_Surface', 'SDL_Renderer', 'opaque', 'int', 'float', 'uint32' ],
+            'int' => sub ( $inner, $target, $points, $width, $color ) {
+                my $packed = _points($points);
+                $inner->(
+                    _target($target), scalar_to_pointer($packed),
+                    length($packed) / 8,
+                    $width, $color
+                );
+            }
+        ],
+        (   map {
+                my $template = $template{$_};
+                (   'Bundle_GFX_' . $_ => [
+                        [ 'SDL_Surface', 'SDL_Renderer', 'opaque', 'int' ],
+                        'int' => sub ( $inner, $target, $items ) {
+                            my ( $packed, $count ) = _items( $template, $items );
+                            $inner->( _target($target), scalar_to_pointer($packed), $count );
+                        }
+                    ]
+                )
+            } keys %template
+        ),
+        Bundle_GFX_Polygons => [
+            [ 'SDL_Surface', 'SDL_Renderer', 'opaque', 'int', 'opaque', 'int' ],
+            'int' => sub ( $inner, $target, $polygons, $points = () ) {
+                ( $polygons, $points ) = @$polygons    # [ $packed_items, $packed_points ]
+                    if !defined $points && ref $polygons eq 'ARRAY' && @$polygons == 2 &&
+                    ref $polygons->[0] ne 'ARRAY';
+                my ( $items, $count );
+                if ( defined $points ) {
+                    ( $items, $count ) = _items( 'lfL', $polygons );
+                    $points = $$points if ref $points eq 'SCALAR';
+                    $points = _points($points) if ref $points;
+                }
+                else {
+                    my @points = map { _points( $_->[0] ) } @$polygons;
+                    $items = join '',
+                        map { pack 'lfL', length( $points[$_] ) / 8, @{ $polygons->[$_] }[ 1, 2 ] }
+                        0 .. $#$polygons;
+                    $count  = @$polygons;
+                    $points = join '', @points;
+                }
+                $inner->(
+                    _target($target),    scalar_to_pointer($items),
+                    $count, scalar_to_pointer($points), int( length($points) / 8 )
+                );
+            }
+        ]
+    };
+
+    # Export symbols!
+    our @EXPORT_OK = map {@$_} values %EXPORT_TAGS;
+
+    #$EXPORT_TAGS{default} = [];             # Export nothing by default
+    $EXPORT_TAGS{all} = \@EXPORT_OK;    # Export everything with :all tag
+
+=encoding utf-8
+
+=head1 NAME
+
+SDL3::GFX - Anti-aliased Drawing Primitives
+
+=head1 SYNOPSIS
+
+    use SDL3 qw[:all];
+    use SDL3::GFX qw[:gfx];
+    GFX_Circle( $renderer, 320, 240, 100, 3, GFX_RGBA( 255, 128, 0 ) );
+    GFX_Circles( $surface, [ map { [ rand 640, rand 480, 4, 0, 0xFFFFFF80 ] } 1 .. 10_000 ] );
+
+=head1 DESCRIPTION
+
+Lines of any width, circles, ellipses, arcs, rounded rectangles and polygons in
+the spirit of SDL2_gfx, drawn natively and anti-aliased. Every shape is built
+from triangles whose edges fade out over a pixel, so it looks the same on both
+kinds of target:
+
+=over
+
+=item L<SDL3::Surface> - blended straight into the pixels; the surface must have 32-bit pixels with 8-bit channels
+
+=item L<SDL3::Renderer> - sent as geometry with alpha blending; needs SDL 2.0.18 or newer
+
+=back
+
+Each primitive has a batch form taking a list of items (or a string of items
+already packed in the given template) and drawing them all in one call, so ten
+thousand circles are a single trip into native code and, on a renderer, a
+handful of draw calls.
+
+Coordinates are floats and name pixels the way C<SDL_RenderDrawPointF( ... )>
+does: C<(0, 0)> is the top left pixel. Rectangles cover the pixels they name.
+Colors are C<0xRRGGBBAA>; see L<< C<GFX_RGBA( ... )>|/C<GFX_RGBA( ... )> >>. A
+C<width> of C<0> fills the shape; otherwise the outline is drawn that many pixels
+wide. Outlines thinner than a pixel are drawn a pixel wide and fainter.
+
+These functions may be imported by name or with the C<:gfx> tag.
+
+All functions return C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head1 Functions
+
+=head2 C<GFX_RGBA( ... )>
+
+Pack a color.
+
+	my $orange = GFX_RGBA( 255, 128, 0 );
+
+Expected parameters include:
+
+=over
+
+=item C<r> - red, C<0> to C<255>
+
+=item C<g> - green
+
+=item C<b> - blue
+
+=item C<a> - alpha; defaults to C<255>
+
+=back
+
+=head2 C<GFX_Line( ... )>
+
+Draw a line with square ends. Both end pixels are covered.
+
+	GFX_Line( $renderer, 10, 10, 200, 80, 1, 0xFFFFFFFF );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<x1>, C<y1> - the first end
+
+=item C<x2>, C<y2> - the second end
+
+=item C<width> - the thickness in pixels; C<0> is treated as C<1>
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_Lines( ... )>
+
+Draw many lines.
+
+	GFX_Lines( $surface, [ [ 0, 0, 99, 99, 1, 0xFF0000FF ], [ 0, 99, 99, 0, 2, 0x00FF00FF ] ] );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<lines> - a list of C<[ $x1, $y1, $x2, $y2, $width, $color ]>, or a string packed with C<f5L> per line
+
+=back
+
+=head2 C<GFX_Circle( ... )>
+
+Draw a circle.
+
+	GFX_Circle( $renderer, 100, 100, 40, 0, 0x3080FFFF );    # filled
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<x>, C<y> - the center
+
+=item C<r> - the radius
+
+=item C<width> - the outline's thickness, or C<0> to fill
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_Circles( ... )>
+
+Draw many circles.
+
+	GFX_Circles( $renderer, [ map { [ $_->x, $_->y, 3, 0, 0xFFFFFFFF ] } @stars ] );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<circles> - a list of C<[ $x, $y, $r, $width, $color ]>, or a string packed with C<f4L> per circle
+
+=back
+
+=head2 C<GFX_Ellipse( ... )>
+
+Draw an axis-aligned ellipse.
+
+	GFX_Ellipse( $surface, 100, 60, 80, 40, 2, 0xFFFFFFFF );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<x>, C<y> - the center
+
+=item C<rx>, C<ry> - the horizontal and vertical radii
+
+=item C<width> - the outline's thickness, or C<0> to fill
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_Ellipses( ... )>
+
+Draw many ellipses.
+
+	GFX_Ellipses( $renderer, \$packed );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<ellipses> - a list of C<[ $x, $y, $rx, $ry, $width, $color ]>, or a string packed with C<f5L> per ellipse
+
+=back
+
+=head2 C<GFX_Arc( ... )>
+
+Draw part of a circle's outline or, when filled, a pie slice.
+
+	GFX_Arc( $renderer, 100, 100, 50, -90, 0, 4, 0xFFFF00FF );    # top right quarter
+
+Angles are in degrees, clockwise from 3 o'clock. The arc runs clockwise from
+C<start> to C<end>, wrapping past 360.
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<x>, C<y> - the center
+
+=item C<r> - the radius
+
+=item C<start> - the starting angle
+
+=item C<end> - the ending angle
+
+=item C<width> - the outline's thickness, or C<0> for a pie slice
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_Arcs( ... )>
+
+Draw many arcs.
+
+	GFX_Arcs( $surface, [ [ 50, 50, 20, 0, $progress * 360, 3, 0x00FF00FF ] ] );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<arcs> - a list of C<[ $x, $y, $r, $start, $end, $width, $color ]>, or a string packed with C<f6L> per arc
+
+=back
+
+=head2 C<GFX_RoundedRect( ... )>
+
+Draw a rectangle with rounded corners. Outlines are drawn inside the rectangle.
+
+	GFX_RoundedRect( $renderer, 10, 10, 200, 40, 8, 0, 0x202020C0 );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<x>, C<y> - the top left pixel
+
+=item C<w>, C<h> - the size in pixels
+
+=item C<radius> - the corners' radius; C<0> for square corners
+
+=item C<width> - the outline's thickness, or C<0> to fill
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_RoundedRects( ... )>
+
+Draw many rounded rectangles.
+
+	GFX_RoundedRects( $renderer, [ map { [ $_ * 50, 10, 40, 20, 6, 0, 0x808080FF ] } 0 .. 9 ] );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<rects> - a list of C<[ $x, $y, $w, $h, $radius, $width, $color ]>, or a string packed with C<f6L> per rectangle
+
+=back
+
+=head2 C<GFX_Polygon( ... )>
+
+Draw a polygon. Filled polygons may be concave but should not cross themselves.
+
+	GFX_Polygon( $surface, [ [ 10, 10 ], [ 90, 20 ], [ 50, 80 ] ], 0, 0xFF8000FF );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<points> - a list of C<[ $x, $y ]> pairs or a flat list of coordinates
+
+=item C<width> - the outline's thickness, or C<0> to fill
+
+=item C<color> - C<0xRRGGBBAA>
+
+=back
+
+=head2 C<GFX_Polygons( ... )>
+
+Draw many polygons.
+
+	GFX_Polygons( $renderer, [ [ \@triangle, 0, 0xFF0000FF ], [ \@square, 2, 0xFFFFFFFF ] ] );
+
+Like the other batch forms, it also takes packed strings: one C<lfL> item
+(point count, width, color) per polygon, and the points of every polygon in
+turn packed with C<f*>. Pass them as a pair or as two arguments.
+
+	my $items  = pack '(lfL)*', 3, 0, 0xFF0000FF, 4, 2, 0xFFFFFFFF;
+	my $points = pack 'f*', @triangle, @square;
+	GFX_Polygons( $surface, [ $items, $points ] );
+	GFX_Polygons( $surface, \$items, \$points );
+
+Expected parameters include:
+
+=over
+
+=item C<target> - the L<SDL3::Surface> or L<SDL3::Renderer> to draw on
+
+=item C<polygons> - a list of C<[ $points, $width, $color ]>, a C<[ $items, $points ]> pair of packed strings, or a packed string of items (or a reference to one)
+
+=item C<points> - with packed items, the packed points (or a reference to them)
+
+=back
+
+It fails if the items ask for more points than were given.
+
+=head1 LICENSE
+
+Copyright (C) Sanko Robinson.
+
+This library is free software; you can redistribute it and/or modify it under
+the terms found in the Artistic License 2. Other copyrights, terms, and
+conditions may apply to data transmitted through this module.
+
+=head1 AUTHOR
+
+Sanko Robinson E<lt>sanko@cpan.orgE<gt>
+
+=begin stopwords
+
+anti-aliased aliased 0xRRGGBBAA
+
+=end stopwords
+
+=cut
+
+};
+1;
@@ -48,7 +48,7 @@ package SDL3::Utils {
         # Windows... this matters in Windows...
         SDL2_image  => [qw[SDL2 jpeg png16 tiff webp zlib1]],
         SDL2_ttf    => [qw[SDL2 freetype]],
-        api_wrapper => [qw[SDL2 SDL2_mixer]],
+        api_wrapper => [qw[SDL2 SDL2_mixer SDL2_image]],
         SDL2_mixer  => [qw[]],                                  # TODO
         freetype    => [qw[zlib1]]
     );
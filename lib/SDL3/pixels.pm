@@ -1,11 +1,14 @@
 package SDL3::pixels 0.01 {
     use SDL3::Utils;
     use experimental 'signatures';
+    use FFI::Platypus::Buffer qw[scalar_to_pointer];
     #
     #
     use SDL3::stdinc;
     use SDL3::endian;
     #
+    load_lib('api_wrapper');
+    #
     define pixels => [ [ SDL_ALPHA_OPAQUE => 255 ], [ SDL_ALPHA_TRANSPARENT => 0 ] ];
     enum SDL_PixelType => [
         qw[SDL_PIXELTYPE_UNKNOWN
@@ -506,6 +509,78 @@ package SDL3::pixels 0.01 {
         SDL_CalculateGammaRamp => [ [ 'float', 'uint16[256]' ] ]
     };
 
+    # The array forms take and return packed strings; pixel values are native 32-bit integers
+    sub _map_array ( $inner, $format, $tuples, $channels ) {
+        $tuples = $$tuples if ref $tuples;
+        my $count  = int( length($tuples) / $channels );
+        my $pixels = "\0" x ( $count * 4 );
+        $inner->( $format, scalar_to_pointer($tuples), scalar_to_pointer($pixels), $count ) == 0
+            ? $pixels : undef;
+    }
+
+    sub _get_array ( $inner, $pixels, $format, $channels ) {
+        $pixels = $$pixels if ref $pixels;
+        my $count  = int( length($pixels) / 4 );
+        my $tuples = "\0" x ( $count * $channels );
+        $inner->( scalar_to_pointer($pixels), $count, $format, scalar_to_pointer($tuples) ) == 0
+            ? $tuples : undef;
+    }
+    attach pixels => {
+        Bundle_SDL_MapRGBArray => [
+            [ 'SDL_PixelFormat', 'opaque', 'opaque', 'int' ],
+            'int' => sub ( $inner, $format, $rgb ) { _map_array( $inner, $format, $rgb, 3 ) }
+        ],
+        Bundle_SDL_MapRGBAArray => [
+            [ 'SDL_PixelFormat', 'opaque', 'opaque', 'int' ],
+            'int' => sub ( $inner, $format, $rgba ) { _map_array( $inner, $format, $rgba, 4 ) }
+        ],
+        Bundle_SDL_GetRGBArray => [
+            [ 'opaque', 'int', 'SDL_PixelFormat', 'opaque' ],
+            'int' => sub ( $inner, $pixels, $format ) { _get_array( $inner, $pixels, $format, 3 ) }
+        ],
+        Bundle_SDL_GetRGBAArray => [
+            [ 'opaque', 'int', 'SDL_PixelFormat', 'opaque' ],
+            'int' => sub ( $inner, $pixels, $format ) { _get_array( $inner, $pixels, $format, 4 ) }
+        ]
+    };
+
+    package SDL3::PaletteCycler {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+    enum SDL_PaletteCycleFlags => [
+        [ SDL_PALETTECYCLE_FORWARD  => 0 ],
+        [ SDL_PALETTECYCLE_REVERSE  => 0x1 ],
+        [ SDL_PALETTECYCLE_PINGPONG => 0x2 ],
+        [ SDL_PALETTECYCLE_BLEND    => 0x4 ]
+    ];
+    attach palettecycle => {
+        Bundle_SDL_CreatePaletteCycler  => [ ['SDL_Palette'], 'SDL_PaletteCycler' ],
+        Bundle_SDL_DestroyPaletteCycler => [ ['SDL_PaletteCycler'] ],
+        Bundle_SDL_AddPaletteCycle      => [
+            [ 'SDL_PaletteCycler', 'int', 'int', 'float', 'uint32' ],
+            'int' => sub ( $inner, $pc, $first, $count, $rate, $flags = 0 ) {
+                $inner->( $pc, $first, $count, $rate, $flags );
+            }
+        ],
+        Bundle_SDL_ClearPaletteCycles     => [ ['SDL_PaletteCycler'] ],
+        Bundle_SDL_ResetPaletteCycler     => [ ['SDL_PaletteCycler'], 'int' ],
+        Bundle_SDL_SetPaletteCyclerColors => [
+            [ 'SDL_PaletteCycler', 'opaque', 'int', 'int' ],
+            'int' => sub ( $inner, $pc, $colors, $first = 0 ) {
+                $colors
+                    = ref $colors eq 'ARRAY' ? pack 'C*', map { ( @$_, 255 )[ 0 .. 3 ] } @$colors :
+                    ref $colors              ? $$colors :
+                    $colors;
+                $inner->( $pc, scalar_to_pointer($colors), $first, int( length($colors) / 4 ) );
+            }
+        ],
+        Bundle_SDL_UpdatePaletteCycler => [
+            [ 'SDL_PaletteCycler', 'uint32' ],
+            'int' => sub ( $inner, $pc, $ticks = SDL3::SDL_GetTicks() ) { $inner->( $pc, $ticks ) }
+        ]
+    };
+
 =encoding utf-8
 
 =head1 NAME
@@ -838,6 +913,94 @@ Expected parameters include:
 
 =back
 
+=head2 C<SDL_MapRGBArray( ... )>
+
+Map a whole buffer of RGB triples to opaque pixel values in one call.
+
+	my $pixels = SDL_MapRGBArray( $surface->format, pack 'C*', map { ( $_, 0, 255 - $_ ) } 0 .. 255 );
+	my @pixels = unpack 'L*', $pixels;
+
+This gives the same results as calling L<< C<SDL_MapRGB( ... )>|/C<SDL_MapRGB( ... )> >>
+for every triple, without a trip through FFI for each one.
+
+Expected parameters include:
+
+=over
+
+=item C<format> - an L<SDL3::PixelFormat> structure describing the pixel format
+
+=item C<rgb> - a packed string (or a reference to one) of red, green, and blue bytes
+
+=back
+
+Returns a packed string of native 32-bit pixel values, one for each triple,
+whatever the depth of C<format>, or undef on failure.
+
+=head2 C<SDL_MapRGBAArray( ... )>
+
+Map a whole buffer of RGBA quadruples to pixel values in one call.
+
+	my $pixels = SDL_MapRGBAArray( $format, $rgba );
+
+For formats with 8 bits in every channel of a 32-bit pixel, such as
+C<SDL_PIXELFORMAT_ARGB8888> or C<SDL_PIXELFORMAT_RGBA32>, this is done with
+SIMD code (see L<SDL3::surface/Pixel Kernels>). Other formats, including those
+with a palette, are still converted in a single native loop.
+
+Expected parameters include:
+
+=over
+
+=item C<format> - an L<SDL3::PixelFormat> structure describing the pixel format
+
+=item C<rgba> - a packed string (or a reference to one) of red, green, blue, and alpha bytes
+
+=back
+
+Returns a packed string of native 32-bit pixel values, one for each
+quadruple, or undef on failure.
+
+=head2 C<SDL_GetRGBArray( ... )>
+
+Get the RGB values of a whole buffer of pixels in one call.
+
+	my @rgb = unpack 'C*', SDL_GetRGBArray( pack( 'L*', @pixels ), $format );
+
+Expected parameters include:
+
+=over
+
+=item C<pixels> - a packed string (or a reference to one) of native 32-bit pixel values
+
+=item C<format> - an L<SDL3::PixelFormat> structure describing the format of the pixels
+
+=back
+
+Returns a packed string of red, green, and blue bytes, or undef on failure.
+
+=head2 C<SDL_GetRGBAArray( ... )>
+
+Get the RGBA values of a whole buffer of pixels in one call.
+
+	my $rgba = SDL_GetRGBAArray( $pixels, $format );
+
+As with L<< C<SDL_GetRGBA( ... )>|/C<SDL_GetRGBA( ... )> >>, alpha is C<255> for
+formats without an alpha channel. Common 32-bit formats take the same SIMD path
+as L<< C<SDL_MapRGBAArray( ... )>|/C<SDL_MapRGBAArray( ... )> >>.
+
+Expected parameters include:
+
+=over
+
+=item C<pixels> - a packed string (or a reference to one) of native 32-bit pixel values
+
+=item C<format> - an L<SDL3::PixelFormat> structure describing the format of the pixels
+
+=back
+
+Returns a packed string of red, green, blue, and alpha bytes, or undef on
+failure.
+
 =head2 C<SDL_CalculateGammaRamp( ... )>
 
 Calculate a 256 entry gamma ramp for a gamma value.
@@ -867,6 +1030,133 @@ These define alpha as the opacity of a surface.
 
 =back
 
+=head1 Palette Cycling
+
+Color cycling animates 8-bit art (waterfalls, fire, marching lights) by
+rotating ranges of the palette instead of touching pixels. A palette cycler
+remembers the palette's colors and, each time it is updated, rotates the ranges
+it was given and writes just those ranges back with L<< C<SDL_SetPaletteColors(
+... )>|/C<SDL_SetPaletteColors( ... )> >>.
+
+    my $cycler = SDL_CreatePaletteCycler( $surface->format->palette );
+    SDL_AddPaletteCycle( $cycler, 16, 8, 10 );                             # water
+    SDL_AddPaletteCycle( $cycler, 64, 12, 4, SDL_PALETTECYCLE_PINGPONG | SDL_PALETTECYCLE_BLEND );
+    ...;    # every frame
+    if ( SDL_UpdatePaletteCycler($cycler) ) {
+        SDL_UpdateTextureIndexed( $texture, undef, $surface );
+    }
+
+Positions come from the time passed to L<< C<SDL_UpdatePaletteCycler( ...
+)>|/C<SDL_UpdatePaletteCycler( ... )> >>, so animation speed does not depend on
+the frame rate. Anything drawing with the palette sees the change: surface
+blits pick it up on their own, as the blit cache keys its converted copies on
+the palette's version, and L<<
+C<SDL_UpdateTextureIndexed( ... )>|SDL3::render/C<SDL_UpdateTextureIndexed( ...
+)> >> carries it to a texture.
+
+These functions may be imported by name or with the C<:palettecycle> tag.
+
+=head2 C<SDL_CreatePaletteCycler( ... )>
+
+Create a cycler for a palette.
+
+	my $cycler = SDL_CreatePaletteCycler( $palette );
+
+Expected parameters include:
+
+=over
+
+=item C<palette> - the L<SDL3::Palette> to animate; its current colors are the ones cycled
+
+=back
+
+The palette is kept alive until the cycler is destroyed.
+
+Returns a new L<SDL3::PaletteCycler> on success or undef on failure.
+
+=head2 C<SDL_DestroyPaletteCycler( ... )>
+
+Destroy a cycler. The palette keeps whatever colors it has at the time.
+
+	SDL_DestroyPaletteCycler( $cycler );
+
+=head2 C<SDL_AddPaletteCycle( ... )>
+
+Rotate a range of colors.
+
+	my $index = SDL_AddPaletteCycle( $cycler, 240, 16, 2.5, SDL_PALETTECYCLE_REVERSE );
+
+Expected parameters include:
+
+=over
+
+=item C<first> - the first palette entry in the range
+
+=item C<count> - the number of entries; at least C<2>
+
+=item C<rate> - steps per second; one step moves every color to the next entry
+
+=item C<flags> - C<SDL_PaletteCycleFlags> values OR'd together; defaults to C<SDL_PALETTECYCLE_FORWARD>
+
+=back
+
+Ranges are applied in the order they were added, so a later range wins where
+two overlap. Up to 64 ranges may be added.
+
+Returns the range's index on success or a negative error code on failure.
+
+=head2 C<SDL_ClearPaletteCycles( ... )>
+
+Remove every range. The palette keeps its current colors.
+
+	SDL_ClearPaletteCycles( $cycler );
+
+=head2 C<SDL_ResetPaletteCycler( ... )>
+
+Write the original, uncycled colors back to the palette.
+
+	SDL_ResetPaletteCycler( $cycler );
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_SetPaletteCyclerColors( ... )>
+
+Replace some of the original colors, for fades or day and night palettes.
+
+	SDL_SetPaletteCyclerColors( $cycler, [ [ 0, 0, 64 ], [ 0, 0, 96 ] ], 16 );
+
+Expected parameters include:
+
+=over
+
+=item C<colors> - a list of C<[ $r, $g, $b, $a ]> (alpha defaults to C<255>), or a packed string (or a reference to one) of RGBA bytes
+
+=item C<first> - the first palette entry to replace; defaults to C<0>
+
+=back
+
+The colors are written to the palette right away; cycled ranges pick them up on
+the next update.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_UpdatePaletteCycler( ... )>
+
+Move every range to its position at the given time.
+
+	my $changed = SDL_UpdatePaletteCycler( $cycler );
+
+Expected parameters include:
+
+=over
+
+=item C<ticks> - the time in milliseconds; defaults to C<SDL_GetTicks( )>
+
+=back
+
+Returns C<1> if any colors changed, C<0> if none did, or a negative error code
+on failure.
+
 =head1 SDL_PixelType
 
 These may be imported with the tag C<:pixelType>
@@ -1133,6 +1423,23 @@ These values may be imported with the C<:pixelFormatEnum> tag.
 
 =back
 
+=head1 SDL_PaletteCycleFlags
+
+How L<< C<SDL_AddPaletteCycle( ... )>|/C<SDL_AddPaletteCycle( ... )> >> ranges
+move. These may be imported with the C<:paletteCycleFlags> tag.
+
+=over
+
+=item C<SDL_PALETTECYCLE_FORWARD> - colors move towards higher entries and wrap around
+
+=item C<SDL_PALETTECYCLE_REVERSE> - colors move towards lower entries
+
+=item C<SDL_PALETTECYCLE_PINGPONG> - colors move across the range and back again rather than wrapping
+
+=item C<SDL_PALETTECYCLE_BLEND> - colors fade smoothly from one entry to the next instead of stepping
+
+=back
+
 =head1 LICENSE
 
 Copyright (C) Sanko Robinson.
@@ -1147,7 +1454,7 @@ Sanko Robinson E<lt>sanko@cpan.orgE<gt>
 
 =begin stopwords
 
-bpp 8-bpp 16-bpp 32-bpp 0xff
+bpp 8-bpp 16-bpp 32-bpp 0xff uncycled
 
 =end stopwords
 
@@ -3,6 +3,7 @@ package SDL3::rect {
     use SDL3::Utils;
     use experimental 'signatures';
     use FFI::C::ArrayDef;
+    use Ref::Util qw[is_plain_arrayref is_plain_hashref];
     #
     use SDL3::stdinc;
     use SDL3::error;
@@ -96,6 +97,22 @@ package SDL3::rect {
         SDL_IntersectRectAndLine => [ [ 'SDL_Rect', 'int*', 'int*', 'int*', 'int*' ], 'SDL_bool' ],
     };
 
+    # Flattens an SDL3::Rect, a plain ARRAY or HASH ref, or undef into ( x, y, w, h ) for the
+    # bundled functions that take a rect as four ints; undef gives all zeros.
+    sub _xywh ($rect) {
+        !defined $rect          ? ( 0, 0, 0, 0 ) :
+            is_plain_arrayref($rect) ? @$rect[ 0 .. 3 ] :
+            is_plain_hashref($rect)  ? @$rect{qw[x y w h]} :
+            ( $rect->x, $rect->y, $rect->w, $rect->h );
+    }
+
+    # True for a rect with no area. undef is not empty; it stands for the whole surface or target.
+    sub _is_empty ($rect) {
+        return 0 unless defined $rect;
+        my ( undef, undef, $w, $h ) = _xywh($rect);
+        $w <= 0 || $h <= 0;
+    }
+
 =encoding utf-8
 
 =head1 NAME
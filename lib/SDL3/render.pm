@@ -3,10 +3,18 @@ package SDL3::render 0.01 {
     use SDL3::Utils;
     use experimental 'signatures';
     #
+    use Ref::Util             qw[is_plain_arrayref is_plain_hashref];
+    use FFI::Platypus::Buffer qw[scalar_to_pointer window];
+    use Digest::MD5;
+    use List::Util;
+    use Path::Tiny            qw[path];
+    #
     use SDL3::stdinc;
     use SDL3::rect;
     use SDL3::video;
     #
+    load_lib('api_wrapper');
+    #
     enum SDL_RendererFlags => [
         [ SDL_RENDERER_SOFTWARE      => 0x00000001 ],
         [ SDL_RENDERER_ACCELERATED   => 0x00000002 ],
@@ -44,7 +52,10 @@ package SDL3::render 0.01 {
         [ SDL_FLIP_NONE       => 0x00000000 ],
         [ SDL_FLIP_HORIZONTAL => 0x00000001 ],
         [ SDL_FLIP_VERTICAL   => 0x00000002 ]
-        ];
+        ],
+        SDL_CaptureFormat => [qw[SDL_CAPTURE_Y4M SDL_CAPTURE_PNG]],
+        SDL_HUDCorner     =>
+        [qw[SDL_HUD_TOPLEFT SDL_HUD_TOPRIGHT SDL_HUD_BOTTOMLEFT SDL_HUD_BOTTOMRIGHT]];
 
     package SDL3::Renderer {
         use SDL3::Utils;
@@ -55,6 +66,152 @@ package SDL3::render 0.01 {
         use SDL3::Utils;
         our $TYPE = has();
     };
+
+    package SDL3::RenderLayer {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::RenderThread {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::StreamingTexture {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::Readback {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::RenderThreadStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            depth          => 'int',
+            in_flight      => 'int',
+            submitted      => 'uint32',
+            presented      => 'uint32',
+            stalls         => 'uint32',
+            last_render_ns => 'uint32',
+            stall_ns       => 'uint64',
+            render_ns      => 'uint64';
+    };
+
+    package SDL3::CaptureSink {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::TileRenderer {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::VirtualTexture {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::TextureManager {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::Atlas {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::Tilemap {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::ParticleEmitter {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::HUD {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::TextureManagerStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            hits         => 'uint32',
+            misses       => 'uint32',
+            evictions    => 'uint32',
+            failures     => 'uint32',
+            resident     => 'int',
+            entries      => 'int',
+            bytes        => 'uint64',
+            budget       => 'uint64',
+            load_ns      => 'uint64',
+            last_load_ns => 'uint32',
+            max_load_ns  => 'uint32';
+    };
+
+    package SDL3::VirtualTextureStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            resident  => 'int',
+            drawn     => 'uint32',
+            uploads   => 'uint32',
+            evictions => 'uint32',
+            upload_ns => 'uint64';
+    };
+
+    package SDL3::CaptureStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            captured => 'uint32',
+            written  => 'uint32',
+            failed   => 'uint32',
+            stalls   => 'uint32',
+            stall_ns => 'uint64';
+    };
+
+    package SDL3::TilemapStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            tiles   => 'uint32',
+            chunks  => 'uint32',
+            rebuilt => 'uint32',
+            batches => 'uint32';
+    };
+
+    package SDL3::ParticleStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            alive     => 'int',
+            capacity  => 'int',
+            emitted   => 'uint32',
+            expired   => 'uint32',
+            dropped   => 'uint32',
+            update_ns => 'uint32',
+            render_ns => 'uint32';
+    };
+
+    package SDL3::HUDStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            frames    => 'uint32',
+            frame_ms  => 'float',
+            avg_ms    => 'float',
+            max_ms    => 'float',
+            fps       => 'float',
+            events    => 'uint32',
+            callbacks => 'int',
+            draw_ns   => 'uint32';
+    };
+
+    # Counts live capture sinks so presenting stays a single call when nothing is recording
+    my $capture_sinks = 0;
     attach render => {
         SDL_GetNumRenderDrivers     => [ [],                            'int' ],
         SDL_GetRenderDriverInfo     => [ [ 'int', 'SDL_RendererInfo' ], 'int' ],
@@ -152,7 +309,13 @@ package SDL3::render 0.01 {
                 );
             }
         ],
-        SDL_RenderDrawRect  => [ [ 'SDL_Renderer', 'SDL_Rect' ], 'int' ],
+        SDL_RenderDrawRect => [
+            [ 'SDL_Renderer', 'SDL_Rect' ],
+            'int' => sub ( $inner, $renderer, $rect = () ) {
+                return $inner->( $renderer, $rect ) unless _is_plain_rect($rect);
+                SDL3::SDL_RenderDrawRectXYWH( $renderer, SDL3::rect::_xywh($rect) );
+            }
+        ],
         SDL_RenderDrawRects => [
             [ 'SDL_Renderer', 'RectList_t', 'int' ],
             'int' => sub ( $inner, $renderer, @rects ) {
@@ -172,7 +335,13 @@ package SDL3::render 0.01 {
                 );
             }
         ],
-        SDL_RenderFillRect  => [ [ 'SDL_Renderer', 'SDL_Rect' ], 'int' ],
+        SDL_RenderFillRect => [
+            [ 'SDL_Renderer', 'SDL_Rect' ],
+            'int' => sub ( $inner, $renderer, $rect = () ) {
+                return $inner->( $renderer, $rect ) unless _is_plain_rect($rect);
+                SDL3::SDL_RenderFillRectXYWH( $renderer, SDL3::rect::_xywh($rect) );
+            }
+        ],
         SDL_RenderFillRects => [
             [ 'SDL_Renderer', 'RectList_t', 'int' ],
             'int' => sub ( $inner, $renderer, @rects ) {
@@ -192,7 +361,18 @@ package SDL3::render 0.01 {
                 );
             }
         ],
-        SDL_RenderCopy => [ [ 'SDL_Renderer', 'SDL_Texture', 'SDL_Rect', 'SDL_Rect' ], 'int' ],
+        SDL_RenderCopy => [
+            [ 'SDL_Renderer', 'SDL_Texture', 'SDL_Rect', 'SDL_Rect' ],
+            'int' => sub ( $inner, $renderer, $texture, $srcrect = (), $dstrect = () ) {
+                return $inner->( $renderer, $texture, $srcrect, $dstrect )
+                    unless _is_plain_rect($srcrect) || _is_plain_rect($dstrect);
+
+                # An empty size means the whole texture or target to the XYWH form; SDL draws nothing
+                return 0 if SDL3::rect::_is_empty($srcrect) || SDL3::rect::_is_empty($dstrect);
+                SDL3::SDL_RenderCopyXYWH( $renderer, $texture, SDL3::rect::_xywh($srcrect),
+                    SDL3::rect::_xywh($dstrect) );
+            }
+        ],
 
         # XXX - I do not have an example for this function in docs
         SDL_RenderCopyEx => [
@@ -303,15 +483,568 @@ package SDL3::render 0.01 {
         ],
         SDL_RenderReadPixels =>
             [ [ 'SDL_Renderer', 'SDL_Rect', 'uint32', 'opaque', 'int' ], 'int' ],
-        SDL_RenderPresent                => [ ['SDL_Renderer'] ],
+        SDL_RenderPresent => [
+            ['SDL_Renderer'],
+            sub ( $inner, $renderer ) {
+                SDL3::SDL_CaptureRenderer($renderer) if $capture_sinks;
+                $inner->($renderer);
+            }
+        ],
         SDL_DestroyTexture               => [ ['SDL_Texture'] ],
         SDL_DestroyRenderer              => [ ['SDL_Renderer'] ],
         SDL_RenderFlush                  => [ ['SDL_Renderer'],                      'int' ],
         SDL_GL_BindTexture               => [ [ 'SDL_Texture', 'float*', 'float*' ], 'int' ],
         SDL_GL_UnbindTexture             => [ ['SDL_Texture'],                       'int' ],
         SDL_RenderGetMetalLayer          => [ ['SDL_Renderer'],                      'opaque' ],
-        SDL_RenderGetMetalCommandEncoder => [ ['SDL_Renderer'],                      'opaque' ]
+        SDL_RenderGetMetalCommandEncoder => [ ['SDL_Renderer'],                      'opaque' ],
+        #
+        Bundle_SDL_RenderDrawRectXYWH  => [ [ 'SDL_Renderer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderFillRectXYWH  => [ [ 'SDL_Renderer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderFillRectXYWHF =>
+            [ [ 'SDL_Renderer', 'float', 'float', 'float', 'float' ], 'int' ],
+        Bundle_SDL_RenderCopyXYWH => [
+            [   'SDL_Renderer', 'SDL_Texture', 'int', 'int', 'int', 'int',
+                'int',          'int',         'int', 'int'
+            ],
+            'int'
+        ],
+        Bundle_SDL_RenderCopyXYWHF => [
+            [   'SDL_Renderer', 'SDL_Texture', 'int',   'int',   'int', 'int',
+                'float',        'float',       'float', 'float'
+            ],
+            'int'
+        ]
+    };
+    attach layer => {
+        Bundle_SDL_CreateRenderLayer     => [ [ 'SDL_Renderer', 'int', 'int' ], 'SDL_RenderLayer' ],
+        Bundle_SDL_DestroyRenderLayer    => [ ['SDL_RenderLayer'] ],
+        Bundle_SDL_GetRenderLayerTexture => [ ['SDL_RenderLayer'], 'SDL_Texture' ],
+        Bundle_SDL_RenderLayerReset      => [ ['SDL_RenderLayer'] ],
+        Bundle_SDL_RenderLayerSetDrawColor =>
+            [ [ 'SDL_RenderLayer', 'uint8', 'uint8', 'uint8', 'uint8' ], 'int' ],
+        Bundle_SDL_RenderLayerSetDrawBlendMode => [ [ 'SDL_RenderLayer', 'SDL_BlendMode' ], 'int' ],
+        Bundle_SDL_RenderLayerFillRect =>
+            [ [ 'SDL_RenderLayer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderLayerDrawRect =>
+            [ [ 'SDL_RenderLayer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderLayerDrawLine =>
+            [ [ 'SDL_RenderLayer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderLayerCopy     => [
+            [   'SDL_RenderLayer', 'SDL_Texture', 'int', 'int', 'int', 'int',
+                'int',             'int',         'int', 'int'
+            ],
+            'int'
+        ],
+        Bundle_SDL_RenderLayerInvalidate => [ ['SDL_RenderLayer'] ],
+        Bundle_SDL_RenderLayerInvalidateRect =>
+            [ [ 'SDL_RenderLayer', 'int', 'int', 'int', 'int' ] ],
+        Bundle_SDL_RenderLayerIsDirty   => [ ['SDL_RenderLayer'], 'SDL_bool' ],
+        Bundle_SDL_RenderLayerRedraws   => [ ['SDL_RenderLayer'], 'uint32' ],
+        Bundle_SDL_RenderLayerUpdate    => [ ['SDL_RenderLayer'], 'int' ],
+        Bundle_SDL_RenderLayerComposite => [
+            [ 'SDL_RenderLayer', 'int', 'int', 'int', 'int' ],
+            'int' => sub ( $inner, $layer, $dx = 0, $dy = 0, $dw = 0, $dh = 0 ) {
+                $inner->( $layer, $dx, $dy, $dw, $dh );
+            }
+        ]
+    };
+    attach renderthread => {
+        Bundle_SDL_CreateRenderThread => [
+            [ 'SDL_Window', 'int', 'uint32', 'int' ],
+            'SDL_RenderThread' => sub ( $inner, $window, $index, $flags, $depth = 2 ) {
+                $inner->( $window, $index, $flags, $depth );
+            }
+        ],
+        Bundle_SDL_DestroyRenderThread => [ ['SDL_RenderThread'] ],
+        Bundle_SDL_RenderThreadSubmit  => [ ['SDL_RenderThread'], 'int' ],
+        Bundle_SDL_RenderThreadFinish  => [ ['SDL_RenderThread'] ],
+        Bundle_SDL_GetRenderThreadStats => [
+            [ 'SDL_RenderThread', 'SDL_RenderThreadStats' ],
+            sub ( $inner, $rt, $stats = SDL3::RenderThreadStats->new ) {
+                $inner->( $rt, $stats );
+                $stats;
+            }
+        ],
+        Bundle_SDL_RenderThreadCreateTexture  => [ [ 'SDL_RenderThread', 'SDL_Surface' ], 'int' ],
+        Bundle_SDL_RenderThreadDestroyTexture => [ [ 'SDL_RenderThread', 'int' ],         'int' ],
+        Bundle_SDL_RenderThreadSetDrawColor =>
+            [ [ 'SDL_RenderThread', 'uint8', 'uint8', 'uint8', 'uint8' ], 'int' ],
+        Bundle_SDL_RenderThreadSetDrawBlendMode =>
+            [ [ 'SDL_RenderThread', 'SDL_BlendMode' ], 'int' ],
+        Bundle_SDL_RenderThreadClear => [ ['SDL_RenderThread'], 'int' ],
+        Bundle_SDL_RenderThreadFillRect =>
+            [ [ 'SDL_RenderThread', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderThreadDrawRect =>
+            [ [ 'SDL_RenderThread', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderThreadDrawLine =>
+            [ [ 'SDL_RenderThread', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_RenderThreadCopy => [
+            [ 'SDL_RenderThread', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int' ],
+            'int'
+        ]
+    };
+    attach streaming => {
+        Bundle_SDL_CreateStreamingTexture => [
+            [ 'SDL_Renderer', 'uint32', 'int', 'int', 'int' ],
+            'SDL_StreamingTexture' => sub ( $inner, $renderer, $format, $w, $h, $count = 2 ) {
+                $inner->( $renderer, $format, $w, $h, $count );
+            }
+        ],
+        Bundle_SDL_DestroyStreamingTexture => [ ['SDL_StreamingTexture'] ],
+        Bundle_SDL_GetStreamingTexture     => [ ['SDL_StreamingTexture'], 'SDL_Texture' ],
+        Bundle_SDL_UpdateStreamingTexture  => [
+            [   'SDL_StreamingTexture', 'int', 'int', 'int', 'int', 'opaque', 'int', 'SDL_bool',
+                'size_t'
+            ],
+            'int' => sub ( $inner, $st, $rect, $pixels, $pitch = 0 ) {
+                my @rect = SDL3::rect::_xywh($rect);
+                return $inner->( $st, @rect, $pixels, $pitch, 1, 0 ) if !ref $pixels;    # native
+                return $inner->( $st, @rect, undef,   $pitch, 0, 0 ) if !defined $$pixels;
+                $inner->( $st, @rect, scalar_to_pointer($$pixels), $pitch, 0, length $$pixels );
+            }
+        ]
+    };
+    attach indexed => {
+        Bundle_SDL_UpdateTextureIndexed => [
+            [ 'SDL_Texture', 'int', 'int', 'int', 'int', 'SDL_Surface' ],
+            'int' => sub ( $inner, $texture, $rect, $surface ) {
+                $inner->( $texture, SDL3::rect::_xywh($rect), $surface );
+            }
+        ]
+    };
+    attach readback => {
+        Bundle_SDL_CreateReadback => [
+            [ 'SDL_Renderer', 'uint32', 'int' ],
+            'SDL_Readback' => sub ( $inner, $renderer, $format, $count = 2 ) {
+                $inner->( $renderer, $format, $count );
+            }
+        ],
+        Bundle_SDL_DestroyReadback => [ ['SDL_Readback'] ],
+        Bundle_SDL_ReadbackCapture => [
+            [ 'SDL_Readback', 'int', 'int', 'int', 'int', 'string' ],
+            'int' => sub ( $inner, $rb, $rect = (), $png = () ) {
+                $inner->( $rb, SDL3::rect::_xywh($rect), $png );
+            }
+        ],
+        Bundle_SDL_ReadbackPoll => [
+            [ 'SDL_Readback', 'int', 'SDL_bool' ],
+            'int' => sub ( $inner, $rb, $handle, $wait = 0 ) {
+                $inner->( $rb, $handle, $wait ? 1 : 0 );
+            }
+        ],
+        Bundle_SDL_GetReadbackPixels => [
+            [ 'SDL_Readback', 'int', 'int*', 'int*', 'int*' ],
+            'opaque' => sub ( $inner, $rb, $handle ) {
+                my $ptr = $inner->( $rb, $handle, \my $w, \my $h, \my $pitch ) // return;
+                window( my $pixels, $ptr, $pitch * $h );    # Read-only; no copy is made
+                wantarray ? ( $pixels, $w, $h, $pitch ) : $pixels;
+            }
+        ],
+        Bundle_SDL_ReadbackRelease => [ [ 'SDL_Readback', 'int' ], 'int' ]
+    };
+    define readback => [
+        [ SDL_ReadbackWait => sub ( $rb, $handle ) { SDL3::SDL_ReadbackPoll( $rb, $handle, 1 ) } ]
+    ];
+    attach capture => {
+        Bundle_SDL_CreateCaptureSink => [
+            [ 'SDL_Renderer', 'SDL_CaptureFormat', 'string', 'int', 'int' ],
+            'SDL_CaptureSink' => sub ( $inner, $renderer, $format, $path, $fps = 60, $depth = 3 ) {
+                my $sink = $inner->( $renderer, $format, $path, $fps, $depth );
+                $capture_sinks++ if $sink;
+                $sink;
+            }
+        ],
+        Bundle_SDL_DestroyCaptureSink => [
+            ['SDL_CaptureSink'],
+            sub ( $inner, $sink ) {
+                $capture_sinks-- if $sink;
+                $inner->($sink);
+            }
+        ],
+        Bundle_SDL_CaptureSinkGrab  => [ ['SDL_CaptureSink'], 'int' ],
+        Bundle_SDL_CaptureRenderer  => [ ['SDL_Renderer'],    'int' ],
+        Bundle_SDL_GetCaptureSinkStats => [
+            [ 'SDL_CaptureSink', 'SDL_CaptureStats' ],
+            sub ( $inner, $sink, $stats = SDL3::CaptureStats->new ) {
+                $inner->( $sink, $stats );
+                $stats;
+            }
+        ]
+    };
+
+    attach tile => {
+        Bundle_SDL_CreateTileRenderer => [
+            [ 'SDL_Surface', 'int', 'int' ],
+            'SDL_TileRenderer' => sub ( $inner, $surface, $threads = 0, $tile_size = 64 ) {
+                $inner->( $surface, $threads, $tile_size );
+            }
+        ],
+        Bundle_SDL_DestroyTileRenderer        => [ ['SDL_TileRenderer'] ],
+        Bundle_SDL_GetTileRendererThreads     => [ ['SDL_TileRenderer'], 'int' ],
+        Bundle_SDL_TileRendererCreateTexture  => [ [ 'SDL_TileRenderer', 'SDL_Surface' ], 'int' ],
+        Bundle_SDL_TileRendererDestroyTexture => [ [ 'SDL_TileRenderer', 'int' ],         'int' ],
+        Bundle_SDL_TileRendererSetDrawColor =>
+            [ [ 'SDL_TileRenderer', 'uint8', 'uint8', 'uint8', 'uint8' ], 'int' ],
+        Bundle_SDL_TileRendererSetDrawBlendMode =>
+            [ [ 'SDL_TileRenderer', 'SDL_BlendMode' ], 'int' ],
+        Bundle_SDL_TileRendererClear => [ ['SDL_TileRenderer'], 'int' ],
+        Bundle_SDL_TileRendererFillRect =>
+            [ [ 'SDL_TileRenderer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_TileRendererDrawRect =>
+            [ [ 'SDL_TileRenderer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_TileRendererDrawLine =>
+            [ [ 'SDL_TileRenderer', 'int', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_TileRendererCopy => [
+            [ 'SDL_TileRenderer', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int' ],
+            'int'
+        ],
+        Bundle_SDL_TileRendererPresent => [ ['SDL_TileRenderer'], 'int' ]
+    };
+
+    attach virtual => {
+        Bundle_SDL_CreateVirtualTexture => [
+            [ 'SDL_Renderer', 'string', 'int', 'int' ],
+            'SDL_VirtualTexture' =>
+                sub ( $inner, $renderer, $path, $tile_size = 0, $max_resident = 64 ) {
+                $inner->( $renderer, $path, $tile_size, $max_resident );
+            }
+        ],
+        Bundle_SDL_CreateVirtualTextureFromSurface => [
+            [ 'SDL_Renderer', 'SDL_Surface', 'int', 'int' ],
+            'SDL_VirtualTexture' =>
+                sub ( $inner, $renderer, $surface, $tile_size = 0, $max_resident = 64 ) {
+                $inner->( $renderer, $surface, $tile_size, $max_resident );
+            }
+        ],
+        Bundle_SDL_BakeVirtualTexture => [
+            [ 'SDL_Surface', 'string', 'int' ],
+            'int' => sub ( $inner, $surface, $path, $tile_size = 512 ) {
+                $inner->( $surface, $path, $tile_size );
+            }
+        ],
+        Bundle_SDL_DestroyVirtualTexture => [ ['SDL_VirtualTexture'] ],
+        Bundle_SDL_GetVirtualTextureSize => [
+            [ 'SDL_VirtualTexture', 'int*', 'int*' ],
+            sub ( $inner, $vt ) {
+                $inner->( $vt, \my $w, \my $h );
+                ( $w, $h );
+            }
+        ],
+        Bundle_SDL_RenderVirtualTexture => [
+            [   'SDL_VirtualTexture', 'int', 'int', 'int', 'int',
+                'float',              'float', 'float', 'float'
+            ],
+            'int' => sub ( $inner, $vt, $view = (), $dst = () ) {
+                $inner->( $vt, SDL3::rect::_xywh($view), SDL3::rect::_xywh($dst) );
+            }
+        ],
+        Bundle_SDL_GetVirtualTextureStats => [
+            [ 'SDL_VirtualTexture', 'SDL_VirtualTextureStats' ],
+            sub ( $inner, $vt, $stats = SDL3::VirtualTextureStats->new ) {
+                $inner->( $vt, $stats );
+                $stats;
+            }
+        ]
+    };
+
+    attach texturemanager => {
+        Bundle_SDL_CreateTextureManager => [
+            [ 'SDL_Renderer', 'uint64' ],
+            'SDL_TextureManager' => sub ( $inner, $renderer, $budget = 256 * 1024 * 1024 ) {
+                $inner->( $renderer, $budget );
+            }
+        ],
+        Bundle_SDL_DestroyTextureManager    => [ ['SDL_TextureManager'] ],
+        Bundle_SDL_TextureManagerAddFile    => [ [ 'SDL_TextureManager', 'string' ],      'int' ],
+        Bundle_SDL_TextureManagerAddSurface => [ [ 'SDL_TextureManager', 'SDL_Surface' ], 'int' ],
+        Bundle_SDL_TextureManagerRemove     => [ [ 'SDL_TextureManager', 'int' ],         'int' ],
+        Bundle_SDL_TextureManagerGet => [ [ 'SDL_TextureManager', 'int' ], 'SDL_Texture' ],
+        Bundle_SDL_TextureManagerCopy => [
+            [ 'SDL_TextureManager', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int', 'int' ],
+            'int' => sub ( $inner, $tm, $handle, $src = (), $dst = () ) {
+                $inner->( $tm, $handle, SDL3::rect::_xywh($src), SDL3::rect::_xywh($dst) );
+            }
+        ],
+        Bundle_SDL_TextureManagerSetBudget => [ [ 'SDL_TextureManager', 'uint64' ] ],
+        Bundle_SDL_GetTextureManagerStats  => [
+            [ 'SDL_TextureManager', 'SDL_TextureManagerStats' ],
+            sub ( $inner, $tm, $stats = SDL3::TextureManagerStats->new ) {
+                $inner->( $tm, $stats );
+                $stats;
+            }
+        ]
+    };
+
+    attach atlas => {
+        Bundle_SDL_CreateAtlas => [
+            [ 'int', 'int', 'int', 'int' ],
+            'SDL_Atlas' => sub ( $inner, $w = 2048, $h = 2048, $padding = 1, $extrude = 1 ) {
+                $inner->( $w, $h, $padding, $extrude );
+            }
+        ],
+        Bundle_SDL_DestroyAtlas => [ ['SDL_Atlas'] ],
+        Bundle_SDL_AtlasAdd     => [
+            [ 'SDL_Atlas', 'SDL_Surface', 'string' ],
+            'int' => sub ( $inner, $atlas, $surface, $name = () ) {
+                $inner->( $atlas, $surface, $name );
+            }
+        ],
+        Bundle_SDL_AtlasPack      => [ ['SDL_Atlas'],                   'int' ],
+        Bundle_SDL_AtlasUpload    => [ [ 'SDL_Atlas', 'SDL_Renderer' ], 'int' ],
+        Bundle_SDL_GetAtlasHandle => [ [ 'SDL_Atlas', 'string' ],       'int' ],
+        Bundle_SDL_GetAtlasRegion => [
+            [ 'SDL_Atlas', 'int', 'int*', 'int*', 'int*', 'int*', 'int*' ],
+            'SDL_Texture' => sub ( $inner, $atlas, $handle ) {
+                my $texture
+                    = $inner->( $atlas, $handle, \my $page, \my $x, \my $y, \my $w, \my $h );
+                $page < 0 ? () : ( $texture, $x, $y, $w, $h, $page );
+            }
+        ],
+        Bundle_SDL_AtlasCopy => [
+            [ 'SDL_Atlas', 'int', 'int', 'int', 'int', 'int' ],
+            'int' => sub ( $inner, $atlas, $handle, $dst = () ) {
+                $inner->( $atlas, $handle, SDL3::rect::_xywh($dst) );
+            }
+        ],
+        Bundle_SDL_GetAtlasNumPages => [ ['SDL_Atlas'],          'int' ],
+        Bundle_SDL_GetAtlasPage     => [ [ 'SDL_Atlas', 'int' ], 'SDL_Surface' ],
+        Bundle_SDL_SaveAtlas        => [ [ 'SDL_Atlas', 'string' ], 'int' ],
+        Bundle_SDL_LoadAtlas        => [ ['string'], 'SDL_Atlas' ]
+    };
+
+    attach tilemap => {
+        Bundle_SDL_CreateTilemap => [
+            [ 'SDL_Renderer', 'SDL_Texture', 'int', 'int', 'int', 'int' ], 'SDL_Tilemap'
+        ],
+        Bundle_SDL_DestroyTilemap  => [ ['SDL_Tilemap'] ],
+        Bundle_SDL_SetTilemapTiles => [
+            [ 'SDL_Tilemap', 'int', 'int', 'int', 'int', 'opaque', 'size_t' ],
+            'int' => sub ( $inner, $tm, $tiles, $rect = () ) {
+                my $packed = is_plain_arrayref($tiles) ? pack 'S*', @$tiles : $$tiles;
+                $inner->(
+                    $tm, SDL3::rect::_xywh($rect),
+                    scalar_to_pointer($packed), length $packed
+                );
+            }
+        ],
+        Bundle_SDL_SetTilemapTile      => [ [ 'SDL_Tilemap', 'int', 'int', 'int' ], 'int' ],
+        Bundle_SDL_GetTilemapTile      => [ [ 'SDL_Tilemap', 'int', 'int' ],        'int' ],
+        Bundle_SDL_SetTilemapAnimation => [
+            [ 'SDL_Tilemap', 'int', 'opaque', 'int', 'uint32' ],
+            'int' => sub ( $inner, $tm, $tile, $frames, $frame_ms = 100 ) {
+                my $packed = pack 'S*', @{ $frames // [] };
+                $inner->( $tm, $tile, scalar_to_pointer($packed), scalar @{ $frames // [] },
+                    $frame_ms );
+            }
+        ],
+        Bundle_SDL_UpdateTilemap       => [ [ 'SDL_Tilemap', 'uint32' ] ],
+        Bundle_SDL_SetTilemapChunkSize => [ [ 'SDL_Tilemap', 'int' ], 'int' ],
+        Bundle_SDL_InvalidateTilemap   => [ ['SDL_Tilemap'] ],
+        Bundle_SDL_RenderTilemap       => [
+            [   'SDL_Tilemap', 'float', 'float', 'float', 'float',
+                'float',       'float', 'float', 'float'
+            ],
+            'int' => sub ( $inner, $tm, $camera = (), $dst = () ) {
+                $inner->( $tm, SDL3::rect::_xywh($camera), SDL3::rect::_xywh($dst) );
+            }
+        ],
+        Bundle_SDL_GetTilemapStats => [
+            [ 'SDL_Tilemap', 'SDL_TilemapStats' ],
+            sub ( $inner, $tm, $stats = SDL3::TilemapStats->new ) {
+                $inner->( $tm, $stats );
+                $stats;
+            }
+        ]
+    };
+
+    attach particles => {
+        Bundle_SDL_CreateParticleEmitter => [
+            [ 'SDL_Renderer', 'int' ],
+            'SDL_ParticleEmitter' => sub ( $inner, $renderer, $capacity = 10000 ) {
+                $inner->( $renderer, $capacity );
+            }
+        ],
+        Bundle_SDL_DestroyParticleEmitter     => [ ['SDL_ParticleEmitter'] ],
+        Bundle_SDL_SetParticleEmitterTexture  => [ [ 'SDL_ParticleEmitter', 'SDL_Texture' ] ],
+        Bundle_SDL_SetParticleEmitterPosition => [ [ 'SDL_ParticleEmitter', 'float', 'float' ] ],
+        Bundle_SDL_SetParticleEmitterRate     => [ [ 'SDL_ParticleEmitter', 'float' ] ],
+        Bundle_SDL_SetParticleEmitterLifetime => [
+            [ 'SDL_ParticleEmitter', 'float', 'float' ],
+            'int' => sub ( $inner, $pe, $min, $max = $min ) { $inner->( $pe, $min, $max ) }
+        ],
+        Bundle_SDL_SetParticleEmitterVelocity => [
+            [ 'SDL_ParticleEmitter', 'float', 'float', 'float', 'float' ],
+            sub ( $inner, $pe, $speed_min, $speed_max = $speed_min, $angle_min = 0,
+                $angle_max = 360 ) {
+                $inner->( $pe, $speed_min, $speed_max, $angle_min, $angle_max );
+            }
+        ],
+        Bundle_SDL_SetParticleEmitterForces => [
+            [ 'SDL_ParticleEmitter', 'float', 'float', 'float' ],
+            sub ( $inner, $pe, $ax, $ay, $drag = 1 ) { $inner->( $pe, $ax, $ay, $drag ) }
+        ],
+        Bundle_SDL_SetParticleEmitterSize => [
+            [ 'SDL_ParticleEmitter', 'float', 'float' ],
+            sub ( $inner, $pe, $start, $end = $start ) { $inner->( $pe, $start, $end ) }
+        ],
+        Bundle_SDL_SetParticleEmitterColor => [
+            [ 'SDL_ParticleEmitter', ('uint8') x 8 ],
+            sub ( $inner, $pe, $start, $end = $start ) {
+                $inner->(
+                    $pe,
+                    map { is_plain_arrayref($_) ? ( @$_[ 0 .. 2 ], $_->[3] // 255 ) :
+                            ( $_->r, $_->g, $_->b, $_->a ) } $start, $end
+                );
+            }
+        ],
+        Bundle_SDL_ParticleEmitterBurst     => [ [ 'SDL_ParticleEmitter', 'int' ], 'int' ],
+        Bundle_SDL_UpdateParticleEmitter    => [ [ 'SDL_ParticleEmitter', 'float' ] ],
+        Bundle_SDL_RenderParticleEmitter    => [ ['SDL_ParticleEmitter'], 'int' ],
+        Bundle_SDL_GetParticleKernel        => [ [], 'string' ],
+        Bundle_SDL_GetParticleEmitterStats  => [
+            [ 'SDL_ParticleEmitter', 'SDL_ParticleStats' ],
+            sub ( $inner, $pe, $stats = SDL3::ParticleStats->new ) {
+                $inner->( $pe, $stats );
+                $stats;
+            }
+        ]
+    };
+
+    attach hud => {
+        Bundle_SDL_CreateHUD => [
+            [ 'SDL_Renderer', 'int', 'int' ],
+            'SDL_HUD' => sub (
+                $inner, $renderer,
+                $toggle = SDL3::SDL_SCANCODE_F3(),
+                $scale  = 2
+            ) {
+                $inner->( $renderer, $toggle, $scale );
+            }
+        ],
+        Bundle_SDL_DestroyHUD         => [ ['SDL_HUD'] ],
+        Bundle_SDL_SetHUDVisible      => [ [ 'SDL_HUD', 'SDL_bool' ] ],
+        Bundle_SDL_IsHUDVisible       => [ ['SDL_HUD'], 'SDL_bool' ],
+        Bundle_SDL_SetHUDCorner       => [ [ 'SDL_HUD', 'SDL_HUDCorner' ] ],
+        Bundle_SDL_SetHUDAudioDevice  => [
+            [ 'SDL_HUD', 'uint32', 'uint32' ],
+            sub ( $inner, $hud, $device, $target = 16384 ) { $inner->( $hud, $device, $target ) }
+        ],
+        Bundle_SDL_SetHUDCounter      => [
+            [ 'SDL_HUD', 'string', 'double', 'SDL_bool' ],
+            'int' => sub ( $inner, $hud, $name, $value = () ) {
+                $inner->( $hud, $name, $value // 0, defined $value ? 0 : 1 );
+            }
+        ],
+        Bundle_SDL_RenderHUD   => [ ['SDL_HUD'], 'int' ],
+        Bundle_SDL_GetHUDStats => [
+            [ 'SDL_HUD', 'SDL_HUDStats' ],
+            sub ( $inner, $hud, $stats = SDL3::HUDStats->new ) {
+                $inner->( $hud, $stats );
+                $stats;
+            }
+        ]
+    };
+    attach autotune => {
+        Bundle_SDL_BenchmarkRenderer => [
+            [ 'SDL_Renderer', 'int', 'uint64*', 'uint64*', 'uint64*' ],
+            'int' => sub ( $inner, $renderer, $frames = 10 ) {
+                my $ok = $inner->( $renderer, $frames, \my $copy, \my $fill, \my $geometry ) == 0;
+                $ok ? ( $copy, $fill, $geometry ) : ();
+            }
+        ]
     };
+    define autotune => [
+        [   SDL_AutoTuneRenderer => sub ( $org, $app, %opts ) {
+                my @drivers = map {
+                    my $info = SDL3::RendererInfo->new;
+                    SDL3::SDL_GetRenderDriverInfo( $_, $info );
+                    ffi->cast( 'opaque', 'string', $info->name );
+                } 0 .. SDL3::SDL_GetNumRenderDrivers() - 1;
+                my %hints = (
+                    SDL3::SDL_HINT_RENDER_BATCHING()      => [ 1, 0 ],
+                    SDL3::SDL_HINT_RENDER_SCALE_QUALITY() => [ 'nearest', 'linear' ],
+                    %{ $opts{hints} // {} }
+                );
+                my $key  = _autotune_fingerprint( \%hints, @drivers );
+                my $pref = SDL3::SDL_GetPrefPath( $org, $app );
+                my $file = defined $pref ? path( $pref, 'autotune.txt' ) : undef;
+                my @lines = $file && $file->is_file ? $file->lines( { chomp => 1 } ) : ();
+                my $best;
+                for ( $opts{force} ? () : @lines ) {
+                    my ( $fingerprint, $driver, $ns, @set ) = split /\t/;
+                    next unless $fingerprint eq $key;
+                    my ($index) = grep { $drivers[$_] eq $driver } 0 .. $#drivers;
+                    $best = {
+                        driver => $driver,
+                        index  => $index,
+                        ns     => $ns,
+                        hints  => { map { split /=/, $_, 2 } @set },
+                        cached => 1
+                    } if defined $index;
+                }
+                if ( !$best ) {    # Probe every driver with every combination of hint values
+                    my @configs = ( {} );
+                    for my $hint ( sort keys %hints ) {
+                        @configs = map {
+                            my $config = $_;
+                            map { +{ %$config, $hint => $_ } } @{ $hints{$hint} }
+                        } @configs;
+                    }
+                    my %saved  = map { $_ => SDL3::SDL_GetHint($_) } keys %hints;
+                    my $window = SDL3::SDL_CreateWindow( 'autotune', 0, 0, 64, 64,
+                        SDL3::SDL_WINDOW_HIDDEN() ) // return;
+                    for my $index ( 0 .. $#drivers ) {
+                        for my $config (@configs) {
+                            SDL3::SDL_SetHint( $_, $config->{$_} ) for keys %$config;
+                            my $renderer
+                                = SDL3::SDL_CreateRenderer( $window, $index, $opts{flags} // 0 )
+                                // next;
+                            my @ns = SDL3::SDL_BenchmarkRenderer( $renderer, $opts{frames} // 10 );
+                            SDL3::SDL_DestroyRenderer($renderer);
+                            next unless @ns;
+                            my $total = List::Util::sum0(@ns);
+                            $best = {
+                                driver => $drivers[$index],
+                                index  => $index,
+                                ns     => $total,
+                                hints  => $config,
+                                cached => 0
+                            } if !$best || $total < $best->{ns};
+                        }
+                    }
+                    SDL3::SDL_DestroyWindow($window);
+                    SDL3::SDL_SetHint( $_, $saved{$_} ) for keys %saved;
+                    return unless $best;
+                    $file->spew(
+                        map {"$_\n"} ( grep { !/^\Q$key\E\t/ } @lines ),
+                        join "\t", $key, $best->{driver}, $best->{ns},
+                        map {"$_=$best->{hints}{$_}"} sort keys %{ $best->{hints} }
+                    ) if $file;
+                }
+                SDL3::SDL_SetHint( SDL3::SDL_HINT_RENDER_DRIVER(), $best->{driver} );
+                SDL3::SDL_SetHint( $_, $best->{hints}{$_} ) for keys %{ $best->{hints} };
+                $best;
+            }
+        ]
+    ];
+
+    # Everything that could change which configuration wins, including the candidates themselves
+    sub _autotune_fingerprint ( $hints, @drivers ) {
+        my $version = SDL3::Version->new;
+        SDL3::SDL_GetVersion($version);
+        my $mode = SDL3::DisplayMode->new;
+        SDL3::SDL_GetDesktopDisplayMode( 0, $mode );
+        Digest::MD5::md5_hex(
+            join "\0", SDL3::SDL_GetPlatform(), SDL3::SDL_GetCPUCount(), SDL3::SDL_GetSystemRAM(),
+            join( '.', $version->major, $version->minor, $version->patch ),
+            SDL3::SDL_GetCurrentVideoDriver() // '', $mode->w, $mode->h, $mode->refresh_rate,
+            @drivers, map { $_, @{ $hints->{$_} } } sort keys %$hints
+        );
+    }
+
+    # Plain ARRAY and HASH refs are routed through the scalar entry points so that no FFI::C
+    # struct is allocated; SDL3::Rect objects (and undef) are passed to SDL untouched.
+    sub _is_plain_rect ($rect) { is_plain_arrayref($rect) || is_plain_hashref($rect) }
 
 =encoding utf-8
 
@@ -1514,6 +2247,10 @@ Expected parameters include:
 
 =back
 
+C<rect> may also be a plain array (C<[ $x, $y, $w, $h ]>) or hash reference in
+which case the call is forwarded to L<< C<SDL_RenderFillRectXYWH( ...
+)>|/C<SDL_RenderFillRectXYWH( ... )> >> and no L<SDL3::Rect> is allocated.
+
 Returns C<0> on success or a negative error code on failure; call
 C<SDL_GetError( )> for more information.
 
@@ -1576,25 +2313,12 @@ Expected parameters include:
 Returns C<0> on success or a negative error code on failure; call
 C<SDL_GetError( )> for more information.
 
-=head2 C<SDL_RenderCopyEx( ... )>
-
-Copy a portion of the texture to the current rendering, with optional rotation
-and flipping.
-
-=for TODO: I need an example for this... it's complex
-
-Copy a portion of the texture to the current rendering target, optionally
-rotating it by angle around the given center and also flipping it top-bottom
-and/or left-right.
-
-The texture is blended with the destination based on its blend mode set with
-L<< C<SDL_SetTextureBlendMode( ... )>|/C<SDL_SetTextureBlendMode( ... )> >>.
+=head2 C<SDL_RenderDrawRectXYWH( ... )>
 
-The texture color is affected based on its color modulation set by L<<
-C<SDL_SetTextureColorMod( ... )>|/C<SDL_SetTextureColorMod( ... )> >>.
+Draw a rectangle on the current rendering target without allocating an
+L<SDL3::Rect>.
 
-The texture alpha is affected based on its alpha modulation set by L<<
-C<SDL_SetTextureAlphaMod( ... )>|/C<SDL_SetTextureAlphaMod( ... )> >>.
+	SDL_RenderDrawRectXYWH( $renderer, 100, 100, 50, 50 );
 
 Expected parameters include:
 
@@ -1602,42 +2326,171 @@ Expected parameters include:
 
 =item C<renderer> - the rendering context
 
-=item C<texture> - the source texture
-
-=item C<srcrect> - the source L<SDL3::Rect> structure
-
-=for TODO: or NULL for the entire texture
-
-=item C<dstrect> - the destination SDL_Rect structure
-
-=for TODO: or NULL for the entire rendering target
+=item C<x> - the x coordinate of the upper left corner
 
-=item C<angle> - an angle in degrees that indicates the rotation that will be applied to dstrect, rotating it in a clockwise direction
+=item C<y> - the y coordinate of the upper left corner
 
-=item C<center> - a pointer to a point indicating the point around which dstrect will be rotated (if NULL, rotation will be done around C<dstrect.w / 2>, C<dstrect.h / 2>)
+=item C<w> - the width of the rectangle
 
-=item C<flip> - a L<:rendererFlip> value stating which flipping actions should be performed on the texture
+=item C<h> - the height of the rectangle
 
 =back
 
 Returns C<0> on success or a negative error code on failure; call
 C<SDL_GetError( )> for more information.
 
-=head2 C<SDL_RenderDrawPointF( ... )>
+=head2 C<SDL_RenderFillRectXYWH( ... )>
 
-Draw a point on the current rendering target at subpixel precision.
+Fill a rectangle on the current rendering target with the drawing color without
+allocating an L<SDL3::Rect>.
 
-	SDL_RenderDrawPointF( $renderer, 25.5, 100.25 );
+	SDL_RenderFillRectXYWH( $renderer, 100, 100, 50, 50 );
+
+The rectangle is built on the C stack and passed directly to
+C<SDL_RenderFillRect( ... )> which makes this the preferred way to fill many
+rectangles in a tight loop.
 
 Expected parameters include:
 
 =over
 
-=item C<renderer> - The renderer which should draw a point.
+=item C<renderer> - the rendering context
 
-=item C<x> - The x coordinate of the point.
+=item C<x> - the x coordinate of the upper left corner
 
-=item C<y> - The y coordinate of the point.
+=item C<y> - the y coordinate of the upper left corner
+
+=item C<w> - the width of the rectangle
+
+=item C<h> - the height of the rectangle
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderFillRectXYWHF( ... )>
+
+Fill a rectangle with floating point precision on the current rendering target
+without allocating an L<SDL3::FRect>.
+
+	SDL_RenderFillRectXYWHF( $renderer, 10.5, 10.5, 20.25, 20.25 );
+
+Expected parameters are the same as L<< C<SDL_RenderFillRectXYWH( ...
+)>|/C<SDL_RenderFillRectXYWH( ... )> >>.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderCopyXYWH( ... )>
+
+Copy a portion of the texture to the current rendering target without
+allocating L<SDL3::Rect> structures.
+
+	SDL_RenderCopyXYWH( $renderer, $sprites, 32, 0, 32, 32, $x, $y, 64, 64 );
+	SDL_RenderCopyXYWH( $renderer, $background, 0, 0, 0, 0, 0, 0, 0, 0 ); # whole texture, whole target
+
+A source or destination with a width or height of C<0> or less is passed along
+as C<NULL>; that is, the entire texture or the entire rendering target.
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the rendering context
+
+=item C<texture> - the source texture
+
+=item C<sx>, C<sy>, C<sw>, C<sh> - the source rectangle
+
+=item C<dx>, C<dy>, C<dw>, C<dh> - the destination rectangle; the texture will be stretched to fill it
+
+=back
+
+L<< C<SDL_RenderCopy( ... )>|/C<SDL_RenderCopy( ... )> >> forwards here when
+either rectangle is given as a plain array or hash reference. A width or
+height of C<0> here means the whole texture or target, so a rectangle with no
+area passed to C<SDL_RenderCopy( ... )> draws nothing and is not forwarded.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderCopyXYWHF( ... )>
+
+Copy a portion of the texture to the current rendering target at subpixel
+precision without allocating L<SDL3::Rect> or L<SDL3::FRect> structures.
+
+	SDL_RenderCopyXYWHF( $renderer, $sprites, 32, 0, 32, 32, 10.5, 20.25, 64, 64 );
+
+Expected parameters are the same as L<< C<SDL_RenderCopyXYWH( ...
+)>|/C<SDL_RenderCopyXYWH( ... )> >> but the destination is given in floating
+point.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderCopyEx( ... )>
+
+Copy a portion of the texture to the current rendering, with optional rotation
+and flipping.
+
+=for TODO: I need an example for this... it's complex
+
+Copy a portion of the texture to the current rendering target, optionally
+rotating it by angle around the given center and also flipping it top-bottom
+and/or left-right.
+
+The texture is blended with the destination based on its blend mode set with
+L<< C<SDL_SetTextureBlendMode( ... )>|/C<SDL_SetTextureBlendMode( ... )> >>.
+
+The texture color is affected based on its color modulation set by L<<
+C<SDL_SetTextureColorMod( ... )>|/C<SDL_SetTextureColorMod( ... )> >>.
+
+The texture alpha is affected based on its alpha modulation set by L<<
+C<SDL_SetTextureAlphaMod( ... )>|/C<SDL_SetTextureAlphaMod( ... )> >>.
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the rendering context
+
+=item C<texture> - the source texture
+
+=item C<srcrect> - the source L<SDL3::Rect> structure
+
+=for TODO: or NULL for the entire texture
+
+=item C<dstrect> - the destination SDL_Rect structure
+
+=for TODO: or NULL for the entire rendering target
+
+=item C<angle> - an angle in degrees that indicates the rotation that will be applied to dstrect, rotating it in a clockwise direction
+
+=item C<center> - a pointer to a point indicating the point around which dstrect will be rotated (if NULL, rotation will be done around C<dstrect.w / 2>, C<dstrect.h / 2>)
+
+=item C<flip> - a L<:rendererFlip> value stating which flipping actions should be performed on the texture
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderDrawPointF( ... )>
+
+Draw a point on the current rendering target at subpixel precision.
+
+	SDL_RenderDrawPointF( $renderer, 25.5, 100.25 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - The renderer which should draw a point.
+
+=item C<x> - The x coordinate of the point.
+
+=item C<y> - The y coordinate of the point.
 
 =back
 
@@ -2088,80 +2941,2144 @@ Expected parameters include:
 Returns C<idE<lt>MTLRenderCommandEncoderE<gt>> on success, or undef if the
 renderer isn't a Metal renderer.
 
-=head1 Defined Variables and Enumerations
+=head1 Retained Layers
 
-Variables may be imported by name or with the C<:render> tag. Enumerations may
-be imported with their given tags.
+Much of a typical frame (backgrounds, static HUD chrome, etc.) does not change
+between frames. A layer records draw calls once and rasterizes them into a
+C<SDL_TEXTUREACCESS_TARGET> texture. Compositing the layer onto the current
+target is then a single C<SDL_RenderCopy( ... )> until something is invalidated.
 
-=head2 C<SDL_RendererFlags>
+    my $hud = SDL_CreateRenderLayer( $renderer, 640, 48 );
+    SDL_RenderLayerSetDrawColor( $hud, 40, 40, 40, 255 );
+    SDL_RenderLayerFillRect( $hud, 0, 0, 640, 48 );
+    SDL_RenderLayerCopy( $hud, $icons, 0, 0, 32, 32, 8, 8, 32, 32 );
+    while (1) {
+        ...;
+        SDL_RenderLayerComposite( $hud, 0, 432, 640, 48 );
+        SDL_RenderPresent($renderer);
+    }
 
-Flags used when creating a rendering context.
+Recording a command only marks the area it touches as dirty. When a layer is
+next updated, each dirty rect is cleared to transparent and only the commands
+that intersect it are replayed with the clip rect set so the rest of the layer
+is left alone. Replays begin with an opaque black draw color and
+C<SDL_BLENDMODE_NONE>, just like a fresh renderer.
 
-=over
+Textures used with L<< C<SDL_RenderLayerCopy( ... )>|/C<SDL_RenderLayerCopy(
+... )> >> are not owned by the layer and must outlive it. If the renderer
+reports C<SDL_RENDER_TARGETS_RESET>, call L<< C<SDL_RenderLayerInvalidate( ...
+)>|/C<SDL_RenderLayerInvalidate( ... )> >> on every layer.
 
-=item C<SDL_RENDERER_SOFTWARE> - The renderer is a software fallback
+These functions may be imported by name or with the C<:layer> tag.
 
-=item C<SDL_RENDERER_ACCELERATED> - The renderer uses hardware acceleration
+=head2 C<SDL_CreateRenderLayer( ... )>
 
-=item C<SDL_RENDERER_PRESENTVSYNC> - Present is synchronized with the refresh rate
+Create a new, empty layer.
 
-=item C<SDL_RENDERER_TARGETTEXTURE> - The renderer supports rendering to texture
+	my $layer = SDL_CreateRenderLayer( $renderer, 640, 480 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the rendering context; it must support render targets
+
+=item C<w> - the width of the layer
+
+=item C<h> - the height of the layer
 
 =back
 
-=head2 C<SDL_ScaleMode>
+Returns a new L<SDL3::RenderLayer> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
 
-The scaling mode for a texture.
+=head2 C<SDL_DestroyRenderLayer( ... )>
 
-=over
+Destroy a layer, its command list, and its backing texture.
 
-=item C<SDL_ScaleModeNearest> - nearest pixel sampling
+	SDL_DestroyRenderLayer( $layer );
 
-=item C<SDL_ScaleModeLinear> - linear filtering
+=head2 C<SDL_GetRenderLayerTexture( ... )>
 
-=item C<SDL_ScaleModeBest> - anisotropic filtering
+Get the L<SDL3::Texture> a layer renders into.
+
+	my $texture = SDL_GetRenderLayerTexture( $layer );
+
+The texture belongs to the layer; do not destroy it.
+
+=head2 C<SDL_RenderLayerReset( ... )>
+
+Drop every recorded command so the layer may be recorded again from scratch.
+
+	SDL_RenderLayerReset( $layer );
+
+=head2 C<SDL_RenderLayerSetDrawColor( ... )>
+
+Record a draw color change.
+
+	SDL_RenderLayerSetDrawColor( $layer, 255, 0, 0, 255 );
+
+Expected parameters include:
+
+=over
+
+=item C<layer> - the layer to record into
+
+=item C<r>, C<g>, C<b>, C<a> - the color used by following commands
 
 =back
 
-=head2 C<SDL_TextureAccess>
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
 
-The access pattern allowed for a texture.
+=head2 C<SDL_RenderLayerSetDrawBlendMode( ... )>
+
+Record a blend mode change.
+
+	SDL_RenderLayerSetDrawBlendMode( $layer, SDL_BLENDMODE_BLEND );
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerFillRect( ... )>
+
+Record a filled rectangle.
+
+	SDL_RenderLayerFillRect( $layer, 10, 10, 100, 20 );
+
+Expected parameters include:
 
 =over
 
-=item C<SDL_TEXTUREACCESS_STATIC> - Changes rarely, not lockable
+=item C<layer> - the layer to record into
 
-=item C<SDL_TEXTUREACCESS_STREAMING> - Changes frequently, lockable
+=item C<x>, C<y>, C<w>, C<h> - the rectangle, in layer coordinates
 
-=item C<SDL_TEXTUREACCESS_TARGET> - Texture can be used as a render target
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerDrawRect( ... )>
+
+Record a rectangle outline.
+
+	SDL_RenderLayerDrawRect( $layer, 10, 10, 100, 20 );
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerDrawLine( ... )>
+
+Record a line.
+
+	SDL_RenderLayerDrawLine( $layer, 0, 0, 639, 479 );
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerCopy( ... )>
+
+Record a texture copy.
+
+	SDL_RenderLayerCopy( $layer, $tiles, 0, 0, 32, 32, 64, 64, 32, 32 );
+
+Parameters follow L<< C<SDL_RenderCopyXYWH( ... )>|/C<SDL_RenderCopyXYWH( ...
+)> >>. A source with a width or height of C<0> or less uses the entire texture
+and a destination with a width or height of C<0> or less covers the entire
+layer.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerInvalidate( ... )>
+
+Mark the entire layer as dirty.
+
+	SDL_RenderLayerInvalidate( $layer );
+
+Use this when a texture the layer copies from has changed.
+
+=head2 C<SDL_RenderLayerInvalidateRect( ... )>
+
+Mark part of the layer as dirty.
+
+	SDL_RenderLayerInvalidateRect( $layer, 600, 0, 40, 20 );
+
+Only this area is cleared and replayed on the next update. Overlapping dirty
+rects are merged; if too many disjoint rects pile up, they are collapsed into
+their bounding rect.
+
+=head2 C<SDL_RenderLayerIsDirty( ... )>
+
+Returns a true value if the layer will be re-rendered by the next update.
+
+=head2 C<SDL_RenderLayerRedraws( ... )>
+
+Returns the number of times the layer has been re-rendered. Handy for making
+sure a static layer really is static.
+
+=head2 C<SDL_RenderLayerUpdate( ... )>
+
+Re-render any dirty areas of the layer into its texture without compositing it.
+
+	SDL_RenderLayerUpdate( $layer );
+
+The renderer's target, clip rect, draw color, and blend mode are restored
+afterwards.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderLayerComposite( ... )>
+
+Update the layer if needed and copy it onto the current rendering target.
+
+	SDL_RenderLayerComposite( $layer );                  # fill the target
+	SDL_RenderLayerComposite( $layer, 0, 432, 640, 48 ); # or a part of it
+
+Expected parameters include:
+
+=over
+
+=item C<layer> - the layer to draw
+
+=item C<x>, C<y>, C<w>, C<h> - the destination rectangle; the entire rendering target is used if the width or height is C<0> or less (the default)
 
 =back
 
-=head2 C<SDL_TextureModulate>
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
 
-The texture channel modulation used in C<SDL_RenderCopy( )>.
+=head1 Render Thread
+
+By default, perl's game logic and SDL's rendering run back to back on the main
+thread. A render thread moves the L<SDL3::Renderer> onto a native thread of its
+own. Perl records each frame into a command list and submits it; the render
+thread replays and presents frame N while perl is already busy with frame N+1.
+
+    my $rt    = SDL_CreateRenderThread( $window, -1, SDL_RENDERER_ACCELERATED, 2 );
+    my $image = IMG_Load('ship.png');
+    my $ship  = SDL_RenderThreadCreateTexture( $rt, $image );
+    SDL_FreeSurface($image);    # the render thread works from its own copy
+    while ( !$done ) {
+        update_world();
+        SDL_RenderThreadSetDrawColor( $rt, 0, 0, 0, 255 );
+        SDL_RenderThreadClear($rt);
+        SDL_RenderThreadCopy( $rt, $ship, 0, 0, 0, 0, $x, $y, 64, 64 );
+        SDL_RenderThreadSubmit($rt);
+    }
+    SDL_DestroyRenderThread($rt);
+
+The command lists form a single producer/single consumer ring of two or three
+entries so no lock is held around frame data. When perl gets too far ahead,
+L<< C<SDL_RenderThreadSubmit( ... )>|/C<SDL_RenderThreadSubmit( ... )> >> waits
+for the render thread to hand a list back and counts a stall.
+
+The renderer is created on the render thread and never leaves it, so textures
+are referred to by the integer handles returned by L<<
+C<SDL_RenderThreadCreateTexture( ... )>|/C<SDL_RenderThreadCreateTexture( ...
+)> >> rather than L<SDL3::Texture> objects. Note that some platforms (macOS in
+particular) insist that rendering happens on the main thread; there, you should
+stick with a plain L<< C<SDL_CreateRenderer( ... )>|/C<SDL_CreateRenderer( ...
+)> >>.
+
+These functions may be imported by name or with the C<:renderthread> tag.
+
+=head2 C<SDL_CreateRenderThread( ... )>
+
+Start a render thread and create a renderer for a window on it.
+
+	my $rt = SDL_CreateRenderThread( $window, -1, SDL_RENDERER_ACCELERATED, 3 );
+
+Expected parameters include:
 
 =over
 
-=item C<SDL_TEXTUREMODULATE_NONE> - No modulation
+=item C<window> - the window where rendering is displayed
 
-=item C<SDL_TEXTUREMODULATE_COLOR> - C<srcC = srcC * color>
+=item C<index> - the index of the rendering driver to initialize, or C<-1> to initialize the first one supporting the requested flags
 
-=item C<SDL_TEXTUREMODULATE_ALPHA> - C<srcA = srcA * alpha>
+=item C<flags> - C<0>, or one or more L<< C<SDL_RendererFlags>|/C<SDL_RendererFlags> >> OR'd together
+
+=item C<depth> - the number of frames in the pipeline; C<2> (the default) or C<3>
 
 =back
 
-=head2 C<SDL_RendererFlip>
+Returns a new L<SDL3::RenderThread> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
 
-Flip constants for SDL_RenderCopyEx
+=head2 C<SDL_DestroyRenderThread( ... )>
+
+Stop the render thread and destroy its renderer and textures.
+
+	SDL_DestroyRenderThread( $rt );
+
+Frames that were submitted but not yet presented are dropped. Call L<<
+C<SDL_RenderThreadFinish( ... )>|/C<SDL_RenderThreadFinish( ... )> >> first if
+that matters.
+
+=head2 C<SDL_RenderThreadSubmit( ... )>
+
+Hand the frame recorded so far to the render thread and begin a new one.
+
+	SDL_RenderThreadSubmit( $rt );
+
+The render thread presents the frame once it has been replayed.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderThreadFinish( ... )>
+
+Wait until every submitted frame has been presented.
+
+	SDL_RenderThreadFinish( $rt );
+
+=head2 C<SDL_GetRenderThreadStats( ... )>
+
+Get pipeline statistics.
+
+	my $stats = SDL_GetRenderThreadStats( $rt );
+	printf "%d stalls (%.2f ms)\n", $stats->stalls, $stats->stall_ns / 1e6;
+
+Returns a L<SDL3::RenderThreadStats> structure with the following fields:
 
 =over
 
-=item C<SDL_FLIP_NONE> - Do not flip
+=item C<depth> - the number of frames in the pipeline
 
-=item C<SDL_FLIP_HORIZONTAL> - flip horizontally
+=item C<in_flight> - frames submitted but not yet presented
 
-=item C<SDL_FLIP_VERTICAL> - flip vertically
+=item C<submitted> - frames submitted so far
+
+=item C<presented> - frames presented so far
+
+=item C<stalls> - submits which had to wait for the render thread
+
+=item C<last_render_ns> - time spent replaying and presenting the most recent frame
+
+=item C<stall_ns> - total time spent waiting in stalled submits
+
+=item C<render_ns> - total time spent replaying and presenting frames
+
+=back
+
+=head2 C<SDL_RenderThreadCreateTexture( ... )>
+
+Queue the creation of a texture from a surface.
+
+	my $handle = SDL_RenderThreadCreateTexture( $rt, $surface );
+
+The surface is copied so it may be freed right away. The texture is created on
+the render thread before the current frame is drawn.
+
+Returns a positive texture handle on success or C<0> on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_RenderThreadDestroyTexture( ... )>
+
+Queue the destruction of a texture once the current frame has been drawn.
+
+	SDL_RenderThreadDestroyTexture( $rt, $handle );
+
+Returns C<0> on success or a negative error code on failure, including when
+the handle did not come from L<< C<SDL_RenderThreadCreateTexture( ...
+)>|/C<SDL_RenderThreadCreateTexture( ... )> >>.
+
+=head2 C<SDL_RenderThreadSetDrawColor( ... )>
+
+Record a draw color change in the current frame.
+
+	SDL_RenderThreadSetDrawColor( $rt, 255, 255, 255, 255 );
+
+=head2 C<SDL_RenderThreadSetDrawBlendMode( ... )>
+
+Record a blend mode change in the current frame.
+
+	SDL_RenderThreadSetDrawBlendMode( $rt, SDL_BLENDMODE_BLEND );
+
+=head2 C<SDL_RenderThreadClear( ... )>
+
+Record a clear in the current frame.
+
+	SDL_RenderThreadClear( $rt );
+
+=head2 C<SDL_RenderThreadFillRect( ... )>
+
+Record a filled rectangle in the current frame.
+
+	SDL_RenderThreadFillRect( $rt, 10, 10, 100, 100 );
+
+=head2 C<SDL_RenderThreadDrawRect( ... )>
+
+Record a rectangle outline in the current frame.
+
+	SDL_RenderThreadDrawRect( $rt, 10, 10, 100, 100 );
+
+=head2 C<SDL_RenderThreadDrawLine( ... )>
+
+Record a line in the current frame.
+
+	SDL_RenderThreadDrawLine( $rt, 0, 0, 100, 100 );
+
+=head2 C<SDL_RenderThreadCopy( ... )>
+
+Record a texture copy in the current frame.
+
+	SDL_RenderThreadCopy( $rt, $handle, 0, 0, 32, 32, $x, $y, 32, 32 );
+
+Parameters follow L<< C<SDL_RenderCopyXYWH( ... )>|/C<SDL_RenderCopyXYWH( ...
+)> >> with the texture handle in place of an L<SDL3::Texture>. Unknown handles
+are an error.
+
+All recording functions return C<0> on success or a negative error code on
+failure.
+
+=head1 Streaming Textures
+
+Writing procedural pixels with L<< C<SDL_UpdateTexture( ...
+)>|/C<SDL_UpdateTexture( ... )> >> every frame often stalls while the GPU is
+still drawing from the texture being overwritten. A streaming texture keeps two
+or three C<SDL_TEXTUREACCESS_STREAMING> textures and writes each update into the
+one that is not on screen. Pixels are copied natively from a packed scalar so
+there is no marshalling on the perl side.
+
+    my $st = SDL_CreateStreamingTexture( $renderer, SDL_PIXELFORMAT_ARGB8888, 320, 200 );
+    while (1) {
+        my $frame = pack 'L*', map { plasma($_) } 0 .. 320 * 200 - 1;
+        SDL_UpdateStreamingTexture( $st, undef, \$frame, 320 * 4 );
+        SDL_RenderCopy( $renderer, SDL_GetStreamingTexture($st), undef, undef );
+        SDL_RenderPresent($renderer);
+    }
+
+Partial updates only copy the area that changed into the next texture (plus
+whatever changed since that texture was last written) so every texture in the
+rotation stays complete.
+
+These functions may be imported by name or with the C<:streaming> tag.
+
+=head2 C<SDL_CreateStreamingTexture( ... )>
+
+Create a set of streaming textures.
+
+	my $st = SDL_CreateStreamingTexture( $renderer, SDL_PIXELFORMAT_ABGR8888, 256, 256, 3 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the rendering context
+
+=item C<format> - one of the packed (non-planar) values from L<SDL3::pixels/SDL_PixelFormatEnum>
+
+=item C<w> - the width of the texture in pixels
+
+=item C<h> - the height of the texture in pixels
+
+=item C<count> - the number of textures to rotate through; C<2> (the default) or C<3>, or C<1> to simply avoid perl side copies
+
+=back
+
+Returns a new L<SDL3::StreamingTexture> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DestroyStreamingTexture( ... )>
+
+Destroy the textures and the system memory copy of the frame.
+
+	SDL_DestroyStreamingTexture( $st );
+
+=head2 C<SDL_UpdateStreamingTexture( ... )>
+
+Copy pixels into the next texture in the rotation.
+
+	SDL_UpdateStreamingTexture( $st, undef, \$pixels, $pitch );        # the whole texture
+	SDL_UpdateStreamingTexture( $st, [ 8, 8, 16, 16 ], \$patch, 64 );  # just a part of it
+	SDL_UpdateStreamingTexture( $st, undef, $surface->pixels, $surface->pitch ); # native memory
+
+Expected parameters include:
+
+=over
+
+=item C<st> - the streaming texture to update
+
+=item C<rect> - an L<SDL3::Rect>, array or hash reference describing the area to update, or undef to update the entire texture; it must lie inside the texture
+
+=item C<pixels> - a reference to a scalar containing packed pixel data or a pointer to native memory
+
+=item C<pitch> - the number of bytes in a row of pixel data, including padding between lines; defaults to a tightly packed row
+
+=back
+
+The length of a packed scalar is checked against C<rect> and C<pitch> before
+anything is copied, so an empty or undefined scalar is an error. A C<pitch>
+shorter than a row of C<rect> is an error too.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetStreamingTexture( ... )>
+
+Get the texture holding the most recent update.
+
+	SDL_RenderCopy( $renderer, SDL_GetStreamingTexture($st), undef, undef );
+
+The returned texture belongs to the streaming texture; do not destroy it or
+hold on to it across updates.
+
+=head1 Indexed Textures
+
+Retro-style content drawn into an 8-bit C<SDL_PIXELFORMAT_INDEX8> surface can be
+shown by expanding its indices through the palette straight into a texture.
+Combined with a L<palette cycler|SDL3::pixels/Palette Cycling>, animating the
+colors of a full screen image costs a palette update and one native expansion
+per frame rather than redrawing every pixel from perl.
+
+    my $screen  = SDL_CreateRGBSurfaceWithFormat( 0, 320, 200, 8, SDL_PIXELFORMAT_INDEX8 );
+    my $texture = SDL_CreateTexture( $renderer, SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING, 320, 200 );
+    my $cycler  = SDL_CreatePaletteCycler( $screen->format->palette );
+    SDL_AddPaletteCycle( $cycler, 32, 16, 8 );    # colors 32..47, 8 steps a second
+    while (1) {
+        SDL_UpdateTextureIndexed( $texture, undef, $screen ) if SDL_UpdatePaletteCycler($cycler);
+        SDL_RenderCopy( $renderer, $texture, undef, undef );
+        SDL_RenderPresent($renderer);
+    }
+
+The expansion uses AVX2 gathers where the CPU has them (see
+L<SDL3::surface/Pixel Kernels>).
+
+This function may be imported by name or with the C<:indexed> tag.
+
+=head2 C<SDL_UpdateTextureIndexed( ... )>
+
+Expand part of an indexed surface through its palette into the same part of a
+texture.
+
+	SDL_UpdateTextureIndexed( $texture, [ 0, 0, 320, 8 ], $screen );    # just the status bar
+
+Expected parameters include:
+
+=over
+
+=item C<texture> - an L<SDL3::Texture> with 32-bit pixels; C<SDL_TEXTUREACCESS_STREAMING> textures are written in place, others through L<< C<SDL_UpdateTexture( ... )>|/C<SDL_UpdateTexture( ... )> >>
+
+=item C<rect> - an L<SDL3::Rect>, array or hash reference describing the area to update, or undef for the whole surface; it must lie inside both the surface and the texture
+
+=item C<surface> - an L<SDL3::Surface> with 8-bit indexed pixels
+
+=back
+
+Indices past the end of the palette come out opaque black.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head1 Readback
+
+Capturing frames for thumbnails or regression checks with L<<
+C<SDL_RenderReadPixels( ... )>|/C<SDL_RenderReadPixels( ... )> >> means
+allocating a buffer every time, copying it into perl, and, often, encoding an
+image on the main thread. A readback pool reuses a few native buffers, exposes
+them to perl without a copy, and writes PNGs with C<IMG_SavePNG_RW( ... )> on a
+worker thread.
+
+    my $rb = SDL_CreateReadback( $renderer, SDL_PIXELFORMAT_ABGR8888, 3 );
+    my @pending;
+    while ( $frame++ < 1000 ) {
+        render_frame();
+        push @pending, SDL_ReadbackCapture( $rb, undef, sprintf 'frame%04d.png', $frame )
+            if $frame % 100 == 0;
+        SDL_RenderPresent($renderer);
+        SDL_ReadbackRelease( $rb, shift @pending )
+            while @pending && SDL_ReadbackPoll( $rb, $pending[0] );
+    }
+    SDL_DestroyReadback($rb);
+
+SDL2 offers no asynchronous GPU readback so the read itself still happens when
+L<< C<SDL_ReadbackCapture( ... )>|/C<SDL_ReadbackCapture( ... )> >> is called;
+everything after it (encoding and disk I/O) does not hold up the frame.
+
+These functions may be imported by name or with the C<:readback> tag.
+
+=head2 C<SDL_CreateReadback( ... )>
+
+Create a pool of readback buffers and its worker thread.
+
+	my $rb = SDL_CreateReadback( $renderer, SDL_PIXELFORMAT_ARGB8888, 2 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the rendering context to read from
+
+=item C<format> - the desired format of the pixel data; one of the packed values from L<SDL3::pixels/SDL_PixelFormatEnum>
+
+=item C<count> - the number of buffers in the pool; C<2> by default and at most C<8>
+
+=back
+
+Returns a new L<SDL3::Readback> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DestroyReadback( ... )>
+
+Wait for pending PNGs to be written, stop the worker, and free every buffer.
+
+	SDL_DestroyReadback( $rb );
+
+=head2 C<SDL_ReadbackCapture( ... )>
+
+Read pixels from the current rendering target into a free buffer.
+
+	my $handle = SDL_ReadbackCapture( $rb );                          # whole target
+	my $thumb  = SDL_ReadbackCapture( $rb, [ 0, 0, 160, 120 ], 'thumb.png' );
+
+If every buffer is busy encoding, this waits for one to finish.
+
+Expected parameters include:
+
+=over
+
+=item C<rb> - the readback pool
+
+=item C<rect> - an L<SDL3::Rect>, array or hash reference describing the area to read, or undef for the entire rendering target
+
+=item C<png> - optional path to write the pixels to as a PNG on the worker thread
+
+=back
+
+Returns a positive handle on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_ReadbackPoll( ... )>
+
+Check whether a capture is complete.
+
+	if ( SDL_ReadbackPoll( $rb, $handle ) ) { ... }
+
+A capture without a PNG path is complete immediately.
+
+Returns C<1> if complete, C<0> if the worker is still busy with it, or a
+negative error code if the handle is invalid or encoding failed; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_ReadbackWait( ... )>
+
+Like L<< C<SDL_ReadbackPoll( ... )>|/C<SDL_ReadbackPoll( ... )> >> but blocks
+until the capture is complete.
+
+	SDL_ReadbackWait( $rb, $handle );
+
+=head2 C<SDL_GetReadbackPixels( ... )>
+
+Get the pixels of a capture.
+
+	my ( $pixels, $w, $h, $pitch ) = SDL_GetReadbackPixels( $rb, $handle );
+	my $digest = Digest::MD5::md5_hex($pixels);
+
+The returned scalar is a read-only window into the pooled buffer; no copy is
+made. It must not be used after the handle is released.
+
+Returns the pixels in scalar context and the pixels, width, height, and pitch
+in list context. Returns undef if the handle is invalid.
+
+=head2 C<SDL_ReadbackRelease( ... )>
+
+Return a capture's buffer to the pool.
+
+	SDL_ReadbackRelease( $rb, $handle );
+
+If the capture is still being encoded, this waits for it to finish.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head1 Frame Capture
+
+A capture sink records everything a renderer presents without touching the
+render loop. While a sink is attached, C<SDL_RenderPresent( ... )> first reads
+the finished frame into one of a few pooled buffers; a background thread then
+converts and writes it so the loop never waits on the disk.
+
+    my $sink = SDL_CreateCaptureSink( $renderer, SDL_CAPTURE_Y4M, 'run.y4m', 60 );
+    while ( $running ) {
+        ...;
+        SDL_RenderPresent($renderer);    # Frame is captured here
+    }
+    SDL_DestroyCaptureSink($sink);       # Flushes everything still queued
+
+Two formats are supported: a YUV4MPEG2 stream (4:2:0, converted with
+C<SDL_ConvertPixels( ... )>) which tools like C<ffmpeg> read directly, and a
+sequence of numbered PNG files. If the encoder falls behind and every buffer is
+queued, the next capture waits for one to free up; this backpressure shows up
+in the C<stalls> counter rather than as dropped frames.
+
+Works with any renderer, including the software renderer of a hidden window,
+which makes it handy for recording in CI or on headless machines.
+
+These functions may be imported by name or with the C<:capture> tag.
+
+=head2 C<SDL_CreateCaptureSink( ... )>
+
+Attach a capture sink to a renderer and start its encoder thread.
+
+	my $sink = SDL_CreateCaptureSink( $renderer, SDL_CAPTURE_PNG, 'shots/frame%05d.png' );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to record
+
+=item C<format> - C<SDL_CAPTURE_Y4M> or C<SDL_CAPTURE_PNG>
+
+=item C<path> - the Y4M file to write or, for PNG, a filename pattern with exactly one C<%d> style conversion for the frame number
+
+=item C<fps> - frame rate written to the Y4M header; defaults to C<60>
+
+=item C<depth> - number of frame buffers and so how far the encoder may fall behind; defaults to C<3>
+
+=back
+
+A Y4M stream takes its size from the first frame, rounded down to even
+dimensions; later frames are cropped to it and frames that are smaller are
+counted as failed.
+
+Returns a new L<SDL3::CaptureSink> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DestroyCaptureSink( ... )>
+
+Detach a capture sink, wait for queued frames to be written, and free it.
+
+	SDL_DestroyCaptureSink( $sink );
+
+=head2 C<SDL_CaptureSinkGrab( ... )>
+
+Capture the renderer's current frame now.
+
+	SDL_CaptureSinkGrab( $sink );
+
+This is what C<SDL_RenderPresent( ... )> does for every attached sink. Call it
+directly to record frames that are never presented.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_CaptureRenderer( ... )>
+
+Capture the current frame into every sink attached to a renderer.
+
+	SDL_CaptureRenderer( $renderer );
+
+Returns C<0> on success or a negative error code if any sink failed.
+
+=head2 C<SDL_GetCaptureSinkStats( ... )>
+
+Get a capture sink's counters.
+
+	my $stats = SDL_GetCaptureSinkStats( $sink );
+	printf "%d/%d written, %d stalls\n", $stats->written, $stats->captured, $stats->stalls;
+
+Returns a L<SDL3::CaptureStats> structure with the following fields:
+
+=over
+
+=item C<captured> - frames read back from the renderer
+
+=item C<written> - frames written out
+
+=item C<failed> - frames that could not be converted or written
+
+=item C<stalls> - captures that had to wait for the encoder
+
+=item C<stall_ns> - total nanoseconds spent waiting in those captures
+
+=back
+
+=head1 Tile Renderer
+
+SDL's software renderer rasterizes on a single core. The tile renderer is a
+separate software backend that draws into any 32-bit L<SDL3::Surface> with
+8-bit channels. It splits the surface into square tiles and rasterizes them on
+a pool of native threads, sized from C<SDL_GetCPUCount( )> unless told
+otherwise.
+
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, 1920, 1080, 32, SDL_PIXELFORMAT_ARGB8888 );
+    my $tr      = SDL_CreateTileRenderer($surface);
+    my $ship    = SDL_TileRendererCreateTexture( $tr, IMG_Load('ship.png') );
+    SDL_TileRendererSetDrawColor( $tr, 0, 0, 0, 255 );
+    SDL_TileRendererClear($tr);
+    SDL_TileRendererCopy( $tr, $ship, 0, 0, 0, 0, $x, $y, 64, 64 );
+    SDL_TileRendererPresent($tr);    # $surface now holds the frame
+    SDL_DestroyTileRenderer($tr);
+
+Draw calls are recorded like they are for a L<render thread|/Render Thread>.
+On present, the recorded state changes are folded into each draw call. A clear
+throws away everything recorded before it. Each call is then binned into the
+tiles it touches, and the workers draw whole tiles. Every pixel sees the same
+draw calls in the same order, computed with the same integer math, so the
+result is bit-identical to the single-threaded path (C<threads> set to C<1>)
+for any thread count and tile size.
+
+Fills, outlines, and lines use the current draw color and blend mode. Copies
+use the blend mode the source surface had when it was turned into a texture.
+They are clipped and sampled the way C<SDL_BlitScaled( ... )> does it, so a
+copy that doesn't blend gives the same pixels, even where it crosses the edge
+of the target or of the source. Color and alpha modulation and color keys are not
+applied. The surface must stay alive for as long as the tile renderer does.
+
+See F<eg/tile_render_bench.pl> for a scaling benchmark across 1..N threads.
+
+These functions may be imported by name or with the C<:tile> tag.
+
+=head2 C<SDL_CreateTileRenderer( ... )>
+
+Create a tile renderer for a surface and start its workers.
+
+	my $tr = SDL_CreateTileRenderer( $surface, 4, 128 );
+
+Expected parameters include:
+
+=over
+
+=item C<surface> - the 32-bit surface to draw into
+
+=item C<threads> - the number of threads including the caller's; C<0> (the default) uses one per CPU
+
+=item C<tile_size> - width and height of a tile in pixels; defaults to C<64>, minimum C<16>
+
+=back
+
+Returns a new L<SDL3::TileRenderer> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DestroyTileRenderer( ... )>
+
+Stop the workers and free the tile renderer and its textures.
+
+	SDL_DestroyTileRenderer( $tr );
+
+=head2 C<SDL_GetTileRendererThreads( ... )>
+
+Get the number of threads drawing tiles, including the caller's.
+
+	my $threads = SDL_GetTileRendererThreads( $tr );
+
+=head2 C<SDL_TileRendererCreateTexture( ... )>
+
+Create a texture from a surface.
+
+	my $handle = SDL_TileRendererCreateTexture( $tr, $surface );
+
+The surface is converted to C<SDL_PIXELFORMAT_ARGB8888> so it may be freed
+right away.
+
+Returns a positive texture handle on success or C<0> on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_TileRendererDestroyTexture( ... )>
+
+Destroy a texture.
+
+	SDL_TileRendererDestroyTexture( $tr, $handle );
+
+Copies already recorded against it are skipped.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_TileRendererSetDrawColor( ... )>
+
+Record a draw color change.
+
+	SDL_TileRendererSetDrawColor( $tr, 255, 255, 255, 255 );
+
+=head2 C<SDL_TileRendererSetDrawBlendMode( ... )>
+
+Record a blend mode change.
+
+	SDL_TileRendererSetDrawBlendMode( $tr, SDL_BLENDMODE_BLEND );
+
+=head2 C<SDL_TileRendererClear( ... )>
+
+Record a clear.
+
+	SDL_TileRendererClear( $tr );
+
+=head2 C<SDL_TileRendererFillRect( ... )>
+
+Record a filled rectangle.
+
+	SDL_TileRendererFillRect( $tr, 10, 10, 100, 100 );
+
+=head2 C<SDL_TileRendererDrawRect( ... )>
+
+Record a rectangle outline.
+
+	SDL_TileRendererDrawRect( $tr, 10, 10, 100, 100 );
+
+=head2 C<SDL_TileRendererDrawLine( ... )>
+
+Record a line.
+
+	SDL_TileRendererDrawLine( $tr, 0, 0, 100, 100 );
+
+=head2 C<SDL_TileRendererCopy( ... )>
+
+Record a texture copy.
+
+	SDL_TileRendererCopy( $tr, $handle, 0, 0, 32, 32, $x, $y, 32, 32 );
+
+Parameters follow L<< C<SDL_RenderCopyXYWH( ... )>|/C<SDL_RenderCopyXYWH( ...
+)> >> with the texture handle in place of an L<SDL3::Texture>.
+
+All recording functions return C<0> on success or a negative error code on
+failure.
+
+=head2 C<SDL_TileRendererPresent( ... )>
+
+Draw everything recorded so far into the surface and start over.
+
+	SDL_TileRendererPresent( $tr );
+
+Returns once every tile has been drawn.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head1 Virtual Textures
+
+A texture can be no larger than the renderer's C<max_texture_width> and
+C<max_texture_height>, and decoding a huge image all at once can use up
+memory. A virtual texture cuts the image into square tiles. Only the tiles
+inside the area being drawn are uploaded as textures. Once more than
+C<max_resident> tiles are resident, the least recently drawn are evicted.
+
+    # Once, offline: decode the big image and write its tiles to disk
+    SDL_BakeVirtualTexture( IMG_Load('world.png'), 'world.vtex', 512 );
+
+    # At runtime the tiles are streamed from the baked file as they come into view
+    my $world = SDL_CreateVirtualTexture( $renderer, 'world.vtex' );
+    while ( !$done ) {
+        SDL_RenderVirtualTexture( $world, [ $cam_x, $cam_y, 1280, 720 ], [ 0, 0, 1280, 720 ] );
+        SDL_RenderPresent($renderer);
+    }
+    SDL_DestroyVirtualTexture($world);
+
+Tiles are ARGB8888 textures with C<SDL_BLENDMODE_BLEND>. Tiles are sampled
+independently, so with linear filtering (see C<SDL_HINT_RENDER_SCALE_QUALITY>)
+faint seams can appear between them when drawing scaled.
+
+These functions may be imported by name or with the C<:virtual> tag.
+
+=head2 C<SDL_CreateVirtualTexture( ... )>
+
+Create a virtual texture from a baked tile file or any image C<IMG_Load( ...
+)> understands.
+
+	my $vt = SDL_CreateVirtualTexture( $renderer, 'world.vtex' );
+
+A baked file stays open and tiles are read from it on demand. Any other image
+is decoded once and its tiles are kept in system memory.
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to draw with
+
+=item C<path> - a file written by L<< C<SDL_BakeVirtualTexture( ... )>|/C<SDL_BakeVirtualTexture( ... )> >> or an image
+
+=item C<tile_size> - tile width and height in pixels; C<0> (the default) picks 512 or whatever a baked file was made with
+
+=item C<max_resident> - how many tiles may be held as textures; defaults to C<64>
+
+=back
+
+Returns a new L<SDL3::VirtualTexture> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_CreateVirtualTextureFromSurface( ... )>
+
+Create a virtual texture by cutting up a surface.
+
+	my $vt = SDL_CreateVirtualTextureFromSurface( $renderer, $surface, 256 );
+
+The tiles are copied, so the surface may be freed right away. Parameters
+otherwise match L<< C<SDL_CreateVirtualTexture( ... )>|/C<SDL_CreateVirtualTexture( ... )> >>.
+
+Returns a new L<SDL3::VirtualTexture> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_BakeVirtualTexture( ... )>
+
+Write a surface to a tile file.
+
+	SDL_BakeVirtualTexture( $surface, 'world.vtex', 512 );
+
+Tiles are stored uncompressed and edge tiles are padded so any tile can be
+read with a single seek.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DestroyVirtualTexture( ... )>
+
+Destroy a virtual texture and all of its tile textures.
+
+	SDL_DestroyVirtualTexture( $vt );
+
+=head2 C<SDL_GetVirtualTextureSize( ... )>
+
+Get the size of the whole image.
+
+	my ( $w, $h ) = SDL_GetVirtualTextureSize( $vt );
+
+=head2 C<SDL_RenderVirtualTexture( ... )>
+
+Draw part of the image.
+
+	SDL_RenderVirtualTexture( $vt, [ $x, $y, 800, 600 ], [ 0, 0, 800, 600 ] );
+	SDL_RenderVirtualTexture( $vt, [ $x, $y, 1600, 1200 ], [ 0, 0, 800, 600 ] );   # zoomed out
+
+Expected parameters include:
+
+=over
+
+=item C<view> - the area of the image to draw; undef for the whole image
+
+=item C<dst> - where to draw it; undef or a zero width or height draws it unscaled at C<x>, C<y>
+
+=back
+
+Rects may be L<SDL3::Rect> objects, array refs, or hash refs. Tiles are
+uploaded as needed, and each visible tile is drawn with a single copy.
+
+Returns C<0> on success or a negative error code if any tile failed to load
+or draw; call C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetVirtualTextureStats( ... )>
+
+Get residency counters.
+
+	my $stats = SDL_GetVirtualTextureStats( $vt );
+
+Returns a L<SDL3::VirtualTextureStats> structure with the following fields:
+
+=over
+
+=item C<resident> - tiles currently held as textures
+
+=item C<drawn> - tiles drawn by the last C<SDL_RenderVirtualTexture( ... )>
+
+=item C<uploads> - tiles turned into textures so far
+
+=item C<evictions> - textures destroyed to stay within budget
+
+=item C<upload_ns> - total nanoseconds spent reading and uploading tiles
+
+=back
+
+=head1 Texture Manager
+
+Textures made with C<SDL_CreateTextureFromSurface( ... )> or C<IMG_LoadTexture(
+... )> stay in video memory until they are destroyed by hand. A texture
+manager owns its textures and keeps their estimated size under a budget. The
+size is worked out from the format and dimensions reported by
+L<< C<SDL_QueryTexture( ... )>|/C<SDL_QueryTexture( ... )> >>. When loading a
+texture would go over the budget, the textures drawn least recently are
+destroyed. Each remembers the file or surface it came from and is reloaded the
+next time it is drawn.
+
+    my $tm     = SDL_CreateTextureManager( $renderer, 128 * 1024 * 1024 );
+    my %sprite = map { $_ => SDL_TextureManagerAddFile( $tm, "gfx/$_.png" ) } @names;
+    ...;
+    SDL_TextureManagerCopy( $tm, $sprite{hero}, undef, [ $x, $y, 64, 64 ] );
+    ...;
+    my $stats = SDL_GetTextureManagerStats($tm);
+    printf "%.1f%% hits, %d evictions\n", 100 * $stats->hits / ( $stats->hits + $stats->misses ),
+        $stats->evictions;
+
+Adding an entry loads nothing. The first draw counts as a miss and loads the
+texture. A texture in use always stays resident even if it alone is over
+budget.
+
+These functions may be imported by name or with the C<:texturemanager> tag.
+
+=head2 C<SDL_CreateTextureManager( ... )>
+
+Create a texture manager.
+
+	my $tm = SDL_CreateTextureManager( $renderer, 64 * 1024 * 1024 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer textures are created for and drawn with
+
+=item C<budget> - estimated bytes of texture memory to stay under; defaults to 256 MiB, C<0> means no limit
+
+=back
+
+Returns a new L<SDL3::TextureManager> on success or undef on failure.
+
+=head2 C<SDL_DestroyTextureManager( ... )>
+
+Destroy a texture manager, its textures, and its copies of surfaces.
+
+	SDL_DestroyTextureManager( $tm );
+
+=head2 C<SDL_TextureManagerAddFile( ... )>
+
+Add a texture that is loaded from a file with C<IMG_LoadTexture( ... )>.
+
+	my $handle = SDL_TextureManagerAddFile( $tm, 'hero.png' );
+
+Returns a positive handle on success or C<0> on failure.
+
+=head2 C<SDL_TextureManagerAddSurface( ... )>
+
+Add a texture that is created from a surface.
+
+	my $handle = SDL_TextureManagerAddSurface( $tm, $surface );
+
+The surface is copied, so it may be freed right away; the copy stays in system
+memory for reloads.
+
+Returns a positive handle on success or C<0> on failure; call C<SDL_GetError(
+)> for more information.
+
+=head2 C<SDL_TextureManagerRemove( ... )>
+
+Forget a texture and destroy it if it is loaded.
+
+	SDL_TextureManagerRemove( $tm, $handle );
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_TextureManagerGet( ... )>
+
+Get the texture for a handle, loading it if needed. This counts as a use.
+
+	my $texture = SDL_TextureManagerGet( $tm, $handle );
+
+The texture may be destroyed by any later call that loads a texture, so use it
+right away and do not keep it.
+
+Returns an L<SDL3::Texture> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_TextureManagerCopy( ... )>
+
+Draw a managed texture, loading it if needed.
+
+	SDL_TextureManagerCopy( $tm, $handle, [ 0, 0, 32, 32 ], [ $x, $y, 64, 64 ] );
+
+Expected parameters include:
+
+=over
+
+=item C<handle> - the texture to draw
+
+=item C<srcrect> - the source rectangle or undef for the whole texture
+
+=item C<dstrect> - the destination rectangle or undef for the whole target
+
+=back
+
+Rects may be L<SDL3::Rect> objects, array refs, or hash refs.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_TextureManagerSetBudget( ... )>
+
+Change the budget, evicting right away if the resident textures no longer fit.
+
+	SDL_TextureManagerSetBudget( $tm, 32 * 1024 * 1024 );
+
+=head2 C<SDL_GetTextureManagerStats( ... )>
+
+Get a texture manager's counters.
+
+	my $stats = SDL_GetTextureManagerStats( $tm );
+
+Returns a L<SDL3::TextureManagerStats> structure with the following fields:
+
+=over
+
+=item C<hits> - draws of a resident texture
+
+=item C<misses> - draws that had to load the texture first
+
+=item C<evictions> - textures destroyed to stay within budget
+
+=item C<failures> - loads that failed
+
+=item C<resident> - textures currently loaded
+
+=item C<entries> - textures known to the manager
+
+=item C<bytes> - estimated size of the resident textures
+
+=item C<budget> - the current budget
+
+=item C<load_ns> - total nanoseconds spent loading
+
+=item C<last_load_ns> - nanoseconds spent on the most recent load
+
+=item C<max_load_ns> - nanoseconds spent on the slowest load so far
+
+=back
+
+=head1 Sprite Atlases
+
+Drawing many small textures means a texture switch, and often a separate batch,
+for every sprite. An atlas packs many small surfaces onto a few large pages so
+that sprites drawn together usually come from the same texture.
+
+    my $atlas = SDL_CreateAtlas( 1024, 1024 );
+    SDL_AtlasAdd( $atlas, IMG_Load("gfx/$_.png"), $_ ) for @names;
+    SDL_AtlasPack($atlas);
+    SDL_AtlasUpload( $atlas, $renderer );
+    my $hero = SDL_GetAtlasHandle( $atlas, 'hero' );
+    ...;
+    SDL_AtlasCopy( $atlas, $hero, [ $x, $y, 0, 0 ] );
+
+Sprites are placed tallest first with a bottom-left skyline packer. A new page
+is started only when a sprite fits nowhere else. Around every sprite the packer
+repeats its outermost pixels C<extrude> pixels outwards and then leaves
+C<padding> pixels empty, so linear filtering and subpixel positions do not pull
+in colors from a neighbour.
+
+Packing a large set takes a while, so a packed atlas can be saved with
+C<SDL_SaveAtlas( ... )> and loaded at startup with C<SDL_LoadAtlas( ... )>.
+
+These functions may be imported by name or with the C<:atlas> tag.
+
+=head2 C<SDL_CreateAtlas( ... )>
+
+Create an empty atlas.
+
+	my $atlas = SDL_CreateAtlas( 2048, 2048, 1, 1 );
+
+Expected parameters include:
+
+=over
+
+=item C<w> - the width of each page; defaults to C<2048>
+
+=item C<h> - the height of each page; defaults to C<2048>
+
+=item C<padding> - empty pixels between sprites; defaults to C<1>
+
+=item C<extrude> - pixels of repeated edge around each sprite; defaults to C<1>
+
+=back
+
+Keep pages within the renderer's C<max_texture_width> and
+C<max_texture_height>.
+
+Returns a new L<SDL3::Atlas> on success or undef on failure.
+
+=head2 C<SDL_DestroyAtlas( ... )>
+
+Destroy an atlas, its pages, and its textures.
+
+	SDL_DestroyAtlas( $atlas );
+
+=head2 C<SDL_AtlasAdd( ... )>
+
+Add a sprite to be placed by the next C<SDL_AtlasPack( ... )>.
+
+	my $handle = SDL_AtlasAdd( $atlas, $surface, 'hero' );
+
+Expected parameters include:
+
+=over
+
+=item C<atlas> - the atlas
+
+=item C<surface> - the sprite; it is copied, so it may be freed right away
+
+=item C<name> - an optional name for C<SDL_GetAtlasHandle( ... )>
+
+=back
+
+Returns a positive handle on success or C<0> on failure, for example when the
+sprite is larger than a page; call C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_AtlasPack( ... )>
+
+Place every sprite added since the last pack.
+
+	my $pages = SDL_AtlasPack( $atlas );
+
+Sprites that were already placed keep their place. Pages that change have to
+be uploaded again.
+
+Returns the number of pages on success or a negative error code on failure.
+
+=head2 C<SDL_AtlasUpload( ... )>
+
+Create a texture for every page.
+
+	SDL_AtlasUpload( $atlas, $renderer );
+
+Sprites are drawn with this renderer from now on.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_GetAtlasHandle( ... )>
+
+Look up a sprite by name.
+
+	my $handle = SDL_GetAtlasHandle( $atlas, 'hero' );
+
+Returns the handle or C<0> if no sprite has that name.
+
+=head2 C<SDL_GetAtlasRegion( ... )>
+
+Find where a sprite was placed.
+
+	my ( $texture, $x, $y, $w, $h, $page ) = SDL_GetAtlasRegion( $atlas, $handle );
+
+This is what to use to draw sprites with C<SDL_RenderCopy( ... )> or
+C<SDL_RenderGeometry( ... )> yourself.
+
+Returns the page texture (undef until uploaded), the sprite's rectangle on the
+page, and the page number. Returns an empty list if the handle is invalid or
+the sprite has not been packed yet.
+
+=head2 C<SDL_AtlasCopy( ... )>
+
+Draw a sprite.
+
+	SDL_AtlasCopy( $atlas, $handle, [ $x, $y, 64, 64 ] );
+
+Expected parameters include:
+
+=over
+
+=item C<atlas> - the atlas
+
+=item C<handle> - the sprite to draw
+
+=item C<dstrect> - where to draw it; a width or height of C<0> uses the sprite's own
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetAtlasNumPages( ... )>
+
+Get the number of pages.
+
+	my $pages = SDL_GetAtlasNumPages( $atlas );
+
+=head2 C<SDL_GetAtlasPage( ... )>
+
+Get a page's pixels.
+
+	SDL_SaveBMP( SDL_GetAtlasPage( $atlas, 0 ), 'page0.bmp' );
+
+The surface belongs to the atlas; do not free it.
+
+Returns an L<SDL3::Surface> on success or undef on failure.
+
+=head2 C<SDL_SaveAtlas( ... )>
+
+Save a packed atlas.
+
+	SDL_SaveAtlas( $atlas, 'sprites.atlas' );
+
+The layout is written to C<path> as text and each page to C<path.N.png>.
+Sprites that have not been packed are saved without a place and cannot be
+drawn after loading. Names may be any length but must not contain a line
+break.
+
+Returns C<0> on success or a negative error code on failure, including when
+the layout could not be written in full.
+
+=head2 C<SDL_LoadAtlas( ... )>
+
+Load an atlas saved with C<SDL_SaveAtlas( ... )>.
+
+	my $atlas = SDL_LoadAtlas( 'sprites.atlas' );
+	SDL_AtlasUpload( $atlas, $renderer );
+
+Handles and names are the same as when it was saved. Sprites added later are
+packed onto new pages.
+
+Returns a new L<SDL3::Atlas> on success or undef on failure.
+
+=head1 Tilemaps
+
+Drawing a tile layer from Perl means a loop over every tile and a call to
+C<SDL_RenderCopy( ... )> for each, visible or not. A tilemap holds the layer
+as a packed grid of tile ids and draws it through a camera: only the tiles the
+camera can see are visited, and they are sent to the renderer as a single
+C<SDL_RenderGeometry( ... )> batch. If SDL is older than 2.0.18 or the renderer
+refuses geometry, the tiles are drawn with C<SDL_RenderCopyF( ... )> instead.
+
+    my $map = SDL_CreateTilemap( $renderer, $tileset, 16, 16, 512, 512 );
+    SDL_SetTilemapTiles( $map, \$level_data );
+    SDL_SetTilemapAnimation( $map, 17, [ 17, 18, 19, 18 ], 150 );    # Water
+    SDL_SetTilemapChunkSize( $map, 32 );
+    while ($running) {
+        SDL_UpdateTilemap( $map, $elapsed_ms );
+        SDL_RenderTilemap( $map, [ $cam_x, $cam_y, 640, 360 ] );
+        ...;
+    }
+
+Tile id C<0> is empty. Id C<n> is the nth tile of the tileset, counting from
+C<1> left to right and then top to bottom.
+
+Large layers that change rarely can be cached in chunks. Each square of tiles
+is drawn once into a target texture and then copied from there, so a frame
+costs one copy per visible chunk. A chunk is redrawn when one of its tiles is
+set and, if it holds animated tiles, when an animation moves to a new frame.
+
+These functions may be imported by name or with the C<:tilemap> tag.
+
+=head2 C<SDL_CreateTilemap( ... )>
+
+Create an empty tilemap.
+
+	my $map = SDL_CreateTilemap( $renderer, $tileset, 16, 16, 256, 128 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to draw with
+
+=item C<tileset> - the L<SDL3::Texture> holding the tiles in a grid; it is not copied, so keep it alive
+
+=item C<tile_w> - the width of a tile in pixels
+
+=item C<tile_h> - the height of a tile in pixels
+
+=item C<cols> - the width of the map in tiles
+
+=item C<rows> - the height of the map in tiles
+
+=back
+
+Returns a new L<SDL3::Tilemap> on success or undef on failure.
+
+=head2 C<SDL_DestroyTilemap( ... )>
+
+Destroy a tilemap and its chunk textures. The tileset is not destroyed.
+
+	SDL_DestroyTilemap( $map );
+
+=head2 C<SDL_SetTilemapTiles( ... )>
+
+Set a block of tiles at once.
+
+	SDL_SetTilemapTiles( $map, [ 1, 1, 2, 3 ], [ 10, 4, 2, 2 ] );
+	SDL_SetTilemapTiles( $map, \pack 'S*', @ids );
+
+Expected parameters include:
+
+=over
+
+=item C<map> - the tilemap
+
+=item C<tiles> - an array ref of tile ids, or a reference to a string of packed native 16-bit ids (C<pack 'S*'>), row by row
+
+=item C<rect> - the block in tiles; undef for the whole map
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_SetTilemapTile( ... )>
+
+Set one tile.
+
+	SDL_SetTilemapTile( $map, $x, $y, 42 );
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_GetTilemapTile( ... )>
+
+Get one tile.
+
+	my $id = SDL_GetTilemapTile( $map, $x, $y );
+
+Returns the tile id or a negative error code if the tile is outside the map.
+
+=head2 C<SDL_SetTilemapAnimation( ... )>
+
+Animate every tile with the given id.
+
+	SDL_SetTilemapAnimation( $map, 17, [ 17, 18, 19 ], 150 );
+
+Expected parameters include:
+
+=over
+
+=item C<map> - the tilemap
+
+=item C<tile> - the tile id to animate
+
+=item C<frames> - an array ref of the tile ids to show in turn; an empty list or undef stops the animation
+
+=item C<frame_ms> - milliseconds each frame is shown; defaults to C<100>
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_UpdateTilemap( ... )>
+
+Advance the tilemap's animation clock.
+
+	SDL_UpdateTilemap( $map, $elapsed_ms );
+
+=head2 C<SDL_SetTilemapChunkSize( ... )>
+
+Cache the map in square chunks of target textures.
+
+	SDL_SetTilemapChunkSize( $map, 32 );
+
+Expected parameters include:
+
+=over
+
+=item C<map> - the tilemap
+
+=item C<tiles> - the width and height of a chunk in tiles; C<0> turns caching off and frees the chunks
+
+=back
+
+Chunks are created as they come into view and stay until caching is turned
+off. Keep C<tiles * tile_w> and C<tiles * tile_h> within the renderer's maximum
+texture size.
+
+Returns C<0> on success or a negative error code on failure, for example if
+the renderer does not support target textures.
+
+=head2 C<SDL_InvalidateTilemap( ... )>
+
+Mark every chunk for redrawing.
+
+	SDL_InvalidateTilemap( $map );
+
+Call this on C<SDL_RENDER_TARGETS_RESET> and C<SDL_RENDER_DEVICE_RESET> events,
+when the contents of target textures are lost, and after drawing into the
+tileset texture.
+
+=head2 C<SDL_RenderTilemap( ... )>
+
+Draw the part of the map the camera sees.
+
+	SDL_RenderTilemap( $map, [ $x, $y, 320, 180 ], [ 0, 0, 1280, 720 ] );
+
+Expected parameters include:
+
+=over
+
+=item C<map> - the tilemap
+
+=item C<camera> - the area of the map to show, in map pixels; undef for the top left corner at the size of the destination
+
+=item C<dstrect> - where to draw it; undef for the whole viewport
+
+=back
+
+The camera is stretched to the destination, so a camera half its size zooms in
+2x. Positions may be fractional for smooth scrolling. Drawing is clipped to the
+destination.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetTilemapStats( ... )>
+
+Get the counters for the most recent C<SDL_RenderTilemap( ... )>.
+
+	my $stats = SDL_GetTilemapStats( $map );
+
+Returns a L<SDL3::TilemapStats> structure with the following fields:
+
+=over
+
+=item C<tiles> - tiles drawn from the tileset
+
+=item C<chunks> - cached chunks drawn
+
+=item C<rebuilt> - chunks that had to be redrawn first
+
+=item C<batches> - geometry batches or copies sent to the renderer
+
+=back
+
+=head1 Particle Emitters
+
+Particle effects written in Perl top out at a few thousand particles a frame.
+An emitter keeps its particles in native arrays, one per property, and moves
+them all at once with AVX2 or SSE2 when the CPU has them. The live particles
+are drawn as textured, colored quads with a single C<SDL_RenderGeometry( ...
+)> call. Perl only sets up the emitter and reads its counters.
+
+    my $fire = SDL_CreateParticleEmitter( $renderer, 20000 );
+    SDL_SetParticleEmitterTexture( $fire, $spark );
+    SDL_SetParticleEmitterRate( $fire, 4000 );
+    SDL_SetParticleEmitterLifetime( $fire, 0.5, 1.2 );
+    SDL_SetParticleEmitterVelocity( $fire, 40, 120, 250, 290 );
+    SDL_SetParticleEmitterForces( $fire, 0, -60, 0.5 );
+    SDL_SetParticleEmitterSize( $fire, 12, 2 );
+    SDL_SetParticleEmitterColor( $fire, [ 255, 220, 80, 255 ], [ 255, 40, 0, 0 ] );
+    while ($running) {
+        SDL_SetParticleEmitterPosition( $fire, $x, $y );
+        SDL_UpdateParticleEmitter( $fire, $elapsed_seconds );
+        SDL_RenderParticleEmitter($fire);
+        ...;
+    }
+
+Each particle starts at the emitter's position with a random lifetime, speed,
+and direction from the configured ranges. Its size and color move in a
+straight line from the start values to the end values over its lifetime. The
+texture's blend mode applies; without a texture the renderer's draw blend mode
+does. With SDL older than 2.0.18 the particles are drawn one call at a time.
+
+These functions may be imported by name or with the C<:particles> tag.
+
+=head2 C<SDL_CreateParticleEmitter( ... )>
+
+Create an emitter.
+
+	my $pe = SDL_CreateParticleEmitter( $renderer, 5000 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to draw with
+
+=item C<capacity> - the most particles alive at once; defaults to C<10000>
+
+=back
+
+The capacity is rounded up to a multiple of eight. The emitter starts with a
+rate of zero, 4 pixel white particles that fade out over one second, and
+speeds of 50 pixels per second in every direction.
+
+Returns a new L<SDL3::ParticleEmitter> on success or undef on failure.
+
+=head2 C<SDL_DestroyParticleEmitter( ... )>
+
+Destroy an emitter. Its texture is not destroyed.
+
+	SDL_DestroyParticleEmitter( $pe );
+
+=head2 C<SDL_SetParticleEmitterTexture( ... )>
+
+Set the texture drawn for each particle, or undef for plain squares.
+
+	SDL_SetParticleEmitterTexture( $pe, $spark );
+
+The whole texture is stretched over each particle and keeps its own blend mode,
+so C<SDL_SetTextureBlendMode( $spark, SDL_BLENDMODE_ADD )> gives glowing
+particles.
+
+=head2 C<SDL_SetParticleEmitterPosition( ... )>
+
+Move the point new particles start from.
+
+	SDL_SetParticleEmitterPosition( $pe, $x, $y );
+
+=head2 C<SDL_SetParticleEmitterRate( ... )>
+
+Set how many particles are emitted per second.
+
+	SDL_SetParticleEmitterRate( $pe, 500 );
+
+=head2 C<SDL_SetParticleEmitterLifetime( ... )>
+
+Set the range a particle's lifetime is picked from, in seconds.
+
+	SDL_SetParticleEmitterLifetime( $pe, 0.5, 2 );
+
+Returns C<0> on success or a negative error code if the range is invalid.
+
+=head2 C<SDL_SetParticleEmitterVelocity( ... )>
+
+Set the ranges a particle's starting speed and direction are picked from.
+
+	SDL_SetParticleEmitterVelocity( $pe, 20, 80, 260, 280 );
+
+Expected parameters include:
+
+=over
+
+=item C<speed_min> - the lowest speed in pixels per second
+
+=item C<speed_max> - the highest speed; defaults to C<speed_min>
+
+=item C<angle_min> - the lowest angle in degrees clockwise from the positive x axis; defaults to C<0>
+
+=item C<angle_max> - the highest angle; defaults to C<360>
+
+=back
+
+=head2 C<SDL_SetParticleEmitterForces( ... )>
+
+Set the acceleration applied to every particle and how fast they slow down.
+
+	SDL_SetParticleEmitterForces( $pe, 0, 98, 0.8 );
+
+Expected parameters include:
+
+=over
+
+=item C<ax> - horizontal acceleration in pixels per second squared
+
+=item C<ay> - vertical acceleration in pixels per second squared
+
+=item C<drag> - the fraction of its speed a particle keeps each second; defaults to C<1> (no drag)
+
+=back
+
+=head2 C<SDL_SetParticleEmitterSize( ... )>
+
+Set a particle's width and height at birth and at death, in pixels.
+
+	SDL_SetParticleEmitterSize( $pe, 16, 4 );
+
+=head2 C<SDL_SetParticleEmitterColor( ... )>
+
+Set a particle's color at birth and at death.
+
+	SDL_SetParticleEmitterColor( $pe, [ 255, 255, 255 ], [ 128, 128, 255, 0 ] );
+
+Colors may be L<SDL3::Color> objects or array refs; alpha defaults to C<255>.
+The end color defaults to the start color.
+
+=head2 C<SDL_ParticleEmitterBurst( ... )>
+
+Emit a number of particles right away.
+
+	SDL_ParticleEmitterBurst( $pe, 300 );
+
+Returns the number emitted, which is less than asked for if the emitter is
+full.
+
+=head2 C<SDL_UpdateParticleEmitter( ... )>
+
+Move every particle forward in time, remove the expired ones, and emit new
+ones at the emitter's rate.
+
+	SDL_UpdateParticleEmitter( $pe, $elapsed_seconds );
+
+=head2 C<SDL_RenderParticleEmitter( ... )>
+
+Draw the live particles.
+
+	SDL_RenderParticleEmitter( $pe );
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetParticleKernel( )>
+
+Get the name of the update code chosen for this CPU.
+
+	say SDL_GetParticleKernel( );    # avx2
+
+Returns C<avx2>, C<sse2>, or C<scalar>.
+
+=head2 C<SDL_GetParticleEmitterStats( ... )>
+
+Get an emitter's counters.
+
+	my $stats = SDL_GetParticleEmitterStats( $pe );
+
+Returns a L<SDL3::ParticleStats> structure with the following fields:
+
+=over
+
+=item C<alive> - particles currently alive
+
+=item C<capacity> - the most particles that can be alive at once
+
+=item C<emitted> - particles emitted so far
+
+=item C<expired> - particles that reached the end of their lifetime so far
+
+=item C<dropped> - particles not emitted because the emitter was full
+
+=item C<update_ns> - nanoseconds spent in the most recent update
+
+=item C<render_ns> - nanoseconds spent in the most recent render
+
+=back
+
+=head1 Auto-Tuning
+
+Which render driver is fastest, and whether batching or linear scaling helps,
+depends on the machine. C<SDL_AutoTuneRenderer( ... )> measures instead of
+guessing. It creates a renderer for every driver with every combination of the
+candidate hint values, runs the same short benchmark on each, and keeps the
+fastest. The answer is saved in the app's preference directory under a
+fingerprint of the machine, so later launches read it back and skip the probe.
+
+    SDL_Init(SDL_INIT_VIDEO);
+    my $tune     = SDL_AutoTuneRenderer( 'My Company', 'My Game' );
+    my $window   = SDL_CreateWindow( 'My Game', 100, 100, 1280, 720, 0 );
+    my $renderer = SDL_CreateRenderer( $window, -1, 0 );    # Uses $tune->{driver}
+
+The probe takes a second or two. It draws off screen into a small hidden window,
+so nothing flashes on screen.
+
+These functions may be imported by name or with the C<:autotune> tag.
+
+=head2 C<SDL_AutoTuneRenderer( ... )>
+
+Pick the fastest render driver and hint values, then set C<SDL_HINT_RENDER_DRIVER>
+and the winning hints so renderers created afterwards use them.
+
+	my $tune = SDL_AutoTuneRenderer( 'org', 'app', frames => 5 );
+	printf "%s in %.2f ms\n", $tune->{driver}, $tune->{ns} / 1e6;
+
+Expected parameters include:
+
+=over
+
+=item C<org> - your organization name, as given to C<SDL_GetPrefPath( ... )>
+
+=item C<app> - your application name, as given to C<SDL_GetPrefPath( ... )>
+
+=back
+
+Options may follow as key/value pairs:
+
+=over
+
+=item C<hints> - a hash ref of hint names to array refs of values to try; these are merged over the default of trying C<SDL_HINT_RENDER_BATCHING> with C<1> and C<0> and C<SDL_HINT_RENDER_SCALE_QUALITY> with C<nearest> and C<linear>. Give a single value to pin a hint, for example C<< { SDL_HINT_RENDER_SCALE_QUALITY, ['linear'] } >> when the look matters more than speed.
+
+=item C<flags> - L<SDL_RendererFlags|/SDL_RendererFlags> to create each renderer with; defaults to C<0>
+
+=item C<frames> - frames of each benchmark phase; defaults to C<10>
+
+=item C<force> - probe even if a saved answer exists
+
+=back
+
+The fingerprint covers the platform, CPU count, memory, SDL version, video
+driver, desktop mode, the list of render drivers, and the hint candidates, so
+changing any of them probes again.
+
+Returns a hash ref with the following keys, or undef if no driver could be
+benchmarked:
+
+=over
+
+=item C<driver> - the name of the winning render driver
+
+=item C<index> - its index for C<SDL_CreateRenderer( ... )>
+
+=item C<hints> - a hash ref of the winning hint values
+
+=item C<ns> - the benchmark time of the winner in nanoseconds
+
+=item C<cached> - true if the answer was read from the cache
+
+=back
+
+=head2 C<SDL_BenchmarkRenderer( ... )>
+
+Time a fixed workload on a renderer. This is what C<SDL_AutoTuneRenderer( ...
+)> runs for each candidate.
+
+	my ( $copy_ns, $fill_ns, $geometry_ns ) = SDL_BenchmarkRenderer( $renderer, 10 );
+
+Each frame draws 2000 blended, scaled copies of a small sprite, then 2000
+blended filled rects, then 2000 colored triangles, into a 512x512 target
+texture if the renderer supports targets. The GPU is waited on at the end of
+each phase.
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to measure
+
+=item C<frames> - frames to draw per phase; defaults to C<10>
+
+=back
+
+Returns the nanoseconds spent on copies, fills, and geometry (C<0> if SDL is
+older than 2.0.18), or an empty list on failure. Any draw call failing fails
+the whole benchmark, so C<SDL_AutoTuneRenderer( ... )> skips that
+configuration rather than picking a driver that drops its work.
+
+=head1 Frame-Time HUD
+
+A HUD is a small overlay for staging builds that shows how a game is doing
+without a profiler attached. It draws in a corner of the renderer:
+
+=over
+
+=item frame-time and FPS graphs of the last 120 frames, green at 60 fps or better, then yellow, then red
+
+=item the events SDL queued during the last frame, the number of callbacks waiting for C<SDL_Yield( )>, and the HUD's own cost
+
+=item how full a queued audio device is, if one is set
+
+=item up to eight counters set by the application
+
+=back
+
+    my $hud = SDL_CreateHUD($renderer);    # F3 shows and hides it
+    SDL_SetHUDAudioDevice( $hud, $device, 8192 );
+    while ($running) {
+        ...;
+        SDL_SetHUDCounter( $hud, 'sprites', scalar @sprites );
+        SDL_RenderHUD($hud);
+        SDL_RenderPresent($renderer);
+    }
+
+Text uses a built-in 3x5 pixel font, and the whole panel is drawn with one
+C<SDL_RenderFillRects( ... )> call per color, so it typically costs well under
+0.1 ms. Frames are timed from one C<SDL_RenderHUD( ... )> call to the next,
+including while the HUD is hidden, so the graphs are full when it is shown.
+
+These functions may be imported by name or with the C<:hud> tag.
+
+=head2 C<SDL_CreateHUD( ... )>
+
+Create a HUD. It starts out visible in the top left corner.
+
+	my $hud = SDL_CreateHUD( $renderer, SDL_SCANCODE_GRAVE, 3 );
+
+Expected parameters include:
+
+=over
+
+=item C<renderer> - the renderer to draw on
+
+=item C<toggle> - the scancode of a key that shows and hides the HUD; defaults to C<SDL_SCANCODE_F3>, C<0> for none
+
+=item C<scale> - the size of a font pixel; defaults to C<2>
+
+=back
+
+Returns a new L<SDL3::HUD> on success or undef on failure.
+
+=head2 C<SDL_DestroyHUD( ... )>
+
+Destroy a HUD.
+
+	SDL_DestroyHUD( $hud );
+
+=head2 C<SDL_SetHUDVisible( ... )>
+
+Show or hide the HUD.
+
+	SDL_SetHUDVisible( $hud, !SDL_IsHUDVisible( $hud ) );
+
+=head2 C<SDL_IsHUDVisible( ... )>
+
+Find out if the HUD is shown.
+
+	my $shown = SDL_IsHUDVisible( $hud );
+
+Returns true if the HUD is visible.
+
+=head2 C<SDL_SetHUDCorner( ... )>
+
+Move the HUD to another corner of the viewport.
+
+	SDL_SetHUDCorner( $hud, SDL_HUD_BOTTOMRIGHT );
+
+See L<SDL_HUDCorner|/C<SDL_HUDCorner>>.
+
+=head2 C<SDL_SetHUDAudioDevice( ... )>
+
+Show how much audio is queued on a device opened without a callback.
+
+	SDL_SetHUDAudioDevice( $hud, $device, 4 * $spec->samples * $spec->channels * 2 );
+
+Expected parameters include:
+
+=over
+
+=item C<device> - the device ID from C<SDL_OpenAudioDevice( ... )>, or C<0> to hide the bar
+
+=item C<target> - the number of queued bytes that counts as full; defaults to C<16384>
+
+=back
+
+=head2 C<SDL_SetHUDCounter( ... )>
+
+Show a value of your own.
+
+	SDL_SetHUDCounter( $hud, 'bullets', scalar @bullets );
+	SDL_SetHUDCounter( $hud, 'bullets' );    # Remove it
+
+Expected parameters include:
+
+=over
+
+=item C<name> - the label; only the first 30 characters are kept, and lower case is shown as upper case
+
+=item C<value> - the number to show, or undef to remove the counter
+
+=back
+
+Returns C<0> on success or a negative error code if eight counters are already
+shown.
+
+=head2 C<SDL_RenderHUD( ... )>
+
+Time the frame and, if the HUD is visible, draw it. Call this once a frame,
+right before C<SDL_RenderPresent( ... )>.
+
+	SDL_RenderHUD( $hud );
+
+The renderer's draw color and blend mode are left as they were.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_GetHUDStats( ... )>
+
+Get the numbers the HUD shows.
+
+	my $stats = SDL_GetHUDStats( $hud );
+
+Returns a L<SDL3::HUDStats> structure with the following fields:
+
+=over
+
+=item C<frames> - frames timed so far
+
+=item C<frame_ms> - the length of the last frame in milliseconds
+
+=item C<avg_ms> - the average frame length over the last 120 frames
+
+=item C<max_ms> - the longest frame of the last 120
+
+=item C<fps> - frames per second based on C<avg_ms>
+
+=item C<events> - events SDL queued during the last frame
+
+=item C<callbacks> - callbacks waiting for C<SDL_Yield( )>
+
+=item C<draw_ns> - nanoseconds the HUD took to draw itself last frame
+
+=back
+
+=head1 Defined Variables and Enumerations
+
+Variables may be imported by name or with the C<:render> tag. Enumerations may
+be imported with their given tags.
+
+=head2 C<SDL_RendererFlags>
+
+Flags used when creating a rendering context.
+
+=over
+
+=item C<SDL_RENDERER_SOFTWARE> - The renderer is a software fallback
+
+=item C<SDL_RENDERER_ACCELERATED> - The renderer uses hardware acceleration
+
+=item C<SDL_RENDERER_PRESENTVSYNC> - Present is synchronized with the refresh rate
+
+=item C<SDL_RENDERER_TARGETTEXTURE> - The renderer supports rendering to texture
+
+=back
+
+=head2 C<SDL_ScaleMode>
+
+The scaling mode for a texture.
+
+=over
+
+=item C<SDL_ScaleModeNearest> - nearest pixel sampling
+
+=item C<SDL_ScaleModeLinear> - linear filtering
+
+=item C<SDL_ScaleModeBest> - anisotropic filtering
+
+=back
+
+=head2 C<SDL_TextureAccess>
+
+The access pattern allowed for a texture.
+
+=over
+
+=item C<SDL_TEXTUREACCESS_STATIC> - Changes rarely, not lockable
+
+=item C<SDL_TEXTUREACCESS_STREAMING> - Changes frequently, lockable
+
+=item C<SDL_TEXTUREACCESS_TARGET> - Texture can be used as a render target
+
+=back
+
+=head2 C<SDL_TextureModulate>
+
+The texture channel modulation used in C<SDL_RenderCopy( )>.
+
+=over
+
+=item C<SDL_TEXTUREMODULATE_NONE> - No modulation
+
+=item C<SDL_TEXTUREMODULATE_COLOR> - C<srcC = srcC * color>
+
+=item C<SDL_TEXTUREMODULATE_ALPHA> - C<srcA = srcA * alpha>
+
+=back
+
+=head2 C<SDL_RendererFlip>
+
+Flip constants for SDL_RenderCopyEx
+
+=over
+
+=item C<SDL_FLIP_NONE> - Do not flip
+
+=item C<SDL_FLIP_HORIZONTAL> - flip horizontally
+
+=item C<SDL_FLIP_VERTICAL> - flip vertically
+
+=back
+
+=head2 C<SDL_CaptureFormat>
+
+Output formats for capture sinks.
+
+=over
+
+=item C<SDL_CAPTURE_Y4M> - a single YUV4MPEG2 stream
+
+=item C<SDL_CAPTURE_PNG> - one PNG file per frame
+
+=back
+
+=head2 C<SDL_HUDCorner>
+
+Where a HUD is drawn.
+
+=over
+
+=item C<SDL_HUD_TOPLEFT>
+
+=item C<SDL_HUD_TOPRIGHT>
+
+=item C<SDL_HUD_BOTTOMLEFT>
+
+=item C<SDL_HUD_BOTTOMRIGHT>
 
 =back
 
@@ -2180,7 +5097,7 @@ Sanko Robinson E<lt>sanko@cpan.orgE<gt>
 =begin stopwords
 
 high-dpi rect viewport subpixel dstrect subrectangle backbuffer OpenGL
-vice-versa CAMetalLayer
+vice-versa CAMetalLayer YUV4MPEG2 ffmpeg backpressure
 
 =end stopwords
 
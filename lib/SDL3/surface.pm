@@ -2,6 +2,8 @@ package SDL3::surface 0.01 {
     use SDL3::Utils;
     use experimental 'signatures';
     use FFI::C::ArrayDef;
+    use FFI::Platypus::Buffer qw[scalar_to_pointer];
+    use Carp                  qw[croak];
     #
     use SDL3::stdinc;
     use SDL3::pixels;
@@ -9,6 +11,8 @@ package SDL3::surface 0.01 {
     use SDL3::blendmode;
     use SDL3::rwops;
     #
+    load_lib('api_wrapper');
+    #
     package SDL3::Surface {
         use SDL3::Utils;
         our $TYPE = has
@@ -34,6 +38,38 @@ package SDL3::surface 0.01 {
             defined $_[1] ? $_[0]->_map( ffi->cast( 'SDL_BlitMap', 'opaque', $_[1] ) ) :
                 ffi->cast( 'opaque', 'SDL_BlitMap', $_[0]->_map );
         }
+        sub pixels_view { SDL3::SDL_GetSurfacePixelsView( $_[0] ) }
+    };
+
+    package SDL3::BlitCacheStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            hits          => 'uint32',
+            conversions   => 'uint32',
+            invalidations => 'uint32',
+            evictions     => 'uint32',
+            entries       => 'int',
+            bytes         => 'uint64',
+            budget        => 'uint64';
+    };
+
+    package SDL3::SurfacePool {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::SurfacePoolStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            hits        => 'uint32',
+            misses      => 'uint32',
+            releases    => 'uint32',
+            evictions   => 'uint32',
+            idle        => 'int',
+            outstanding => 'int',
+            bytes       => 'uint64',
+            budget      => 'uint64',
+            hit_rate    => 'float';
     };
     #
     enum SDL_YUV_CONVERSION_MODE => [
@@ -42,6 +78,19 @@ package SDL3::surface 0.01 {
             SDL_YUV_CONVERSION_BT709
             SDL_YUV_CONVERSION_AUTOMATIC]
     ];
+    enum SDL_ResampleFilter => [
+        qw[SDL_RESAMPLE_BILINEAR
+            SDL_RESAMPLE_BICUBIC
+            SDL_RESAMPLE_LANCZOS3]
+    ];
+    #
+    # Pixel buffers are passed by reference so the C side can use (and pin) the caller's scalar
+    # itself; anything else is a native pointer. Returns the scalar's reference and whether it
+    # holds a pointer. Array references of 16-bit values are still accepted for compatibility.
+    sub _pixels ($pixels) {
+        return ( \$pixels, 1 ) if !ref $pixels;
+        ( ref $pixels eq 'ARRAY' ? \pack( 'S*', @$pixels ) : $pixels, 0 );
+    }
     attach surface => {
         SDL_CreateRGBSurface => [
             [ 'uint32', 'int', 'int', 'int', 'uint32', 'uint32', 'uint32', 'uint32' ],
@@ -49,17 +98,31 @@ package SDL3::surface 0.01 {
         ],
         SDL_CreateRGBSurfaceWithFormat =>
             [ [ 'uint32', 'int', 'int', 'int', 'uint32' ], 'SDL_Surface' ],
-        SDL_CreateRGBSurfaceFrom => [    # FIX: uint16 might be large enough for raw data
-            [ 'uint16[]', 'int', 'int', 'int', 'int', 'uint32', 'uint32', 'uint32', 'uint32' ],
-            'SDL_Surface'
+        Bundle_SDL_CreateRGBSurfaceFrom => [
+            [   'opaque', 'SDL_bool', 'int', 'int', 'int', 'int', 'uint32', 'uint32', 'uint32',
+                'uint32'
+            ],
+            'SDL_Surface' => sub ( $inner, $pixels, @args ) {
+                $inner->( _pixels($pixels), @args );
+            }
+        ],
+        Bundle_SDL_CreateRGBSurfaceWithFormatFrom => [
+            [ 'opaque', 'SDL_bool', 'int', 'int', 'int', 'int', 'uint32' ],
+            'SDL_Surface' => sub ( $inner, $pixels, @args ) {
+                $inner->( _pixels($pixels), @args );
+            }
         ],
-        SDL_CreateRGBSurfaceWithFormatFrom => [    # FIX: uint16 might be large enough for raw data
-            [ 'uint16[]', 'int', 'int', 'int', 'int', 'uint32' ], 'SDL_Surface'
+        Bundle_SDL_FreeSurface   => [ ['SDL_Surface'] ],
+        SDL_SetSurfacePalette    => [ [ 'SDL_Surface', 'SDL_Palette' ], 'int' ],
+        Bundle_SDL_LockSurface   => [ ['SDL_Surface'],                  'int' ],
+        Bundle_SDL_UnlockSurface => [ ['SDL_Surface'] ],
+        Bundle_SDL_GetSurfacePixelsView => [
+            [ 'SDL_Surface', 'opaque' ],
+            'int' => sub ( $inner, $surface ) {
+                my $view;
+                $inner->( $surface, \$view ) == 0 ? \$view : undef;
+            }
         ],
-        SDL_FreeSurface         => [ ['SDL_Surface'] ],
-        SDL_SetSurfacePalette   => [ [ 'SDL_Surface', 'SDL_Palette' ], 'int' ],
-        SDL_LockSurface         => [ ['SDL_Surface'],                  'int' ],
-        SDL_UnlockSurface       => [ ['SDL_Surface'] ],
         SDL_LoadBMP_RW          => [ [ 'SDL_RWops', 'int' ],                       'SDL_Surface' ],
         SDL_SaveBMP_RW          => [ [ 'SDL_Surface', 'SDL_RWops', 'int' ],        'int' ],
         SDL_SetSurfaceRLE       => [ [ 'SDL_Surface', 'int' ],                     'int' ],
@@ -78,11 +141,22 @@ package SDL3::surface 0.01 {
         SDL_DuplicateSurface    => [ ['SDL_Surface'], 'SDL_Surface' ],
         SDL_ConvertSurface => [ [ 'SDL_Surface', 'SDL_PixelFormat', 'uint32' ], 'SDL_Surface' ],
         SDL_ConvertSurfaceFormat => [ [ 'SDL_Surface', 'uint32', 'uint32' ], 'SDL_Surface' ],
-        SDL_ConvertPixels        => [    # FIX: uint16 might be large enough for raw data
-            [ 'int', 'int', 'uint32', 'uint16[]', 'int', 'uint32', 'uint16[]', 'int' ], 'int'
+        Bundle_SDL_ConvertPixels => [
+            [   'int',    'int', 'uint32', 'opaque', 'SDL_bool', 'int',
+                'uint32', 'opaque', 'SDL_bool', 'int'
+            ],
+            'int' => sub ( $inner, $w, $h, $src_format, $src, $src_pitch, $dst_format, $dst,
+                $dst_pitch ) {
+                croak 'SDL_ConvertPixels( ... ) cannot write into an array reference; pass a scalar'
+                    if ref $dst eq 'ARRAY';
+                $inner->(
+                    $w, $h, $src_format, _pixels($src), $src_pitch, $dst_format, _pixels($dst),
+                    $dst_pitch
+                );
+            }
         ],
-        SDL_FillRect  => [ [ 'SDL_Surface', 'SDL_Rect', 'uint32' ], 'int' ],
-        SDL_FillRects => [
+        Bundle_SDL_FillRect  => [ [ 'SDL_Surface', 'SDL_Rect', 'uint32' ], 'int' ],
+        Bundle_SDL_FillRects => [
             [ 'SDL_Surface', 'RectList_t', 'int', 'uint32' ],
             'int' => sub ( $inner, $dst, $_rects, $count, $color ) {
                 my $rects = $SDL3::Rect::LIST->create(
@@ -90,13 +164,18 @@ package SDL3::surface 0.01 {
                 $inner->( $dst, $rects, $count, $color );
             }
         ],
-        SDL_UpperBlit   => [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
-        SDL_LowerBlit   => [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
-        SDL_SoftStretch => [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
-        SDL_SoftStretchLinear =>
+        Bundle_SDL_UpperBlit =>
+            [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
+        Bundle_SDL_LowerBlit =>
+            [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
+        Bundle_SDL_SoftStretch =>
+            [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
+        Bundle_SDL_SoftStretchLinear =>
+            [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
+        Bundle_SDL_UpperBlitScaled =>
+            [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
+        Bundle_SDL_LowerBlitScaled =>
             [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
-        SDL_UpperBlitScaled => [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
-        SDL_LowerBlitScaled => [ [ 'SDL_Surface', 'SDL_Rect', 'SDL_Surface', 'SDL_Rect' ], 'int' ],
         SDL_SetYUVConversionMode              => [ ['SDL_YUV_CONVERSION_MODE'] ],
         SDL_GetYUVConversionMode              => [ [],               'SDL_YUV_CONVERSION_MODE' ],
         SDL_GetYUVConversionModeForResolution => [ [ 'int', 'int' ], 'SDL_YUV_CONVERSION_MODE' ]
@@ -119,6 +198,123 @@ package SDL3::surface 0.01 {
             }
         ],
     ];
+    attach pixelkernel => {
+        Bundle_SDL_GetPixelKernel => [ [], 'string' ],
+        Bundle_SDL_SetPixelKernel => [ ['string'], 'int' ],
+        Bundle_SDL_FillSurface    => [
+            [ 'SDL_Surface', 'int', 'int', 'int', 'int', 'uint32' ],
+            'int' => sub ( $inner, $surface, $rect, $color ) {
+                $inner->( $surface, SDL3::rect::_xywh($rect), $color );
+            }
+        ],
+        Bundle_SDL_FillSurfaceGradient => [
+            [ 'SDL_Surface', 'int', 'int', 'int', 'int', 'uint32', 'uint32', 'SDL_bool' ],
+            'int' => sub ( $inner, $surface, $rect, $from, $to, $vertical = 0 ) {
+                $inner->( $surface, SDL3::rect::_xywh($rect), $from, $to, $vertical ? 1 : 0 );
+            }
+        ],
+        Bundle_SDL_BlendSurface => [
+            [ 'SDL_Surface', 'int', 'int', 'int', 'int', 'SDL_Surface', 'int', 'int' ],
+            'int' => sub ( $inner, $src, $srcrect, $dst, $dstrect = () ) {
+                $inner->(
+                    $src, SDL3::rect::_xywh($srcrect),
+                    $dst, ( SDL3::rect::_xywh($dstrect) )[ 0, 1 ]
+                );
+            }
+        ],
+        Bundle_SDL_PremultiplySurfaceAlpha   => [ ['SDL_Surface'],                  'int' ],
+        Bundle_SDL_UnpremultiplySurfaceAlpha => [ ['SDL_Surface'],                  'int' ],
+        Bundle_SDL_SwizzleSurface            => [ [ 'SDL_Surface', 'SDL_Surface' ], 'int' ],
+        Bundle_SDL_GrayscaleSurface          => [ ['SDL_Surface'],                  'int' ]
+    };
+    #
+    # [ [ $srcrect, $dstrect ], ... ] or a (reference to a) string of packed ints, eight per pair.
+    # An undef rect is packed with a size of -1, the whole surface; an empty one stays empty.
+    sub _rect_pairs ($pairs) {
+        return $$pairs if ref $pairs eq 'SCALAR';
+        return $pairs  if !ref $pairs;
+        pack 'i*', map { $_ // 0 }
+            map { defined $_ ? SDL3::rect::_xywh($_) : ( 0, 0, -1, -1 ) } map {@$_[ 0, 1 ]} @$pairs;
+    }
+
+    sub _blit_many ( $inner, $src, $dst, $pairs ) {
+        my $packed = _rect_pairs($pairs);
+        my $count  = int( length($packed) / ( 8 * length pack 'i', 0 ) );
+        my $mask   = "\0" x ( ( $count + 7 ) >> 3 );
+        $inner->( $src, $dst, scalar_to_pointer($packed), $count, scalar_to_pointer($mask) ) < 0 ?
+            undef :
+            $mask;
+    }
+    attach blit => {
+        Bundle_SDL_BlitSurfaceMany =>
+            [ [ 'SDL_Surface', 'SDL_Surface', 'opaque', 'int', 'opaque' ], 'int' => \&_blit_many ],
+        Bundle_SDL_BlitScaledMany =>
+            [ [ 'SDL_Surface', 'SDL_Surface', 'opaque', 'int', 'opaque' ], 'int' => \&_blit_many ]
+    };
+    attach blitcache => {
+        Bundle_SDL_SetBlitCacheEnabled => [ ['SDL_bool'] ],
+        Bundle_SDL_SetBlitCacheBudget  => [ ['uint64'] ],
+        Bundle_SDL_InvalidateBlitCache => [
+            ['SDL_Surface'], sub ( $inner, $surface = () ) { $inner->($surface) }
+        ],
+        Bundle_SDL_GetBlitCacheStats => [
+            ['SDL_BlitCacheStats'],
+            sub ( $inner, $stats = SDL3::BlitCacheStats->new ) {
+                $inner->($stats);
+                $stats;
+            }
+        ]
+    };
+    attach surfacepool => {
+        Bundle_SDL_CreateSurfacePool => [
+            ['uint64'],
+            'SDL_SurfacePool' => sub ( $inner, $budget = 64 * 1024 * 1024 ) { $inner->($budget) }
+        ],
+        Bundle_SDL_DestroySurfacePool => [ ['SDL_SurfacePool'] ],
+        Bundle_SDL_SurfacePoolAcquire => [
+            [ 'SDL_SurfacePool', 'int', 'int', 'uint32', 'SDL_bool' ],
+            'SDL_Surface' => sub ( $inner, $pool, $w, $h, $format, $clear = 1 ) {
+                $inner->( $pool, $w, $h, $format, $clear ? 1 : 0 );
+            }
+        ],
+        Bundle_SDL_SurfacePoolRelease   => [ [ 'SDL_SurfacePool', 'SDL_Surface' ] ],
+        Bundle_SDL_SurfacePoolTrim      => [
+            [ 'SDL_SurfacePool', 'uint64' ],
+            sub ( $inner, $pool, $keep = 0 ) { $inner->( $pool, $keep ) }
+        ],
+        Bundle_SDL_SurfacePoolSetBudget => [ [ 'SDL_SurfacePool', 'uint64' ] ],
+        Bundle_SDL_GetSurfacePoolStats  => [
+            [ 'SDL_SurfacePool', 'SDL_SurfacePoolStats' ],
+            sub ( $inner, $pool, $stats = SDL3::SurfacePoolStats->new ) {
+                $inner->( $pool, $stats );
+                $stats;
+            }
+        ]
+    };
+    attach filter => {
+        Bundle_SDL_BoxBlurSurface      => [ [ 'SDL_Surface', 'SDL_Surface', 'int' ],   'int' ],
+        Bundle_SDL_GaussianBlurSurface => [ [ 'SDL_Surface', 'SDL_Surface', 'float' ], 'int' ],
+        Bundle_SDL_ConvolveSurface     => [
+            [ 'SDL_Surface', 'SDL_Surface', 'float[]', 'int', 'float', 'float' ],
+            'int' => sub ( $inner, $src, $dst, $kernel, $divisor = (), $bias = 0 ) {
+                if ( !defined $divisor ) {
+                    $divisor = 0;
+                    $divisor += $_ for @$kernel;
+                    $divisor ||= 1;
+                }
+                my $size = @$kernel == 25 ? 5 : @$kernel == 9 ? 3 : 0;
+                $inner->( $src, $dst, $kernel, $size, $divisor, $bias );
+            }
+        ],
+        Bundle_SDL_ResampleSurface => [
+            [ 'SDL_Surface', 'SDL_Surface', 'SDL_ResampleFilter' ],
+            'int' => sub ( $inner, $src, $dst, $filter = SDL3::SDL_RESAMPLE_LANCZOS3() ) {
+                $inner->( $src, $dst, $filter );
+            }
+        ],
+        Bundle_SDL_SetFilterThreads => [ ['int'], 'int' ],
+        Bundle_SDL_GetFilterThreads => [ [],      'int' ]
+    };
 
 =encoding utf-8
 
@@ -295,14 +491,28 @@ This function operates mostly like L<< C<SDL_CreateRGBSurface( ...
 the pixel data, instead the caller provides an existing buffer of data for the
 surface to use.
 
-No copy is made of the pixel data. Pixel data is not managed automatically; you
-must free the surface before you free the pixel data.
+No copy is made of the pixel data. When C<pixels> is a reference to a packed
+string, the surface takes over that scalar's buffer and holds a reference to it
+until L<< C<SDL_FreeSurface( ... )>|/C<SDL_FreeSurface( ... )> >>; while it
+does, the scalar can be modified in place (C<substr>, C<vec>, etc.) or assigned
+a string of the same length, but anything that would resize it croaks. Freeing
+the surface hands the buffer back to the scalar. A string that is read-only or
+already backs another surface is copied once first.
+
+Anything that is not a reference is a pointer, even if it has been used as a
+string (C<"$ptr">) along the way. A pointer is used as is and you must free the
+surface before you free the memory behind it.
+
+	my $pixels  = pack 'L*', (0xFF336699) x (64 * 64);
+	my $surface = SDL_CreateRGBSurfaceFrom( \$pixels, 64, 64, 32, 64 * 4,
+		0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 );
+	substr $pixels, 0, 4, pack 'L', 0xFFFFFFFF;    # visible through $surface
 
 Expected parameters include:
 
 =over
 
-=item C<pixels> - a pointer to existing pixel data
+=item C<pixels> - existing pixel data: a reference to a packed string of at least C<pitch * height> bytes, a pointer, or a reference to a list of 16-bit values
 
 =item C<width> - the width of the surface
 
@@ -335,14 +545,15 @@ This function operates mostly like L<< C<SDL_CreateRGBSurfaceFrom( ...
 color masks, you provide it with a predefined format from
 C<SDL_PixelFormatEnum>.
 
-No copy is made of the pixel data. Pixel data is not managed automatically; you
-must free the surface before you free the pixel data.
+As with C<SDL_CreateRGBSurfaceFrom( ... )>, no copy is made of a packed
+string or pointer and a string is kept alive until the surface is freed.
+Strings are passed by reference; anything else is a pointer.
 
 Expected parameters include:
 
 =over
 
-=item C<pixels> - a pointer to existing pixel data
+=item C<pixels> - existing pixel data: a reference to a packed string, a pointer, or a reference to a list of 16-bit values
 
 =item C<width> - the width of the surface
 
@@ -404,6 +615,9 @@ Not all surfaces require locking. If C<SDL_MUSTLOCK(surface)> evaluates to
 C<0>, then you can read and write to the surface at any time, and the pixel
 format of the surface will not change.
 
+Locking also drops any converted copies of the surface held by the
+L<blit cache|/Blit Cache>.
+
 Expected parameters include:
 
 =over
@@ -427,6 +641,40 @@ Expected parameters include:
 
 =back
 
+Releasing the last lock detaches any views from L<< C<SDL_GetSurfacePixelsView(
+... )>|/C<SDL_GetSurfacePixelsView( ... )> >>.
+
+=head2 C<SDL_GetSurfacePixelsView( ... )>
+
+Get a perl scalar that is the surface's pixel memory, without copying it.
+
+    SDL_LockSurface($surface);
+    my $pixels = SDL_GetSurfacePixelsView($surface);    # or $surface->pixels_view
+    vec( $$pixels, $y * $surface->pitch / 4 + $x, 32 ) = 0xFFFF0000;
+    substr( $$pixels, $y * $surface->pitch, $surface->w * 4 ) = $row;
+    SDL_UnlockSurface($surface);    # $$pixels is now undef
+
+The scalar is C<< $surface->pitch * $surface->h >> bytes long, padding
+included, and anything written to it is written to the surface. Its length
+cannot change: an assignment that would make it longer or shorter copies as
+much as fits and then dies.
+
+A surface that needs locking (see C<SDL_LockSurface( ... )>) must be locked
+first. The view is detached, leaving the scalar undef, when the surface's last
+lock is released with C<SDL_UnlockSurface( ... )> or when the surface is freed,
+so it can never point at memory SDL has moved or released.
+
+Expected parameters include:
+
+=over
+
+=item C<surface> - the L<SDL3::Surface> structure to view
+
+=back
+
+Returns a reference to the scalar on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
 =head2 C<SDL_LoadBMP_RW( ... )>
 
 Load a BMP image from a seekable SDL data stream.
@@ -838,6 +1086,9 @@ fails; call C<SDL_GetError( )> for more information.
 
 Copy a block of pixels of one format to another format.
 
+As with L<< C<SDL_CreateRGBSurfaceFrom( ... )>|/C<SDL_CreateRGBSurfaceFrom( ...
+)> >>, a reference is a packed string and anything else is a pointer.
+
 Expected parameters include:
 
 =over
@@ -848,13 +1099,17 @@ Expected parameters include:
 
 =item C<src_format> - an C<SDL_PixelFormatEnum> value of the C<src> pixels format
 
-=item C<src> - a pointer to the source pixels
+=item C<src> - the source pixels: a reference to a packed string of at least C<src_pitch * height> bytes or a pointer
 
 =item C<src_pitch> - the pitch of the block to copy, in bytes
 
 =item C<dst_format> - an C<SDL_PixelFormatEnum> value of the C<dst> pixels format
 
-=item C<dst> - a pointer to be filled in with new pixel data
+=item C<dst> - a reference to a scalar or a pointer to be filled in with new pixel data; a plain scalar is grown to C<dst_pitch * height> bytes if needed, but a pixels view or a string backing a surface must already be large enough
+
+	my $rgba;
+	SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, \$argb, $w * 4,
+		SDL_PIXELFORMAT_RGBA8888, \$rgba, $w * 4 );
 
 =item C<dst_pitch> - the pitch of the destination pixels, in bytes
 
@@ -997,6 +1252,9 @@ defined as follows:
 You should call C<SDL_BlitSurface( ... )> unless you know exactly how SDL
 blitting works internally and how to use the other blit functions.
 
+When the formats differ, the source is converted once and the copy is reused;
+see L</Blit Cache>.
+
 Returns C<0> if the blit is successful or a negative error code on failure;
 call C<SDL_GetError( )> for more information.
 
@@ -1206,6 +1464,611 @@ Expected parameters include:
 
 Returns a C<SDL_YUV_CONVERSION_MODE> value.
 
+=head1 Pixel Kernels
+
+These functions work directly on the pixels of 32-bit surfaces with native
+loops instead of touching one byte at a time from perl. Each has scalar, SSE2,
+AVX2 and NEON versions; the widest one the CPU supports is chosen the first
+time any of them is used. All versions use the same integer math, so they
+produce exactly the same pixels.
+
+Surfaces that need locking are locked and unlocked for you. Functions that
+fill or blend respect the destination's clip rectangle.
+
+These may be imported with the C<:pixelkernel> tag or individually by name.
+
+=head2 C<SDL_GetPixelKernel( )>
+
+Find out which set of kernels is in use.
+
+	say SDL_GetPixelKernel();    # avx2
+
+Returns one of C<avx2>, C<sse2>, C<neon>, or C<scalar>.
+
+=head2 C<SDL_SetPixelKernel( ... )>
+
+Force a set of kernels. This is meant for testing and benchmarking.
+
+	SDL_SetPixelKernel('scalar');
+
+Expected parameters include:
+
+=over
+
+=item C<name> - C<scalar>, C<sse2>, C<avx2>, or C<neon>
+
+=back
+
+Returns C<0> on success or a negative error code if the kernels were not built
+in or the CPU does not support them.
+
+=head2 C<SDL_FillSurface( ... )>
+
+Fill a rectangle with a color.
+
+	SDL_FillSurface( $surface, [ 10, 10, 32, 32 ], SDL_MapRGB( $surface->format, 255, 0, 0 ) );
+
+Expected parameters include:
+
+=over
+
+=item C<surface> - the 32-bit surface to fill
+
+=item C<rect> - a L<SDL3::Rect>, C<[x, y, w, h]>, C<{x, y, w, h}>, or undef for the whole surface
+
+=item C<color> - the color, already mapped to the surface's format
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_FillSurfaceGradient( ... )>
+
+Fill a rectangle with a linear gradient.
+
+	my $fmt = $surface->format;
+	SDL_FillSurfaceGradient( $surface, undef, SDL_MapRGB( $fmt, 0, 0, 64 ),
+		SDL_MapRGB( $fmt, 128, 160, 255 ), 1 );
+
+Each byte of the two colors is interpolated separately, so this works with any
+32-bit format.
+
+Expected parameters include:
+
+=over
+
+=item C<surface> - the 32-bit surface to fill
+
+=item C<rect> - the area of the gradient, or undef for the whole surface; the clip rectangle may cut it short without changing its colors
+
+=item C<from> - the color at the left or top edge, mapped to the surface's format
+
+=item C<to> - the color at the right or bottom edge
+
+=item C<vertical> - true to run the gradient from top to bottom; defaults to left to right
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_BlendSurface( ... )>
+
+Alpha-blend one surface over another.
+
+	SDL_BlendSurface( $sprite, undef, $screen, [ 100, 40 ] );
+
+This gives the same result as C<SDL_BlitSurface( ... )> with
+C<SDL_BLENDMODE_BLEND>, rounded to the nearest value, but both surfaces must
+share a format with an 8-bit alpha channel.
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the surface to draw
+
+=item C<srcrect> - the part of C<src> to draw, or undef for all of it
+
+=item C<dst> - the surface to draw on
+
+=item C<dstrect> - where to draw; only the position is used, and undef means C<[0, 0]>
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_PremultiplySurfaceAlpha( ... )>
+
+Multiply the color channels of every pixel by its alpha, in place.
+
+	SDL_PremultiplySurfaceAlpha( $surface );
+
+The surface must have an 8-bit alpha channel.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_UnpremultiplySurfaceAlpha( ... )>
+
+Divide the color channels of every pixel by its alpha, in place. This undoes
+L<< C<SDL_PremultiplySurfaceAlpha( ... )>|/C<SDL_PremultiplySurfaceAlpha( ... )> >>
+to within one step per channel; fully opaque pixels come back unchanged.
+
+	SDL_UnpremultiplySurfaceAlpha( $surface );
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_SwizzleSurface( ... )>
+
+Copy pixels between surfaces that store the same channels with the fourth byte
+at opposite ends.
+
+	my $rgba = SDL_CreateRGBSurfaceWithFormat( 0, $argb->w, $argb->h, 32, SDL_PIXELFORMAT_RGBA8888 );
+	SDL_SwizzleSurface( $argb, $rgba );
+
+The supported pairs, in either direction, are C<SDL_PIXELFORMAT_ARGB8888> and
+C<SDL_PIXELFORMAT_RGBA8888>, C<SDL_PIXELFORMAT_ABGR8888> and
+C<SDL_PIXELFORMAT_BGRA8888>, C<SDL_PIXELFORMAT_XRGB8888> and
+C<SDL_PIXELFORMAT_RGBX8888>, and C<SDL_PIXELFORMAT_XBGR8888> and
+C<SDL_PIXELFORMAT_BGRX8888>.
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the surface to read
+
+=item C<dst> - a surface of the same size in the paired format
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_GrayscaleSurface( ... )>
+
+Turn every pixel gray, in place, using Rec. 601 luma weights.
+
+	SDL_GrayscaleSurface( $surface );
+
+Alpha is left alone.
+
+Returns C<0> on success or a negative error code on failure.
+
+=head1 Batched Blits
+
+Each C<SDL_BlitSurface( ... )> from perl costs an FFI call and two
+L<SDL3::Rect> structures. These functions take a whole list of rectangle pairs
+and do the blits in one native loop: the surfaces are checked, the
+L<blit cache|/Blit Cache> is consulted and the blit map is prepared once per
+call, and each item is then clipped and blitted natively. A failing item does
+not stop the batch.
+
+    my $pairs = pack 'i*', map { ( @{ $frame[ $_->{frame} ] }, $_->{x}, $_->{y}, 0, 0 ) } @sprites;
+    my $mask  = SDL_BlitSurfaceMany( $sheet, $screen, \$pairs );
+    if ( my $failed = unpack '%32b*', $mask ) {
+        warn "$failed blits failed: " . SDL_GetError();
+        warn "sprite $_ failed" for grep { vec $mask, $_, 1 } 0 .. $#sprites;
+    }
+
+Pairs may be given as a list of C<[ $srcrect, $dstrect ]> array refs (rects
+may be L<SDL3::Rect> objects, array refs, hash refs, or undef), or as a string
+(or a reference to one) of native ints packed with C<pack 'i*'>, eight per
+pair: C<sx, sy, sw, sh, dx, dy, dw, dh>. In packed pairs a negative width or
+height means the whole surface, as undef does in the list form. A rectangle
+with a width or height of C<0> is empty and nothing is drawn for it, as with
+C<SDL_BlitSurface( ... )>. Unlike C<SDL_BlitSurface( ... )>, the final clipped
+rectangles are not written back.
+
+These functions may be imported by name or with the C<:blit> tag.
+
+=head2 C<SDL_BlitSurfaceMany( ... )>
+
+Do many unscaled blits from one surface to another.
+
+	my $mask = SDL_BlitSurfaceMany( $src, $dst,
+		[ [ undef, [ 10, 10 ] ], [ [ 0, 0, 8, 8 ], [ 40, 10 ] ] ] );
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to copy from
+
+=item C<dst> - the L<SDL3::Surface> to copy to
+
+=item C<pairs> - source and destination rectangles; only the position of the destination is used
+
+=back
+
+Returns a failure mask: bit C<i> (C<vec( $mask, $i, 1 )>) is set if item C<i>
+failed. Returns undef if the call as a whole fails (a missing or locked
+surface); call C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_BlitScaledMany( ... )>
+
+Do many scaled blits from one surface to another, as with
+C<SDL_BlitScaled( ... )>.
+
+	my $mask = SDL_BlitScaledMany( $src, $dst, \pack( 'i*', 0, 0, 16, 16, 0, 0, 64, 64 ) );
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to copy from
+
+=item C<dst> - the L<SDL3::Surface> to copy to
+
+=item C<pairs> - source and destination rectangles; an undef destination (or a negative width or height when packed) means the whole destination
+
+=back
+
+Returns a failure mask like C<SDL_BlitSurfaceMany( ... )>, or undef if the
+call as a whole fails.
+
+=head1 Blit Cache
+
+Blitting a surface onto one of a different format (an image from
+C<IMG_Load( ... )> onto the window surface, say) converts every pixel on every
+blit. With the blit cache turned on, C<SDL_BlitSurface( ... )>,
+C<SDL_BlitScaled( ... )> and their C<SDL_UpperBlit...> forms instead convert
+the source to the destination's format with C<SDL_ConvertSurfaceFormat( ...
+)> the first time and blit the copy from then on, which takes SDL's fast
+same-format path.
+
+    SDL_SetBlitCacheEnabled(1);
+    my $sprite = IMG_Load('hero.png');    # ABGR8888
+    my $screen = SDL_GetWindowSurface($window);    # XRGB8888
+    SDL_BlitSurface( $sprite, undef, $screen, [ $x, $y, 0, 0 ] ) for 1 .. 1000;    # 1 conversion
+
+Copies are kept per source surface and target format and follow the source's
+current color mod, alpha mod, and blend mode. A copy keeps an alpha channel if
+the source needs one for blending. A copy is dropped when its source is locked
+with L<< C<SDL_LockSurface( ... )>|/C<SDL_LockSurface( ... )> >>, filled with
+C<SDL_FillRect( ... )> or C<SDL_FillRects( ... )>, blitted onto, changed by a
+pixel kernel or a pixel view, given a different color key or palette colors,
+or freed. C<SDL_LowerBlit( ... )>, C<SDL_LowerBlitScaled( ... )>,
+C<SDL_SoftStretch( ... )> and C<SDL_SoftStretchLinear( ... )> don't use the
+cache but do drop the copies of the surface they write to. If you write to
+C<< $surface->pixels >> through the raw pointer any other way (e.g.
+C<SDL_memcpy( ... )> on a surface that doesn't need locking, or drawing done
+by another library), the cache can't tell; call L<<
+C<SDL_InvalidateBlitCache( ... )>|/C<SDL_InvalidateBlitCache( ... )> >>
+afterwards. That is why the cache is off until you turn it on.
+
+Copies are limited to 64 MiB by default; past that, the least recently used
+are freed first. A source whose copy alone would not fit is blitted directly.
+Change the limit with L<< C<SDL_SetBlitCacheBudget( ...
+)>|/C<SDL_SetBlitCacheBudget( ... )> >>.
+
+Sources with a color key that would have to become an alpha channel, and
+indexed or FOURCC targets, are blitted directly as before.
+
+These functions may be imported by name or with the C<:blitcache> tag.
+
+=head2 C<SDL_SetBlitCacheEnabled( ... )>
+
+Turn the cache on or off. It is off by default; turning it off frees every
+copy.
+
+	SDL_SetBlitCacheEnabled( 1 );
+
+=head2 C<SDL_SetBlitCacheBudget( ... )>
+
+Set how much pixel memory the copies may hold, freeing the least recently used
+copies right away if they are over it.
+
+	SDL_SetBlitCacheBudget( 16 * 1024 * 1024 );
+
+Expected parameters include:
+
+=over
+
+=item C<budget> - the limit in bytes; C<0> means no limit
+
+=back
+
+=head2 C<SDL_InvalidateBlitCache( ... )>
+
+Drop the copies of a surface, or of every surface if none is given.
+
+	SDL_memcpy( $surface->pixels, \$bytes, length $bytes );
+	SDL_InvalidateBlitCache( $surface );
+
+=head2 C<SDL_GetBlitCacheStats( )>
+
+Get the cache's counters.
+
+	my $stats = SDL_GetBlitCacheStats( );
+
+Returns a L<SDL3::BlitCacheStats> structure with the following fields:
+
+=over
+
+=item C<hits> - blits that used a converted copy
+
+=item C<conversions> - copies made
+
+=item C<invalidations> - copies dropped because their source changed
+
+=item C<evictions> - copies dropped to stay within the budget
+
+=item C<entries> - copies held
+
+=item C<bytes> - pixel memory held by the copies
+
+=item C<budget> - the limit for C<bytes>; C<0> means no limit
+
+=back
+
+=head1 Surface Pool
+
+Creating and freeing the same few sizes of scratch surface every frame (text,
+compositing, thumbnails) keeps the allocator busy. A surface pool hands out
+surfaces by size and format and keeps them when they are released so the next
+request for the same shape reuses one.
+
+    my $pool = SDL_CreateSurfacePool( 32 * 1024 * 1024 );
+    ...;    # every frame
+    my $scratch = SDL_SurfacePoolAcquire( $pool, 256, 64, SDL_PIXELFORMAT_ARGB8888 );
+    ...;
+    SDL_SurfacePoolRelease( $pool, $scratch );
+    ...;
+    my $stats = SDL_GetSurfacePoolStats($pool);
+    printf "%.1f%% hits, %d bytes idle\n", 100 * $stats->hit_rate, $stats->bytes;
+
+Pooled surfaces are ordinary L<SDL3::Surface>s. Released surfaces are reset to
+the state a new one would have (no clip rectangle, color key, RLE or color/alpha
+mods, and the default blend mode) and any pixel views of them are detached.
+Only idle surfaces count towards the budget; when it would be exceeded, the
+surfaces released longest ago are freed.
+
+These functions may be imported by name or with the C<:surfacepool> tag.
+
+=head2 C<SDL_CreateSurfacePool( ... )>
+
+Create a surface pool.
+
+	my $pool = SDL_CreateSurfacePool( 16 * 1024 * 1024 );
+
+Expected parameters include:
+
+=over
+
+=item C<budget> - bytes of idle pixel memory to keep at most; defaults to 64 MiB, C<0> means no limit
+
+=back
+
+Returns a new L<SDL3::SurfacePool> on success or undef on failure.
+
+=head2 C<SDL_DestroySurfacePool( ... )>
+
+Destroy a pool and free its idle surfaces.
+
+	SDL_DestroySurfacePool( $pool );
+
+Surfaces still acquired are not touched; free them with L<< C<SDL_FreeSurface(
+... )>|/C<SDL_FreeSurface( ... )> >>.
+
+=head2 C<SDL_SurfacePoolAcquire( ... )>
+
+Get a surface, reusing an idle one of the same size and format if there is one.
+
+	my $surface = SDL_SurfacePoolAcquire( $pool, 64, 64, SDL_PIXELFORMAT_RGBA8888, 0 );
+
+Expected parameters include:
+
+=over
+
+=item C<w> - the width in pixels
+
+=item C<h> - the height in pixels
+
+=item C<format> - the C<SDL_PixelFormatEnum>
+
+=item C<clear> - zero the pixels of a reused surface; defaults to true. Pass a false value when every pixel will be overwritten anyway
+
+=back
+
+Returns an L<SDL3::Surface> on success or undef on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_SurfacePoolRelease( ... )>
+
+Give a surface back to the pool.
+
+	SDL_SurfacePoolRelease( $pool, $surface );
+
+The surface must not be used (or freed) afterwards. Surfaces made elsewhere may
+be released too. Surfaces that are locked, shared, RLE encoded, use
+caller-provided pixels or a palette, or are larger than the whole budget are
+freed instead.
+
+=head2 C<SDL_SurfacePoolTrim( ... )>
+
+Free idle surfaces, oldest first, until no more than C<keep> bytes are held.
+
+	SDL_SurfacePoolTrim( $pool );    # free everything idle
+
+Expected parameters include:
+
+=over
+
+=item C<keep> - bytes of idle memory to keep; defaults to C<0>
+
+=back
+
+=head2 C<SDL_SurfacePoolSetBudget( ... )>
+
+Change the budget, freeing idle surfaces right away if they no longer fit.
+
+	SDL_SurfacePoolSetBudget( $pool, 8 * 1024 * 1024 );
+
+=head2 C<SDL_GetSurfacePoolStats( ... )>
+
+Get a pool's counters.
+
+	my $stats = SDL_GetSurfacePoolStats( $pool );
+
+Returns a L<SDL3::SurfacePoolStats> structure with the following fields:
+
+=over
+
+=item C<hits> - acquires served from an idle surface
+
+=item C<misses> - acquires that created a new surface
+
+=item C<releases> - surfaces kept for reuse
+
+=item C<evictions> - idle surfaces freed to stay within budget
+
+=item C<idle> - surfaces waiting to be reused
+
+=item C<outstanding> - surfaces acquired and not yet released
+
+=item C<bytes> - pixel memory held by idle surfaces
+
+=item C<budget> - the current budget
+
+=item C<hit_rate> - C<hits> divided by all acquires, from C<0> to C<1>
+
+=back
+
+=head1 Image Filters
+
+Blurs, convolutions and resampling for 32-bit surfaces with 8-bit channels. The
+work is split by rows across a pool of worker threads and the inner loops use
+the same SIMD instructions as the L<pixel kernels|/Pixel Kernels>; every kernel
+gives the same pixels on x86.
+
+    my $small = SDL_CreateRGBSurfaceWithFormat( 0, 480, 270, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_ResampleSurface( $photo, $small, SDL_RESAMPLE_LANCZOS3 );
+    SDL_GaussianBlurSurface( $shadow, $shadow, 4 );
+    SDL_ConvolveSurface( $small, $small, [ 0, -1, 0, -1, 5, -1, 0, -1, 0 ] );    # sharpen
+
+Source and destination must have the same pixel format. A surface may be
+filtered onto itself except when resampling. When the format has an alpha
+channel, blurs and resampling work on a premultiplied copy of the source and
+unpremultiply what they write, so the color of transparent pixels never bleeds
+into their neighbours; pass straight (not premultiplied) alpha. Convolution
+uses the color channels as they are. Pixels past the edge of the source are
+treated as copies of the edge.
+
+These functions may be imported by name or with the C<:filter> tag.
+
+=head2 C<SDL_GaussianBlurSurface( ... )>
+
+Blur a surface with a Gaussian.
+
+	SDL_GaussianBlurSurface( $src, $dst, 2.5 );
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to read
+
+=item C<dst> - the L<SDL3::Surface> to write; the same size as C<src>
+
+=item C<sigma> - the standard deviation in pixels
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call C<SDL_GetError( )> for more
+information.
+
+=head2 C<SDL_BoxBlurSurface( ... )>
+
+Replace each pixel with the average of the square around it.
+
+	SDL_BoxBlurSurface( $src, $dst, 3 );    # 7x7 average
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to read
+
+=item C<dst> - the L<SDL3::Surface> to write; the same size as C<src>
+
+=item C<radius> - pixels on each side of the center; at least C<1>
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_ConvolveSurface( ... )>
+
+Apply a 3x3 or 5x5 convolution kernel to the color channels. Alpha is copied
+from the source and the color of transparent pixels is used as is, so clear
+it (or premultiply with L<< C<SDL_PremultiplySurfaceAlpha( ...
+)>|/C<SDL_PremultiplySurfaceAlpha( ... )> >>) first if it shouldn't count.
+
+	SDL_ConvolveSurface( $src, $dst, [ -1, -1, -1, -1, 8, -1, -1, -1, -1 ], 1, 128 );
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to read
+
+=item C<dst> - the L<SDL3::Surface> to write; the same size as C<src>
+
+=item C<kernel> - a list of 9 or 25 weights, row by row
+
+=item C<divisor> - each sum is divided by this; defaults to the sum of the weights or C<1> if that is C<0>
+
+=item C<bias> - added after dividing; defaults to C<0>
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_ResampleSurface( ... )>
+
+Scale the whole of one surface onto the whole of another.
+
+	SDL_ResampleSurface( $src, $dst, SDL_RESAMPLE_BICUBIC );
+
+Unlike L<< C<SDL_BlitScaled( ... )>|/C<SDL_BlitScaled( ... )> >>, every source
+pixel contributes when shrinking so fine detail does not alias.
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the L<SDL3::Surface> to read
+
+=item C<dst> - the L<SDL3::Surface> to write
+
+=item C<filter> - an C<SDL_ResampleFilter>; defaults to C<SDL_RESAMPLE_LANCZOS3>
+
+=back
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_SetFilterThreads( ... )>
+
+Set how many threads, including the calling one, the filters use.
+
+	SDL_SetFilterThreads( 1 );    # filter on the calling thread only
+
+Expected parameters include:
+
+=over
+
+=item C<threads> - the thread count; C<0> uses one per CPU, which is the default
+
+=back
+
+Returns C<0> on success or a negative error code if a thread could not be
+started; the threads that did start are kept.
+
+=head2 C<SDL_GetFilterThreads( )>
+
+Get how many threads the filters use.
+
+	my $threads = SDL_GetFilterThreads( );
+
 =head1 Defined Values and Enumerations
 
 These may be imported with the given tag or individually by name.
@@ -1227,6 +2090,22 @@ imported with the C<:YUV_CONVERSION_MODE> tag.
 
 =back
 
+=head2 C<SDL_ResampleFilter>
+
+The filter used by L<< C<SDL_ResampleSurface( ...
+)>|/C<SDL_ResampleSurface( ... )> >>. These values may be imported with the
+C<:resampleFilter> tag.
+
+=over
+
+=item C<SDL_RESAMPLE_BILINEAR> - Linear interpolation; the fastest
+
+=item C<SDL_RESAMPLE_BICUBIC> - Catmull-Rom cubic
+
+=item C<SDL_RESAMPLE_LANCZOS3> - Three-lobed Lanczos; the sharpest
+
+=back
+
 =head1 LICENSE
 
 Copyright (C) Sanko Robinson.
@@ -1242,7 +2121,7 @@ Sanko Robinson E<lt>sanko@cpan.orgE<gt>
 =begin stopwords
 
 colorkey paletted bitmasks blit blits blitted blitting blendmode rect enum
-0xFF000000
+0xFF000000 resampling Catmull Lanczos
 
 =end stopwords
 
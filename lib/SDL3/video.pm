@@ -10,6 +10,8 @@ package SDL3::video {
     use SDL3::rect;
     use SDL3::surface;
     #
+    load_lib('api_wrapper');
+    #
     package SDL3::DisplayMode {
         use SDL3::Utils;
         our $TYPE = has
@@ -351,6 +353,64 @@ package SDL3::video {
         SDL_GL_SwapWindow         => [ ['SDL_Window'] ],
         SDL_GL_DeleteContext      => [ ['SDL_GLContext'] ]
     };
+    #
+    enum SDL_DamageMerge => [
+        qw[SDL_DAMAGE_MERGE_NONE
+            SDL_DAMAGE_MERGE_OVERLAP
+            SDL_DAMAGE_MERGE_AREA]
+    ];
+
+    package SDL3::DamageTracker {
+        use SDL3::Utils;
+        our $TYPE = has();
+    };
+
+    package SDL3::DamageStats {
+        use SDL3::Utils;
+        our $TYPE = has
+            presents     => 'uint32',
+            full_updates => 'uint32',
+            rects        => 'uint32',
+            pixels       => 'uint64';
+    };
+    attach damage => {
+        Bundle_SDL_CreateDamageTracker => [
+            [ 'SDL_Window', 'SDL_DamageMerge', 'float' ],
+            'SDL_DamageTracker' => sub (
+                $inner, $window,
+                $merge     = SDL3::SDL_DAMAGE_MERGE_OVERLAP(),
+                $threshold = 0.5
+            ) {
+                $inner->( $window, $merge, $threshold );
+            }
+        ],
+        Bundle_SDL_DestroyDamageTracker => [ ['SDL_DamageTracker'] ],
+        Bundle_SDL_SetDamageMerge       => [
+            [ 'SDL_DamageTracker', 'SDL_DamageMerge', 'float' ],
+            'int' => sub ( $inner, $dt, $merge, $slack = 1.25 ) {
+                $inner->( $dt, $merge, $slack );
+            }
+        ],
+        Bundle_SDL_SetDamageThreshold => [ [ 'SDL_DamageTracker', 'float' ], 'int' ],
+        Bundle_SDL_DamageAddRect => [ [ 'SDL_DamageTracker', 'int', 'int', 'int', 'int' ] ],
+        Bundle_SDL_DamageNumRects => [ ['SDL_DamageTracker'], 'int' ],
+        Bundle_SDL_DamageFillRect =>
+            [ [ 'SDL_DamageTracker', 'int', 'int', 'int', 'int', 'uint32' ], 'int' ],
+        Bundle_SDL_DamageBlit => [
+            [   'SDL_DamageTracker', 'SDL_Surface', 'int', 'int', 'int', 'int',
+                'int',               'int',         'int', 'int'
+            ],
+            'int'
+        ],
+        Bundle_SDL_DamagePresent  => [ ['SDL_DamageTracker'], 'int' ],
+        Bundle_SDL_GetDamageStats => [
+            [ 'SDL_DamageTracker', 'SDL_DamageStats' ],
+            sub ( $inner, $dt, $stats = SDL3::DamageStats->new ) {
+                $inner->( $dt, $stats );
+                $stats;
+            }
+        ]
+    };
 
 =encoding utf-8
 
@@ -2134,6 +2194,165 @@ Expected parameters include:
 
 =back
 
+=head1 Damage Tracking
+
+When a frame is drawn in software into the window surface,
+L<< C<SDL_UpdateWindowSurface( ... )>|/C<SDL_UpdateWindowSurface( ... )> >>
+pushes the whole framebuffer even if only a score counter changed. A damage
+tracker records the areas touched by fills and blits made through it, merges
+them as they come in, and presents only those with
+L<< C<SDL_UpdateWindowSurfaceRects( ... )>|/C<SDL_UpdateWindowSurfaceRects( ... )> >>.
+
+    my $dt = SDL_CreateDamageTracker( $window, SDL_DAMAGE_MERGE_OVERLAP, 0.4 );
+    while ( !$done ) {
+        SDL_DamageFillRect( $dt, 8, 8, 120, 24, $black );
+        SDL_DamageBlit( $dt, $digits, $score * 12, 0, 12, 16, 10, 12, 0, 0 );
+        SDL_DamagePresent($dt);
+    }
+    SDL_DestroyDamageTracker($dt);
+
+Drawing done some other way can be reported with
+L<< C<SDL_DamageAddRect( ... )>|/C<SDL_DamageAddRect( ... )> >>. Once the
+damage covers more than the threshold fraction of the window, presenting
+falls back to a full update. That also happens on the first present and after
+the window surface changes size.
+
+These functions may be imported by name or with the C<:damage> tag.
+
+=head2 C<SDL_CreateDamageTracker( ... )>
+
+Create a damage tracker for a window's surface.
+
+	my $dt = SDL_CreateDamageTracker( $window );
+
+Expected parameters include:
+
+=over
+
+=item C<window> - the window whose surface is drawn to
+
+=item C<merge> - an L<< C<SDL_DamageMerge>|/C<SDL_DamageMerge> >> heuristic; defaults to C<SDL_DAMAGE_MERGE_OVERLAP>
+
+=item C<threshold> - fraction of the window above which the whole surface is pushed; must be greater than C<0> and at most C<1>, defaults to C<0.5>
+
+=back
+
+Returns a new L<SDL3::DamageTracker> on success or undef on failure, including when C<merge> or
+C<threshold> is out of range.
+
+=head2 C<SDL_DestroyDamageTracker( ... )>
+
+Free a damage tracker.
+
+	SDL_DestroyDamageTracker( $dt );
+
+=head2 C<SDL_SetDamageMerge( ... )>
+
+Change how damaged rects are merged.
+
+	SDL_SetDamageMerge( $dt, SDL_DAMAGE_MERGE_AREA, 1.5 );
+
+Expected parameters include:
+
+=over
+
+=item C<merge> - an L<< C<SDL_DamageMerge>|/C<SDL_DamageMerge> >> heuristic
+
+=item C<slack> - for C<SDL_DAMAGE_MERGE_AREA>, how much larger than the two rects their union may be; defaults to C<1.25>
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_SetDamageThreshold( ... )>
+
+Change the fraction of the window above which the whole surface is pushed.
+
+	SDL_SetDamageThreshold( $dt, 0.25 );
+
+Returns C<0> on success or a negative error code on failure.
+
+=head2 C<SDL_DamageAddRect( ... )>
+
+Report an area that was changed without going through the tracker.
+
+	SDL_DamageAddRect( $dt, 100, 100, 32, 32 );
+
+A width or height of C<0> marks the whole window.
+
+=head2 C<SDL_DamageNumRects( ... )>
+
+Get the number of rects waiting to be presented.
+
+	my $pending = SDL_DamageNumRects( $dt );
+
+Returns C<-1> if the next present is a full update.
+
+=head2 C<SDL_DamageFillRect( ... )>
+
+Fill a rectangle on the window surface and record it.
+
+	SDL_DamageFillRect( $dt, 0, 0, 64, 64, SDL_MapRGB( $surface->format, 255, 0, 0 ) );
+
+Parameters follow C<SDL_FillRect( ... )>. A width or height of C<0> fills the
+whole surface.
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DamageBlit( ... )>
+
+Blit a surface onto the window surface and record the area it wrote.
+
+	SDL_DamageBlit( $dt, $sprite, 0, 0, 0, 0, $x, $y, 0, 0 );          # unscaled
+	SDL_DamageBlit( $dt, $sprite, 0, 0, 0, 0, $x, $y, 64, 64 );        # scaled
+
+Expected parameters include:
+
+=over
+
+=item C<src> - the surface to copy from
+
+=item C<sx>, C<sy>, C<sw>, C<sh> - the source rectangle; a width or height of C<0> means the whole surface
+
+=item C<dx>, C<dy>, C<dw>, C<dh> - where to draw; with a width or height of C<0> the blit is unscaled
+
+=back
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_DamagePresent( ... )>
+
+Copy the damaged areas to the screen and start over.
+
+	SDL_DamagePresent( $dt );
+
+Returns C<0> on success or a negative error code on failure; call
+C<SDL_GetError( )> for more information.
+
+=head2 C<SDL_GetDamageStats( ... )>
+
+Get a damage tracker's counters.
+
+	my $stats = SDL_GetDamageStats( $dt );
+	printf "%d of %d presents were full\n", $stats->full_updates, $stats->presents;
+
+Returns a L<SDL3::DamageStats> structure with the following fields:
+
+=over
+
+=item C<presents> - calls to C<SDL_DamagePresent( ... )>
+
+=item C<full_updates> - presents that pushed the whole surface
+
+=item C<rects> - rects pushed by partial updates
+
+=item C<pixels> - pixels pushed in total
+
+=back
+
 =head1 Defined values and enumerations
 
 These may be imported with their given tags.
@@ -2465,6 +2684,21 @@ Possible return values from the L<SDL_HitTest> callback.
 
 =back
 
+=head2 C<SDL_DamageMerge>
+
+Heuristics for merging damaged rects. These may be imported with the
+C<:damage> tag.
+
+=over
+
+=item C<SDL_DAMAGE_MERGE_NONE> - keep rects apart unless one covers the other
+
+=item C<SDL_DAMAGE_MERGE_OVERLAP> - merge rects that overlap or touch
+
+=item C<SDL_DAMAGE_MERGE_AREA> - merge rects when their union is no more than C<slack> times their combined area
+
+=back
+
 =head1 LICENSE
 
 Copyright (C) Sanko Robinson.
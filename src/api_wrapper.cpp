@@ -1,4 +1,5 @@
 #include <SDL_events.h>
+#include <SDL_image.h>
 #include <SDL_mixer.h>
 #include <SDL_stdinc.h>
 
@@ -6,6 +7,26 @@
 #include <SDL_thread.h>
 #include <SDL_timer.h>
 
+// x86 SIMD kernels are built for SSE2 (the x86-64 baseline) and, through a per-function target,
+// for AVX2. Which one runs is decided at runtime with SDL_HasAVX2.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define BUNDLE_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define BUNDLE_AVX2 1
+#define BUNDLE_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(_MSC_VER)
+#define BUNDLE_AVX2 1
+#define BUNDLE_TARGET_AVX2
+#endif
+#endif
+// NEON is only built when the compiler targets it (always on AArch64) and still gated on
+// SDL_HasNEON at runtime for 32-bit ARM builds.
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BUNDLE_NEON 1
+#endif
+
 #define PERL_NO_GET_CONTEXT
 #include "EXTERN.h"
 #include "perl.h"
@@ -419,3 +440,6980 @@ extern "C" int Bundle_Mix_RegisterEffect(int chan, Mix_EffectFunc_t f, Mix_Effec
         chan, (Mix_EffectFunc_t)(f == (Mix_EffectFunc_t)NULL ? (void *)f : (void *)mix_effect_func),
         (Mix_EffectDone_t)(d == (Mix_EffectDone_t)NULL ? d : mix_effect_done_func), real);
 }
+
+// Scalar fast paths for the 2D renderer. These build their SDL_Rect/SDL_FRect on the C stack so
+// perl never has to allocate an FFI::C struct just to describe a rectangle. A non-positive width
+// or height on a source or destination rect passes NULL (the entire texture or target) along.
+static inline const SDL_Rect *xywh_rect(SDL_Rect *rect, int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return NULL;
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+    return rect;
+}
+static inline const SDL_FRect *xywh_frect(SDL_FRect *rect, float x, float y, float w, float h) {
+    if (w <= 0.0f || h <= 0.0f) return NULL;
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+    return rect;
+}
+extern "C" int Bundle_SDL_RenderDrawRectXYWH(SDL_Renderer *renderer, int x, int y, int w, int h) {
+    SDL_Rect rect = {x, y, w, h};
+    return SDL_RenderDrawRect(renderer, &rect);
+}
+extern "C" int Bundle_SDL_RenderFillRectXYWH(SDL_Renderer *renderer, int x, int y, int w, int h) {
+    SDL_Rect rect = {x, y, w, h};
+    return SDL_RenderFillRect(renderer, &rect);
+}
+extern "C" int Bundle_SDL_RenderFillRectXYWHF(SDL_Renderer *renderer, float x, float y, float w,
+                                              float h) {
+    SDL_FRect rect = {x, y, w, h};
+    return SDL_RenderFillRectF(renderer, &rect);
+}
+extern "C" int Bundle_SDL_RenderCopyXYWH(SDL_Renderer *renderer, SDL_Texture *texture, int sx,
+                                         int sy, int sw, int sh, int dx, int dy, int dw, int dh) {
+    SDL_Rect src, dst;
+    return SDL_RenderCopy(renderer, texture, xywh_rect(&src, sx, sy, sw, sh),
+                          xywh_rect(&dst, dx, dy, dw, dh));
+}
+extern "C" int Bundle_SDL_RenderCopyXYWHF(SDL_Renderer *renderer, SDL_Texture *texture, int sx,
+                                          int sy, int sw, int sh, float dx, float dy, float dw,
+                                          float dh) {
+    SDL_Rect src;
+    SDL_FRect dst;
+    return SDL_RenderCopyF(renderer, texture, xywh_rect(&src, sx, sy, sw, sh),
+                           xywh_frect(&dst, dx, dy, dw, dh));
+}
+
+// Recorded render commands. These are shared by retained layers and the render thread: draw calls
+// are appended to a CommandList from perl and replayed natively later on.
+typedef enum RenderOp
+{
+    RENDER_OP_COLOR,
+    RENDER_OP_BLEND,
+    RENDER_OP_CLEAR,
+    RENDER_OP_FILL,
+    RENDER_OP_RECT,
+    RENDER_OP_LINE,
+    RENDER_OP_COPY,
+    RENDER_OP_LOAD,  // render thread only: create texture slot from a surface
+    RENDER_OP_UNLOAD // render thread only: destroy texture slot
+} RenderOp;
+
+typedef struct RenderCommand
+{
+    RenderOp op;
+    int args[4];     // color (r, g, b, a), blend mode, line (x1, y1, x2, y2), or copy srcrect
+    SDL_Rect bounds; // area touched by the command; unused for state changes
+    SDL_Texture *texture;
+    int slot; // texture slot when commands are replayed on the render thread
+    SDL_bool has_src;
+    SDL_Surface *surface; // RENDER_OP_LOAD
+} RenderCommand;
+
+typedef struct CommandList
+{
+    RenderCommand *commands;
+    int count, capacity;
+} CommandList;
+
+static RenderCommand *command_push(CommandList *list, RenderOp op) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        RenderCommand *commands =
+            (RenderCommand *)SDL_realloc(list->commands, capacity * sizeof(RenderCommand));
+        if (!commands) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        list->commands = commands;
+        list->capacity = capacity;
+    }
+    RenderCommand *cmd = &list->commands[list->count++];
+    SDL_zerop(cmd);
+    cmd->op = op;
+    return cmd;
+}
+
+static RenderCommand *command_push_rect(CommandList *list, RenderOp op, int x, int y, int w,
+                                        int h) {
+    RenderCommand *cmd = command_push(list, op);
+    if (!cmd) return NULL;
+    cmd->bounds.x = x;
+    cmd->bounds.y = y;
+    cmd->bounds.w = w;
+    cmd->bounds.h = h;
+    return cmd;
+}
+
+static RenderCommand *command_push_line(CommandList *list, int x1, int y1, int x2, int y2) {
+    RenderCommand *cmd = command_push_rect(list, RENDER_OP_LINE, SDL_min(x1, x2), SDL_min(y1, y2),
+                                           SDL_abs(x2 - x1) + 1, SDL_abs(y2 - y1) + 1);
+    if (!cmd) return NULL;
+    cmd->args[0] = x1;
+    cmd->args[1] = y1;
+    cmd->args[2] = x2;
+    cmd->args[3] = y2;
+    return cmd;
+}
+
+static RenderCommand *command_push_copy(CommandList *list, int sx, int sy, int sw, int sh, int dx,
+                                        int dy, int dw, int dh) {
+    RenderCommand *cmd = command_push_rect(list, RENDER_OP_COPY, dx, dy, dw, dh);
+    if (!cmd) return NULL;
+    cmd->has_src = (sw > 0 && sh > 0) ? SDL_TRUE : SDL_FALSE;
+    cmd->args[0] = sx;
+    cmd->args[1] = sy;
+    cmd->args[2] = sw;
+    cmd->args[3] = sh;
+    return cmd;
+}
+
+static void command_list_clear(CommandList *list) {
+    for (int i = 0; i < list->count; i++)
+        if (list->commands[i].surface) SDL_FreeSurface(list->commands[i].surface);
+    list->count = 0;
+}
+
+static void command_list_free(CommandList *list) {
+    command_list_clear(list);
+    SDL_free(list->commands);
+    list->commands = NULL;
+    list->capacity = 0;
+}
+
+// Replay a list. Commands that touch nothing inside cull (if given) are skipped. Copies resolve
+// their texture through slots when they were recorded against a render thread.
+static void command_list_replay(SDL_Renderer *renderer, const CommandList *list,
+                                const SDL_Rect *cull, SDL_Texture **slots, int num_slots) {
+    SDL_Rect rect;
+    for (int i = 0; i < list->count; i++) {
+        const RenderCommand *cmd = &list->commands[i];
+        switch (cmd->op) {
+        case RENDER_OP_COLOR:
+            SDL_SetRenderDrawColor(renderer, cmd->args[0], cmd->args[1], cmd->args[2],
+                                   cmd->args[3]);
+            break;
+        case RENDER_OP_BLEND:
+            SDL_SetRenderDrawBlendMode(renderer, (SDL_BlendMode)cmd->args[0]);
+            break;
+        case RENDER_OP_CLEAR:
+            SDL_RenderClear(renderer);
+            break;
+        case RENDER_OP_LOAD:
+        case RENDER_OP_UNLOAD:
+            break; // Handled by the render thread itself
+        default:
+            if (cull && !SDL_HasIntersection(&cmd->bounds, cull)) break;
+            if (cmd->op == RENDER_OP_FILL)
+                SDL_RenderFillRect(renderer, &cmd->bounds);
+            else if (cmd->op == RENDER_OP_RECT)
+                SDL_RenderDrawRect(renderer, &cmd->bounds);
+            else if (cmd->op == RENDER_OP_LINE)
+                SDL_RenderDrawLine(renderer, cmd->args[0], cmd->args[1], cmd->args[2],
+                                   cmd->args[3]);
+            else if (cmd->op == RENDER_OP_COPY) {
+                SDL_Texture *texture = cmd->texture;
+                if (!texture && cmd->slot > 0 && cmd->slot < num_slots) texture = slots[cmd->slot];
+                if (!texture) break;
+                rect.x = cmd->args[0];
+                rect.y = cmd->args[1];
+                rect.w = cmd->args[2];
+                rect.h = cmd->args[3];
+                SDL_RenderCopy(renderer, texture, cmd->has_src ? &rect : NULL,
+                               cmd->bounds.w > 0 && cmd->bounds.h > 0 ? &cmd->bounds : NULL);
+            }
+        }
+    }
+}
+
+// Retained render layers. Draw calls are recorded into a command list and rasterized into a
+// SDL_TEXTUREACCESS_TARGET texture; compositing the layer is then a single SDL_RenderCopy until
+// part of it is invalidated. Only the dirty rects are cleared and replayed (with the clip rect
+// set) so a small change to a large static layer stays cheap.
+#define LAYER_MAX_DIRTY 16
+
+typedef struct SDL_RenderLayer
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    int w, h;
+    CommandList list;
+    SDL_Rect dirty[LAYER_MAX_DIRTY];
+    int num_dirty;
+    Uint32 redraws;
+} SDL_RenderLayer;
+
+static void layer_invalidate(SDL_RenderLayer *layer, const SDL_Rect *rect) {
+    SDL_Rect full = {0, 0, layer->w, layer->h}, area;
+    if (rect == NULL)
+        area = full;
+    else if (!SDL_IntersectRect(rect, &full, &area))
+        return;
+    for (int i = 0; i < layer->num_dirty; i++) {
+        if (SDL_HasIntersection(&layer->dirty[i], &area)) {
+            SDL_UnionRect(&layer->dirty[i], &area, &layer->dirty[i]);
+            return;
+        }
+    }
+    if (layer->num_dirty == LAYER_MAX_DIRTY) { // Too fragmented; collapse to the bounding rect
+        for (int i = 1; i < layer->num_dirty; i++)
+            SDL_UnionRect(&layer->dirty[0], &layer->dirty[i], &layer->dirty[0]);
+        SDL_UnionRect(&layer->dirty[0], &area, &layer->dirty[0]);
+        layer->num_dirty = 1;
+        return;
+    }
+    layer->dirty[layer->num_dirty++] = area;
+}
+
+static int layer_recorded(SDL_RenderLayer *layer, RenderCommand *cmd) {
+    if (!cmd) return -1;
+    layer_invalidate(layer, &cmd->bounds);
+    return 0;
+}
+
+static void layer_replay(SDL_RenderLayer *layer, const SDL_Rect *clip) {
+    SDL_Renderer *renderer = layer->renderer;
+    SDL_RenderSetClipRect(renderer, clip);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(renderer, clip);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    command_list_replay(renderer, &layer->list, clip, NULL, 0);
+}
+
+extern "C" SDL_RenderLayer *Bundle_SDL_CreateRenderLayer(SDL_Renderer *renderer, int w, int h) {
+    if (!SDL_RenderTargetSupported(renderer)) {
+        SDL_SetError("Renderer does not support render targets");
+        return NULL;
+    }
+    SDL_RenderLayer *layer = (SDL_RenderLayer *)SDL_calloc(1, sizeof(SDL_RenderLayer));
+    if (!layer) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    layer->texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                       SDL_TEXTUREACCESS_TARGET, w, h);
+    if (!layer->texture) {
+        SDL_free(layer);
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(layer->texture, SDL_BLENDMODE_BLEND);
+    layer->renderer = renderer;
+    layer->w = w;
+    layer->h = h;
+    layer_invalidate(layer, NULL);
+    return layer;
+}
+extern "C" void Bundle_SDL_DestroyRenderLayer(SDL_RenderLayer *layer) {
+    if (!layer) return;
+    SDL_DestroyTexture(layer->texture);
+    command_list_free(&layer->list);
+    SDL_free(layer);
+}
+extern "C" SDL_Texture *Bundle_SDL_GetRenderLayerTexture(SDL_RenderLayer *layer) {
+    return layer->texture;
+}
+extern "C" void Bundle_SDL_RenderLayerReset(SDL_RenderLayer *layer) {
+    command_list_clear(&layer->list);
+    layer_invalidate(layer, NULL);
+}
+extern "C" int Bundle_SDL_RenderLayerSetDrawColor(SDL_RenderLayer *layer, Uint8 r, Uint8 g,
+                                                  Uint8 b, Uint8 a) {
+    RenderCommand *cmd = command_push(&layer->list, RENDER_OP_COLOR);
+    if (!cmd) return -1;
+    cmd->args[0] = r;
+    cmd->args[1] = g;
+    cmd->args[2] = b;
+    cmd->args[3] = a;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderLayerSetDrawBlendMode(SDL_RenderLayer *layer, int mode) {
+    RenderCommand *cmd = command_push(&layer->list, RENDER_OP_BLEND);
+    if (!cmd) return -1;
+    cmd->args[0] = mode;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderLayerFillRect(SDL_RenderLayer *layer, int x, int y, int w, int h) {
+    return layer_recorded(layer, command_push_rect(&layer->list, RENDER_OP_FILL, x, y, w, h));
+}
+extern "C" int Bundle_SDL_RenderLayerDrawRect(SDL_RenderLayer *layer, int x, int y, int w, int h) {
+    return layer_recorded(layer, command_push_rect(&layer->list, RENDER_OP_RECT, x, y, w, h));
+}
+extern "C" int Bundle_SDL_RenderLayerDrawLine(SDL_RenderLayer *layer, int x1, int y1, int x2,
+                                              int y2) {
+    return layer_recorded(layer, command_push_line(&layer->list, x1, y1, x2, y2));
+}
+extern "C" int Bundle_SDL_RenderLayerCopy(SDL_RenderLayer *layer, SDL_Texture *texture, int sx,
+                                          int sy, int sw, int sh, int dx, int dy, int dw, int dh) {
+    if (dw <= 0 || dh <= 0) { // Entire layer
+        dx = dy = 0;
+        dw = layer->w;
+        dh = layer->h;
+    }
+    RenderCommand *cmd = command_push_copy(&layer->list, sx, sy, sw, sh, dx, dy, dw, dh);
+    if (!cmd) return -1;
+    cmd->texture = texture;
+    return layer_recorded(layer, cmd);
+}
+extern "C" void Bundle_SDL_RenderLayerInvalidate(SDL_RenderLayer *layer) {
+    layer_invalidate(layer, NULL);
+}
+extern "C" void Bundle_SDL_RenderLayerInvalidateRect(SDL_RenderLayer *layer, int x, int y, int w,
+                                                     int h) {
+    SDL_Rect rect = {x, y, w, h};
+    layer_invalidate(layer, &rect);
+}
+extern "C" SDL_bool Bundle_SDL_RenderLayerIsDirty(SDL_RenderLayer *layer) {
+    return layer->num_dirty ? SDL_TRUE : SDL_FALSE;
+}
+extern "C" Uint32 Bundle_SDL_RenderLayerRedraws(SDL_RenderLayer *layer) {
+    return layer->redraws;
+}
+extern "C" int Bundle_SDL_RenderLayerUpdate(SDL_RenderLayer *layer) {
+    if (!layer->num_dirty) return 0;
+    SDL_Renderer *renderer = layer->renderer;
+    SDL_Texture *target = SDL_GetRenderTarget(renderer);
+    SDL_Rect clip;
+    SDL_bool clipped = SDL_RenderIsClipEnabled(renderer);
+    if (clipped) SDL_RenderGetClipRect(renderer, &clip);
+    Uint8 r, g, b, a;
+    SDL_BlendMode blend;
+    SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+    SDL_GetRenderDrawBlendMode(renderer, &blend);
+    if (SDL_SetRenderTarget(renderer, layer->texture) < 0) return -1;
+    for (int i = 0; i < layer->num_dirty; i++)
+        layer_replay(layer, &layer->dirty[i]);
+    layer->num_dirty = 0;
+    layer->redraws++;
+    SDL_RenderSetClipRect(renderer, NULL);
+    SDL_SetRenderTarget(renderer, target);
+    SDL_RenderSetClipRect(renderer, clipped ? &clip : NULL);
+    SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    SDL_SetRenderDrawBlendMode(renderer, blend);
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderLayerComposite(SDL_RenderLayer *layer, int dx, int dy, int dw,
+                                               int dh) {
+    if (Bundle_SDL_RenderLayerUpdate(layer) < 0) return -1;
+    SDL_Rect dst;
+    return SDL_RenderCopy(layer->renderer, layer->texture, NULL, xywh_rect(&dst, dx, dy, dw, dh));
+}
+
+// Render thread. The SDL_Renderer is created on (and only ever touched by) a native thread. Perl
+// records a frame into one of 2 or 3 command lists and submits it; the lists form a single
+// producer/single consumer ring so no lock is ever held around command data. The semaphores only
+// exist so that either side may sleep: `ready` counts submitted frames and `free` counts lists
+// perl may record into next. Frame N is replayed and presented while perl builds frame N+1. `lock`
+// only guards the stats and lets SDL_RenderThreadFinish( ... ) sleep on `idle`.
+#define RENDER_THREAD_MAX_DEPTH 3
+
+typedef struct SDL_RenderThreadStats
+{
+    int depth;             // number of command lists in the ring
+    int in_flight;         // frames submitted but not yet presented
+    Uint32 submitted;      // frames handed over by perl
+    Uint32 presented;      // frames replayed and presented by the render thread
+    Uint32 stalls;         // submits that had to wait for the render thread to free a list
+    Uint32 last_render_ns; // time spent on the most recently presented frame
+    Uint64 stall_ns;       // total time perl spent waiting in those submits
+    Uint64 render_ns;      // total time spent replaying and presenting
+} SDL_RenderThreadStats;
+
+typedef struct SDL_RenderThread
+{
+    SDL_Window *window;
+    int index;
+    Uint32 flags;
+    SDL_Renderer *renderer; // owned by the render thread
+    SDL_Thread *thread;
+    CommandList lists[RENDER_THREAD_MAX_DEPTH];
+    int depth;
+    int write; // perl side only
+    int read;  // render thread only
+    int next_slot;
+    SDL_Texture **slots; // render thread only
+    int num_slots;
+    SDL_sem *ready, *free, *started;
+    SDL_mutex *lock;
+    SDL_cond *idle; // signalled when in_flight drops to 0
+    SDL_atomic_t quit, in_flight, presented;
+    SDL_RenderThreadStats stats;
+    char error[256];
+} SDL_RenderThread;
+
+static void render_thread_slot(SDL_RenderThread *rt, RenderCommand *cmd) {
+    if (cmd->slot >= rt->num_slots) {
+        int num_slots = SDL_max(cmd->slot + 1, rt->num_slots * 2);
+        SDL_Texture **slots =
+            (SDL_Texture **)SDL_realloc(rt->slots, num_slots * sizeof(SDL_Texture *));
+        if (!slots) {
+            SDL_Log("Render thread failed to grow to %d textures", num_slots);
+            SDL_FreeSurface(cmd->surface);
+            cmd->surface = NULL;
+            return;
+        }
+        SDL_memset(slots + rt->num_slots, 0, (num_slots - rt->num_slots) * sizeof(SDL_Texture *));
+        rt->slots = slots;
+        rt->num_slots = num_slots;
+    }
+    if (cmd->op == RENDER_OP_LOAD) {
+        rt->slots[cmd->slot] = SDL_CreateTextureFromSurface(rt->renderer, cmd->surface);
+        if (!rt->slots[cmd->slot])
+            SDL_Log("Render thread failed to create texture %d: %s", cmd->slot, SDL_GetError());
+        SDL_FreeSurface(cmd->surface);
+        cmd->surface = NULL;
+    }
+    else if (rt->slots[cmd->slot]) {
+        SDL_DestroyTexture(rt->slots[cmd->slot]);
+        rt->slots[cmd->slot] = NULL;
+    }
+}
+
+static int SDLCALL render_thread_main(void *data) {
+    SDL_RenderThread *rt = (SDL_RenderThread *)data;
+    rt->renderer = SDL_CreateRenderer(rt->window, rt->index, rt->flags);
+    if (!rt->renderer) SDL_snprintf(rt->error, sizeof(rt->error), "%s", SDL_GetError());
+    SDL_SemPost(rt->started);
+    if (!rt->renderer) return -1;
+    Uint64 freq = SDL_GetPerformanceFrequency();
+    while (1) {
+        SDL_SemWait(rt->ready);
+        if (SDL_AtomicGet(&rt->quit)) break;
+        CommandList *list = &rt->lists[rt->read];
+        Uint64 start = SDL_GetPerformanceCounter();
+        RenderCommand *cmd = list->commands;
+        for (int i = 0; i < list->count; i++) // Uploads happen before the frame is drawn...
+            if (cmd[i].op == RENDER_OP_LOAD) render_thread_slot(rt, &cmd[i]);
+        command_list_replay(rt->renderer, list, NULL, rt->slots, rt->num_slots);
+        for (int i = 0; i < list->count; i++) // ...and textures are released after
+            if (cmd[i].op == RENDER_OP_UNLOAD) render_thread_slot(rt, &cmd[i]);
+        SDL_RenderPresent(rt->renderer);
+        Uint64 elapsed = (SDL_GetPerformanceCounter() - start) * 1000000000 / freq;
+        rt->read = (rt->read + 1) % rt->depth;
+        SDL_LockMutex(rt->lock);
+        rt->stats.render_ns += elapsed;
+        rt->stats.last_render_ns = (Uint32)elapsed;
+        SDL_AtomicAdd(&rt->presented, 1);
+        if (SDL_AtomicAdd(&rt->in_flight, -1) == 1) SDL_CondBroadcast(rt->idle);
+        SDL_UnlockMutex(rt->lock);
+        SDL_SemPost(rt->free);
+    }
+    for (int i = 0; i < rt->num_slots; i++)
+        if (rt->slots[i]) SDL_DestroyTexture(rt->slots[i]);
+    SDL_free(rt->slots);
+    SDL_DestroyRenderer(rt->renderer);
+    return 0;
+}
+
+extern "C" SDL_RenderThread *Bundle_SDL_CreateRenderThread(SDL_Window *window, int index,
+                                                           Uint32 flags, int depth) {
+    if (depth < 2 || depth > RENDER_THREAD_MAX_DEPTH) {
+        SDL_SetError("Pipeline depth must be 2 or 3; got %d", depth);
+        return NULL;
+    }
+    SDL_RenderThread *rt = (SDL_RenderThread *)SDL_calloc(1, sizeof(SDL_RenderThread));
+    if (!rt) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rt->window = window;
+    rt->index = index;
+    rt->flags = flags;
+    rt->depth = rt->stats.depth = depth;
+    rt->next_slot = 1; // 0 is never a valid texture
+    rt->ready = SDL_CreateSemaphore(0);
+    rt->free = SDL_CreateSemaphore(depth - 1); // perl is already holding the first list
+    rt->started = SDL_CreateSemaphore(0);
+    rt->lock = SDL_CreateMutex();
+    rt->idle = SDL_CreateCond();
+    if (rt->lock && rt->idle)
+        rt->thread = SDL_CreateThread(render_thread_main, "SDL3::RenderThread", rt);
+    if (rt->thread) {
+        SDL_SemWait(rt->started);
+        if (rt->renderer) return rt;
+        SDL_WaitThread(rt->thread, NULL);
+        SDL_SetError("%s", rt->error);
+    }
+    SDL_DestroySemaphore(rt->ready);
+    SDL_DestroySemaphore(rt->free);
+    SDL_DestroySemaphore(rt->started);
+    if (rt->lock) SDL_DestroyMutex(rt->lock);
+    if (rt->idle) SDL_DestroyCond(rt->idle);
+    SDL_free(rt);
+    return NULL;
+}
+extern "C" void Bundle_SDL_DestroyRenderThread(SDL_RenderThread *rt) {
+    if (!rt) return;
+    SDL_AtomicSet(&rt->quit, 1);
+    SDL_SemPost(rt->ready);
+    SDL_WaitThread(rt->thread, NULL);
+    for (int i = 0; i < rt->depth; i++)
+        command_list_free(&rt->lists[i]);
+    SDL_DestroySemaphore(rt->ready);
+    SDL_DestroySemaphore(rt->free);
+    SDL_DestroySemaphore(rt->started);
+    SDL_DestroyMutex(rt->lock);
+    SDL_DestroyCond(rt->idle);
+    SDL_free(rt);
+}
+extern "C" int Bundle_SDL_RenderThreadSubmit(SDL_RenderThread *rt) {
+    SDL_LockMutex(rt->lock);
+    SDL_AtomicAdd(&rt->in_flight, 1);
+    rt->stats.submitted++;
+    SDL_UnlockMutex(rt->lock);
+    SDL_SemPost(rt->ready);
+    if (SDL_SemTryWait(rt->free) != 0) { // Render thread is behind; wait for a list to come back
+        Uint64 start = SDL_GetPerformanceCounter();
+        if (SDL_SemWait(rt->free) < 0) return -1;
+        Uint64 elapsed =
+            (SDL_GetPerformanceCounter() - start) * 1000000000 / SDL_GetPerformanceFrequency();
+        SDL_LockMutex(rt->lock);
+        rt->stats.stalls++;
+        rt->stats.stall_ns += elapsed;
+        SDL_UnlockMutex(rt->lock);
+    }
+    rt->write = (rt->write + 1) % rt->depth;
+    command_list_clear(&rt->lists[rt->write]);
+    return 0;
+}
+extern "C" void Bundle_SDL_RenderThreadFinish(SDL_RenderThread *rt) {
+    // Block until everything submitted so far has been presented
+    SDL_LockMutex(rt->lock);
+    while (SDL_AtomicGet(&rt->in_flight) > 0)
+        SDL_CondWait(rt->idle, rt->lock);
+    SDL_UnlockMutex(rt->lock);
+}
+extern "C" void Bundle_SDL_GetRenderThreadStats(SDL_RenderThread *rt,
+                                                SDL_RenderThreadStats *stats) {
+    SDL_LockMutex(rt->lock);
+    *stats = rt->stats;
+    stats->in_flight = SDL_AtomicGet(&rt->in_flight);
+    stats->presented = SDL_AtomicGet(&rt->presented);
+    SDL_UnlockMutex(rt->lock);
+}
+extern "C" int Bundle_SDL_RenderThreadCreateTexture(SDL_RenderThread *rt, SDL_Surface *surface) {
+    RenderCommand *cmd = command_push(&rt->lists[rt->write], RENDER_OP_LOAD);
+    if (!cmd) return 0;
+    cmd->surface = SDL_DuplicateSurface(surface); // perl is free to reuse or free the original
+    if (!cmd->surface) {
+        rt->lists[rt->write].count--;
+        return 0;
+    }
+    cmd->slot = rt->next_slot++;
+    return cmd->slot;
+}
+// Slots are checked as commands are recorded; the render thread trusts them
+static int render_thread_check_slot(SDL_RenderThread *rt, int slot) {
+    if (slot < 1 || slot >= rt->next_slot)
+        return SDL_SetError("Render thread texture %d was never created", slot);
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderThreadDestroyTexture(SDL_RenderThread *rt, int slot) {
+    if (render_thread_check_slot(rt, slot) < 0) return -1;
+    RenderCommand *cmd = command_push(&rt->lists[rt->write], RENDER_OP_UNLOAD);
+    if (!cmd) return -1;
+    cmd->slot = slot;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderThreadSetDrawColor(SDL_RenderThread *rt, Uint8 r, Uint8 g, Uint8 b,
+                                                   Uint8 a) {
+    RenderCommand *cmd = command_push(&rt->lists[rt->write], RENDER_OP_COLOR);
+    if (!cmd) return -1;
+    cmd->args[0] = r;
+    cmd->args[1] = g;
+    cmd->args[2] = b;
+    cmd->args[3] = a;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderThreadSetDrawBlendMode(SDL_RenderThread *rt, int mode) {
+    RenderCommand *cmd = command_push(&rt->lists[rt->write], RENDER_OP_BLEND);
+    if (!cmd) return -1;
+    cmd->args[0] = mode;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderThreadClear(SDL_RenderThread *rt) {
+    return command_push(&rt->lists[rt->write], RENDER_OP_CLEAR) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_RenderThreadFillRect(SDL_RenderThread *rt, int x, int y, int w, int h) {
+    return command_push_rect(&rt->lists[rt->write], RENDER_OP_FILL, x, y, w, h) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_RenderThreadDrawRect(SDL_RenderThread *rt, int x, int y, int w, int h) {
+    return command_push_rect(&rt->lists[rt->write], RENDER_OP_RECT, x, y, w, h) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_RenderThreadDrawLine(SDL_RenderThread *rt, int x1, int y1, int x2,
+                                               int y2) {
+    return command_push_line(&rt->lists[rt->write], x1, y1, x2, y2) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_RenderThreadCopy(SDL_RenderThread *rt, int slot, int sx, int sy, int sw,
+                                           int sh, int dx, int dy, int dw, int dh) {
+    if (render_thread_check_slot(rt, slot) < 0) return -1;
+    RenderCommand *cmd = command_push_copy(&rt->lists[rt->write], sx, sy, sw, sh, dx, dy, dw, dh);
+    if (!cmd) return -1;
+    cmd->slot = slot;
+    return 0;
+}
+
+// Round-robin streaming textures. Pixels are copied from a packed perl scalar (or any native
+// buffer) into a system memory shadow of the frame and from there into the next of 2 or 3
+// SDL_TEXTUREACCESS_STREAMING textures with SDL_LockTexture, so an update never waits on the
+// texture the GPU is still drawing from. Each texture remembers the area that changed since it was
+// last written so partial updates stay partial and every texture still ends up complete.
+#define STREAMING_TEXTURE_MAX 3
+
+typedef struct SDL_StreamingTexture
+{
+    SDL_Texture *textures[STREAMING_TEXTURE_MAX];
+    SDL_Rect pending[STREAMING_TEXTURE_MAX]; // damage not yet copied into each texture
+    int count, current;
+    int w, h, bpp;
+    Uint8 *shadow;
+    int shadow_pitch;
+} SDL_StreamingTexture;
+
+extern "C" void Bundle_SDL_DestroyStreamingTexture(SDL_StreamingTexture *st) {
+    if (!st) return;
+    for (int i = 0; i < st->count; i++)
+        if (st->textures[i]) SDL_DestroyTexture(st->textures[i]);
+    SDL_free(st->shadow);
+    SDL_free(st);
+}
+extern "C" SDL_StreamingTexture *Bundle_SDL_CreateStreamingTexture(SDL_Renderer *renderer,
+                                                                   Uint32 format, int w, int h,
+                                                                   int count) {
+    if (count < 1 || count > STREAMING_TEXTURE_MAX) {
+        SDL_SetError("Texture count must be between 1 and %d; got %d", STREAMING_TEXTURE_MAX,
+                     count);
+        return NULL;
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Planar formats are not supported; use SDL_UpdateYUVTexture( ... )");
+        return NULL;
+    }
+    SDL_StreamingTexture *st = (SDL_StreamingTexture *)SDL_calloc(1, sizeof(SDL_StreamingTexture));
+    if (!st) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    st->count = count;
+    st->w = w;
+    st->h = h;
+    st->bpp = SDL_BYTESPERPIXEL(format);
+    st->shadow_pitch = w * st->bpp;
+    st->shadow = (Uint8 *)SDL_calloc(h, st->shadow_pitch);
+    if (!st->shadow) {
+        SDL_OutOfMemory();
+        Bundle_SDL_DestroyStreamingTexture(st);
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        st->textures[i] =
+            SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, w, h);
+        if (!st->textures[i]) {
+            Bundle_SDL_DestroyStreamingTexture(st);
+            return NULL;
+        }
+        st->pending[i].w = w; // Everything is stale until the first upload
+        st->pending[i].h = h;
+    }
+    st->current = count - 1; // The first update lands in textures[0]
+    return st;
+}
+extern "C" SDL_Texture *Bundle_SDL_GetStreamingTexture(SDL_StreamingTexture *st) {
+    return st->textures[st->current];
+}
+extern "C" int Bundle_SDL_UpdateStreamingTexture(SDL_StreamingTexture *st, int x, int y, int w,
+                                                 int h, const void *pixels, int pitch,
+                                                 SDL_bool is_pointer, size_t len) {
+    SDL_Rect area = {x, y, w, h};
+    if (w <= 0 || h <= 0) {
+        area.x = area.y = 0;
+        area.w = st->w;
+        area.h = st->h;
+    }
+    else if (x < 0 || y < 0 || x + w > st->w || y + h > st->h)
+        return SDL_SetError("Update rect must lie inside the texture");
+    size_t row = (size_t)area.w * st->bpp;
+    if (pitch <= 0) pitch = (int)row;
+    else if ((size_t)pitch < row)
+        return SDL_SetError("Pitch %d is less than a row of %d bytes", pitch, (int)row);
+    // Native memory can't be measured; a perl buffer can
+    if (!is_pointer && len < (size_t)pitch * (area.h - 1) + row)
+        return SDL_SetError("Pixel buffer is too small: %d bytes for %dx%d with pitch %d",
+                            (int)len, area.w, area.h, pitch);
+    if (!pixels) return SDL_InvalidParamError("pixels");
+    const Uint8 *src = (const Uint8 *)pixels;
+    Uint8 *dst = st->shadow + area.y * st->shadow_pitch + area.x * st->bpp;
+    for (int r = 0; r < area.h; r++)
+        SDL_memcpy(dst + r * st->shadow_pitch, src + (size_t)r * pitch, row);
+    for (int i = 0; i < st->count; i++)
+        SDL_UnionRect(&st->pending[i], &area, &st->pending[i]);
+    int next = (st->current + 1) % st->count;
+    SDL_Rect *stale = &st->pending[next];
+    void *locked;
+    int locked_pitch;
+    if (SDL_LockTexture(st->textures[next], stale, &locked, &locked_pitch) < 0) return -1;
+    row = (size_t)stale->w * st->bpp;
+    src = st->shadow + stale->y * st->shadow_pitch + stale->x * st->bpp;
+    for (int r = 0; r < stale->h; r++)
+        SDL_memcpy((Uint8 *)locked + (size_t)r * locked_pitch, src + r * st->shadow_pitch, row);
+    SDL_UnlockTexture(st->textures[next]);
+    SDL_zerop(stale);
+    st->current = next;
+    return 0;
+}
+
+// Pooled readback. SDL_RenderReadPixels lands in one of a small pool of reusable native buffers
+// and perl gets a handle back right away. Format conversion and PNG encoding (IMG_SavePNG_RW) run
+// on a worker thread; the handle completes once that is done. Pixels are handed to perl as a
+// read-only window into the pooled buffer rather than copied.
+#define READBACK_MAX_SLOTS 8
+
+typedef enum ReadbackState
+{
+    READBACK_FREE,
+    READBACK_BUSY, // queued for or being processed by the worker
+    READBACK_READY,
+    READBACK_FAILED
+} ReadbackState;
+
+typedef struct ReadbackSlot
+{
+    ReadbackState state;
+    Uint32 serial;
+    void *pixels;
+    size_t size;
+    int w, h, pitch;
+    char *path; // PNG destination, if any
+} ReadbackSlot;
+
+typedef struct SDL_Readback
+{
+    SDL_Renderer *renderer;
+    Uint32 format;
+    ReadbackSlot slots[READBACK_MAX_SLOTS];
+    int count;
+    Uint32 serial;
+    int queue[READBACK_MAX_SLOTS], head, tail, queued;
+    SDL_mutex *lock;
+    SDL_cond *wake, *done;
+    SDL_Thread *worker;
+    SDL_bool quit;
+} SDL_Readback;
+
+static int readback_slot(SDL_Readback *rb, int handle) {
+    int index = handle & 0xF;
+    if (handle <= 0 || index >= rb->count || rb->slots[index].serial != (Uint32)(handle >> 4)) {
+        SDL_SetError("Invalid or released readback handle %d", handle);
+        return -1;
+    }
+    return index;
+}
+
+static int SDLCALL readback_worker(void *data) {
+    SDL_Readback *rb = (SDL_Readback *)data;
+    SDL_LockMutex(rb->lock);
+    while (1) {
+        while (!rb->queued && !rb->quit)
+            SDL_CondWait(rb->wake, rb->lock);
+        if (!rb->queued) break; // Asked to quit and nothing left to encode
+        ReadbackSlot *slot = &rb->slots[rb->queue[rb->head]];
+        rb->head = (rb->head + 1) % READBACK_MAX_SLOTS;
+        rb->queued--;
+        SDL_UnlockMutex(rb->lock);
+        ReadbackState state = READBACK_READY;
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(
+            slot->pixels, slot->w, slot->h, SDL_BITSPERPIXEL(rb->format), slot->pitch, rb->format);
+        SDL_RWops *rw = surface ? SDL_RWFromFile(slot->path, "wb") : NULL;
+        if (!rw || IMG_SavePNG_RW(surface, rw, 1) < 0) {
+            SDL_Log("Failed to write %s: %s", slot->path, SDL_GetError());
+            state = READBACK_FAILED;
+        }
+        if (surface) SDL_FreeSurface(surface);
+        SDL_LockMutex(rb->lock);
+        SDL_free(slot->path);
+        slot->path = NULL;
+        slot->state = state;
+        SDL_CondBroadcast(rb->done);
+    }
+    SDL_UnlockMutex(rb->lock);
+    return 0;
+}
+
+extern "C" SDL_Readback *Bundle_SDL_CreateReadback(SDL_Renderer *renderer, Uint32 format,
+                                                   int count) {
+    if (count < 1 || count > READBACK_MAX_SLOTS) {
+        SDL_SetError("Readback pool size must be between 1 and %d; got %d", READBACK_MAX_SLOTS,
+                     count);
+        return NULL;
+    }
+    SDL_Readback *rb = (SDL_Readback *)SDL_calloc(1, sizeof(SDL_Readback));
+    if (!rb) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    rb->renderer = renderer;
+    rb->format = format;
+    rb->count = count;
+    rb->lock = SDL_CreateMutex();
+    rb->wake = SDL_CreateCond();
+    rb->done = SDL_CreateCond();
+    rb->worker = SDL_CreateThread(readback_worker, "SDL3::Readback", rb);
+    if (!rb->worker) {
+        SDL_DestroyCond(rb->done);
+        SDL_DestroyCond(rb->wake);
+        SDL_DestroyMutex(rb->lock);
+        SDL_free(rb);
+        return NULL;
+    }
+    return rb;
+}
+extern "C" void Bundle_SDL_DestroyReadback(SDL_Readback *rb) {
+    if (!rb) return;
+    SDL_LockMutex(rb->lock);
+    rb->quit = SDL_TRUE; // Pending PNGs are still written
+    SDL_CondSignal(rb->wake);
+    SDL_UnlockMutex(rb->lock);
+    SDL_WaitThread(rb->worker, NULL);
+    for (int i = 0; i < rb->count; i++)
+        SDL_free(rb->slots[i].pixels);
+    SDL_DestroyCond(rb->done);
+    SDL_DestroyCond(rb->wake);
+    SDL_DestroyMutex(rb->lock);
+    SDL_free(rb);
+}
+extern "C" int Bundle_SDL_ReadbackCapture(SDL_Readback *rb, int x, int y, int w, int h,
+                                          const char *path) {
+    SDL_Rect rect, *area = NULL;
+    if (w > 0 && h > 0) {
+        rect.x = x;
+        rect.y = y;
+        rect.w = w;
+        rect.h = h;
+        area = &rect;
+    }
+    else if (SDL_GetRendererOutputSize(rb->renderer, &w, &h) < 0)
+        return -1;
+    int bpp = SDL_BYTESPERPIXEL(rb->format), index = -1;
+    SDL_LockMutex(rb->lock);
+    while (index < 0) {
+        SDL_bool busy = SDL_FALSE;
+        for (int i = 0; i < rb->count && index < 0; i++) {
+            if (rb->slots[i].state == READBACK_FREE) index = i;
+            if (rb->slots[i].state == READBACK_BUSY) busy = SDL_TRUE;
+        }
+        if (index >= 0) break;
+        if (!busy) { // Every buffer is still held by perl
+            SDL_UnlockMutex(rb->lock);
+            return SDL_SetError("No free readback buffers; release a handle first");
+        }
+        SDL_CondWait(rb->done, rb->lock); // Wait for the worker to finish one
+    }
+    ReadbackSlot *slot = &rb->slots[index];
+    slot->state = READBACK_BUSY; // Reserved
+    SDL_UnlockMutex(rb->lock);
+    size_t size = (size_t)w * h * bpp;
+    if (slot->size < size) {
+        void *pixels = SDL_realloc(slot->pixels, size);
+        if (!pixels) {
+            slot->state = READBACK_FREE;
+            SDL_OutOfMemory();
+            return -1;
+        }
+        slot->pixels = pixels;
+        slot->size = size;
+    }
+    slot->w = w;
+    slot->h = h;
+    slot->pitch = w * bpp;
+    if (SDL_RenderReadPixels(rb->renderer, area, rb->format, slot->pixels, slot->pitch) < 0) {
+        slot->state = READBACK_FREE;
+        return -1;
+    }
+    slot->serial = ++rb->serial & 0x7FFFFFF;
+    if (slot->serial == 0) slot->serial = rb->serial = 1;
+    int handle = (int)(slot->serial << 4) | index;
+    SDL_LockMutex(rb->lock);
+    if (path) {
+        slot->path = SDL_strdup(path);
+        rb->queue[rb->tail] = index;
+        rb->tail = (rb->tail + 1) % READBACK_MAX_SLOTS;
+        rb->queued++;
+        SDL_CondSignal(rb->wake);
+    }
+    else
+        slot->state = READBACK_READY;
+    SDL_UnlockMutex(rb->lock);
+    return handle;
+}
+extern "C" int Bundle_SDL_ReadbackPoll(SDL_Readback *rb, int handle, SDL_bool wait) {
+    int index = readback_slot(rb, handle);
+    if (index < 0) return -1;
+    SDL_LockMutex(rb->lock);
+    while (wait && rb->slots[index].state == READBACK_BUSY)
+        SDL_CondWait(rb->done, rb->lock);
+    ReadbackState state = rb->slots[index].state;
+    SDL_UnlockMutex(rb->lock);
+    if (state == READBACK_FAILED) return SDL_SetError("Failed to encode readback %d", handle);
+    return state == READBACK_READY ? 1 : 0;
+}
+extern "C" void *Bundle_SDL_GetReadbackPixels(SDL_Readback *rb, int handle, int *w, int *h,
+                                              int *pitch) {
+    int index = readback_slot(rb, handle);
+    if (index < 0) return NULL;
+    ReadbackSlot *slot = &rb->slots[index];
+    *w = slot->w;
+    *h = slot->h;
+    *pitch = slot->pitch;
+    return slot->pixels;
+}
+extern "C" int Bundle_SDL_ReadbackRelease(SDL_Readback *rb, int handle) {
+    int index = readback_slot(rb, handle);
+    if (index < 0) return -1;
+    Bundle_SDL_ReadbackPoll(rb, handle, SDL_TRUE); // Never hand a buffer back mid-encode
+    SDL_LockMutex(rb->lock);
+    rb->slots[index].state = READBACK_FREE;
+    rb->slots[index].serial = 0;
+    SDL_CondBroadcast(rb->done);
+    SDL_UnlockMutex(rb->lock);
+    return 0;
+}
+
+// Capture sinks. A sink is attached to a renderer and grabs every frame right before it is
+// presented into one of a fixed number of buffers. A background thread converts and writes the
+// frames (a YUV4MPEG2 stream or numbered PNGs) so the render loop never waits on disk I/O; it only
+// waits when every buffer is queued, which is how backpressure is applied.
+typedef enum SDL_CaptureFormat
+{
+    SDL_CAPTURE_Y4M,
+    SDL_CAPTURE_PNG
+} SDL_CaptureFormat;
+
+typedef struct SDL_CaptureStats
+{
+    Uint32 captured; // frames read back from the renderer
+    Uint32 written;  // frames handed to the disk
+    Uint32 failed;   // frames that could not be converted or written
+    Uint32 stalls;   // captures that had to wait for a free buffer
+    Uint64 stall_ns; // total time spent waiting in those captures
+} SDL_CaptureStats;
+
+typedef struct CaptureFrame
+{
+    void *pixels;
+    size_t size;
+    int w, h;
+    Uint32 index;
+} CaptureFrame;
+
+typedef struct SDL_CaptureSink
+{
+    SDL_Renderer *renderer;
+    SDL_CaptureFormat format;
+    char *path; // Y4M file or PNG filename pattern
+    int fps;
+    SDL_RWops *y4m;
+    int y4m_w, y4m_h;
+    Uint8 *yuv;
+    CaptureFrame *frames;
+    int depth;
+    int *queue, head, tail, queued; // frames waiting for the encoder
+    int *unused, num_unused;        // frames free for the next capture
+    SDL_mutex *lock;
+    SDL_cond *wake, *freed;
+    SDL_Thread *encoder;
+    SDL_bool quit;
+    SDL_CaptureStats stats;
+    struct SDL_CaptureSink *next;
+} SDL_CaptureSink;
+
+static SDL_CaptureSink *capture_sinks = NULL; // Only ever touched from perl's thread
+
+// PNG patterns are handed to SDL_snprintf so only a single integer conversion is allowed
+static SDL_bool capture_pattern_ok(const char *pattern) {
+    int conversions = 0;
+    for (const char *p = pattern; *p; p++) {
+        if (*p != '%') continue;
+        if (*++p == '%') continue;
+        while (*p >= '0' && *p <= '9')
+            p++;
+        if (*p != 'd' && *p != 'u') return SDL_FALSE;
+        conversions++;
+    }
+    return conversions == 1 ? SDL_TRUE : SDL_FALSE;
+}
+
+static SDL_bool capture_write(SDL_CaptureSink *sink, CaptureFrame *frame) {
+    if (sink->format == SDL_CAPTURE_PNG) {
+        char path[4096];
+        SDL_snprintf(path, sizeof(path), sink->path, frame->index);
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormatFrom(
+            frame->pixels, frame->w, frame->h, 32, frame->w * 4, SDL_PIXELFORMAT_ARGB8888);
+        if (!surface) return SDL_FALSE;
+        SDL_RWops *rw = SDL_RWFromFile(path, "wb");
+        int ok = rw ? IMG_SavePNG_RW(surface, rw, 1) : -1;
+        SDL_FreeSurface(surface);
+        return ok < 0 ? SDL_FALSE : SDL_TRUE;
+    }
+    if (!sink->y4m) { // The first frame decides the size of the stream; 4:2:0 wants it even
+        sink->y4m_w = frame->w & ~1;
+        sink->y4m_h = frame->h & ~1;
+        sink->yuv = (Uint8 *)SDL_malloc(sink->y4m_w * sink->y4m_h * 3 / 2);
+        sink->y4m = sink->yuv ? SDL_RWFromFile(sink->path, "wb") : NULL;
+        if (!sink->y4m) return SDL_FALSE;
+        char header[128];
+        int len = SDL_snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+                               sink->y4m_w, sink->y4m_h, sink->fps);
+        SDL_RWwrite(sink->y4m, header, 1, len);
+    }
+    if (frame->w < sink->y4m_w || frame->h < sink->y4m_h) {
+        SDL_SetError("Frame is %dx%d but the stream is %dx%d", frame->w, frame->h, sink->y4m_w,
+                     sink->y4m_h);
+        return SDL_FALSE;
+    }
+    if (SDL_ConvertPixels(sink->y4m_w, sink->y4m_h, SDL_PIXELFORMAT_ARGB8888, frame->pixels,
+                          frame->w * 4, SDL_PIXELFORMAT_IYUV, sink->yuv, sink->y4m_w) < 0)
+        return SDL_FALSE;
+    size_t size = sink->y4m_w * sink->y4m_h * 3 / 2;
+    return SDL_RWwrite(sink->y4m, "FRAME\n", 1, 6) == 6 &&
+                   SDL_RWwrite(sink->y4m, sink->yuv, 1, size) == size ?
+               SDL_TRUE :
+               SDL_FALSE;
+}
+
+static int SDLCALL capture_encoder(void *data) {
+    SDL_CaptureSink *sink = (SDL_CaptureSink *)data;
+    SDL_LockMutex(sink->lock);
+    while (1) {
+        while (!sink->queued && !sink->quit)
+            SDL_CondWait(sink->wake, sink->lock);
+        if (!sink->queued) break; // Drained and asked to stop
+        int index = sink->queue[sink->head];
+        sink->head = (sink->head + 1) % sink->depth;
+        sink->queued--;
+        SDL_UnlockMutex(sink->lock);
+        SDL_bool ok = capture_write(sink, &sink->frames[index]);
+        if (!ok)
+            SDL_Log("Capture failed on frame %u: %s", sink->frames[index].index, SDL_GetError());
+        SDL_LockMutex(sink->lock);
+        if (ok)
+            sink->stats.written++;
+        else
+            sink->stats.failed++;
+        sink->unused[sink->num_unused++] = index;
+        SDL_CondSignal(sink->freed);
+    }
+    SDL_UnlockMutex(sink->lock);
+    return 0;
+}
+
+extern "C" void Bundle_SDL_DestroyCaptureSink(SDL_CaptureSink *sink) {
+    if (!sink) return;
+    for (SDL_CaptureSink **p = &capture_sinks; *p; p = &(*p)->next)
+        if (*p == sink) {
+            *p = sink->next;
+            break;
+        }
+    if (sink->encoder) {
+        SDL_LockMutex(sink->lock);
+        sink->quit = SDL_TRUE; // Everything already captured is still written
+        SDL_CondSignal(sink->wake);
+        SDL_UnlockMutex(sink->lock);
+        SDL_WaitThread(sink->encoder, NULL);
+    }
+    if (sink->y4m) SDL_RWclose(sink->y4m);
+    for (int i = 0; sink->frames && i < sink->depth; i++)
+        SDL_free(sink->frames[i].pixels);
+    SDL_free(sink->frames);
+    SDL_free(sink->queue);
+    SDL_free(sink->unused);
+    SDL_free(sink->yuv);
+    SDL_free(sink->path);
+    if (sink->freed) SDL_DestroyCond(sink->freed);
+    if (sink->wake) SDL_DestroyCond(sink->wake);
+    if (sink->lock) SDL_DestroyMutex(sink->lock);
+    SDL_free(sink);
+}
+extern "C" SDL_CaptureSink *Bundle_SDL_CreateCaptureSink(SDL_Renderer *renderer, int format,
+                                                         const char *path, int fps, int depth) {
+    if (format != SDL_CAPTURE_Y4M && format != SDL_CAPTURE_PNG) {
+        SDL_SetError("Unknown capture format %d", format);
+        return NULL;
+    }
+    if (format == SDL_CAPTURE_PNG && !capture_pattern_ok(path)) {
+        SDL_SetError("PNG capture path must contain exactly one %%d style conversion: %s", path);
+        return NULL;
+    }
+    if (depth < 1) depth = 1;
+    SDL_CaptureSink *sink = (SDL_CaptureSink *)SDL_calloc(1, sizeof(SDL_CaptureSink));
+    if (!sink) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    sink->renderer = renderer;
+    sink->format = (SDL_CaptureFormat)format;
+    sink->fps = fps > 0 ? fps : 60;
+    sink->depth = depth;
+    sink->path = SDL_strdup(path);
+    sink->frames = (CaptureFrame *)SDL_calloc(depth, sizeof(CaptureFrame));
+    sink->queue = (int *)SDL_calloc(depth, sizeof(int));
+    sink->unused = (int *)SDL_calloc(depth, sizeof(int));
+    sink->lock = SDL_CreateMutex();
+    sink->wake = SDL_CreateCond();
+    sink->freed = SDL_CreateCond();
+    if (!sink->path || !sink->frames || !sink->queue || !sink->unused) {
+        SDL_OutOfMemory();
+        Bundle_SDL_DestroyCaptureSink(sink);
+        return NULL;
+    }
+    for (int i = 0; i < depth; i++)
+        sink->unused[sink->num_unused++] = i;
+    sink->encoder = SDL_CreateThread(capture_encoder, "SDL3::CaptureSink", sink);
+    if (!sink->encoder) {
+        Bundle_SDL_DestroyCaptureSink(sink);
+        return NULL;
+    }
+    sink->next = capture_sinks;
+    capture_sinks = sink;
+    return sink;
+}
+extern "C" int Bundle_SDL_CaptureSinkGrab(SDL_CaptureSink *sink) {
+    SDL_LockMutex(sink->lock);
+    if (!sink->num_unused) { // Encoder is behind; this is the backpressure
+        Uint64 start = SDL_GetPerformanceCounter();
+        sink->stats.stalls++;
+        while (!sink->num_unused)
+            SDL_CondWait(sink->freed, sink->lock);
+        sink->stats.stall_ns +=
+            (SDL_GetPerformanceCounter() - start) * 1000000000 / SDL_GetPerformanceFrequency();
+    }
+    int index = sink->unused[--sink->num_unused];
+    SDL_UnlockMutex(sink->lock);
+    CaptureFrame *frame = &sink->frames[index];
+    int w, h, ok = SDL_GetRendererOutputSize(sink->renderer, &w, &h);
+    size_t size = (size_t)w * h * 4;
+    if (ok == 0 && frame->size < size) {
+        void *pixels = SDL_realloc(frame->pixels, size);
+        if (pixels) {
+            frame->pixels = pixels;
+            frame->size = size;
+        }
+        else
+            ok = SDL_OutOfMemory();
+    }
+    if (ok == 0)
+        ok = SDL_RenderReadPixels(sink->renderer, NULL, SDL_PIXELFORMAT_ARGB8888, frame->pixels,
+                                  w * 4);
+    SDL_LockMutex(sink->lock);
+    if (ok < 0)
+        sink->unused[sink->num_unused++] = index;
+    else {
+        frame->w = w;
+        frame->h = h;
+        frame->index = sink->stats.captured++;
+        sink->queue[sink->tail] = index;
+        sink->tail = (sink->tail + 1) % sink->depth;
+        sink->queued++;
+        SDL_CondSignal(sink->wake);
+    }
+    SDL_UnlockMutex(sink->lock);
+    return ok < 0 ? -1 : 0;
+}
+extern "C" int Bundle_SDL_CaptureRenderer(SDL_Renderer *renderer) {
+    int ret = 0;
+    for (SDL_CaptureSink *sink = capture_sinks; sink; sink = sink->next)
+        if (sink->renderer == renderer && Bundle_SDL_CaptureSinkGrab(sink) < 0) ret = -1;
+    return ret;
+}
+extern "C" void Bundle_SDL_GetCaptureSinkStats(SDL_CaptureSink *sink, SDL_CaptureStats *stats) {
+    SDL_LockMutex(sink->lock);
+    *stats = sink->stats;
+    SDL_UnlockMutex(sink->lock);
+}
+
+// Tile-parallel software rendering into a 32-bit SDL_Surface. Draw calls are recorded into a
+// CommandList like the render thread's. On present the list is resolved into self-contained
+// items (state changes are folded in and a clear drops everything before it). Each item is
+// binned into the tiles its bounds touch, and a pool of workers sized from SDL_GetCPUCount
+// rasterizes whole tiles. Every pixel sees the same items in the same order, computed with the
+// same integer math, so the output is identical for any thread count or tile size. A single
+// thread skips binning entirely and draws straight into the target.
+#define TILE_MAX_THREADS 64
+
+typedef struct TileItem
+{
+    RenderOp op;     // RENDER_OP_FILL, _RECT, _LINE, or _COPY; clears become fills
+    SDL_Rect bounds; // dst clipped to the target
+    SDL_Rect dst;    // unclipped rect, clipped copy destination, or line (x1, y1, x2, y2)
+    SDL_Rect src;    // copy source, clipped along with dst the way SDL_BlitScaled does
+    Uint8 color[4];
+    Uint32 mapped; // color in the target's format for SDL_BLENDMODE_NONE
+    SDL_BlendMode blend;
+    SDL_Surface *source; // ARGB8888 copy of the texture
+} TileItem;
+
+typedef struct SDL_TileRenderer
+{
+    SDL_Surface *target;
+    int tile_size, tiles_x, tiles_y, num_tiles, threads;
+    CommandList list;
+    SDL_Surface **slots; // textures are ARGB8888 copies made when they are created
+    SDL_BlendMode *slot_blend;
+    int num_slots, next_slot;
+    TileItem *items;
+    int num_items, max_items;
+    int *bins, *bin_start, max_bins; // item indices per tile; bin_start has num_tiles + 1 entries
+    SDL_Thread *workers[TILE_MAX_THREADS];
+    SDL_sem *start, *done;
+    SDL_atomic_t next_tile, quit;
+} SDL_TileRenderer;
+
+static inline Uint8 tile_mul(int a, int b) { // round(a * b / 255) without a division
+    int t = a * b + 128;
+    return (Uint8)((t + (t >> 8)) >> 8);
+}
+
+static inline Uint32 tile_encode(const SDL_PixelFormat *f, int r, int g, int b, int a) {
+    Uint32 pixel = ((Uint32)r << f->Rshift) | ((Uint32)g << f->Gshift) | ((Uint32)b << f->Bshift);
+    return f->Amask ? pixel | ((Uint32)a << f->Ashift) : pixel;
+}
+
+// SDL2's blend equations for 8-bit channels
+static inline Uint32 tile_blend(const SDL_PixelFormat *f, Uint32 dst, int sr, int sg, int sb,
+                                int sa, SDL_BlendMode mode) {
+    int dr = (dst >> f->Rshift) & 0xFF, dg = (dst >> f->Gshift) & 0xFF,
+        db = (dst >> f->Bshift) & 0xFF, da = f->Amask ? (dst >> f->Ashift) & 0xFF : 0xFF;
+    switch (mode) {
+    case SDL_BLENDMODE_BLEND:
+        dr = tile_mul(sr, sa) + tile_mul(dr, 255 - sa);
+        dg = tile_mul(sg, sa) + tile_mul(dg, 255 - sa);
+        db = tile_mul(sb, sa) + tile_mul(db, 255 - sa);
+        da = sa + tile_mul(da, 255 - sa);
+        break;
+    case SDL_BLENDMODE_ADD:
+        dr = SDL_min(dr + tile_mul(sr, sa), 255);
+        dg = SDL_min(dg + tile_mul(sg, sa), 255);
+        db = SDL_min(db + tile_mul(sb, sa), 255);
+        break;
+    case SDL_BLENDMODE_MOD:
+        dr = tile_mul(sr, dr);
+        dg = tile_mul(sg, dg);
+        db = tile_mul(sb, db);
+        break;
+    case SDL_BLENDMODE_MUL:
+        dr = SDL_min(tile_mul(sr, dr) + tile_mul(dr, 255 - sa), 255);
+        dg = SDL_min(tile_mul(sg, dg) + tile_mul(dg, 255 - sa), 255);
+        db = SDL_min(tile_mul(sb, db) + tile_mul(db, 255 - sa), 255);
+        break;
+    default:
+        dr = sr, dg = sg, db = sb, da = sa;
+    }
+    return tile_encode(f, dr, dg, db, da);
+}
+
+static inline Uint32 *tile_row(SDL_Surface *surface, int y) {
+    return (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+}
+
+static void tile_fill(SDL_Surface *target, const TileItem *item, const SDL_Rect *area,
+                      const SDL_Rect *clip) {
+    SDL_Rect rect;
+    if (!SDL_IntersectRect(area, clip, &rect)) return;
+    for (int y = rect.y; y < rect.y + rect.h; y++) {
+        Uint32 *row = tile_row(target, y);
+        if (item->blend == SDL_BLENDMODE_NONE)
+            for (int x = rect.x; x < rect.x + rect.w; x++)
+                row[x] = item->mapped;
+        else
+            for (int x = rect.x; x < rect.x + rect.w; x++)
+                row[x] = tile_blend(target->format, row[x], item->color[0], item->color[1],
+                                    item->color[2], item->color[3], item->blend);
+    }
+}
+
+static void tile_outline(SDL_Surface *target, const TileItem *item, const SDL_Rect *clip) {
+    const SDL_Rect *r = &item->dst; // Every pixel of the outline is touched exactly once
+    SDL_Rect edge = {r->x, r->y, r->w, 1};
+    tile_fill(target, item, &edge, clip);
+    if (r->h < 2) return;
+    edge.y = r->y + r->h - 1;
+    tile_fill(target, item, &edge, clip);
+    if (r->h < 3) return;
+    edge.y = r->y + 1;
+    edge.w = 1;
+    edge.h = r->h - 2;
+    tile_fill(target, item, &edge, clip);
+    if (r->w < 2) return;
+    edge.x = r->x + r->w - 1;
+    tile_fill(target, item, &edge, clip);
+}
+
+static void tile_line(SDL_Surface *target, const TileItem *item, const SDL_Rect *clip) {
+    // Midpoint line in closed form: step k of the major axis lands on the minor axis at
+    // round(k * minor / major). Each tile only walks the steps that fall inside it yet lands on
+    // exactly the pixels a walk over the whole line would.
+    int x1 = item->dst.x, y1 = item->dst.y, adx = SDL_abs(item->dst.w - x1),
+        ady = SDL_abs(item->dst.h - y1), sx = item->dst.w < x1 ? -1 : 1,
+        sy = item->dst.h < y1 ? -1 : 1;
+    SDL_bool steep = ady > adx ? SDL_TRUE : SDL_FALSE;
+    int major = steep ? ady : adx, minor = steep ? adx : ady, origin = steep ? y1 : x1,
+        step = steep ? sy : sx, lo = steep ? clip->y : clip->x,
+        hi = lo + (steep ? clip->h : clip->w) - 1;
+    int k0 = step > 0 ? lo - origin : origin - hi, k1 = step > 0 ? hi - origin : origin - lo;
+    for (int k = SDL_max(k0, 0); k <= SDL_min(k1, major); k++) {
+        int m = major ? (int)(((Sint64)2 * k * minor + major) / (2 * (Sint64)major)) : 0;
+        int x = steep ? x1 + sx * m : x1 + sx * k, y = steep ? y1 + sy * k : y1 + sy * m;
+        if (x < clip->x || x >= clip->x + clip->w || y < clip->y || y >= clip->y + clip->h)
+            continue;
+        Uint32 *pixel = tile_row(target, y) + x;
+        *pixel = item->blend == SDL_BLENDMODE_NONE ?
+                     item->mapped :
+                     tile_blend(target->format, *pixel, item->color[0], item->color[1],
+                                item->color[2], item->color[3], item->blend);
+    }
+}
+
+// One axis of SDL_UpperBlitScaled's clipping: the source span is clipped to the surface and the
+// destination moved to match, then the destination is clipped to the target and the source moved
+// back, all in doubles so nothing is rounded until the end.
+static void tile_clip_axis(double *s0, double *s1, double *d0, double *d1, int size, int limit) {
+    double scale = (*d1 - *d0) / (*s1 - *s0);
+    if (*s0 < 0) {
+        *d0 -= *s0 * scale;
+        *s0 = 0;
+    }
+    if (*s1 > size) {
+        *d1 -= (*s1 - size) * scale;
+        *s1 = size;
+    }
+    if (*d0 < 0) {
+        *s0 -= *d0 / scale;
+        *d0 = 0;
+    }
+    if (*d1 > limit) {
+        *s1 -= (*d1 - limit) / scale;
+        *d1 = limit;
+    }
+}
+
+// The rects SDL_BlitScaled would hand to its stretcher for a copy onto the whole target. src is
+// NULL for the whole source surface.
+static SDL_bool tile_copy_rects(const SDL_Surface *source, const SDL_Rect *src, const SDL_Rect *dst,
+                                const SDL_Rect *target, SDL_Rect *final_src, SDL_Rect *final_dst) {
+    SDL_Rect whole = {0, 0, source->w, source->h};
+    if (!src) src = &whole;
+    if (src->w <= 0 || src->h <= 0 || dst->w <= 0 || dst->h <= 0) return SDL_FALSE;
+    double sx0 = src->x, sy0 = src->y, sx1 = sx0 + src->w, sy1 = sy0 + src->h;
+    double dx0 = dst->x, dy0 = dst->y, dx1 = dx0 + dst->w, dy1 = dy0 + dst->h;
+    tile_clip_axis(&sx0, &sx1, &dx0, &dx1, source->w, target->w);
+    tile_clip_axis(&sy0, &sy1, &dy0, &dy1, source->h, target->h);
+    SDL_Rect s = {(int)SDL_round(sx0), (int)SDL_round(sy0), (int)SDL_round(sx1 - sx0),
+                  (int)SDL_round(sy1 - sy0)};
+    SDL_Rect d = {(int)SDL_round(dx0), (int)SDL_round(dy0), (int)SDL_round(dx1 - dx0),
+                  (int)SDL_round(dy1 - dy0)};
+    if (!SDL_IntersectRect(&whole, &s, final_src) || !SDL_IntersectRect(target, &d, final_dst))
+        return SDL_FALSE;
+    return final_src->w <= 0xFFFF && final_src->h <= 0xFFFF ? SDL_TRUE : SDL_FALSE;
+}
+
+static void tile_copy(SDL_Surface *target, const TileItem *item, const SDL_Rect *clip) {
+    SDL_Rect rect;
+    if (!SDL_IntersectRect(&item->bounds, clip, &rect)) return;
+    const SDL_PixelFormat *f = target->format;
+    SDL_bool raw = f->format == SDL_PIXELFORMAT_ARGB8888 ? SDL_TRUE : SDL_FALSE;
+    // SDL's nearest stretch: 16.16 steps from the middle of the first pixel, taken from absolute
+    // coordinates so where a tile starts makes no difference
+    Uint32 incx = ((Uint32)item->src.w << 16) / item->dst.w;
+    Uint32 incy = ((Uint32)item->src.h << 16) / item->dst.h;
+    for (int y = rect.y; y < rect.y + rect.h; y++) {
+        Uint32 sy = (incy / 2 + (Uint32)(y - item->dst.y) * incy) >> 16;
+        const Uint32 *src = tile_row(item->source, item->src.y + (int)sy) + item->src.x;
+        Uint32 *row = tile_row(target, y);
+        for (int x = rect.x; x < rect.x + rect.w; x++) {
+            Uint32 s = src[(incx / 2 + (Uint32)(x - item->dst.x) * incx) >> 16];
+            if (item->blend == SDL_BLENDMODE_NONE && raw)
+                row[x] = s;
+            else
+                row[x] = tile_blend(f, row[x], (s >> 16) & 0xFF, (s >> 8) & 0xFF, s & 0xFF,
+                                    s >> 24, item->blend);
+        }
+    }
+}
+
+static void tile_draw(SDL_TileRenderer *tr, const TileItem *item, const SDL_Rect *clip) {
+    switch (item->op) {
+    case RENDER_OP_FILL:
+        tile_fill(tr->target, item, &item->bounds, clip);
+        break;
+    case RENDER_OP_RECT:
+        tile_outline(tr->target, item, clip);
+        break;
+    case RENDER_OP_LINE:
+        tile_line(tr->target, item, clip);
+        break;
+    case RENDER_OP_COPY:
+        tile_copy(tr->target, item, clip);
+        break;
+    default:
+        break;
+    }
+}
+
+static void tile_render(SDL_TileRenderer *tr, int tile) {
+    int tx = tile % tr->tiles_x, ty = tile / tr->tiles_x;
+    SDL_Rect clip = {tx * tr->tile_size, ty * tr->tile_size, 0, 0};
+    clip.w = SDL_min(tr->tile_size, tr->target->w - clip.x);
+    clip.h = SDL_min(tr->tile_size, tr->target->h - clip.y);
+    for (int i = tr->bin_start[tile]; i < tr->bin_start[tile + 1]; i++)
+        tile_draw(tr, &tr->items[tr->bins[i]], &clip);
+}
+
+static void tile_drain(SDL_TileRenderer *tr) {
+    int tile;
+    while ((tile = SDL_AtomicAdd(&tr->next_tile, 1)) < tr->num_tiles)
+        tile_render(tr, tile);
+}
+
+static int SDLCALL tile_worker(void *data) {
+    SDL_TileRenderer *tr = (SDL_TileRenderer *)data;
+    while (1) {
+        SDL_SemWait(tr->start);
+        if (SDL_AtomicGet(&tr->quit)) break;
+        tile_drain(tr);
+        SDL_SemPost(tr->done);
+    }
+    return 0;
+}
+
+// Fold the recorded state into self-contained items clipped to the target
+static int tile_resolve(SDL_TileRenderer *tr) {
+    SDL_Surface *target = tr->target;
+    SDL_Rect full = {0, 0, target->w, target->h};
+    Uint8 color[4] = {0, 0, 0, 255};
+    SDL_BlendMode blend = SDL_BLENDMODE_NONE;
+    tr->num_items = 0;
+    for (int i = 0; i < tr->list.count; i++) {
+        const RenderCommand *cmd = &tr->list.commands[i];
+        if (cmd->op == RENDER_OP_COLOR) {
+            for (int c = 0; c < 4; c++)
+                color[c] = (Uint8)cmd->args[c];
+            continue;
+        }
+        if (cmd->op == RENDER_OP_BLEND) {
+            blend = (SDL_BlendMode)cmd->args[0];
+            continue;
+        }
+        if (tr->num_items == tr->max_items) {
+            int max_items = tr->max_items ? tr->max_items * 2 : 64;
+            TileItem *items = (TileItem *)SDL_realloc(tr->items, max_items * sizeof(TileItem));
+            if (!items) return SDL_OutOfMemory();
+            tr->items = items;
+            tr->max_items = max_items;
+        }
+        TileItem *item = &tr->items[tr->num_items];
+        SDL_zerop(item);
+        item->op = cmd->op;
+        item->dst = cmd->bounds;
+        item->blend = blend;
+        SDL_memcpy(item->color, color, sizeof(color));
+        switch (cmd->op) {
+        case RENDER_OP_CLEAR: // Nothing drawn before a clear can show through it
+            tr->num_items = 0;
+            item = &tr->items[0];
+            SDL_zerop(item);
+            item->op = RENDER_OP_FILL;
+            item->dst = full;
+            item->blend = SDL_BLENDMODE_NONE;
+            SDL_memcpy(item->color, color, sizeof(color));
+            break;
+        case RENDER_OP_LINE:
+            item->dst.x = cmd->args[0];
+            item->dst.y = cmd->args[1];
+            item->dst.w = cmd->args[2];
+            item->dst.h = cmd->args[3];
+            break;
+        case RENDER_OP_COPY:
+            if (cmd->slot < 1 || cmd->slot >= tr->num_slots || !tr->slots[cmd->slot]) continue;
+            item->source = tr->slots[cmd->slot];
+            item->blend = tr->slot_blend[cmd->slot];
+            {
+                SDL_Rect src = {cmd->args[0], cmd->args[1], cmd->args[2], cmd->args[3]};
+                SDL_Rect dst = cmd->bounds.w > 0 && cmd->bounds.h > 0 ? cmd->bounds : full;
+                if (!tile_copy_rects(item->source, cmd->has_src ? &src : NULL, &dst, &full,
+                                     &item->src, &item->dst))
+                    continue;
+            }
+            break;
+        default:
+            break;
+        }
+        if (!SDL_IntersectRect(item->op == RENDER_OP_LINE ? &cmd->bounds : &item->dst, &full,
+                               &item->bounds))
+            continue;
+        item->mapped = SDL_MapRGBA(target->format, item->color[0], item->color[1],
+                                   item->color[2], item->color[3]);
+        tr->num_items++;
+    }
+    return 0;
+}
+
+static int tile_bin(SDL_TileRenderer *tr) {
+    int ts = tr->tile_size, total = 0;
+    SDL_memset(tr->bin_start, 0, (tr->num_tiles + 1) * sizeof(int));
+    for (int pass = 0; pass < 2; pass++) { // Count, then fill
+        for (int i = 0; i < tr->num_items; i++) {
+            const SDL_Rect *b = &tr->items[i].bounds;
+            for (int ty = b->y / ts; ty <= (b->y + b->h - 1) / ts; ty++)
+                for (int tx = b->x / ts; tx <= (b->x + b->w - 1) / ts; tx++) {
+                    int tile = ty * tr->tiles_x + tx;
+                    if (pass) tr->bins[tr->bin_start[tile]++] = i;
+                    else tr->bin_start[tile + 1]++;
+                }
+        }
+        if (pass) break;
+        for (int t = 0; t < tr->num_tiles; t++)
+            tr->bin_start[t + 1] += tr->bin_start[t];
+        total = tr->bin_start[tr->num_tiles];
+        if (total > tr->max_bins) {
+            int *bins = (int *)SDL_realloc(tr->bins, total * sizeof(int));
+            if (!bins) return SDL_OutOfMemory();
+            tr->bins = bins;
+            tr->max_bins = total;
+        }
+    }
+    // The fill pass left each bin_start at the end of its bin; shift them back into place
+    SDL_memmove(tr->bin_start + 1, tr->bin_start, tr->num_tiles * sizeof(int));
+    tr->bin_start[0] = 0;
+    return 0;
+}
+
+extern "C" void Bundle_SDL_DestroyTileRenderer(SDL_TileRenderer *tr) {
+    if (!tr) return;
+    SDL_AtomicSet(&tr->quit, 1);
+    for (int i = 0; i < tr->threads; i++)
+        if (tr->workers[i]) SDL_SemPost(tr->start);
+    for (int i = 0; i < tr->threads; i++)
+        if (tr->workers[i]) SDL_WaitThread(tr->workers[i], NULL);
+    for (int i = 0; i < tr->num_slots; i++)
+        if (tr->slots[i]) SDL_FreeSurface(tr->slots[i]);
+    command_list_free(&tr->list);
+    SDL_free(tr->slots);
+    SDL_free(tr->slot_blend);
+    SDL_free(tr->items);
+    SDL_free(tr->bins);
+    SDL_free(tr->bin_start);
+    if (tr->start) SDL_DestroySemaphore(tr->start);
+    if (tr->done) SDL_DestroySemaphore(tr->done);
+    SDL_free(tr);
+}
+extern "C" SDL_TileRenderer *Bundle_SDL_CreateTileRenderer(SDL_Surface *target, int threads,
+                                                           int tile_size) {
+    const SDL_PixelFormat *f = target->format;
+    if (f->BytesPerPixel != 4 || f->Rloss || f->Gloss || f->Bloss) {
+        SDL_SetError("Tile renderer needs a surface with 8-bit channels in 32-bit pixels");
+        return NULL;
+    }
+    if (threads <= 0) threads = SDL_GetCPUCount();
+    threads = SDL_min(SDL_max(threads, 1), TILE_MAX_THREADS);
+    tile_size = tile_size > 0 ? SDL_max(tile_size, 16) : 64;
+    SDL_TileRenderer *tr = (SDL_TileRenderer *)SDL_calloc(1, sizeof(SDL_TileRenderer));
+    if (!tr) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    tr->target = target;
+    tr->threads = threads;
+    tr->tile_size = tile_size;
+    tr->tiles_x = (target->w + tile_size - 1) / tile_size;
+    tr->tiles_y = (target->h + tile_size - 1) / tile_size;
+    tr->num_tiles = tr->tiles_x * tr->tiles_y;
+    tr->next_slot = 1; // 0 is never a valid texture
+    tr->bin_start = (int *)SDL_calloc(tr->num_tiles + 1, sizeof(int));
+    tr->start = SDL_CreateSemaphore(0);
+    tr->done = SDL_CreateSemaphore(0);
+    if (!tr->bin_start || !tr->start || !tr->done) {
+        if (!tr->bin_start) SDL_OutOfMemory();
+        Bundle_SDL_DestroyTileRenderer(tr);
+        return NULL;
+    }
+    for (int i = 1; i < threads; i++) // The calling thread is the first worker
+        if (!(tr->workers[i] = SDL_CreateThread(tile_worker, "SDL3::TileRenderer", tr))) {
+            Bundle_SDL_DestroyTileRenderer(tr);
+            return NULL;
+        }
+    return tr;
+}
+extern "C" int Bundle_SDL_GetTileRendererThreads(SDL_TileRenderer *tr) {
+    return tr->threads;
+}
+extern "C" int Bundle_SDL_TileRendererCreateTexture(SDL_TileRenderer *tr, SDL_Surface *surface) {
+    if (tr->next_slot >= tr->num_slots) {
+        int num_slots = SDL_max(16, tr->num_slots * 2);
+        SDL_Surface **slots =
+            (SDL_Surface **)SDL_realloc(tr->slots, num_slots * sizeof(SDL_Surface *));
+        if (slots) tr->slots = slots;
+        SDL_BlendMode *blend =
+            (SDL_BlendMode *)SDL_realloc(tr->slot_blend, num_slots * sizeof(SDL_BlendMode));
+        if (blend) tr->slot_blend = blend;
+        if (!slots || !blend) {
+            SDL_OutOfMemory();
+            return 0;
+        }
+        SDL_memset(slots + tr->num_slots, 0, (num_slots - tr->num_slots) * sizeof(SDL_Surface *));
+        tr->num_slots = num_slots;
+    }
+    SDL_BlendMode mode;
+    if (SDL_GetSurfaceBlendMode(surface, &mode) < 0) return 0;
+    SDL_Surface *copy = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!copy) return 0;
+    tr->slots[tr->next_slot] = copy;
+    tr->slot_blend[tr->next_slot] = mode;
+    return tr->next_slot++;
+}
+extern "C" int Bundle_SDL_TileRendererDestroyTexture(SDL_TileRenderer *tr, int slot) {
+    if (slot < 1 || slot >= tr->num_slots || !tr->slots[slot])
+        return SDL_SetError("Invalid tile renderer texture %d", slot);
+    SDL_FreeSurface(tr->slots[slot]); // Copies recorded against it are dropped on present
+    tr->slots[slot] = NULL;
+    return 0;
+}
+extern "C" int Bundle_SDL_TileRendererSetDrawColor(SDL_TileRenderer *tr, Uint8 r, Uint8 g, Uint8 b,
+                                                   Uint8 a) {
+    RenderCommand *cmd = command_push(&tr->list, RENDER_OP_COLOR);
+    if (!cmd) return -1;
+    cmd->args[0] = r;
+    cmd->args[1] = g;
+    cmd->args[2] = b;
+    cmd->args[3] = a;
+    return 0;
+}
+extern "C" int Bundle_SDL_TileRendererSetDrawBlendMode(SDL_TileRenderer *tr, int mode) {
+    RenderCommand *cmd = command_push(&tr->list, RENDER_OP_BLEND);
+    if (!cmd) return -1;
+    cmd->args[0] = mode;
+    return 0;
+}
+extern "C" int Bundle_SDL_TileRendererClear(SDL_TileRenderer *tr) {
+    return command_push(&tr->list, RENDER_OP_CLEAR) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_TileRendererFillRect(SDL_TileRenderer *tr, int x, int y, int w, int h) {
+    return command_push_rect(&tr->list, RENDER_OP_FILL, x, y, w, h) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_TileRendererDrawRect(SDL_TileRenderer *tr, int x, int y, int w, int h) {
+    return command_push_rect(&tr->list, RENDER_OP_RECT, x, y, w, h) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_TileRendererDrawLine(SDL_TileRenderer *tr, int x1, int y1, int x2,
+                                               int y2) {
+    return command_push_line(&tr->list, x1, y1, x2, y2) ? 0 : -1;
+}
+extern "C" int Bundle_SDL_TileRendererCopy(SDL_TileRenderer *tr, int slot, int sx, int sy, int sw,
+                                           int sh, int dx, int dy, int dw, int dh) {
+    RenderCommand *cmd = command_push_copy(&tr->list, sx, sy, sw, sh, dx, dy, dw, dh);
+    if (!cmd) return -1;
+    cmd->slot = slot;
+    return 0;
+}
+static void blitcache_invalidate(SDL_Surface *src); // With the blit cache below
+extern "C" int Bundle_SDL_TileRendererPresent(SDL_TileRenderer *tr) {
+    int ret = tile_resolve(tr);
+    if (ret == 0 && tr->threads > 1) ret = tile_bin(tr);
+    if (ret == 0 && SDL_MUSTLOCK(tr->target)) ret = SDL_LockSurface(tr->target);
+    if (ret == 0) {
+        if (tr->threads == 1) {
+            for (int i = 0; i < tr->num_items; i++)
+                tile_draw(tr, &tr->items[i], &tr->items[i].bounds);
+        }
+        else {
+            SDL_AtomicSet(&tr->next_tile, 0);
+            for (int i = 1; i < tr->threads; i++)
+                SDL_SemPost(tr->start);
+            tile_drain(tr);
+            for (int i = 1; i < tr->threads; i++)
+                SDL_SemWait(tr->done);
+        }
+        if (SDL_MUSTLOCK(tr->target)) SDL_UnlockSurface(tr->target);
+        blitcache_invalidate(tr->target);
+    }
+    command_list_clear(&tr->list);
+    return ret;
+}
+
+// Damage tracking for window surfaces. Fills and blits made through the tracker (or reported with
+// SDL_DamageAddRect) are collected as clipped rects, merged as they arrive, and presented with
+// SDL_UpdateWindowSurfaceRects. Once the damage covers more than a threshold of the window (or
+// there are too many rects to be worth it) the whole surface is pushed instead.
+#define DAMAGE_MAX_RECTS 64
+
+typedef enum SDL_DamageMerge
+{
+    SDL_DAMAGE_MERGE_NONE,    // only drop rects that are covered by another
+    SDL_DAMAGE_MERGE_OVERLAP, // merge rects that overlap or touch
+    SDL_DAMAGE_MERGE_AREA     // merge when the union wastes little area (see slack)
+} SDL_DamageMerge;
+
+typedef struct SDL_DamageStats
+{
+    Uint32 presents;     // calls to SDL_DamagePresent
+    Uint32 full_updates; // presents that pushed the whole surface
+    Uint32 rects;        // rects pushed by partial updates
+    Uint64 pixels;       // pixels pushed in total
+} SDL_DamageStats;
+
+typedef struct SDL_DamageTracker
+{
+    SDL_Window *window;
+    SDL_DamageMerge merge;
+    float slack, threshold;
+    SDL_Rect rects[DAMAGE_MAX_RECTS];
+    int num_rects, w, h;
+    SDL_bool full;
+    SDL_DamageStats stats;
+} SDL_DamageTracker;
+
+static inline Sint64 damage_area(const SDL_Rect *r) {
+    return (Sint64)r->w * r->h;
+}
+
+static SDL_bool damage_should_merge(SDL_DamageTracker *dt, const SDL_Rect *a, const SDL_Rect *b) {
+    SDL_Rect both, overlap;
+    SDL_UnionRect(a, b, &both);
+    Sint64 shared = SDL_IntersectRect(a, b, &overlap) ? damage_area(&overlap) : 0;
+    if (shared == damage_area(a) || shared == damage_area(b)) return SDL_TRUE; // One covers all
+    switch (dt->merge) {
+    case SDL_DAMAGE_MERGE_OVERLAP: // Rects that share an edge count as touching
+        return a->x <= b->x + b->w && b->x <= a->x + a->w && a->y <= b->y + b->h &&
+                       b->y <= a->y + a->h ?
+                   SDL_TRUE :
+                   SDL_FALSE;
+    case SDL_DAMAGE_MERGE_AREA:
+        return damage_area(&both) <= dt->slack * (damage_area(a) + damage_area(b) - shared) ?
+                   SDL_TRUE :
+                   SDL_FALSE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+static void damage_add(SDL_DamageTracker *dt, const SDL_Rect *rect) {
+    SDL_Surface *surface = SDL_GetWindowSurface(dt->window);
+    if (!surface) return;
+    SDL_Rect full = {0, 0, surface->w, surface->h}, area;
+    if (dt->full || !SDL_IntersectRect(rect, &full, &area)) return;
+    for (int i = 0; i < dt->num_rects; i++) {
+        if (!damage_should_merge(dt, &dt->rects[i], &area)) continue;
+        SDL_UnionRect(&dt->rects[i], &area, &area); // The union may now reach others; start over
+        dt->rects[i] = dt->rects[--dt->num_rects];
+        i = -1;
+    }
+    if (dt->num_rects == DAMAGE_MAX_RECTS) { // Fold into whichever rect grows the least
+        int best = 0;
+        Sint64 best_growth = -1;
+        for (int i = 0; i < dt->num_rects; i++) {
+            SDL_Rect both;
+            SDL_UnionRect(&dt->rects[i], &area, &both);
+            Sint64 growth = damage_area(&both) - damage_area(&dt->rects[i]);
+            if (best_growth < 0 || growth < best_growth) {
+                best = i;
+                best_growth = growth;
+            }
+        }
+        SDL_UnionRect(&dt->rects[best], &area, &dt->rects[best]);
+        return;
+    }
+    dt->rects[dt->num_rects++] = area;
+}
+
+extern "C" int Bundle_SDL_SetDamageMerge(SDL_DamageTracker *dt, int merge, float slack) {
+    if (merge < SDL_DAMAGE_MERGE_NONE || merge > SDL_DAMAGE_MERGE_AREA)
+        return SDL_SetError("Unknown damage merge heuristic %d", merge);
+    if (slack < 1.0f) return SDL_SetError("Merge slack must be at least 1.0; got %f", slack);
+    dt->merge = (SDL_DamageMerge)merge;
+    dt->slack = slack;
+    return 0;
+}
+extern "C" int Bundle_SDL_SetDamageThreshold(SDL_DamageTracker *dt, float threshold) {
+    if (threshold <= 0.0f || threshold > 1.0f)
+        return SDL_SetError("Damage threshold must be in (0, 1]; got %f", threshold);
+    dt->threshold = threshold;
+    return 0;
+}
+extern "C" SDL_DamageTracker *Bundle_SDL_CreateDamageTracker(SDL_Window *window, int merge,
+                                                             float threshold) {
+    SDL_DamageTracker *dt = (SDL_DamageTracker *)SDL_calloc(1, sizeof(SDL_DamageTracker));
+    if (!dt) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    dt->window = window;
+    dt->full = SDL_TRUE; // Nothing has been shown yet
+    if (Bundle_SDL_SetDamageMerge(dt, merge, 1.25f) < 0 ||
+        Bundle_SDL_SetDamageThreshold(dt, threshold) < 0) {
+        SDL_free(dt);
+        return NULL;
+    }
+    return dt;
+}
+extern "C" void Bundle_SDL_DestroyDamageTracker(SDL_DamageTracker *dt) {
+    SDL_free(dt);
+}
+extern "C" void Bundle_SDL_DamageAddRect(SDL_DamageTracker *dt, int x, int y, int w, int h) {
+    SDL_Rect rect = {x, y, w, h};
+    if (w <= 0 || h <= 0)
+        dt->full = SDL_TRUE;
+    else
+        damage_add(dt, &rect);
+}
+extern "C" int Bundle_SDL_DamageNumRects(SDL_DamageTracker *dt) {
+    return dt->full ? -1 : dt->num_rects;
+}
+extern "C" int Bundle_SDL_DamageFillRect(SDL_DamageTracker *dt, int x, int y, int w, int h,
+                                         Uint32 color) {
+    SDL_Surface *surface = SDL_GetWindowSurface(dt->window);
+    if (!surface) return -1;
+    SDL_Rect rect;
+    if (SDL_FillRect(surface, xywh_rect(&rect, x, y, w, h), color) < 0) return -1;
+    if (w <= 0 || h <= 0)
+        dt->full = SDL_TRUE;
+    else if (SDL_IntersectRect(&rect, &surface->clip_rect, &rect))
+        damage_add(dt, &rect);
+    return 0;
+}
+extern "C" int Bundle_SDL_DamageBlit(SDL_DamageTracker *dt, SDL_Surface *src, int sx, int sy,
+                                     int sw, int sh, int dx, int dy, int dw, int dh) {
+    SDL_Surface *surface = SDL_GetWindowSurface(dt->window);
+    if (!surface) return -1;
+    SDL_Rect srcrect, dstrect = {dx, dy, dw, dh};
+    const SDL_Rect *srcp = xywh_rect(&srcrect, sx, sy, sw, sh);
+    int ret = dw > 0 && dh > 0 ? SDL_BlitScaled(src, srcp, surface, &dstrect) :
+                                 SDL_BlitSurface(src, srcp, surface, &dstrect);
+    if (ret < 0) return ret;
+    if (dstrect.w > 0 && dstrect.h > 0) damage_add(dt, &dstrect); // SDL wrote the clipped area
+    return 0;
+}
+extern "C" int Bundle_SDL_DamagePresent(SDL_DamageTracker *dt) {
+    SDL_Surface *surface = SDL_GetWindowSurface(dt->window);
+    if (!surface) return -1;
+    if (surface->w != dt->w || surface->h != dt->h) { // Resized; the old rects mean nothing
+        dt->w = surface->w;
+        dt->h = surface->h;
+        dt->full = SDL_TRUE;
+    }
+    Sint64 damaged = 0, total = (Sint64)dt->w * dt->h;
+    for (int i = 0; i < dt->num_rects; i++)
+        damaged += damage_area(&dt->rects[i]);
+    int ret = 0;
+    dt->stats.presents++;
+    if (dt->full || damaged > dt->threshold * total) {
+        ret = SDL_UpdateWindowSurface(dt->window);
+        dt->stats.full_updates++;
+        dt->stats.pixels += total;
+    }
+    else if (dt->num_rects) {
+        ret = SDL_UpdateWindowSurfaceRects(dt->window, dt->rects, dt->num_rects);
+        dt->stats.rects += dt->num_rects;
+        dt->stats.pixels += damaged;
+    }
+    dt->num_rects = 0;
+    dt->full = SDL_FALSE;
+    return ret;
+}
+extern "C" void Bundle_SDL_GetDamageStats(SDL_DamageTracker *dt, SDL_DamageStats *stats) {
+    *stats = dt->stats;
+}
+
+// Virtual textures for images larger than the renderer's maximum texture size (or larger than we
+// want in memory at once). The image is cut into square tiles, either held in system memory or
+// streamed from a baked tile file, and a tile only becomes a texture when a draw needs it.
+// Textures beyond the residency budget are evicted least recently drawn first.
+#define VTEX_MAGIC "SDLVTEX1"
+#define VTEX_HEADER 20 // magic, then width, height, and tile size as little endian 32-bit ints
+
+typedef struct SDL_VirtualTextureStats
+{
+    int resident;     // tiles currently held as textures
+    Uint32 drawn;     // tiles drawn by the last SDL_RenderVirtualTexture
+    Uint32 uploads;   // tiles turned into textures so far
+    Uint32 evictions; // textures destroyed to stay within budget
+    Uint64 upload_ns; // total time spent reading and uploading tiles
+} SDL_VirtualTextureStats;
+
+typedef struct VirtualTile
+{
+    SDL_Texture *texture;
+    void *pixels; // ARGB8888, tile_size square; NULL when streamed from a file
+    Uint32 last_used;
+} VirtualTile;
+
+typedef struct SDL_VirtualTexture
+{
+    SDL_Renderer *renderer;
+    int w, h, tile_size, tiles_x, tiles_y, max_resident;
+    VirtualTile *tiles;
+    SDL_RWops *file;
+    char *path;    // for error messages
+    void *scratch; // a tile read back from the file
+    Uint32 frame;
+    SDL_VirtualTextureStats stats;
+} SDL_VirtualTexture;
+
+static inline size_t vtex_tile_bytes(int tile_size) {
+    return (size_t)tile_size * tile_size * 4;
+}
+
+// Copy one tile of a surface into a zero padded ARGB8888 buffer
+static int vtex_carve(SDL_Surface *src, int tile_size, int tx, int ty, void *pixels) {
+    SDL_memset(pixels, 0, vtex_tile_bytes(tile_size));
+    SDL_Surface *tile = SDL_CreateRGBSurfaceWithFormatFrom(pixels, tile_size, tile_size, 32,
+                                                           tile_size * 4, SDL_PIXELFORMAT_ARGB8888);
+    if (!tile) return -1;
+    SDL_Rect rect = {tx * tile_size, ty * tile_size, tile_size, tile_size};
+    int ret = SDL_BlitSurface(src, &rect, tile, NULL);
+    SDL_FreeSurface(tile);
+    return ret;
+}
+
+static SDL_VirtualTexture *vtex_create(SDL_Renderer *renderer, int w, int h, int tile_size,
+                                       int max_resident) {
+    SDL_RendererInfo info;
+    if (SDL_GetRendererInfo(renderer, &info) < 0) return NULL;
+    int max = SDL_min(info.max_texture_width ? info.max_texture_width : 4096,
+                      info.max_texture_height ? info.max_texture_height : 4096);
+    if (tile_size <= 0) tile_size = SDL_min(512, max);
+    if (tile_size > max || tile_size < 16) {
+        SDL_SetError("Tile size %d is outside 16..%d", tile_size, max);
+        return NULL;
+    }
+    SDL_VirtualTexture *vt = (SDL_VirtualTexture *)SDL_calloc(1, sizeof(SDL_VirtualTexture));
+    if (!vt) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    vt->renderer = renderer;
+    vt->w = w;
+    vt->h = h;
+    vt->tile_size = tile_size;
+    vt->tiles_x = (w + tile_size - 1) / tile_size;
+    vt->tiles_y = (h + tile_size - 1) / tile_size;
+    vt->max_resident = max_resident > 0 ? max_resident : 64;
+    vt->tiles = (VirtualTile *)SDL_calloc(vt->tiles_x * vt->tiles_y, sizeof(VirtualTile));
+    if (!vt->tiles) {
+        SDL_OutOfMemory();
+        SDL_free(vt);
+        return NULL;
+    }
+    return vt;
+}
+
+extern "C" void Bundle_SDL_DestroyVirtualTexture(SDL_VirtualTexture *vt) {
+    if (!vt) return;
+    for (int i = 0; i < vt->tiles_x * vt->tiles_y; i++) {
+        if (vt->tiles[i].texture) SDL_DestroyTexture(vt->tiles[i].texture);
+        SDL_free(vt->tiles[i].pixels);
+    }
+    if (vt->file) SDL_RWclose(vt->file);
+    SDL_free(vt->path);
+    SDL_free(vt->scratch);
+    SDL_free(vt->tiles);
+    SDL_free(vt);
+}
+extern "C" SDL_VirtualTexture *Bundle_SDL_CreateVirtualTextureFromSurface(SDL_Renderer *renderer,
+                                                                         SDL_Surface *surface,
+                                                                         int tile_size,
+                                                                         int max_resident) {
+    SDL_VirtualTexture *vt =
+        vtex_create(renderer, surface->w, surface->h, tile_size, max_resident);
+    if (!vt) return NULL;
+    SDL_BlendMode mode;
+    SDL_GetSurfaceBlendMode(surface, &mode);
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE); // Copy alpha rather than blend it
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < vt->tiles_x * vt->tiles_y; i++) {
+        vt->tiles[i].pixels = SDL_malloc(vtex_tile_bytes(vt->tile_size));
+        ret = vt->tiles[i].pixels ?
+                  vtex_carve(surface, vt->tile_size, i % vt->tiles_x, i / vt->tiles_x,
+                             vt->tiles[i].pixels) :
+                  SDL_OutOfMemory();
+    }
+    SDL_SetSurfaceBlendMode(surface, mode);
+    if (ret < 0) {
+        Bundle_SDL_DestroyVirtualTexture(vt);
+        return NULL;
+    }
+    return vt;
+}
+extern "C" SDL_VirtualTexture *Bundle_SDL_CreateVirtualTexture(SDL_Renderer *renderer,
+                                                               const char *path, int tile_size,
+                                                               int max_resident) {
+    SDL_RWops *file = SDL_RWFromFile(path, "rb");
+    if (!file) return NULL;
+    char magic[8];
+    if (SDL_RWread(file, magic, 1, 8) != 8 || SDL_memcmp(magic, VTEX_MAGIC, 8) != 0) {
+        SDL_RWclose(file); // Not baked; decode it once and keep the tiles in memory
+        SDL_Surface *surface = IMG_Load(path);
+        if (!surface) return NULL;
+        SDL_VirtualTexture *vt =
+            Bundle_SDL_CreateVirtualTextureFromSurface(renderer, surface, tile_size, max_resident);
+        SDL_FreeSurface(surface);
+        return vt;
+    }
+    int w = SDL_ReadLE32(file), h = SDL_ReadLE32(file), baked = SDL_ReadLE32(file);
+    SDL_VirtualTexture *vt = NULL;
+    if (w <= 0 || h <= 0 || baked <= 0)
+        SDL_SetError("Corrupt tile file header in %s", path);
+    else if (tile_size > 0 && tile_size != baked)
+        SDL_SetError("%s was baked with %d pixel tiles, not %d", path, baked, tile_size);
+    else if ((vt = vtex_create(renderer, w, h, baked, max_resident))) {
+        Sint64 expect =
+            VTEX_HEADER + (Sint64)vt->tiles_x * vt->tiles_y * vtex_tile_bytes(vt->tile_size);
+        vt->scratch = SDL_malloc(vtex_tile_bytes(vt->tile_size));
+        vt->path = SDL_strdup(path);
+        if (!vt->scratch || !vt->path)
+            SDL_OutOfMemory();
+        else if (SDL_RWsize(file) < expect)
+            SDL_SetError("%s is truncated", path);
+        else {
+            vt->file = file;
+            return vt;
+        }
+        Bundle_SDL_DestroyVirtualTexture(vt);
+    }
+    SDL_RWclose(file);
+    return NULL;
+}
+extern "C" int Bundle_SDL_BakeVirtualTexture(SDL_Surface *surface, const char *path,
+                                             int tile_size) {
+    if (tile_size <= 0) tile_size = 512;
+    if (tile_size < 16) return SDL_SetError("Tile size %d is smaller than 16", tile_size);
+    void *pixels = SDL_malloc(vtex_tile_bytes(tile_size));
+    if (!pixels) return SDL_OutOfMemory();
+    SDL_RWops *file = SDL_RWFromFile(path, "wb");
+    if (!file) {
+        SDL_free(pixels);
+        return -1;
+    }
+    int tiles_x = (surface->w + tile_size - 1) / tile_size,
+        tiles_y = (surface->h + tile_size - 1) / tile_size, ret = 0;
+    SDL_RWwrite(file, VTEX_MAGIC, 1, 8);
+    SDL_WriteLE32(file, surface->w);
+    SDL_WriteLE32(file, surface->h);
+    SDL_WriteLE32(file, tile_size);
+    SDL_BlendMode mode;
+    SDL_GetSurfaceBlendMode(surface, &mode);
+    SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    for (int i = 0; ret == 0 && i < tiles_x * tiles_y; i++) {
+        ret = vtex_carve(surface, tile_size, i % tiles_x, i / tiles_x, pixels);
+        if (ret == 0 && SDL_RWwrite(file, pixels, 1, vtex_tile_bytes(tile_size)) !=
+                            vtex_tile_bytes(tile_size))
+            ret = SDL_SetError("Failed to write %s", path);
+    }
+    SDL_SetSurfaceBlendMode(surface, mode);
+    SDL_RWclose(file);
+    SDL_free(pixels);
+    return ret;
+}
+
+static void vtex_evict(SDL_VirtualTexture *vt) {
+    VirtualTile *oldest = NULL; // Tiles drawn in the current call are never candidates
+    for (int i = 0; i < vt->tiles_x * vt->tiles_y; i++) {
+        VirtualTile *tile = &vt->tiles[i];
+        if (tile->texture && tile->last_used != vt->frame &&
+            (!oldest || tile->last_used < oldest->last_used))
+            oldest = tile;
+    }
+    if (!oldest) return; // Everything resident is on screen; go over budget for now
+    SDL_DestroyTexture(oldest->texture);
+    oldest->texture = NULL;
+    vt->stats.resident--;
+    vt->stats.evictions++;
+}
+
+static SDL_Texture *vtex_tile(SDL_VirtualTexture *vt, int tx, int ty) {
+    VirtualTile *tile = &vt->tiles[ty * vt->tiles_x + tx];
+    tile->last_used = vt->frame;
+    if (tile->texture) return tile->texture;
+    Uint64 start = SDL_GetPerformanceCounter();
+    const void *pixels = tile->pixels;
+    if (!pixels) {
+        size_t bytes = vtex_tile_bytes(vt->tile_size);
+        if (SDL_RWseek(vt->file, VTEX_HEADER + (Sint64)(ty * vt->tiles_x + tx) * bytes,
+                       RW_SEEK_SET) < 0 ||
+            SDL_RWread(vt->file, vt->scratch, 1, bytes) != bytes) {
+            SDL_SetError("Failed to read tile (%d, %d) from %s", tx, ty, vt->path);
+            return NULL;
+        }
+        pixels = vt->scratch;
+    }
+    while (vt->stats.resident >= vt->max_resident) {
+        int resident = vt->stats.resident;
+        vtex_evict(vt);
+        if (vt->stats.resident == resident) break;
+    }
+    int w = SDL_min(vt->tile_size, vt->w - tx * vt->tile_size),
+        h = SDL_min(vt->tile_size, vt->h - ty * vt->tile_size);
+    tile->texture =
+        SDL_CreateTexture(vt->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, w, h);
+    if (!tile->texture) return NULL;
+    SDL_SetTextureBlendMode(tile->texture, SDL_BLENDMODE_BLEND);
+    if (SDL_UpdateTexture(tile->texture, NULL, pixels, vt->tile_size * 4) < 0) {
+        SDL_DestroyTexture(tile->texture);
+        tile->texture = NULL;
+        return NULL;
+    }
+    vt->stats.resident++;
+    vt->stats.uploads++;
+    vt->stats.upload_ns +=
+        (SDL_GetPerformanceCounter() - start) * 1000000000 / SDL_GetPerformanceFrequency();
+    return tile->texture;
+}
+
+extern "C" void Bundle_SDL_GetVirtualTextureSize(SDL_VirtualTexture *vt, int *w, int *h) {
+    *w = vt->w;
+    *h = vt->h;
+}
+extern "C" int Bundle_SDL_RenderVirtualTexture(SDL_VirtualTexture *vt, int vx, int vy, int vw,
+                                               int vh, float dx, float dy, float dw, float dh) {
+    SDL_Rect image = {0, 0, vt->w, vt->h}, view = {vx, vy, vw, vh}, visible;
+    if (vw <= 0 || vh <= 0) view = image;
+    float sx = dw > 0 && dh > 0 ? dw / view.w : 1.0f, sy = dw > 0 && dh > 0 ? dh / view.h : 1.0f;
+    vt->frame++;
+    vt->stats.drawn = 0;
+    if (!SDL_IntersectRect(&view, &image, &visible)) return 0;
+    int ts = vt->tile_size, ret = 0;
+    for (int ty = visible.y / ts; ty <= (visible.y + visible.h - 1) / ts; ty++)
+        for (int tx = visible.x / ts; tx <= (visible.x + visible.w - 1) / ts; tx++) {
+            SDL_Rect bounds = {tx * ts, ty * ts, ts, ts}, part;
+            SDL_IntersectRect(&bounds, &visible, &part);
+            SDL_Texture *texture = vtex_tile(vt, tx, ty);
+            if (!texture) {
+                ret = -1;
+                continue;
+            }
+            SDL_Rect src = {part.x - bounds.x, part.y - bounds.y, part.w, part.h};
+            SDL_FRect dst = {dx + (part.x - view.x) * sx, dy + (part.y - view.y) * sy,
+                             part.w * sx, part.h * sy};
+            if (SDL_RenderCopyF(vt->renderer, texture, &src, &dst) < 0) ret = -1;
+            vt->stats.drawn++;
+        }
+    return ret;
+}
+extern "C" void Bundle_SDL_GetVirtualTextureStats(SDL_VirtualTexture *vt,
+                                                  SDL_VirtualTextureStats *stats) {
+    *stats = vt->stats;
+}
+
+// Texture residency. The manager owns textures created from files or surfaces and keeps their
+// estimated size (from SDL_QueryTexture) under a budget. Entries sit on an intrusive list in
+// draw order; when a load would go over budget the least recently drawn textures are destroyed.
+// Their path or surface is kept so they are reloaded the next time they are drawn.
+typedef struct SDL_TextureManagerStats
+{
+    Uint32 hits;         // draws of a resident texture
+    Uint32 misses;       // draws that had to load the texture first
+    Uint32 evictions;    // textures destroyed to stay within budget
+    Uint32 failures;     // loads that failed
+    int resident;        // textures currently loaded
+    int entries;         // textures known to the manager
+    Uint64 bytes;        // estimated size of the resident textures
+    Uint64 budget;       // the limit for bytes
+    Uint64 load_ns;      // total time spent loading
+    Uint32 last_load_ns; // the most recent load
+    Uint32 max_load_ns;  // the slowest load so far
+} SDL_TextureManagerStats;
+
+typedef struct ManagedTexture
+{
+    char *path;           // either a file...
+    SDL_Surface *surface; // ...or a private copy of a surface
+    SDL_Texture *texture;
+    Uint64 bytes;
+    int prev, next; // draw order; -1 terminates
+} ManagedTexture;
+
+typedef struct SDL_TextureManager
+{
+    SDL_Renderer *renderer;
+    ManagedTexture *entries;
+    int num_entries, max_entries;
+    int newest, oldest; // resident entries only
+    SDL_TextureManagerStats stats;
+} SDL_TextureManager;
+
+static Uint64 texman_bytes(SDL_Texture *texture) {
+    Uint32 format;
+    int w, h;
+    if (SDL_QueryTexture(texture, &format, NULL, &w, &h) < 0) return 0;
+    Uint64 pixels = (Uint64)w * h;
+    if (SDL_ISPIXELFORMAT_FOURCC(format) && SDL_BYTESPERPIXEL(format) == 1)
+        return pixels * 3 / 2; // Planar YUV: a full size luma plane and two quarter size chroma
+    return pixels * SDL_BYTESPERPIXEL(format);
+}
+
+static void texman_unlink(SDL_TextureManager *tm, int index) {
+    ManagedTexture *entry = &tm->entries[index];
+    if (entry->prev >= 0)
+        tm->entries[entry->prev].next = entry->next;
+    else
+        tm->newest = entry->next;
+    if (entry->next >= 0)
+        tm->entries[entry->next].prev = entry->prev;
+    else
+        tm->oldest = entry->prev;
+    entry->prev = entry->next = -1;
+}
+
+static void texman_push(SDL_TextureManager *tm, int index) {
+    ManagedTexture *entry = &tm->entries[index];
+    entry->prev = -1;
+    entry->next = tm->newest;
+    if (tm->newest >= 0) tm->entries[tm->newest].prev = index;
+    tm->newest = index;
+    if (tm->oldest < 0) tm->oldest = index;
+}
+
+static void texman_unload(SDL_TextureManager *tm, int index) {
+    ManagedTexture *entry = &tm->entries[index];
+    if (!entry->texture) return;
+    texman_unlink(tm, index);
+    SDL_DestroyTexture(entry->texture);
+    entry->texture = NULL;
+    tm->stats.bytes -= entry->bytes;
+    tm->stats.resident--;
+}
+
+// Evict from the cold end until bytes more will fit; keep is never evicted. A budget of 0 means
+// no limit.
+static void texman_trim(SDL_TextureManager *tm, Uint64 bytes, int keep) {
+    if (!tm->stats.budget) return;
+    int index = tm->oldest;
+    while (index >= 0 && tm->stats.bytes + bytes > tm->stats.budget) {
+        int prev = tm->entries[index].prev;
+        if (index != keep) {
+            texman_unload(tm, index);
+            tm->stats.evictions++;
+        }
+        index = prev;
+    }
+}
+
+static SDL_Texture *texman_use(SDL_TextureManager *tm, int handle) {
+    if (handle < 1 || handle > tm->num_entries ||
+        (!tm->entries[handle - 1].path && !tm->entries[handle - 1].surface)) {
+        SDL_SetError("Invalid texture manager handle %d", handle);
+        return NULL;
+    }
+    int index = handle - 1;
+    ManagedTexture *entry = &tm->entries[index];
+    if (entry->texture) {
+        tm->stats.hits++;
+        texman_unlink(tm, index);
+        texman_push(tm, index);
+        return entry->texture;
+    }
+    tm->stats.misses++;
+    Uint64 start = SDL_GetPerformanceCounter();
+    // The size isn't known until the texture exists, so trim with the last known estimate first
+    texman_trim(tm, entry->bytes, index);
+    entry->texture = entry->path ? IMG_LoadTexture(tm->renderer, entry->path) :
+                                   SDL_CreateTextureFromSurface(tm->renderer, entry->surface);
+    if (!entry->texture) {
+        tm->stats.failures++;
+        return NULL;
+    }
+    entry->bytes = texman_bytes(entry->texture);
+    texman_trim(tm, entry->bytes, index);
+    texman_push(tm, index);
+    tm->stats.bytes += entry->bytes;
+    tm->stats.resident++;
+    Uint64 elapsed =
+        (SDL_GetPerformanceCounter() - start) * 1000000000 / SDL_GetPerformanceFrequency();
+    tm->stats.load_ns += elapsed;
+    tm->stats.last_load_ns = (Uint32)SDL_min(elapsed, 0xFFFFFFFF);
+    tm->stats.max_load_ns = SDL_max(tm->stats.max_load_ns, tm->stats.last_load_ns);
+    return entry->texture;
+}
+
+static int texman_add(SDL_TextureManager *tm, char *path, SDL_Surface *surface) {
+    if (!path && !surface) return 0;
+    if (tm->num_entries == tm->max_entries) {
+        int max_entries = tm->max_entries ? tm->max_entries * 2 : 64;
+        ManagedTexture *entries =
+            (ManagedTexture *)SDL_realloc(tm->entries, max_entries * sizeof(ManagedTexture));
+        if (!entries) {
+            SDL_free(path);
+            if (surface) SDL_FreeSurface(surface);
+            SDL_OutOfMemory();
+            return 0;
+        }
+        tm->entries = entries;
+        tm->max_entries = max_entries;
+    }
+    ManagedTexture *entry = &tm->entries[tm->num_entries++];
+    SDL_zerop(entry);
+    entry->path = path;
+    entry->surface = surface;
+    entry->prev = entry->next = -1;
+    tm->stats.entries++;
+    return tm->num_entries; // Handles are never reused
+}
+
+extern "C" SDL_TextureManager *Bundle_SDL_CreateTextureManager(SDL_Renderer *renderer,
+                                                               Uint64 budget) {
+    SDL_TextureManager *tm = (SDL_TextureManager *)SDL_calloc(1, sizeof(SDL_TextureManager));
+    if (!tm) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    tm->renderer = renderer;
+    tm->newest = tm->oldest = -1;
+    tm->stats.budget = budget;
+    return tm;
+}
+extern "C" void Bundle_SDL_DestroyTextureManager(SDL_TextureManager *tm) {
+    if (!tm) return;
+    for (int i = 0; i < tm->num_entries; i++) {
+        if (tm->entries[i].texture) SDL_DestroyTexture(tm->entries[i].texture);
+        if (tm->entries[i].surface) SDL_FreeSurface(tm->entries[i].surface);
+        SDL_free(tm->entries[i].path);
+    }
+    SDL_free(tm->entries);
+    SDL_free(tm);
+}
+extern "C" int Bundle_SDL_TextureManagerAddFile(SDL_TextureManager *tm, const char *path) {
+    return texman_add(tm, SDL_strdup(path), NULL);
+}
+extern "C" int Bundle_SDL_TextureManagerAddSurface(SDL_TextureManager *tm, SDL_Surface *surface) {
+    return texman_add(tm, NULL, SDL_DuplicateSurface(surface));
+}
+extern "C" int Bundle_SDL_TextureManagerRemove(SDL_TextureManager *tm, int handle) {
+    if (handle < 1 || handle > tm->num_entries)
+        return SDL_SetError("Invalid texture manager handle %d", handle);
+    ManagedTexture *entry = &tm->entries[handle - 1];
+    if (!entry->path && !entry->surface) return 0;
+    texman_unload(tm, handle - 1);
+    if (entry->surface) SDL_FreeSurface(entry->surface);
+    SDL_free(entry->path);
+    entry->surface = NULL;
+    entry->path = NULL;
+    tm->stats.entries--;
+    return 0;
+}
+extern "C" SDL_Texture *Bundle_SDL_TextureManagerGet(SDL_TextureManager *tm, int handle) {
+    return texman_use(tm, handle);
+}
+extern "C" int Bundle_SDL_TextureManagerCopy(SDL_TextureManager *tm, int handle, int sx, int sy,
+                                             int sw, int sh, int dx, int dy, int dw, int dh) {
+    SDL_Texture *texture = texman_use(tm, handle);
+    if (!texture) return -1;
+    SDL_Rect src, dst;
+    return SDL_RenderCopy(tm->renderer, texture, xywh_rect(&src, sx, sy, sw, sh),
+                          xywh_rect(&dst, dx, dy, dw, dh));
+}
+extern "C" void Bundle_SDL_TextureManagerSetBudget(SDL_TextureManager *tm, Uint64 budget) {
+    tm->stats.budget = budget;
+    texman_trim(tm, 0, -1);
+}
+extern "C" void Bundle_SDL_GetTextureManagerStats(SDL_TextureManager *tm,
+                                                  SDL_TextureManagerStats *stats) {
+    *stats = tm->stats;
+}
+
+// Sprite atlases. Surfaces are collected, then packed with a bottom-left skyline into as few
+// pages as possible, tallest first. Each sprite gets extrude pixels of its own edges around it (so
+// linear filtering never samples a neighbour) plus padding pixels of empty space. Pages are
+// uploaded once and regions are drawn as sub-rects of the page textures. The layout is saved as a
+// small text file next to one PNG per page so startup can load it instead of repacking.
+#define ATLAS_LAYOUT "SDL_Atlas 1"
+
+typedef struct AtlasRegion
+{
+    int page;
+    SDL_Rect rect;
+    char *name;
+    SDL_Surface *pending; // waiting for SDL_AtlasPack
+} AtlasRegion;
+
+typedef struct SkylineNode
+{
+    int x, y, w;
+} SkylineNode;
+
+typedef struct AtlasPage
+{
+    SDL_Surface *surface;
+    SDL_Texture *texture;
+    SkylineNode *skyline;
+    int num_nodes;
+} AtlasPage;
+
+typedef struct SDL_Atlas
+{
+    int w, h, padding, extrude;
+    AtlasRegion *regions;
+    int num_regions, max_regions;
+    AtlasPage *pages;
+    int num_pages;
+    SDL_Renderer *renderer; // set by SDL_AtlasUpload
+} SDL_Atlas;
+
+// Lowest y at which a w wide box starting at node i fits, or -1
+static int skyline_fit(const AtlasPage *page, int i, int w, int h, int page_w, int page_h) {
+    int x = page->skyline[i].x, y = 0;
+    if (x + w > page_w) return -1;
+    for (int left = w; left > 0; i++) {
+        if (i == page->num_nodes) return -1;
+        y = SDL_max(y, page->skyline[i].y);
+        if (y + h > page_h) return -1;
+        left -= page->skyline[i].w;
+    }
+    return y;
+}
+
+static SDL_bool skyline_place(AtlasPage *page, int w, int h, int page_w, int page_h, int *out_x,
+                              int *out_y) {
+    int best = -1, best_y = page_h, best_w = page_w;
+    for (int i = 0; i < page->num_nodes; i++) {
+        int y = skyline_fit(page, i, w, h, page_w, page_h);
+        if (y >= 0 && (y + h < best_y || (y + h == best_y && page->skyline[i].w < best_w))) {
+            best = i;
+            best_y = y + h;
+            best_w = page->skyline[i].w;
+        }
+    }
+    if (best < 0) return SDL_FALSE;
+    SkylineNode *nodes = (SkylineNode *)SDL_realloc(page->skyline,
+                                                    (page->num_nodes + 1) * sizeof(SkylineNode));
+    if (!nodes) return SDL_FALSE;
+    page->skyline = nodes;
+    *out_x = nodes[best].x;
+    *out_y = best_y - h;
+    SDL_memmove(&nodes[best + 1], &nodes[best], (page->num_nodes - best) * sizeof(SkylineNode));
+    page->num_nodes++;
+    nodes[best].y = best_y;
+    nodes[best].w = w;
+    for (int i = best + 1; i < page->num_nodes; i++) { // Trim what the new box now covers
+        int shrink = nodes[i - 1].x + nodes[i - 1].w - nodes[i].x;
+        if (shrink <= 0) break;
+        nodes[i].x += shrink;
+        nodes[i].w -= shrink;
+        if (nodes[i].w > 0) break;
+        SDL_memmove(&nodes[i], &nodes[i + 1], (page->num_nodes - i - 1) * sizeof(SkylineNode));
+        page->num_nodes--;
+        i--;
+    }
+    for (int i = 0; i < page->num_nodes - 1; i++) // Merge neighbours at the same height
+        if (nodes[i].y == nodes[i + 1].y) {
+            nodes[i].w += nodes[i + 1].w;
+            SDL_memmove(&nodes[i + 1], &nodes[i + 2],
+                        (page->num_nodes - i - 2) * sizeof(SkylineNode));
+            page->num_nodes--;
+            i--;
+        }
+    return SDL_TRUE;
+}
+
+static AtlasPage *atlas_add_page(SDL_Atlas *atlas, SDL_Surface *surface) {
+    AtlasPage *pages =
+        (AtlasPage *)SDL_realloc(atlas->pages, (atlas->num_pages + 1) * sizeof(AtlasPage));
+    if (!pages) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->pages = pages;
+    AtlasPage *page = &pages[atlas->num_pages];
+    SDL_zerop(page);
+    page->surface = surface ? surface :
+                              SDL_CreateRGBSurfaceWithFormat(0, atlas->w, atlas->h, 32,
+                                                             SDL_PIXELFORMAT_ARGB8888);
+    page->skyline = (SkylineNode *)SDL_malloc(sizeof(SkylineNode));
+    if (!page->surface || !page->skyline) {
+        if (page->surface && !surface) SDL_FreeSurface(page->surface);
+        SDL_free(page->skyline);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    page->skyline[0].x = page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->w;
+    page->num_nodes = 1;
+    atlas->num_pages++;
+    return page;
+}
+
+// Blit a sprite into its cell and smear its outermost pixels extrude pixels outwards
+static int atlas_blit(SDL_Atlas *atlas, AtlasRegion *region) {
+    SDL_Surface *page = atlas->pages[region->page].surface;
+    SDL_Rect dst = region->rect;
+    SDL_BlendMode mode;
+    SDL_GetSurfaceBlendMode(region->pending, &mode);
+    SDL_SetSurfaceBlendMode(region->pending, SDL_BLENDMODE_NONE);
+    int ret = SDL_BlitSurface(region->pending, NULL, page, &dst);
+    SDL_SetSurfaceBlendMode(region->pending, mode);
+    int e = atlas->extrude, x = region->rect.x, w = region->rect.w;
+    if (ret < 0 || !e) return ret;
+    for (int y = region->rect.y; y < region->rect.y + region->rect.h; y++) {
+        Uint32 *row = tile_row(page, y);
+        for (int i = 1; i <= e; i++) {
+            row[x - i] = row[x];
+            row[x + w - 1 + i] = row[x + w - 1];
+        }
+    }
+    size_t span = (w + 2 * e) * sizeof(Uint32);
+    for (int i = 1; i <= e; i++) {
+        SDL_memcpy(tile_row(page, region->rect.y - i) + x - e,
+                   tile_row(page, region->rect.y) + x - e, span);
+        SDL_memcpy(tile_row(page, region->rect.y + region->rect.h - 1 + i) + x - e,
+                   tile_row(page, region->rect.y + region->rect.h - 1) + x - e, span);
+    }
+    return 0;
+}
+
+typedef struct AtlasOrder
+{
+    int index, w, h;
+} AtlasOrder;
+
+static int SDLCALL atlas_taller(const void *a, const void *b) {
+    const AtlasOrder *l = (const AtlasOrder *)a, *r = (const AtlasOrder *)b;
+    if (l->h != r->h) return r->h - l->h;
+    if (l->w != r->w) return r->w - l->w;
+    return l->index - r->index; // Stable, so a layout is reproducible
+}
+
+extern "C" SDL_Atlas *Bundle_SDL_CreateAtlas(int w, int h, int padding, int extrude) {
+    if (w <= 0 || h <= 0 || padding < 0 || extrude < 0) {
+        SDL_SetError("Invalid atlas geometry %dx%d, padding %d, extrude %d", w, h, padding,
+                     extrude);
+        return NULL;
+    }
+    SDL_Atlas *atlas = (SDL_Atlas *)SDL_calloc(1, sizeof(SDL_Atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->w = w;
+    atlas->h = h;
+    atlas->padding = padding;
+    atlas->extrude = extrude;
+    return atlas;
+}
+extern "C" void Bundle_SDL_DestroyAtlas(SDL_Atlas *atlas) {
+    if (!atlas) return;
+    for (int i = 0; i < atlas->num_regions; i++) {
+        if (atlas->regions[i].pending) SDL_FreeSurface(atlas->regions[i].pending);
+        SDL_free(atlas->regions[i].name);
+    }
+    for (int i = 0; i < atlas->num_pages; i++) {
+        if (atlas->pages[i].texture) SDL_DestroyTexture(atlas->pages[i].texture);
+        SDL_FreeSurface(atlas->pages[i].surface);
+        SDL_free(atlas->pages[i].skyline);
+    }
+    SDL_free(atlas->regions);
+    SDL_free(atlas->pages);
+    SDL_free(atlas);
+}
+
+static AtlasRegion *atlas_region(SDL_Atlas *atlas, const char *name) {
+    if (name && (!*name || SDL_strchr(name, '\n'))) {
+        SDL_SetError("Atlas region names must be a single non-empty line");
+        return NULL;
+    }
+    if (atlas->num_regions == atlas->max_regions) {
+        int max_regions = atlas->max_regions ? atlas->max_regions * 2 : 64;
+        AtlasRegion *regions =
+            (AtlasRegion *)SDL_realloc(atlas->regions, max_regions * sizeof(AtlasRegion));
+        if (!regions) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        atlas->regions = regions;
+        atlas->max_regions = max_regions;
+    }
+    AtlasRegion *region = &atlas->regions[atlas->num_regions];
+    SDL_zerop(region);
+    region->page = -1;
+    if (name && !(region->name = SDL_strdup(name))) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->num_regions++;
+    return region;
+}
+
+extern "C" int Bundle_SDL_AtlasAdd(SDL_Atlas *atlas, SDL_Surface *surface, const char *name) {
+    int e = atlas->extrude * 2 + atlas->padding;
+    if (surface->w + e > atlas->w || surface->h + e > atlas->h) {
+        SDL_SetError("A %dx%d sprite does not fit on a %dx%d atlas page", surface->w, surface->h,
+                     atlas->w, atlas->h);
+        return 0;
+    }
+    SDL_Surface *copy = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+    if (!copy) return 0;
+    AtlasRegion *region = atlas_region(atlas, name);
+    if (!region) {
+        SDL_FreeSurface(copy);
+        return 0;
+    }
+    region->pending = copy;
+    region->rect.w = copy->w;
+    region->rect.h = copy->h;
+    return atlas->num_regions;
+}
+extern "C" int Bundle_SDL_AtlasPack(SDL_Atlas *atlas) {
+    int count = 0, e = atlas->extrude, cell = 2 * e + atlas->padding;
+    AtlasOrder *order = (AtlasOrder *)SDL_malloc((atlas->num_regions + 1) * sizeof(AtlasOrder));
+    if (!order) return SDL_OutOfMemory();
+    for (int i = 0; i < atlas->num_regions; i++)
+        if (atlas->regions[i].pending) {
+            order[count].index = i;
+            order[count].w = atlas->regions[i].rect.w;
+            order[count++].h = atlas->regions[i].rect.h;
+        }
+    SDL_qsort(order, count, sizeof(AtlasOrder), atlas_taller);
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < count; i++) {
+        AtlasRegion *region = &atlas->regions[order[i].index];
+        int x, y, page = 0;
+        // Pages loaded from a saved layout have no skyline and never take new sprites
+        while (page < atlas->num_pages &&
+               !(atlas->pages[page].skyline &&
+                 skyline_place(&atlas->pages[page], region->rect.w + cell,
+                               region->rect.h + cell, atlas->w, atlas->h, &x, &y)))
+            page++;
+        if (page == atlas->num_pages &&
+            !(atlas_add_page(atlas, NULL) &&
+              skyline_place(&atlas->pages[page], region->rect.w + cell, region->rect.h + cell,
+                            atlas->w, atlas->h, &x, &y))) {
+            ret = -1;
+            break;
+        }
+        region->page = page;
+        region->rect.x = x + e;
+        region->rect.y = y + e;
+        ret = atlas_blit(atlas, region);
+        SDL_FreeSurface(region->pending);
+        region->pending = NULL;
+        if (atlas->pages[page].texture) { // Uploaded before; it has to be uploaded again
+            SDL_DestroyTexture(atlas->pages[page].texture);
+            atlas->pages[page].texture = NULL;
+        }
+    }
+    SDL_free(order);
+    return ret < 0 ? ret : atlas->num_pages;
+}
+extern "C" int Bundle_SDL_AtlasUpload(SDL_Atlas *atlas, SDL_Renderer *renderer) {
+    atlas->renderer = renderer;
+    for (int i = 0; i < atlas->num_pages; i++) {
+        AtlasPage *page = &atlas->pages[i];
+        if (page->texture) SDL_DestroyTexture(page->texture);
+        page->texture = SDL_CreateTextureFromSurface(renderer, page->surface);
+        if (!page->texture) return -1;
+        SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    }
+    return 0;
+}
+extern "C" int Bundle_SDL_GetAtlasHandle(SDL_Atlas *atlas, const char *name) {
+    for (int i = 0; i < atlas->num_regions; i++)
+        if (atlas->regions[i].name && SDL_strcmp(atlas->regions[i].name, name) == 0) return i + 1;
+    return 0;
+}
+static SDL_Texture *atlas_lookup(SDL_Atlas *atlas, int handle, int *page, SDL_Rect *rect) {
+    *page = -1;
+    if (handle < 1 || handle > atlas->num_regions) {
+        SDL_SetError("Invalid atlas handle %d", handle);
+        return NULL;
+    }
+    AtlasRegion *region = &atlas->regions[handle - 1];
+    *page = region->page;
+    *rect = region->rect;
+    if (region->page < 0) SDL_SetError("Atlas region %d is not packed", handle);
+    return region->page < 0 ? NULL : atlas->pages[region->page].texture;
+}
+extern "C" SDL_Texture *Bundle_SDL_GetAtlasRegion(SDL_Atlas *atlas, int handle, int *page, int *x,
+                                                  int *y, int *w, int *h) {
+    SDL_Rect rect = {0, 0, 0, 0};
+    SDL_Texture *texture = atlas_lookup(atlas, handle, page, &rect);
+    *x = rect.x;
+    *y = rect.y;
+    *w = rect.w;
+    *h = rect.h;
+    return texture;
+}
+extern "C" int Bundle_SDL_AtlasCopy(SDL_Atlas *atlas, int handle, int dx, int dy, int dw, int dh) {
+    int page;
+    SDL_Rect src, dst;
+    SDL_Texture *texture = atlas_lookup(atlas, handle, &page, &src);
+    if (!texture)
+        return page < 0 ? -1 : SDL_SetError("Atlas page %d has not been uploaded", page);
+    return SDL_RenderCopy(atlas->renderer, texture, &src,
+                          xywh_rect(&dst, dx, dy, dw > 0 ? dw : src.w, dh > 0 ? dh : src.h));
+}
+extern "C" int Bundle_SDL_GetAtlasNumPages(SDL_Atlas *atlas) {
+    return atlas->num_pages;
+}
+extern "C" SDL_Surface *Bundle_SDL_GetAtlasPage(SDL_Atlas *atlas, int page) {
+    if (page < 0 || page >= atlas->num_pages) {
+        SDL_SetError("Invalid atlas page %d", page);
+        return NULL;
+    }
+    return atlas->pages[page].surface;
+}
+// Short writes (a full disk, say) must fail the save rather than leave a layout that loads wrong
+static SDL_bool atlas_write(SDL_RWops *file, const char *data, size_t len) {
+    return SDL_RWwrite(file, data, 1, len) == len ? SDL_TRUE : SDL_FALSE;
+}
+extern "C" int Bundle_SDL_SaveAtlas(SDL_Atlas *atlas, const char *path) {
+    char line[4096];
+    if (SDL_snprintf(line, sizeof(line), "%s.%d.png", path, atlas->num_pages) >= (int)sizeof(line))
+        return SDL_SetError("Atlas path is too long: %s", path);
+    SDL_RWops *file = SDL_RWFromFile(path, "wb");
+    if (!file) return -1;
+    int len = SDL_snprintf(line, sizeof(line), "%s\npages %d %d %d %d %d\n", ATLAS_LAYOUT,
+                           atlas->num_pages, atlas->w, atlas->h, atlas->padding, atlas->extrude);
+    SDL_bool ok = atlas_write(file, line, len);
+    for (int i = 0; ok && i < atlas->num_regions; i++) { // Names go straight out; any length
+        const AtlasRegion *r = &atlas->regions[i];
+        const char *name = r->name ? r->name : "";
+        if (SDL_strchr(name, '\n')) {
+            SDL_RWclose(file);
+            return SDL_SetError("Sprite name cannot be saved with a line break: %s", name);
+        }
+        len = SDL_snprintf(line, sizeof(line), "%d %d %d %d %d ", r->page, r->rect.x, r->rect.y,
+                           r->rect.w, r->rect.h);
+        if (!atlas_write(file, line, len) || !atlas_write(file, name, SDL_strlen(name)) ||
+            !atlas_write(file, "\n", 1))
+            ok = SDL_FALSE;
+    }
+    if (SDL_RWclose(file) < 0) ok = SDL_FALSE;
+    if (!ok) return SDL_SetError("Failed to write atlas layout %s", path);
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < atlas->num_pages; i++) {
+        SDL_snprintf(line, sizeof(line), "%s.%d.png", path, i);
+        ret = IMG_SavePNG(atlas->pages[i].surface, line);
+    }
+    return ret;
+}
+extern "C" SDL_Atlas *Bundle_SDL_LoadAtlas(const char *path) {
+    size_t size;
+    char *text = (char *)SDL_LoadFile(path, &size), *line = text, *next;
+    if (!text) return NULL;
+    SDL_Atlas *atlas = NULL;
+    int pages, w, h, padding, extrude, offset = 0;
+    char png[4096];
+    if (SDL_strncmp(text, ATLAS_LAYOUT "\n", sizeof(ATLAS_LAYOUT)) != 0 ||
+        SDL_sscanf(text + sizeof(ATLAS_LAYOUT), "pages %d %d %d %d %d\n%n", &pages, &w, &h,
+                   &padding, &extrude, &offset) != 5 ||
+        !offset || pages < 0) {
+        SDL_SetError("%s is not an atlas layout", path);
+        goto fail;
+    }
+    if (!(atlas = Bundle_SDL_CreateAtlas(w, h, padding, extrude))) goto fail;
+    for (int i = 0; i < pages; i++) {
+        SDL_snprintf(png, sizeof(png), "%s.%d.png", path, i);
+        SDL_Surface *surface = IMG_Load(png), *page;
+        if (!surface) goto fail;
+        page = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(surface);
+        if (!page || !atlas_add_page(atlas, page)) {
+            if (page) SDL_FreeSurface(page);
+            goto fail;
+        }
+        SDL_free(atlas->pages[i].skyline); // Already full as far as we know
+        atlas->pages[i].skyline = NULL;
+    }
+    for (line = text + sizeof(ATLAS_LAYOUT) + offset; line < text + size && *line; line = next) {
+        next = SDL_strchr(line, '\n');
+        if (!next) next = text + size;
+        *next++ = '\0';
+        int page, x, y, rw, rh, name = 0;
+        if (SDL_sscanf(line, "%d %d %d %d %d %n", &page, &x, &y, &rw, &rh, &name) != 5 ||
+            !name || page < -1 || page >= pages || rw <= 0 || rh <= 0 || x < 0 || y < 0 ||
+            x + rw > w || y + rh > h) {
+            SDL_SetError("Corrupt region in %s: %s", path, line);
+            goto fail;
+        }
+        AtlasRegion *region = atlas_region(atlas, line[name] ? line + name : NULL);
+        if (!region) goto fail;
+        region->page = page;
+        region->rect.x = x;
+        region->rect.y = y;
+        region->rect.w = rw;
+        region->rect.h = rh;
+    }
+    SDL_free(text);
+    return atlas;
+fail:
+    Bundle_SDL_DestroyAtlas(atlas);
+    SDL_free(text);
+    return NULL;
+}
+
+// Tilemaps. A layer is a packed grid of 16-bit tile ids (0 is empty, n is the nth tile of the
+// tileset, left to right and top to bottom) drawn through a camera rect. Only the tiles the camera
+// sees are visited, and they go out as one SDL_RenderGeometry batch where SDL has it (falling back
+// to SDL_RenderCopyF per tile if the renderer refuses). Tile ids can be animated with a list of
+// frames. With a chunk size set, each square of chunk x chunk tiles is rendered once into a target
+// texture and redrawn from there until one of its tiles (or, for chunks holding animated tiles, a
+// frame) changes.
+#define HAVE_RENDER_GEOMETRY SDL_VERSION_ATLEAST(2, 0, 18)
+
+typedef struct TilemapAnim
+{
+    Uint16 *frames;
+    int count, current;
+    Uint32 frame_ms;
+} TilemapAnim;
+
+typedef struct TilemapChunk
+{
+    SDL_Texture *texture;
+    Uint32 serial;
+    SDL_bool dirty, animated;
+} TilemapChunk;
+
+typedef struct SDL_TilemapStats
+{
+    Uint32 tiles, chunks, rebuilt, batches; // for the most recent SDL_RenderTilemap
+} SDL_TilemapStats;
+
+typedef struct SDL_Tilemap
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *tileset;
+    int tileset_w, tileset_h, tileset_cols, tileset_tiles;
+    int tile_w, tile_h, cols, rows;
+    Uint16 *tiles;
+    TilemapAnim *anims; // indexed by tile id
+    int num_anims;
+    Uint32 clock, serial; // serial moves whenever an animation shows a new frame
+    int chunk, chunk_cols, chunk_rows;
+    TilemapChunk *chunks;
+    SDL_bool copies; // geometry failed once; stick to SDL_RenderCopyF
+#if HAVE_RENDER_GEOMETRY
+    SDL_Vertex *verts;
+    int *indices;
+    int num_quads, max_quads;
+    SDL_Texture *batch; // texture of the queued quads
+    SDL_Color color;
+#endif
+    SDL_TilemapStats stats;
+} SDL_Tilemap;
+
+static inline int tilemap_frame(const SDL_Tilemap *tm, int id) {
+    return id < tm->num_anims && tm->anims[id].count ? tm->anims[id].frames[tm->anims[id].current] :
+                                                       id;
+}
+
+static int tilemap_flush(SDL_Tilemap *tm) {
+#if HAVE_RENDER_GEOMETRY
+    int ret = 0, count = tm->num_quads;
+    if (!count) return 0;
+    tm->num_quads = 0;
+    tm->stats.batches++;
+    if (SDL_RenderGeometry(tm->renderer, tm->batch, tm->verts, count * 4, tm->indices, count * 6) ==
+        0)
+        return 0;
+    // Not every renderer takes geometry; replay the queue as copies and stop queueing
+    tm->copies = SDL_TRUE;
+    int w, h;
+    if (SDL_QueryTexture(tm->batch, NULL, NULL, &w, &h) < 0) return -1;
+    for (int i = 0; ret == 0 && i < count; i++) {
+        const SDL_Vertex *v = &tm->verts[i * 4];
+        SDL_Rect src = {(int)(v[0].tex_coord.x * w + 0.5f), (int)(v[0].tex_coord.y * h + 0.5f),
+                        (int)((v[2].tex_coord.x - v[0].tex_coord.x) * w + 0.5f),
+                        (int)((v[2].tex_coord.y - v[0].tex_coord.y) * h + 0.5f)};
+        SDL_FRect dst = {v[0].position.x, v[0].position.y, v[2].position.x - v[0].position.x,
+                         v[2].position.y - v[0].position.y};
+        ret = SDL_RenderCopyF(tm->renderer, tm->batch, &src, &dst);
+    }
+    return ret;
+#else
+    (void)tm;
+    return 0;
+#endif
+}
+
+static int tilemap_quad(SDL_Tilemap *tm, SDL_Texture *texture, int tex_w, int tex_h,
+                        const SDL_Rect *src, const SDL_FRect *dst) {
+#if HAVE_RENDER_GEOMETRY
+    if (!tm->copies) {
+        if (texture != tm->batch || !tm->num_quads) {
+            if (tilemap_flush(tm) < 0) return -1;
+            tm->batch = texture;
+            SDL_GetTextureColorMod(texture, &tm->color.r, &tm->color.g, &tm->color.b);
+            SDL_GetTextureAlphaMod(texture, &tm->color.a);
+        }
+        if (tm->num_quads == tm->max_quads) {
+            int max_quads = tm->max_quads ? tm->max_quads * 2 : 256;
+            SDL_Vertex *verts =
+                (SDL_Vertex *)SDL_realloc(tm->verts, max_quads * 4 * sizeof(SDL_Vertex));
+            if (!verts) return SDL_OutOfMemory();
+            tm->verts = verts;
+            int *indices = (int *)SDL_realloc(tm->indices, max_quads * 6 * sizeof(int));
+            if (!indices) return SDL_OutOfMemory();
+            tm->indices = indices;
+            tm->max_quads = max_quads;
+        }
+        if (!tm->copies) { // Unless that flush just gave up on geometry
+            float u0 = (float)src->x / tex_w, v0 = (float)src->y / tex_h,
+                  u1 = (float)(src->x + src->w) / tex_w, v1 = (float)(src->y + src->h) / tex_h;
+            float x0 = dst->x, y0 = dst->y, x1 = dst->x + dst->w, y1 = dst->y + dst->h;
+            SDL_Vertex *v = &tm->verts[tm->num_quads * 4];
+            int *i = &tm->indices[tm->num_quads * 6], base = tm->num_quads * 4;
+            v[0].position.x = v[3].position.x = x0;
+            v[1].position.x = v[2].position.x = x1;
+            v[0].position.y = v[1].position.y = y0;
+            v[2].position.y = v[3].position.y = y1;
+            v[0].tex_coord.x = v[3].tex_coord.x = u0;
+            v[1].tex_coord.x = v[2].tex_coord.x = u1;
+            v[0].tex_coord.y = v[1].tex_coord.y = v0;
+            v[2].tex_coord.y = v[3].tex_coord.y = v1;
+            v[0].color = v[1].color = v[2].color = v[3].color = tm->color;
+            i[0] = i[3] = base;
+            i[1] = base + 1;
+            i[2] = i[4] = base + 2;
+            i[5] = base + 3;
+            tm->num_quads++;
+            return 0;
+        }
+    }
+#else
+    (void)tex_w;
+    (void)tex_h;
+#endif
+    tm->stats.batches++;
+    return SDL_RenderCopyF(tm->renderer, texture, src, dst);
+}
+
+// Queue tiles [c0, c1) x [r0, r1) with the map's origin at (ox, oy) scaled by (sx, sy)
+static int tilemap_tiles(SDL_Tilemap *tm, int c0, int r0, int c1, int r1, float ox, float oy,
+                         float sx, float sy) {
+    float tw = tm->tile_w * sx, th = tm->tile_h * sy;
+    for (int r = r0; r < r1; r++) {
+        const Uint16 *row = &tm->tiles[r * tm->cols];
+        float y0 = oy + r * th, y1 = oy + (r + 1) * th;
+        for (int c = c0; c < c1; c++) {
+            int id = tilemap_frame(tm, row[c]);
+            if (!id || id > tm->tileset_tiles) continue;
+            SDL_Rect src = {(id - 1) % tm->tileset_cols * tm->tile_w,
+                            (id - 1) / tm->tileset_cols * tm->tile_h, tm->tile_w, tm->tile_h};
+            // Edges come from the same expression on both sides so neighbours never leave seams
+            float x0 = ox + c * tw;
+            SDL_FRect dst = {x0, y0, ox + (c + 1) * tw - x0, y1 - y0};
+            if (tilemap_quad(tm, tm->tileset, tm->tileset_w, tm->tileset_h, &src, &dst) < 0)
+                return -1;
+            tm->stats.tiles++;
+        }
+    }
+    return 0;
+}
+
+static void tilemap_dirty(SDL_Tilemap *tm, int x, int y, int w, int h) {
+    if (!tm->chunk) return;
+    for (int cy = y / tm->chunk; cy <= (y + h - 1) / tm->chunk; cy++)
+        for (int cx = x / tm->chunk; cx <= (x + w - 1) / tm->chunk; cx++)
+            tm->chunks[cy * tm->chunk_cols + cx].dirty = SDL_TRUE;
+}
+
+static int tilemap_build_chunk(SDL_Tilemap *tm, int cx, int cy) {
+    TilemapChunk *chunk = &tm->chunks[cy * tm->chunk_cols + cx];
+    int k = tm->chunk, c0 = cx * k, r0 = cy * k;
+    int c1 = SDL_min(c0 + k, tm->cols), r1 = SDL_min(r0 + k, tm->rows);
+    if (!chunk->texture) {
+        chunk->texture = SDL_CreateTexture(tm->renderer, SDL_PIXELFORMAT_ARGB8888,
+                                           SDL_TEXTUREACCESS_TARGET, k * tm->tile_w,
+                                           k * tm->tile_h);
+        if (!chunk->texture) return -1;
+        SDL_SetTextureBlendMode(chunk->texture, SDL_BLENDMODE_BLEND);
+    }
+    if (SDL_SetRenderTarget(tm->renderer, chunk->texture) < 0) return -1;
+    SDL_SetRenderDrawColor(tm->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(tm->renderer);
+    int ret = tilemap_tiles(tm, c0, r0, c1, r1, (float)-c0 * tm->tile_w, (float)-r0 * tm->tile_h,
+                            1.0f, 1.0f);
+    if (ret == 0) ret = tilemap_flush(tm);
+    chunk->animated = SDL_FALSE;
+    for (int r = r0; r < r1 && !chunk->animated; r++)
+        for (int c = c0; c < c1; c++) {
+            int id = tm->tiles[r * tm->cols + c];
+            if (id < tm->num_anims && tm->anims[id].count) {
+                chunk->animated = SDL_TRUE;
+                break;
+            }
+        }
+    chunk->dirty = SDL_FALSE;
+    chunk->serial = tm->serial;
+    tm->stats.rebuilt++;
+    return ret;
+}
+
+// Bring the visible chunks up to date, leaving the renderer's target and state as they were
+static int tilemap_build_chunks(SDL_Tilemap *tm, int x0, int y0, int x1, int y1) {
+    SDL_Renderer *renderer = tm->renderer;
+    SDL_Texture *target = NULL;
+    SDL_Rect viewport, clip;
+    SDL_bool saved = SDL_FALSE, clipped = SDL_FALSE;
+    float scale_x = 1.0f, scale_y = 1.0f;
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+    SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+    int ret = 0;
+    for (int cy = y0; ret == 0 && cy < y1; cy++)
+        for (int cx = x0; ret == 0 && cx < x1; cx++) {
+            TilemapChunk *chunk = &tm->chunks[cy * tm->chunk_cols + cx];
+            if (chunk->texture && !chunk->dirty &&
+                !(chunk->animated && chunk->serial != tm->serial))
+                continue;
+            if (!saved) { // First stale chunk; save what switching targets resets
+                saved = SDL_TRUE;
+                target = SDL_GetRenderTarget(renderer);
+                SDL_RenderGetViewport(renderer, &viewport);
+                SDL_RenderGetClipRect(renderer, &clip);
+                clipped = SDL_RenderIsClipEnabled(renderer);
+                SDL_RenderGetScale(renderer, &scale_x, &scale_y);
+                SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
+                // Tiles do not overlap, so copy them as-is instead of blending them onto the
+                // cleared chunk, which would premultiply any translucent pixels
+                SDL_GetTextureBlendMode(tm->tileset, &mode);
+                SDL_SetTextureBlendMode(tm->tileset, SDL_BLENDMODE_NONE);
+            }
+            ret = tilemap_build_chunk(tm, cx, cy);
+        }
+    if (saved) {
+        SDL_SetTextureBlendMode(tm->tileset, mode);
+        SDL_SetRenderTarget(renderer, target);
+        if (target) { // SDL only restores these by itself when going back to the window
+            SDL_RenderSetScale(renderer, scale_x, scale_y);
+            SDL_RenderSetViewport(renderer, &viewport);
+            SDL_RenderSetClipRect(renderer, clipped ? &clip : NULL);
+        }
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+    }
+    return ret;
+}
+
+extern "C" SDL_Tilemap *Bundle_SDL_CreateTilemap(SDL_Renderer *renderer, SDL_Texture *tileset,
+                                                 int tile_w, int tile_h, int cols, int rows) {
+    int w, h;
+    if (tile_w <= 0 || tile_h <= 0 || cols <= 0 || rows <= 0) {
+        SDL_SetError("Invalid tilemap geometry: %dx%d tiles of %dx%d", cols, rows, tile_w, tile_h);
+        return NULL;
+    }
+    if (SDL_QueryTexture(tileset, NULL, NULL, &w, &h) < 0) return NULL;
+    if (w < tile_w || h < tile_h) {
+        SDL_SetError("A %dx%d tileset holds no %dx%d tiles", w, h, tile_w, tile_h);
+        return NULL;
+    }
+    SDL_Tilemap *tm = (SDL_Tilemap *)SDL_calloc(1, sizeof(SDL_Tilemap));
+    if (!tm || !(tm->tiles = (Uint16 *)SDL_calloc((size_t)cols * rows, sizeof(Uint16)))) {
+        SDL_free(tm);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    tm->renderer = renderer;
+    tm->tileset = tileset;
+    tm->tileset_w = w;
+    tm->tileset_h = h;
+    tm->tileset_cols = w / tile_w;
+    tm->tileset_tiles = SDL_min(tm->tileset_cols * (h / tile_h), 0xFFFF);
+    tm->tile_w = tile_w;
+    tm->tile_h = tile_h;
+    tm->cols = cols;
+    tm->rows = rows;
+    return tm;
+}
+
+static void tilemap_free_chunks(SDL_Tilemap *tm) {
+    for (int i = 0; i < tm->chunk_cols * tm->chunk_rows; i++)
+        if (tm->chunks[i].texture) SDL_DestroyTexture(tm->chunks[i].texture);
+    SDL_free(tm->chunks);
+    tm->chunks = NULL;
+    tm->chunk = tm->chunk_cols = tm->chunk_rows = 0;
+}
+
+extern "C" void Bundle_SDL_DestroyTilemap(SDL_Tilemap *tm) {
+    if (!tm) return;
+    tilemap_free_chunks(tm);
+    for (int i = 0; i < tm->num_anims; i++)
+        SDL_free(tm->anims[i].frames);
+    SDL_free(tm->anims);
+#if HAVE_RENDER_GEOMETRY
+    SDL_free(tm->verts);
+    SDL_free(tm->indices);
+#endif
+    SDL_free(tm->tiles);
+    SDL_free(tm);
+}
+extern "C" int Bundle_SDL_SetTilemapTiles(SDL_Tilemap *tm, int x, int y, int w, int h,
+                                          const Uint16 *tiles, size_t len) {
+    if (w <= 0 || h <= 0) {
+        x = y = 0;
+        w = tm->cols;
+        h = tm->rows;
+    }
+    if (x < 0 || y < 0 || x + w > tm->cols || y + h > tm->rows)
+        return SDL_SetError("Rect %d,%d %dx%d is outside the %dx%d tilemap", x, y, w, h, tm->cols,
+                            tm->rows);
+    if (len < (size_t)w * h * sizeof(Uint16))
+        return SDL_SetError("%dx%d tiles need %d bytes; got %d", w, h, (int)(w * h * 2), (int)len);
+    for (int r = 0; r < h; r++)
+        SDL_memcpy(&tm->tiles[(y + r) * tm->cols + x], &tiles[r * w], w * sizeof(Uint16));
+    tilemap_dirty(tm, x, y, w, h);
+    return 0;
+}
+extern "C" int Bundle_SDL_SetTilemapTile(SDL_Tilemap *tm, int x, int y, int id) {
+    if (x < 0 || y < 0 || x >= tm->cols || y >= tm->rows || id < 0 || id > 0xFFFF)
+        return SDL_SetError("Cannot set tile %d,%d to %d", x, y, id);
+    if (tm->tiles[y * tm->cols + x] != id) {
+        tm->tiles[y * tm->cols + x] = (Uint16)id;
+        tilemap_dirty(tm, x, y, 1, 1);
+    }
+    return 0;
+}
+extern "C" int Bundle_SDL_GetTilemapTile(SDL_Tilemap *tm, int x, int y) {
+    if (x < 0 || y < 0 || x >= tm->cols || y >= tm->rows)
+        return SDL_SetError("Tile %d,%d is outside the %dx%d tilemap", x, y, tm->cols, tm->rows);
+    return tm->tiles[y * tm->cols + x];
+}
+extern "C" int Bundle_SDL_SetTilemapAnimation(SDL_Tilemap *tm, int id, const Uint16 *frames,
+                                              int count, Uint32 frame_ms) {
+    if (id <= 0 || id > 0xFFFF || count < 0 || (count && !frame_ms))
+        return SDL_SetError("Invalid animation for tile %d", id);
+    if (id >= tm->num_anims) {
+        if (!count) return 0;
+        TilemapAnim *anims = (TilemapAnim *)SDL_realloc(tm->anims, (id + 1) * sizeof(TilemapAnim));
+        if (!anims) return SDL_OutOfMemory();
+        SDL_memset(&anims[tm->num_anims], 0, (id + 1 - tm->num_anims) * sizeof(TilemapAnim));
+        tm->anims = anims;
+        tm->num_anims = id + 1;
+    }
+    TilemapAnim *anim = &tm->anims[id];
+    Uint16 *copy = NULL;
+    if (count && !(copy = (Uint16 *)SDL_malloc(count * sizeof(Uint16)))) return SDL_OutOfMemory();
+    if (count) SDL_memcpy(copy, frames, count * sizeof(Uint16));
+    SDL_free(anim->frames);
+    anim->frames = copy;
+    anim->count = count;
+    anim->frame_ms = frame_ms;
+    anim->current = count ? (int)(tm->clock / frame_ms % count) : 0;
+    tm->serial++;
+    tilemap_dirty(tm, 0, 0, tm->cols, tm->rows); // Any chunk may hold the tile
+    return 0;
+}
+extern "C" void Bundle_SDL_UpdateTilemap(SDL_Tilemap *tm, Uint32 ms) {
+    SDL_bool changed = SDL_FALSE;
+    tm->clock += ms;
+    for (int i = 0; i < tm->num_anims; i++) {
+        TilemapAnim *anim = &tm->anims[i];
+        if (!anim->count) continue;
+        int current = (int)(tm->clock / anim->frame_ms % anim->count);
+        if (current != anim->current) {
+            anim->current = current;
+            changed = SDL_TRUE;
+        }
+    }
+    if (changed) tm->serial++;
+}
+extern "C" int Bundle_SDL_SetTilemapChunkSize(SDL_Tilemap *tm, int tiles) {
+    if (tiles < 0) return SDL_SetError("Invalid chunk size %d", tiles);
+    if (tiles == tm->chunk) return 0;
+    tilemap_free_chunks(tm);
+    if (!tiles) return 0;
+    if (!SDL_RenderTargetSupported(tm->renderer))
+        return SDL_SetError("Chunk caching needs render target support");
+    int chunk_cols = (tm->cols + tiles - 1) / tiles, chunk_rows = (tm->rows + tiles - 1) / tiles;
+    tm->chunks = (TilemapChunk *)SDL_calloc((size_t)chunk_cols * chunk_rows, sizeof(TilemapChunk));
+    if (!tm->chunks) return SDL_OutOfMemory();
+    tm->chunk = tiles;
+    tm->chunk_cols = chunk_cols;
+    tm->chunk_rows = chunk_rows;
+    return 0;
+}
+// Call after SDL_RENDER_TARGETS_RESET or SDL_RENDER_DEVICE_RESET; chunk contents are gone
+extern "C" void Bundle_SDL_InvalidateTilemap(SDL_Tilemap *tm) {
+    tilemap_dirty(tm, 0, 0, tm->cols, tm->rows);
+}
+extern "C" int Bundle_SDL_RenderTilemap(SDL_Tilemap *tm, float cx, float cy, float cw, float ch,
+                                        float dx, float dy, float dw, float dh) {
+    SDL_Renderer *renderer = tm->renderer;
+    SDL_Rect viewport, clip, old_clip;
+    SDL_zero(tm->stats);
+    SDL_RenderGetViewport(renderer, &viewport);
+    if (dw <= 0.0f || dh <= 0.0f) {
+        dx = dy = 0.0f;
+        dw = (float)viewport.w;
+        dh = (float)viewport.h;
+    }
+    if (cw <= 0.0f || ch <= 0.0f) {
+        cw = dw;
+        ch = dh;
+    }
+    float sx = dw / cw, sy = dh / ch;
+    int c0 = SDL_max((int)SDL_floorf(cx / tm->tile_w), 0),
+        r0 = SDL_max((int)SDL_floorf(cy / tm->tile_h), 0),
+        c1 = SDL_min((int)SDL_ceilf((cx + cw) / tm->tile_w), tm->cols),
+        r1 = SDL_min((int)SDL_ceilf((cy + ch) / tm->tile_h), tm->rows);
+    if (c0 >= c1 || r0 >= r1) return 0;
+    int k = tm->chunk, x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    if (k) {
+        x0 = c0 / k;
+        y0 = r0 / k;
+        x1 = (c1 - 1) / k + 1;
+        y1 = (r1 - 1) / k + 1;
+        if (tilemap_build_chunks(tm, x0, y0, x1, y1) < 0) return -1;
+    }
+    // Edge tiles stick out of the destination; clip them to it (and to any clip already set)
+    SDL_bool clipped = SDL_RenderIsClipEnabled(renderer);
+    SDL_RenderGetClipRect(renderer, &old_clip);
+    clip.x = (int)SDL_floorf(dx);
+    clip.y = (int)SDL_floorf(dy);
+    clip.w = (int)SDL_ceilf(dx + dw) - clip.x;
+    clip.h = (int)SDL_ceilf(dy + dh) - clip.y;
+    if (clipped && !SDL_IntersectRect(&old_clip, &clip, &clip)) return 0;
+    SDL_RenderSetClipRect(renderer, &clip);
+    int ret = 0;
+    if (k) {
+        for (int y = y0; ret == 0 && y < y1; y++)
+            for (int x = x0; ret == 0 && x < x1; x++) {
+                int c = x * k, r = y * k;
+                SDL_Rect src = {0, 0, SDL_min(k, tm->cols - c) * tm->tile_w,
+                                SDL_min(k, tm->rows - r) * tm->tile_h};
+                float left = dx + (c * tm->tile_w - cx) * sx, top = dy + (r * tm->tile_h - cy) * sy;
+                SDL_FRect dst = {left, top, src.w * sx, src.h * sy};
+                ret = tilemap_quad(tm, tm->chunks[y * tm->chunk_cols + x].texture, k * tm->tile_w,
+                                   k * tm->tile_h, &src, &dst);
+                tm->stats.chunks++;
+            }
+    }
+    else
+        ret = tilemap_tiles(tm, c0, r0, c1, r1, dx - cx * sx, dy - cy * sy, sx, sy);
+    if (ret == 0) ret = tilemap_flush(tm);
+    SDL_RenderSetClipRect(renderer, clipped ? &old_clip : NULL);
+    return ret;
+}
+extern "C" void Bundle_SDL_GetTilemapStats(SDL_Tilemap *tm, SDL_TilemapStats *stats) {
+    *stats = tm->stats;
+}
+
+// Particle emitters. Particles live in structure-of-arrays form so the per-frame integration
+// (velocity, position, age, size, and colour) runs over plain float arrays, eight lanes at a time
+// with AVX2 or four with SSE2, picked once with SDL_HasAVX2. Capacity is rounded up to a multiple
+// of eight so the kernels never need a scalar tail; lanes past the live count are harmless.
+// Expired particles are swapped out afterwards and the survivors go to the renderer as quads in a
+// single SDL_RenderGeometry call.
+enum
+{
+    PARTICLE_X,
+    PARTICLE_Y,
+    PARTICLE_VX,
+    PARTICLE_VY,
+    PARTICLE_AGE, // 0 at birth, 1 at death
+    PARTICLE_RATE, // 1 / lifetime
+    PARTICLE_SIZE,
+    PARTICLE_R,
+    PARTICLE_G,
+    PARTICLE_B,
+    PARTICLE_A,
+    PARTICLE_FIELDS
+};
+
+typedef struct SDL_ParticleStats
+{
+    int alive, capacity;
+    Uint32 emitted, expired, dropped;
+    Uint32 update_ns, render_ns; // for the most recent update and render
+} SDL_ParticleStats;
+
+// Everything a kernel needs for one step
+typedef struct ParticleStep
+{
+    float dt, ax, ay, drag; // ax and ay are already multiplied by dt, drag is per step
+    float from[5], delta[5]; // size, r, g, b, a at birth and the change until death
+} ParticleStep;
+
+typedef void (*ParticleKernel)(float *const *field, int count, const ParticleStep *step);
+
+typedef struct SDL_ParticleEmitter
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    float *field[PARTICLE_FIELDS];
+    int alive, capacity;
+    Uint32 seed;
+    float x, y, rate, pending;
+    float life_min, life_max, speed_min, speed_max, angle_min, angle_max;
+    float ax, ay, drag;
+    float size[2], color[2][4];
+#if HAVE_RENDER_GEOMETRY
+    SDL_Vertex *verts;
+    int *indices;
+#endif
+    SDL_ParticleStats stats;
+} SDL_ParticleEmitter;
+
+static void particle_kernel_scalar(float *const *field, int count, const ParticleStep *step) {
+    float *x = field[PARTICLE_X], *y = field[PARTICLE_Y], *vx = field[PARTICLE_VX],
+          *vy = field[PARTICLE_VY], *age = field[PARTICLE_AGE];
+    const float *rate = field[PARTICLE_RATE];
+    for (int i = 0; i < count; i++) {
+        vx[i] = (vx[i] + step->ax) * step->drag;
+        vy[i] = (vy[i] + step->ay) * step->drag;
+        x[i] += vx[i] * step->dt;
+        y[i] += vy[i] * step->dt;
+        age[i] += rate[i] * step->dt;
+        float t = SDL_min(age[i], 1.0f);
+        for (int f = 0; f < 5; f++)
+            field[PARTICLE_SIZE + f][i] = step->from[f] + step->delta[f] * t;
+    }
+}
+
+#ifdef BUNDLE_SSE2
+static void particle_kernel_sse2(float *const *field, int count, const ParticleStep *step) {
+    float *x = field[PARTICLE_X], *y = field[PARTICLE_Y], *vx = field[PARTICLE_VX],
+          *vy = field[PARTICLE_VY], *age = field[PARTICLE_AGE];
+    const float *rate = field[PARTICLE_RATE];
+    __m128 dt = _mm_set1_ps(step->dt), ax = _mm_set1_ps(step->ax), ay = _mm_set1_ps(step->ay),
+           drag = _mm_set1_ps(step->drag), one = _mm_set1_ps(1.0f);
+    for (int i = 0; i < count; i += 4) {
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vx + i), ax), drag);
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(vy + i), ay), drag);
+        _mm_storeu_ps(vx + i, u);
+        _mm_storeu_ps(vy + i, v);
+        _mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(u, dt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(v, dt)));
+        __m128 a = _mm_add_ps(_mm_loadu_ps(age + i), _mm_mul_ps(_mm_loadu_ps(rate + i), dt));
+        _mm_storeu_ps(age + i, a);
+        __m128 t = _mm_min_ps(a, one);
+        for (int f = 0; f < 5; f++)
+            _mm_storeu_ps(field[PARTICLE_SIZE + f] + i,
+                          _mm_add_ps(_mm_set1_ps(step->from[f]),
+                                     _mm_mul_ps(_mm_set1_ps(step->delta[f]), t)));
+    }
+}
+#endif
+
+#ifdef BUNDLE_AVX2
+BUNDLE_TARGET_AVX2
+static void particle_kernel_avx2(float *const *field, int count, const ParticleStep *step) {
+    float *x = field[PARTICLE_X], *y = field[PARTICLE_Y], *vx = field[PARTICLE_VX],
+          *vy = field[PARTICLE_VY], *age = field[PARTICLE_AGE];
+    const float *rate = field[PARTICLE_RATE];
+    __m256 dt = _mm256_set1_ps(step->dt), ax = _mm256_set1_ps(step->ax),
+           ay = _mm256_set1_ps(step->ay), drag = _mm256_set1_ps(step->drag),
+           one = _mm256_set1_ps(1.0f);
+    for (int i = 0; i < count; i += 8) {
+        __m256 u = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(vx + i), ax), drag);
+        __m256 v = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(vy + i), ay), drag);
+        _mm256_storeu_ps(vx + i, u);
+        _mm256_storeu_ps(vy + i, v);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(u, dt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(v, dt)));
+        __m256 a =
+            _mm256_add_ps(_mm256_loadu_ps(age + i), _mm256_mul_ps(_mm256_loadu_ps(rate + i), dt));
+        _mm256_storeu_ps(age + i, a);
+        __m256 t = _mm256_min_ps(a, one);
+        for (int f = 0; f < 5; f++)
+            _mm256_storeu_ps(field[PARTICLE_SIZE + f] + i,
+                             _mm256_add_ps(_mm256_set1_ps(step->from[f]),
+                                           _mm256_mul_ps(_mm256_set1_ps(step->delta[f]), t)));
+    }
+}
+#endif
+
+static ParticleKernel particle_kernel = NULL;
+static const char *particle_kernel_name = "scalar";
+
+static void particle_pick_kernel(void) {
+    if (particle_kernel) return;
+    particle_kernel = particle_kernel_scalar;
+#ifdef BUNDLE_SSE2
+    particle_kernel = particle_kernel_sse2;
+    particle_kernel_name = "sse2";
+#endif
+#ifdef BUNDLE_AVX2
+    if (SDL_HasAVX2()) {
+        particle_kernel = particle_kernel_avx2;
+        particle_kernel_name = "avx2";
+    }
+#endif
+}
+
+// xorshift32; good enough for sparks and cheap enough to call per particle
+static inline float particle_random(SDL_ParticleEmitter *pe, float min, float max) {
+    pe->seed ^= pe->seed << 13;
+    pe->seed ^= pe->seed >> 17;
+    pe->seed ^= pe->seed << 5;
+    return min + (max - min) * (float)(pe->seed >> 8) * (1.0f / 16777216.0f);
+}
+
+static int particle_emit(SDL_ParticleEmitter *pe, int count) {
+    int room = pe->capacity - pe->alive, n = SDL_min(count, room);
+    pe->stats.dropped += count - n;
+    for (int i = pe->alive; i < pe->alive + n; i++) {
+        float angle = particle_random(pe, pe->angle_min, pe->angle_max) * (float)M_PI / 180.0f,
+              speed = particle_random(pe, pe->speed_min, pe->speed_max);
+        pe->field[PARTICLE_X][i] = pe->x;
+        pe->field[PARTICLE_Y][i] = pe->y;
+        pe->field[PARTICLE_VX][i] = SDL_cosf(angle) * speed;
+        pe->field[PARTICLE_VY][i] = SDL_sinf(angle) * speed;
+        pe->field[PARTICLE_AGE][i] = 0.0f;
+        pe->field[PARTICLE_RATE][i] = 1.0f / particle_random(pe, pe->life_min, pe->life_max);
+        pe->field[PARTICLE_SIZE][i] = pe->size[0];
+        for (int c = 0; c < 4; c++)
+            pe->field[PARTICLE_R + c][i] = pe->color[0][c];
+    }
+    pe->alive += n;
+    pe->stats.emitted += n;
+    return n;
+}
+
+extern "C" SDL_ParticleEmitter *Bundle_SDL_CreateParticleEmitter(SDL_Renderer *renderer,
+                                                                 int capacity) {
+    if (capacity <= 0 || capacity > 0x1FFFFFF) {
+        SDL_SetError("Invalid particle capacity %d", capacity);
+        return NULL;
+    }
+    capacity = (capacity + 7) & ~7;
+    SDL_ParticleEmitter *pe = (SDL_ParticleEmitter *)SDL_calloc(1, sizeof(SDL_ParticleEmitter));
+    float *block = (float *)SDL_calloc((size_t)capacity * PARTICLE_FIELDS, sizeof(float));
+#if HAVE_RENDER_GEOMETRY
+    SDL_Vertex *verts = (SDL_Vertex *)SDL_malloc((size_t)capacity * 4 * sizeof(SDL_Vertex));
+    int *indices = (int *)SDL_malloc((size_t)capacity * 6 * sizeof(int));
+    if (!pe || !block || !verts || !indices) {
+        SDL_free(verts);
+        SDL_free(indices);
+#else
+    if (!pe || !block) {
+#endif
+        SDL_free(pe);
+        SDL_free(block);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    particle_pick_kernel();
+    for (int f = 0; f < PARTICLE_FIELDS; f++)
+        pe->field[f] = block + (size_t)f * capacity;
+#if HAVE_RENDER_GEOMETRY
+    pe->verts = verts;
+    pe->indices = indices;
+    for (int i = 0; i < capacity; i++) { // Quads never change shape, only place, so build once
+        int *q = &indices[i * 6];
+        q[0] = q[3] = i * 4;
+        q[1] = i * 4 + 1;
+        q[2] = q[4] = i * 4 + 2;
+        q[5] = i * 4 + 3;
+        verts[i * 4].tex_coord.x = verts[i * 4 + 3].tex_coord.x = 0.0f;
+        verts[i * 4 + 1].tex_coord.x = verts[i * 4 + 2].tex_coord.x = 1.0f;
+        verts[i * 4].tex_coord.y = verts[i * 4 + 1].tex_coord.y = 0.0f;
+        verts[i * 4 + 2].tex_coord.y = verts[i * 4 + 3].tex_coord.y = 1.0f;
+    }
+#endif
+    pe->renderer = renderer;
+    pe->capacity = capacity;
+    pe->seed = (Uint32)(uintptr_t)pe ^ SDL_GetTicks() ^ 0x9E3779B9;
+    if (!pe->seed) pe->seed = 1;
+    pe->life_min = pe->life_max = 1.0f;
+    pe->speed_min = pe->speed_max = 50.0f;
+    pe->angle_max = 360.0f;
+    pe->drag = 1.0f;
+    pe->size[0] = pe->size[1] = 4.0f;
+    for (int c = 0; c < 4; c++)
+        pe->color[0][c] = pe->color[1][c] = 255.0f;
+    pe->color[1][3] = 0.0f;
+    return pe;
+}
+extern "C" void Bundle_SDL_DestroyParticleEmitter(SDL_ParticleEmitter *pe) {
+    if (!pe) return;
+    SDL_free(pe->field[0]);
+#if HAVE_RENDER_GEOMETRY
+    SDL_free(pe->verts);
+    SDL_free(pe->indices);
+#endif
+    SDL_free(pe);
+}
+extern "C" void Bundle_SDL_SetParticleEmitterTexture(SDL_ParticleEmitter *pe,
+                                                     SDL_Texture *texture) {
+    pe->texture = texture;
+}
+extern "C" void Bundle_SDL_SetParticleEmitterPosition(SDL_ParticleEmitter *pe, float x, float y) {
+    pe->x = x;
+    pe->y = y;
+}
+extern "C" void Bundle_SDL_SetParticleEmitterRate(SDL_ParticleEmitter *pe, float per_second) {
+    pe->rate = SDL_max(per_second, 0.0f);
+    if (!pe->rate) pe->pending = 0.0f;
+}
+extern "C" int Bundle_SDL_SetParticleEmitterLifetime(SDL_ParticleEmitter *pe, float min,
+                                                     float max) {
+    if (min <= 0.0f || max < min) return SDL_SetError("Invalid lifetime %g to %g", min, max);
+    pe->life_min = min;
+    pe->life_max = max;
+    return 0;
+}
+extern "C" void Bundle_SDL_SetParticleEmitterVelocity(SDL_ParticleEmitter *pe, float speed_min,
+                                                      float speed_max, float angle_min,
+                                                      float angle_max) {
+    pe->speed_min = speed_min;
+    pe->speed_max = speed_max;
+    pe->angle_min = angle_min;
+    pe->angle_max = angle_max;
+}
+extern "C" void Bundle_SDL_SetParticleEmitterForces(SDL_ParticleEmitter *pe, float ax, float ay,
+                                                    float drag) {
+    pe->ax = ax;
+    pe->ay = ay;
+    pe->drag = SDL_max(SDL_min(drag, 1.0f), 0.0f);
+}
+extern "C" void Bundle_SDL_SetParticleEmitterSize(SDL_ParticleEmitter *pe, float start, float end) {
+    pe->size[0] = start;
+    pe->size[1] = end;
+}
+extern "C" void Bundle_SDL_SetParticleEmitterColor(SDL_ParticleEmitter *pe, Uint8 r0, Uint8 g0,
+                                                   Uint8 b0, Uint8 a0, Uint8 r1, Uint8 g1, Uint8 b1,
+                                                   Uint8 a1) {
+    const Uint8 c[2][4] = {{r0, g0, b0, a0}, {r1, g1, b1, a1}};
+    for (int i = 0; i < 2; i++)
+        for (int j = 0; j < 4; j++)
+            pe->color[i][j] = c[i][j];
+}
+extern "C" int Bundle_SDL_ParticleEmitterBurst(SDL_ParticleEmitter *pe, int count) {
+    return count > 0 ? particle_emit(pe, count) : 0;
+}
+extern "C" void Bundle_SDL_UpdateParticleEmitter(SDL_ParticleEmitter *pe, float dt) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (dt > 0.0f && pe->alive) {
+        ParticleStep step;
+        step.dt = dt;
+        step.ax = pe->ax * dt;
+        step.ay = pe->ay * dt;
+        step.drag = pe->drag < 1.0f ? SDL_powf(pe->drag, dt) : 1.0f; // drag is per second
+        step.from[0] = pe->size[0];
+        step.delta[0] = pe->size[1] - pe->size[0];
+        for (int c = 0; c < 4; c++) {
+            step.from[1 + c] = pe->color[0][c];
+            step.delta[1 + c] = pe->color[1][c] - pe->color[0][c];
+        }
+        particle_kernel(pe->field, (pe->alive + 7) & ~7, &step);
+        for (int i = 0; i < pe->alive;) { // Swap the dead out from the end
+            if (pe->field[PARTICLE_AGE][i] < 1.0f) {
+                i++;
+                continue;
+            }
+            pe->alive--;
+            for (int f = 0; f < PARTICLE_FIELDS; f++)
+                pe->field[f][i] = pe->field[f][pe->alive];
+            pe->stats.expired++;
+        }
+    }
+    if (dt > 0.0f && pe->rate > 0.0f) {
+        pe->pending += pe->rate * dt;
+        int count = (int)pe->pending;
+        pe->pending -= count;
+        particle_emit(pe, count);
+    }
+    pe->stats.update_ns = (Uint32)((SDL_GetPerformanceCounter() - start) * 1000000000 /
+                                   SDL_GetPerformanceFrequency());
+}
+extern "C" int Bundle_SDL_RenderParticleEmitter(SDL_ParticleEmitter *pe) {
+    Uint64 start = SDL_GetPerformanceCounter();
+    int ret = 0, n = pe->alive;
+    const float *x = pe->field[PARTICLE_X], *y = pe->field[PARTICLE_Y],
+                *size = pe->field[PARTICLE_SIZE];
+    if (!n) return 0;
+#if HAVE_RENDER_GEOMETRY
+    for (int i = 0; i < n; i++) {
+        SDL_Vertex *v = &pe->verts[i * 4];
+        float h = size[i] * 0.5f, x0 = x[i] - h, x1 = x[i] + h, y0 = y[i] - h, y1 = y[i] + h;
+        SDL_Color color = {(Uint8)pe->field[PARTICLE_R][i], (Uint8)pe->field[PARTICLE_G][i],
+                           (Uint8)pe->field[PARTICLE_B][i], (Uint8)pe->field[PARTICLE_A][i]};
+        v[0].position.x = v[3].position.x = x0;
+        v[1].position.x = v[2].position.x = x1;
+        v[0].position.y = v[1].position.y = y0;
+        v[2].position.y = v[3].position.y = y1;
+        v[0].color = v[1].color = v[2].color = v[3].color = color;
+    }
+    ret = SDL_RenderGeometry(pe->renderer, pe->texture, pe->verts, n * 4, pe->indices, n * 6);
+#else
+    Uint8 r, g, b, a, mod[4];
+    SDL_GetRenderDrawColor(pe->renderer, &r, &g, &b, &a);
+    if (pe->texture) {
+        SDL_GetTextureColorMod(pe->texture, &mod[0], &mod[1], &mod[2]);
+        SDL_GetTextureAlphaMod(pe->texture, &mod[3]);
+    }
+    for (int i = 0; ret == 0 && i < n; i++) { // One call per particle; SDL is too old for geometry
+        float h = size[i] * 0.5f;
+        SDL_FRect dst = {x[i] - h, y[i] - h, size[i], size[i]};
+        Uint8 c[4];
+        for (int k = 0; k < 4; k++)
+            c[k] = (Uint8)pe->field[PARTICLE_R + k][i];
+        if (pe->texture) {
+            SDL_SetTextureColorMod(pe->texture, c[0], c[1], c[2]);
+            SDL_SetTextureAlphaMod(pe->texture, c[3]);
+            ret = SDL_RenderCopyF(pe->renderer, pe->texture, NULL, &dst);
+        }
+        else {
+            SDL_SetRenderDrawColor(pe->renderer, c[0], c[1], c[2], c[3]);
+            ret = SDL_RenderFillRectF(pe->renderer, &dst);
+        }
+    }
+    SDL_SetRenderDrawColor(pe->renderer, r, g, b, a);
+    if (pe->texture) {
+        SDL_SetTextureColorMod(pe->texture, mod[0], mod[1], mod[2]);
+        SDL_SetTextureAlphaMod(pe->texture, mod[3]);
+    }
+#endif
+    pe->stats.render_ns = (Uint32)((SDL_GetPerformanceCounter() - start) * 1000000000 /
+                                   SDL_GetPerformanceFrequency());
+    return ret;
+}
+extern "C" const char *Bundle_SDL_GetParticleKernel(void) {
+    particle_pick_kernel();
+    return particle_kernel_name;
+}
+extern "C" void Bundle_SDL_GetParticleEmitterStats(SDL_ParticleEmitter *pe,
+                                                   SDL_ParticleStats *stats) {
+    pe->stats.alive = pe->alive;
+    pe->stats.capacity = pe->capacity;
+    *stats = pe->stats;
+}
+
+// Renderer benchmark behind SDL_AutoTuneRenderer. A fixed workload (scaled sprite copies, fills,
+// and triangles at positions from a fixed seed) is drawn into a target texture so window size and
+// vsync stay out of it. Reading a pixel back after each phase waits for the GPU to catch up, so
+// the time covers the work rather than just queueing it.
+#define BENCH_SIZE 512
+#define BENCH_ITEMS 2000
+
+static int bench_finish(SDL_Renderer *renderer, Uint64 start, Uint64 *ns) {
+    Uint32 pixel;
+    SDL_Rect one = {0, 0, 1, 1};
+    if (SDL_RenderReadPixels(renderer, &one, SDL_PIXELFORMAT_ARGB8888, &pixel, sizeof(pixel)) < 0)
+        return -1;
+    *ns = (SDL_GetPerformanceCounter() - start) * 1000000000 / SDL_GetPerformanceFrequency();
+    return 0;
+}
+
+// Any failed draw fails the phase; a driver that drops the work would otherwise look fastest
+static int bench_phase(SDL_Renderer *renderer, SDL_Texture *sprite, int phase, int frames) {
+    Uint32 seed = 0x2545F491;
+#if HAVE_RENDER_GEOMETRY
+    SDL_Vertex tri[3 * 64];
+#endif
+    for (int frame = 0; frame < frames; frame++) {
+        if (SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255) < 0 || SDL_RenderClear(renderer) < 0)
+            return -1;
+        for (int i = 0; i < BENCH_ITEMS; i++) {
+            seed = seed * 1664525 + 1013904223; // Same sequence for every driver
+            float x = (float)(seed >> 23), y = (float)((seed >> 14) & 511);
+            if (phase == 0) {
+                SDL_FRect dst = {x - 20.0f, y - 20.0f, 40.0f, 40.0f};
+                if (SDL_RenderCopyF(renderer, sprite, NULL, &dst) < 0) return -1;
+            }
+            else if (phase == 1) {
+                SDL_FRect dst = {x - 16.0f, y - 16.0f, 32.0f, 32.0f};
+                if (SDL_SetRenderDrawColor(renderer, seed >> 24, seed >> 16, seed >> 8, 160) < 0 ||
+                    SDL_RenderFillRectF(renderer, &dst) < 0)
+                    return -1;
+            }
+#if HAVE_RENDER_GEOMETRY
+            else {
+                SDL_Vertex *v = &tri[(i % 64) * 3];
+                SDL_Color color = {(Uint8)(seed >> 24), (Uint8)(seed >> 16), (Uint8)(seed >> 8),
+                                   160};
+                for (int k = 0; k < 3; k++) {
+                    v[k].position.x = x + (k == 1 ? 24.0f : 0.0f);
+                    v[k].position.y = y + (k == 2 ? 24.0f : 0.0f);
+                    v[k].color = color;
+                    v[k].tex_coord.x = v[k].tex_coord.y = 0.0f;
+                }
+                if (i % 64 == 63 && SDL_RenderGeometry(renderer, NULL, tri, 3 * 64, NULL, 0) < 0)
+                    return -1;
+            }
+#endif
+        }
+    }
+    return 0;
+}
+
+extern "C" int Bundle_SDL_BenchmarkRenderer(SDL_Renderer *renderer, int frames, Uint64 *copy_ns,
+                                            Uint64 *fill_ns, Uint64 *geometry_ns) {
+    Uint32 pixels[32 * 32];
+    *copy_ns = *fill_ns = *geometry_ns = 0;
+    for (int i = 0; i < 32 * 32; i++) { // A soft dot, so blending has something to do
+        int dx = i % 32 - 16, dy = i / 32 - 16, a = SDL_max(0, 255 - (dx * dx + dy * dy));
+        pixels[i] = (Uint32)a << 24 | 0xFFFFFF;
+    }
+    SDL_Texture *sprite = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                            SDL_TEXTUREACCESS_STATIC, 32, 32),
+                *target = NULL;
+    if (!sprite) return -1;
+    int ret = SDL_UpdateTexture(sprite, NULL, pixels, 32 * sizeof(Uint32));
+    if (ret == 0) ret = SDL_SetTextureBlendMode(sprite, SDL_BLENDMODE_BLEND);
+    if (ret == 0 && SDL_RenderTargetSupported(renderer)) {
+        target = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                   BENCH_SIZE, BENCH_SIZE);
+        if (target && SDL_SetRenderTarget(renderer, target) < 0) {
+            SDL_DestroyTexture(target);
+            target = NULL;
+        }
+    }
+    if (ret == 0) ret = SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    Uint64 *out[3] = {copy_ns, fill_ns, geometry_ns}, warm;
+    for (int phase = 0; ret == 0 && phase < (HAVE_RENDER_GEOMETRY ? 3 : 2); phase++) {
+        ret = bench_phase(renderer, sprite, phase, 1); // Warm up shaders and caches
+        if (ret == 0) ret = bench_finish(renderer, 0, &warm);
+        Uint64 start = SDL_GetPerformanceCounter();
+        if (ret == 0) ret = bench_phase(renderer, sprite, phase, frames);
+        if (ret == 0) ret = bench_finish(renderer, start, out[phase]);
+    }
+    if (target) {
+        SDL_SetRenderTarget(renderer, NULL);
+        SDL_DestroyTexture(target);
+    }
+    SDL_DestroyTexture(sprite);
+    if (ret < 0) *copy_ns = *fill_ns = *geometry_ns = 0;
+    return ret < 0 ? -1 : 0;
+}
+
+// Frame-time HUD. A small panel in a corner of the renderer with frame-time and FPS graphs, the
+// number of events seen last frame, the depth of the perl callback queue, the fill level of a
+// queued audio device, and any counters the application sets. Text uses a built-in 3x5 font and
+// every pixel of the panel is a rect in one of a few colour buckets, so the whole overlay is one
+// SDL_RenderFillRects call per colour. Frame times are sampled even while it is hidden.
+#define HUD_SAMPLES 120
+#define HUD_COUNTERS 8
+#define HUD_COLUMNS 30 // Characters per line
+
+// Glyphs for ' ' to '_', five rows of three bits each from the top; lower case is upper cased
+static const Uint16 hud_font[64] = {
+    0x0000, 0x2482, 0x5A00, 0x5F7D, 0x3C9E, 0x52A5, 0x2AAB, 0x2400, 0x1491, 0x4494, 0x55D5, 0x05D0,
+    0x0014, 0x01C0, 0x0002, 0x12A4, 0x7B6F, 0x2C97, 0x73E7, 0x73CF, 0x5BC9, 0x79CF, 0x79EF, 0x7252,
+    0x7BEF, 0x7BCF, 0x0410, 0x0414, 0x1511, 0x0E38, 0x4454, 0x7282, 0x7BE7, 0x2BED, 0x6BAE, 0x3923,
+    0x6B6E, 0x79A7, 0x79A4, 0x396B, 0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A,
+    0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492, 0x5B6F, 0x5B6A, 0x5BFD, 0x5AAD, 0x5A92, 0x72A7, 0x3493,
+    0x4889, 0x6496, 0x2A00, 0x0007};
+
+enum
+{
+    HUD_BG,
+    HUD_DIM,
+    HUD_TEXT,
+    HUD_GOOD,
+    HUD_WARN,
+    HUD_BAD,
+    HUD_COLORS
+};
+
+static const SDL_Color hud_colors[HUD_COLORS] = {
+    {0, 0, 0, 176}, {96, 96, 96, 255}, {255, 255, 255, 255},
+    {64, 224, 96, 255}, {240, 200, 48, 255}, {240, 64, 48, 255}};
+
+typedef enum
+{
+    SDL_HUD_TOPLEFT,
+    SDL_HUD_TOPRIGHT,
+    SDL_HUD_BOTTOMLEFT,
+    SDL_HUD_BOTTOMRIGHT
+} SDL_HUDCorner;
+
+typedef struct SDL_HUDStats
+{
+    Uint32 frames;
+    float frame_ms, avg_ms, max_ms, fps; // avg and max cover the last HUD_SAMPLES frames
+    Uint32 events; // during the last frame
+    int callbacks; // waiting for SDL_Yield
+    Uint32 draw_ns; // the HUD's own cost last frame
+} SDL_HUDStats;
+
+typedef struct HUDCounter
+{
+    char name[HUD_COLUMNS + 1];
+    double value;
+} HUDCounter;
+
+typedef struct SDL_HUD
+{
+    SDL_Renderer *renderer;
+    SDL_atomic_t visible, events;
+    int toggle, scale;
+    SDL_HUDCorner corner;
+    float samples[HUD_SAMPLES];
+    int head, count;
+    Uint64 last;
+    SDL_AudioDeviceID audio;
+    Uint32 audio_target;
+    HUDCounter counters[HUD_COUNTERS];
+    int num_counters;
+    SDL_Rect *rects[HUD_COLORS];
+    int num_rects[HUD_COLORS], max_rects[HUD_COLORS];
+    SDL_HUDStats stats;
+} SDL_HUD;
+
+static int SDLCALL hud_event_watch(void *userdata, SDL_Event *event) {
+    SDL_HUD *hud = (SDL_HUD *)userdata;
+    SDL_AtomicAdd(&hud->events, 1);
+    if (event->type == SDL_KEYDOWN && !event->key.repeat && hud->toggle &&
+        event->key.keysym.scancode == hud->toggle)
+        SDL_AtomicSet(&hud->visible, !SDL_AtomicGet(&hud->visible));
+    return 1;
+}
+
+static void hud_rect(SDL_HUD *hud, int color, int x, int y, int w, int h) {
+    if (w <= 0 || h <= 0) return;
+    if (hud->num_rects[color] == hud->max_rects[color]) {
+        int max_rects = hud->max_rects[color] ? hud->max_rects[color] * 2 : 256;
+        SDL_Rect *rects = (SDL_Rect *)SDL_realloc(hud->rects[color], max_rects * sizeof(SDL_Rect));
+        if (!rects) return; // Drop the pixel rather than the frame
+        hud->rects[color] = rects;
+        hud->max_rects[color] = max_rects;
+    }
+    SDL_Rect *rect = &hud->rects[color][hud->num_rects[color]++];
+    rect->x = x;
+    rect->y = y;
+    rect->w = w;
+    rect->h = h;
+}
+
+// One rect per horizontal run of lit pixels
+static void hud_text(SDL_HUD *hud, int color, int x, int y, const char *text) {
+    int s = hud->scale;
+    for (int i = 0; text[i] && i < HUD_COLUMNS; i++, x += 4 * s) {
+        int c = text[i] >= 'a' && text[i] <= 'z' ? text[i] - 32 : text[i];
+        Uint16 glyph = hud_font[c >= 32 && c < 96 ? c - 32 : '?' - 32];
+        for (int row = 0; row < 5; row++) {
+            int bits = glyph >> (12 - row * 3) & 7;
+            for (int col = 0; col < 3;) {
+                if (!(bits & 4 >> col)) {
+                    col++;
+                    continue;
+                }
+                int start = col;
+                while (col < 3 && bits & 4 >> col)
+                    col++;
+                hud_rect(hud, color, x + start * s, y + row * s, (col - start) * s, s);
+            }
+        }
+    }
+}
+
+static inline int hud_bucket(float ms) {
+    return ms <= 17.5f ? HUD_GOOD : ms <= 34.0f ? HUD_WARN : HUD_BAD;
+}
+
+// A bar per sample, oldest on the left. Frame times are drawn up to 33 ms and frame rates up to
+// 120 fps, so 60 fps sits halfway up either graph.
+static void hud_graph(SDL_HUD *hud, int x, int y, int h, SDL_bool fps) {
+    int s = hud->scale, first = hud->count < HUD_SAMPLES ? 0 : hud->head;
+    hud_rect(hud, HUD_DIM, x, y + h - h / 2, HUD_SAMPLES * s, 1);
+    for (int i = 0; i < hud->count; i++) {
+        float ms = hud->samples[(first + i) % HUD_SAMPLES];
+        float v = fps ? (ms > 0.0f ? 1000.0f / ms / 120.0f : 1.0f) : ms / 33.33f;
+        int bar = (int)(SDL_min(v, 1.0f) * h + 0.5f);
+        hud_rect(hud, hud_bucket(ms), x + i * s, y + h - bar, s, SDL_max(bar, 1));
+    }
+}
+
+extern "C" SDL_HUD *Bundle_SDL_CreateHUD(SDL_Renderer *renderer, int toggle, int scale) {
+    SDL_HUD *hud = (SDL_HUD *)SDL_calloc(1, sizeof(SDL_HUD));
+    if (!hud) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    hud->renderer = renderer;
+    hud->toggle = toggle;
+    hud->scale = SDL_max(scale, 1);
+    SDL_AtomicSet(&hud->visible, 1);
+    SDL_AddEventWatch(hud_event_watch, hud);
+    return hud;
+}
+extern "C" void Bundle_SDL_DestroyHUD(SDL_HUD *hud) {
+    if (!hud) return;
+    SDL_DelEventWatch(hud_event_watch, hud);
+    for (int i = 0; i < HUD_COLORS; i++)
+        SDL_free(hud->rects[i]);
+    SDL_free(hud);
+}
+extern "C" void Bundle_SDL_SetHUDVisible(SDL_HUD *hud, SDL_bool visible) {
+    SDL_AtomicSet(&hud->visible, visible ? 1 : 0);
+}
+extern "C" SDL_bool Bundle_SDL_IsHUDVisible(SDL_HUD *hud) {
+    return SDL_AtomicGet(&hud->visible) ? SDL_TRUE : SDL_FALSE;
+}
+extern "C" void Bundle_SDL_SetHUDCorner(SDL_HUD *hud, SDL_HUDCorner corner) {
+    hud->corner = corner;
+}
+extern "C" void Bundle_SDL_SetHUDAudioDevice(SDL_HUD *hud, SDL_AudioDeviceID dev, Uint32 target) {
+    hud->audio = dev;
+    hud->audio_target = target;
+}
+extern "C" int Bundle_SDL_SetHUDCounter(SDL_HUD *hud, const char *name, double value,
+                                        SDL_bool remove) {
+    int i = 0;
+    while (i < hud->num_counters && SDL_strncmp(hud->counters[i].name, name, HUD_COLUMNS) != 0)
+        i++;
+    if (remove) {
+        if (i < hud->num_counters) {
+            SDL_memmove(&hud->counters[i], &hud->counters[i + 1],
+                        (hud->num_counters - i - 1) * sizeof(HUDCounter));
+            hud->num_counters--;
+        }
+        return 0;
+    }
+    if (i == hud->num_counters) {
+        if (i == HUD_COUNTERS) return SDL_SetError("The HUD shows at most %d counters", i);
+        SDL_strlcpy(hud->counters[i].name, name, sizeof(hud->counters[i].name));
+        hud->num_counters++;
+    }
+    hud->counters[i].value = value;
+    return 0;
+}
+extern "C" int Bundle_SDL_RenderHUD(SDL_HUD *hud) {
+    Uint64 now = SDL_GetPerformanceCounter(), freq = SDL_GetPerformanceFrequency();
+    if (hud->last) {
+        hud->samples[hud->head] = (float)((double)(now - hud->last) * 1000.0 / freq);
+        hud->head = (hud->head + 1) % HUD_SAMPLES;
+        hud->count = SDL_min(hud->count + 1, HUD_SAMPLES);
+        hud->stats.frames++;
+    }
+    hud->last = now;
+    hud->stats.events = (Uint32)SDL_AtomicSet(&hud->events, 0);
+    hud->stats.callbacks = SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, callbackEventType,
+                                          callbackEventType + CALLBACK_TYPES - 1);
+    float sum = 0.0f, max = 0.0f;
+    for (int i = 0; i < hud->count; i++) {
+        sum += hud->samples[i];
+        max = SDL_max(max, hud->samples[i]);
+    }
+    int newest = (hud->head + HUD_SAMPLES - 1) % HUD_SAMPLES;
+    hud->stats.frame_ms = hud->count ? hud->samples[newest] : 0.0f;
+    hud->stats.avg_ms = hud->count ? sum / hud->count : 0.0f;
+    hud->stats.max_ms = max;
+    hud->stats.fps = hud->stats.avg_ms > 0.0f ? 1000.0f / hud->stats.avg_ms : 0.0f;
+    if (!SDL_AtomicGet(&hud->visible)) return 0;
+
+    int s = hud->scale, pad = 3 * s, line = 7 * s, graph = 16 * s;
+    int lines = 2 + (hud->audio ? 1 : 0) + hud->num_counters;
+    int w = HUD_SAMPLES * s + 2 * pad, h = 2 * pad + lines * line + 2 * (graph + s * 2);
+    SDL_Rect viewport;
+    SDL_RenderGetViewport(hud->renderer, &viewport);
+    int x = hud->corner & 1 ? viewport.w - w : 0, y = hud->corner & 2 ? viewport.h - h : 0;
+    char text[64];
+    for (int i = 0; i < HUD_COLORS; i++)
+        hud->num_rects[i] = 0;
+    hud_rect(hud, HUD_BG, x, y, w, h);
+    x += pad;
+    y += pad;
+    SDL_snprintf(text, sizeof(text), "FPS %.1f %.1fMS MAX %.1f", hud->stats.fps,
+                 hud->stats.avg_ms, max);
+    hud_text(hud, HUD_TEXT, x, y, text);
+    y += line;
+    hud_graph(hud, x, y, graph, SDL_FALSE);
+    y += graph + 2 * s;
+    hud_graph(hud, x, y, graph, SDL_TRUE);
+    y += graph + 2 * s;
+    SDL_snprintf(text, sizeof(text), "EVT %u CB %d HUD %.2fMS", hud->stats.events,
+                 hud->stats.callbacks, hud->stats.draw_ns / 1e6);
+    hud_text(hud, HUD_TEXT, x, y, text);
+    y += line;
+    if (hud->audio) {
+        Uint32 queued = SDL_GetQueuedAudioSize(hud->audio);
+        float fill = hud->audio_target ? (float)queued / hud->audio_target : 0.0f;
+        int bar = (HUD_COLUMNS - 10) * 4 * s;
+        hud_text(hud, HUD_TEXT, x, y, "AUD");
+        hud_rect(hud, HUD_DIM, x + 4 * 4 * s, y, bar, 5 * s);
+        hud_rect(hud, fill < 0.25f ? HUD_BAD : fill < 0.5f ? HUD_WARN : HUD_GOOD, x + 4 * 4 * s,
+                 y, (int)(SDL_min(fill, 1.0f) * bar), 5 * s);
+        SDL_snprintf(text, sizeof(text), "%d%%", (int)(fill * 100.0f + 0.5f));
+        hud_text(hud, HUD_TEXT, x + 4 * 4 * s + bar + 2 * s, y, text);
+        y += line;
+    }
+    for (int i = 0; i < hud->num_counters; i++, y += line) {
+        SDL_snprintf(text, sizeof(text), "%s %g", hud->counters[i].name, hud->counters[i].value);
+        hud_text(hud, HUD_TEXT, x, y, text);
+    }
+
+    Uint8 r, g, b, a;
+    SDL_BlendMode mode;
+    SDL_GetRenderDrawColor(hud->renderer, &r, &g, &b, &a);
+    SDL_GetRenderDrawBlendMode(hud->renderer, &mode);
+    SDL_SetRenderDrawBlendMode(hud->renderer, SDL_BLENDMODE_BLEND);
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < HUD_COLORS; i++) {
+        if (!hud->num_rects[i]) continue;
+        const SDL_Color *c = &hud_colors[i];
+        SDL_SetRenderDrawColor(hud->renderer, c->r, c->g, c->b, c->a);
+        ret = SDL_RenderFillRects(hud->renderer, hud->rects[i], hud->num_rects[i]);
+    }
+    SDL_SetRenderDrawBlendMode(hud->renderer, mode);
+    SDL_SetRenderDrawColor(hud->renderer, r, g, b, a);
+    hud->stats.draw_ns = (Uint32)((SDL_GetPerformanceCounter() - now) * 1000000000 / freq);
+    return ret;
+}
+extern "C" void Bundle_SDL_GetHUDStats(SDL_HUD *hud, SDL_HUDStats *stats) {
+    *stats = hud->stats;
+}
+
+// Blit conversion cache. Blitting between surfaces of different formats converts every pixel on
+// every blit. SDL_UpperBlit(Scaled) instead convert the source once with SDL_ConvertSurfaceFormat
+// to the destination's format and blit the copy through SDL's same-format path from then on.
+// Copies are keyed by source surface and target format and dropped when the source is locked,
+// written by this module, has its color key or palette changed, or is freed. Copies beyond the
+// byte budget are evicted least recently used first. Writes through a raw pixel pointer can't be
+// seen, so the cache is off until SDL_SetBlitCacheEnabled turns it on.
+typedef struct SDL_BlitCacheStats
+{
+    Uint32 hits;          // blits served from a converted copy
+    Uint32 conversions;   // copies made
+    Uint32 invalidations; // copies dropped because their source changed
+    Uint32 evictions;     // copies dropped to stay within budget
+    int entries;          // copies held
+    Uint64 bytes;         // pixel memory held by the copies
+    Uint64 budget;        // the limit for bytes; 0 for none
+} SDL_BlitCacheStats;
+
+typedef struct BlitCacheEntry
+{
+    SDL_Surface *src, *copy;
+    Uint32 format;
+    Uint32 colorkey;        // of src when copied; ~0 for none
+    SDL_Palette *palette;   // of src when copied
+    Uint32 palette_version; // palette->version when copied
+    Uint32 last_used;       // blitcache_clock at the last hit
+    struct BlitCacheEntry *next;
+} BlitCacheEntry;
+
+#define BLITCACHE_BUCKETS 256
+
+static BlitCacheEntry *blitcache[BLITCACHE_BUCKETS];
+static SDL_bool blitcache_enabled = SDL_FALSE;
+static SDL_BlitCacheStats blitcache_stats = {0, 0, 0, 0, 0, 0, 64 * 1024 * 1024};
+static Uint32 blitcache_clock;
+
+static inline BlitCacheEntry **blitcache_bucket(SDL_Surface *src) {
+    return &blitcache[((uintptr_t)src >> 6 ^ (uintptr_t)src >> 14) % BLITCACHE_BUCKETS];
+}
+
+static void blitcache_drop(BlitCacheEntry **at) {
+    BlitCacheEntry *entry = *at;
+    *at = entry->next;
+    blitcache_stats.entries--;
+    blitcache_stats.bytes -= (Uint64)entry->copy->pitch * entry->copy->h;
+    SDL_FreeSurface(entry->copy);
+    SDL_free(entry);
+}
+
+static void blitcache_invalidate(SDL_Surface *src) {
+    if (!blitcache_stats.entries) return;
+    for (BlitCacheEntry **at = blitcache_bucket(src); *at;)
+        if ((*at)->src == src) {
+            blitcache_drop(at);
+            blitcache_stats.invalidations++;
+        }
+        else
+            at = &(*at)->next;
+}
+
+// Evict the least recently used copies, other than keep, until no more than budget bytes are held
+static void blitcache_trim(Uint64 budget, const BlitCacheEntry *keep) {
+    while (blitcache_stats.bytes > budget) {
+        BlitCacheEntry **oldest = NULL;
+        for (int i = 0; i < BLITCACHE_BUCKETS; i++)
+            for (BlitCacheEntry **at = &blitcache[i]; *at; at = &(*at)->next)
+                if (*at != keep &&
+                    (!oldest || blitcache_clock - (*at)->last_used >
+                                    blitcache_clock - (*oldest)->last_used))
+                    oldest = at;
+        if (!oldest) return;
+        blitcache_drop(oldest);
+        blitcache_stats.evictions++;
+    }
+}
+
+static Uint32 blitcache_colorkey(SDL_Surface *src) {
+    Uint32 key;
+    return SDL_HasColorKey(src) && SDL_GetColorKey(src, &key) == 0 ? key : ~0u;
+}
+
+// The format to convert src to for blitting onto dst or 0 when a copy would not blit the same.
+// The copy has an alpha channel exactly when src does, in dst's channel order, so the blit
+// semantics (per-surface alpha, color keys) don't change.
+static Uint32 blitcache_format(SDL_Surface *src, SDL_Surface *dst) {
+    const SDL_PixelFormat *f = dst->format;
+    Uint32 format = f->format;
+    SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+    SDL_GetSurfaceBlendMode(src, &mode);
+    SDL_bool alpha = src->format->Amask && mode != SDL_BLENDMODE_NONE ? SDL_TRUE : SDL_FALSE;
+    if (src->format->Amask && !alpha) alpha = f->Amask ? SDL_TRUE : SDL_FALSE;
+    if (alpha != (f->Amask != 0)) {
+        if (f->BitsPerPixel != 32) return 0;
+        Uint32 rgb = f->Rmask | f->Gmask | f->Bmask;
+        format = SDL_MasksToPixelFormatEnum(32, f->Rmask, f->Gmask, f->Bmask, alpha ? ~rgb : 0);
+    }
+    // A color key would be turned into alpha
+    if (alpha && SDL_HasColorKey(src)) return 0;
+    if (format == SDL_PIXELFORMAT_UNKNOWN || format == src->format->format ||
+        SDL_ISPIXELFORMAT_INDEXED(format) || SDL_ISPIXELFORMAT_FOURCC(format))
+        return 0;
+    return format;
+}
+
+// Returns the surface to blit in place of src: a converted copy or src itself
+static SDL_Surface *blitcache_lookup(SDL_Surface *src, SDL_Surface *dst) {
+    if (!blitcache_enabled || !src || !dst || src == dst || src->locked) return src;
+    Uint32 format = blitcache_format(src, dst);
+    if (!format) return src;
+    Uint32 colorkey = blitcache_colorkey(src);
+    SDL_Palette *palette = src->format->palette;
+    Uint32 version = palette ? palette->version : 0;
+    BlitCacheEntry *entry = NULL;
+    BlitCacheEntry **bucket = blitcache_bucket(src);
+    blitcache_clock++;
+    for (BlitCacheEntry **at = bucket; *at; at = &(*at)->next)
+        if ((*at)->src == src && (*at)->format == format) {
+            if ((*at)->colorkey == colorkey && (*at)->palette == palette &&
+                (*at)->palette_version == version) {
+                entry = *at;
+                entry->last_used = blitcache_clock;
+                blitcache_stats.hits++;
+            }
+            else {
+                blitcache_drop(at);
+                blitcache_stats.invalidations++;
+            }
+            break;
+        }
+    if (!entry) {
+        Uint64 budget = blitcache_stats.budget;
+        if (budget && (Uint64)src->w * src->h * SDL_BYTESPERPIXEL(format) > budget)
+            return src; // Would never fit; don't evict everything else for it
+        SDL_Surface *copy = SDL_ConvertSurfaceFormat(src, format, 0);
+        if (!copy) return src;
+        entry = (BlitCacheEntry *)SDL_malloc(sizeof(BlitCacheEntry));
+        if (!entry) {
+            SDL_FreeSurface(copy);
+            return src;
+        }
+        entry->src = src;
+        entry->copy = copy;
+        entry->format = format;
+        entry->colorkey = colorkey;
+        entry->palette = palette;
+        entry->palette_version = version;
+        entry->last_used = blitcache_clock;
+        entry->next = *bucket;
+        *bucket = entry;
+        blitcache_stats.conversions++;
+        blitcache_stats.entries++;
+        blitcache_stats.bytes += (Uint64)copy->pitch * copy->h;
+        if (budget) blitcache_trim(budget, entry);
+    }
+    // Modulation and blending are applied at blit time, so follow src's current settings
+    SDL_Surface *copy = entry->copy;
+    Uint8 r, g, b, a;
+    SDL_BlendMode mode;
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    SDL_SetSurfaceColorMod(copy, r, g, b);
+    SDL_GetSurfaceAlphaMod(src, &a);
+    SDL_SetSurfaceAlphaMod(copy, a);
+    SDL_GetSurfaceBlendMode(src, &mode);
+    SDL_SetSurfaceBlendMode(copy, mode);
+    return copy;
+}
+
+extern "C" int Bundle_SDL_UpperBlit(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst,
+                                    SDL_Rect *dstrect) {
+    blitcache_invalidate(dst);
+    return SDL_UpperBlit(blitcache_lookup(src, dst), srcrect, dst, dstrect);
+}
+extern "C" int Bundle_SDL_UpperBlitScaled(SDL_Surface *src, const SDL_Rect *srcrect,
+                                          SDL_Surface *dst, SDL_Rect *dstrect) {
+    blitcache_invalidate(dst);
+    return SDL_UpperBlitScaled(blitcache_lookup(src, dst), srcrect, dst, dstrect);
+}
+// The lower level entry points don't use the cache but still write to dst
+extern "C" int Bundle_SDL_LowerBlit(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
+                                    SDL_Rect *dstrect) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_LowerBlit(src, srcrect, dst, dstrect);
+}
+extern "C" int Bundle_SDL_LowerBlitScaled(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *dst,
+                                          SDL_Rect *dstrect) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_LowerBlitScaled(src, srcrect, dst, dstrect);
+}
+extern "C" int Bundle_SDL_SoftStretch(SDL_Surface *src, const SDL_Rect *srcrect, SDL_Surface *dst,
+                                      const SDL_Rect *dstrect) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_SoftStretch(src, srcrect, dst, dstrect);
+}
+extern "C" int Bundle_SDL_SoftStretchLinear(SDL_Surface *src, const SDL_Rect *srcrect,
+                                            SDL_Surface *dst, const SDL_Rect *dstrect) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_SoftStretchLinear(src, srcrect, dst, dstrect);
+}
+extern "C" int Bundle_SDL_LockSurface(SDL_Surface *surface) {
+    if (surface) blitcache_invalidate(surface);
+    return SDL_LockSurface(surface);
+}
+extern "C" int Bundle_SDL_FillRect(SDL_Surface *dst, const SDL_Rect *rect, Uint32 color) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_FillRect(dst, rect, color);
+}
+extern "C" int Bundle_SDL_FillRects(SDL_Surface *dst, const SDL_Rect *rects, int count,
+                                    Uint32 color) {
+    if (dst) blitcache_invalidate(dst);
+    return SDL_FillRects(dst, rects, count, color);
+}
+extern "C" void Bundle_SDL_InvalidateBlitCache(SDL_Surface *surface) {
+    if (surface) {
+        blitcache_invalidate(surface);
+        return;
+    }
+    for (int i = 0; i < BLITCACHE_BUCKETS; i++)
+        while (blitcache[i])
+            blitcache_drop(&blitcache[i]);
+}
+extern "C" void Bundle_SDL_SetBlitCacheEnabled(SDL_bool enabled) {
+    blitcache_enabled = enabled;
+    if (!enabled) Bundle_SDL_InvalidateBlitCache(NULL);
+}
+extern "C" void Bundle_SDL_SetBlitCacheBudget(Uint64 budget) {
+    blitcache_stats.budget = budget;
+    if (budget) blitcache_trim(budget, NULL);
+}
+extern "C" void Bundle_SDL_GetBlitCacheStats(SDL_BlitCacheStats *stats) {
+    *stats = blitcache_stats;
+}
+
+// Batched blits. items is a packed array of native ints, eight per item: the source rect (x, y,
+// w, h) then the destination rect (x, y, w, h; the size only matters when scaling). A negative
+// w or h stands for the whole surface, as a NULL rect would; a zero one is empty and draws
+// nothing, as it does in SDL. Null and locked surfaces, the blit cache and the switch back from
+// a scaled blit map are dealt with once; items are then clipped natively and each failure sets
+// its bit in mask (LSB first, like vec) instead of stopping the batch.
+static inline SDL_Rect *blit_many_rect(SDL_Rect *rect, const int *xywh) {
+    if (xywh[2] < 0 || xywh[3] < 0) return NULL;
+    rect->x = xywh[0];
+    rect->y = xywh[1];
+    rect->w = xywh[2];
+    rect->h = xywh[3];
+    return rect;
+}
+static int blit_many_begin(SDL_Surface **src, SDL_Surface *dst, const int *items, int count) {
+    if (!*src) return SDL_InvalidParamError("src");
+    if (!dst) return SDL_InvalidParamError("dst");
+    if (count < 0 || (count && !items)) return SDL_InvalidParamError("items");
+    if ((*src)->locked || dst->locked)
+        return SDL_SetError("Surfaces must not be locked during blit");
+    blitcache_invalidate(dst);
+    *src = blitcache_lookup(*src, dst);
+    return 0;
+}
+
+// SDL_UpperBlit's clipping of one unscaled item against the source and the destination's clip
+// rect. Returns SDL_FALSE if nothing is left to draw.
+static SDL_bool blit_many_clip(SDL_Surface *src, SDL_Surface *dst, const int *item,
+                               SDL_Rect *from, SDL_Rect *to) {
+    SDL_Rect all = {0, 0, src->w, src->h};
+    if (!blit_many_rect(from, item)) *from = all;
+    to->x = item[4];
+    to->y = item[5];
+    if (from->x < 0) {
+        from->w += from->x;
+        to->x -= from->x;
+        from->x = 0;
+    }
+    if (from->y < 0) {
+        from->h += from->y;
+        to->y -= from->y;
+        from->y = 0;
+    }
+    from->w = SDL_min(from->w, src->w - from->x);
+    from->h = SDL_min(from->h, src->h - from->y);
+    const SDL_Rect *clip = &dst->clip_rect;
+    int d = clip->x - to->x;
+    if (d > 0) {
+        from->w -= d;
+        from->x += d;
+        to->x += d;
+    }
+    d = to->x + from->w - clip->x - clip->w;
+    if (d > 0) from->w -= d;
+    d = clip->y - to->y;
+    if (d > 0) {
+        from->h -= d;
+        from->y += d;
+        to->y += d;
+    }
+    d = to->y + from->h - clip->y - clip->h;
+    if (d > 0) from->h -= d;
+    to->w = from->w;
+    to->h = from->h;
+    return from->w > 0 && from->h > 0 ? SDL_TRUE : SDL_FALSE;
+}
+
+extern "C" int Bundle_SDL_BlitSurfaceMany(SDL_Surface *src, SDL_Surface *dst, const int *items,
+                                          int count, Uint8 *mask) {
+    if (blit_many_begin(&src, dst, items, count) < 0) return -1;
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        const int *item = items + i * 8;
+        SDL_Rect from, to;
+        int ret;
+        if (i == 0) { // Through SDL once so a map left over from scaling is reset
+            SDL_Rect rect;
+            to.x = item[4];
+            to.y = item[5];
+            to.w = to.h = 0;
+            ret = SDL_UpperBlit(src, blit_many_rect(&rect, item), dst, &to);
+        }
+        else
+            ret = blit_many_clip(src, dst, item, &from, &to) ? SDL_LowerBlit(src, &from, dst, &to)
+                                                             : 0;
+        if (ret < 0) {
+            mask[i >> 3] |= 1 << (i & 7);
+            failures++;
+        }
+    }
+    return failures;
+}
+extern "C" int Bundle_SDL_BlitScaledMany(SDL_Surface *src, SDL_Surface *dst, const int *items,
+                                         int count, Uint8 *mask) {
+    if (blit_many_begin(&src, dst, items, count) < 0) return -1;
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        const int *item = items + i * 8;
+        SDL_Rect from, to;
+        if (SDL_UpperBlitScaled(src, blit_many_rect(&from, item), dst,
+                                blit_many_rect(&to, item + 4)) < 0) {
+            mask[i >> 3] |= 1 << (i & 7);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Pixel kernels. Fill, gradient, alpha blend, premultiply/unpremultiply, swizzle and grayscale
+// for 32-bit surfaces, with scalar, SSE2, AVX2 and NEON versions of each inner loop. The widest
+// set the CPU supports is picked on first use and can be overridden with SDL_SetPixelKernel for
+// testing. Every SIMD path does the same integer math as the scalar one so results are
+// bit-identical: x/255 is rounded with (t + (t >> 8)) >> 8 where t = x + 128, and unpremultiply
+// uses a 16-bit reciprocal table.
+typedef struct PixelGray
+{
+    Uint32 keep;
+    int rshift, gshift, bshift;
+} PixelGray;
+
+// Where each 8-bit channel sits in a 32-bit pixel; see pixel_shuffle
+typedef struct PixelShuffle
+{
+    int rshift, gshift, bshift, ashift;
+    Uint32 amask;
+} PixelShuffle;
+
+typedef struct PixelKernels
+{
+    const char *name;
+    void (*fill)(Uint32 *dst, int n, Uint32 color);
+    void (*blend)(const Uint32 *src, Uint32 *dst, int n, int ashift);
+    void (*premultiply)(Uint32 *pixels, int n, int ashift);
+    void (*unpremultiply)(Uint32 *pixels, int n, int ashift);
+    void (*swizzle)(const Uint32 *src, Uint32 *dst, int n, SDL_bool left);
+    void (*grayscale)(Uint32 *pixels, int n, const PixelGray *gray);
+    void (*map_rgba)(const Uint8 *rgba, Uint32 *pixels, int n, const PixelShuffle *shuffle);
+    void (*get_rgba)(const Uint32 *pixels, Uint8 *rgba, int n, const PixelShuffle *shuffle);
+} PixelKernels;
+
+// ceil(255 * 256 / a); (c * pixel_recip[a]) >> 8 is c * 255 / a, never rounded down
+static Uint16 pixel_recip[256];
+
+static inline Uint32 pixel_div255(Uint32 x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+static void pixel_fill_scalar(Uint32 *dst, int n, Uint32 color) {
+    for (int i = 0; i < n; i++)
+        dst[i] = color;
+}
+
+static void pixel_blend_scalar(const Uint32 *src, Uint32 *dst, int n, int ashift) {
+    for (int i = 0; i < n; i++) {
+        Uint32 s = src[i], d = dst[i], a = (s >> ashift) & 0xFF, out = 0;
+        if (a == 0) continue;
+        if (a == 255) {
+            dst[i] = s;
+            continue;
+        }
+        s |= 0xFFu << ashift; // a * 255 + da * (255 - a) blends the alpha byte the same way
+        for (int sh = 0; sh < 32; sh += 8)
+            out |= pixel_div255(((s >> sh) & 0xFF) * a + ((d >> sh) & 0xFF) * (255 - a)) << sh;
+        dst[i] = out;
+    }
+}
+
+static void pixel_premultiply_scalar(Uint32 *pixels, int n, int ashift) {
+    for (int i = 0; i < n; i++) {
+        Uint32 p = pixels[i] | 0xFFu << ashift, a = (pixels[i] >> ashift) & 0xFF, out = 0;
+        for (int sh = 0; sh < 32; sh += 8)
+            out |= pixel_div255(((p >> sh) & 0xFF) * a) << sh;
+        pixels[i] = out;
+    }
+}
+
+static void pixel_unpremultiply_scalar(Uint32 *pixels, int n, int ashift) {
+    for (int i = 0; i < n; i++) {
+        Uint32 p = pixels[i], a = (p >> ashift) & 0xFF, out = a << ashift;
+        for (int sh = 0; sh < 32; sh += 8)
+            if (sh != ashift)
+                out |= SDL_min((((p >> sh) & 0xFF) * pixel_recip[a]) >> 8, 255u) << sh;
+        pixels[i] = out;
+    }
+}
+
+static void pixel_swizzle_scalar(const Uint32 *src, Uint32 *dst, int n, SDL_bool left) {
+    for (int i = 0; i < n; i++)
+        dst[i] = left ? src[i] << 8 | src[i] >> 24 : src[i] >> 8 | src[i] << 24;
+}
+
+static void pixel_grayscale_scalar(Uint32 *pixels, int n, const PixelGray *gray) {
+    for (int i = 0; i < n; i++) {
+        Uint32 p = pixels[i];
+        Uint32 y = (77 * ((p >> gray->rshift) & 0xFF) + 150 * ((p >> gray->gshift) & 0xFF) +
+                    29 * ((p >> gray->bshift) & 0xFF) + 128) >>
+                   8;
+        pixels[i] = (p & gray->keep) | y << gray->rshift | y << gray->gshift | y << gray->bshift;
+    }
+}
+
+static void pixel_map_rgba_scalar(const Uint8 *rgba, Uint32 *pixels, int n,
+                                  const PixelShuffle *shuffle) {
+    for (int i = 0; i < n; i++, rgba += 4)
+        pixels[i] = (Uint32)rgba[0] << shuffle->rshift | (Uint32)rgba[1] << shuffle->gshift |
+                    (Uint32)rgba[2] << shuffle->bshift |
+                    ((Uint32)rgba[3] << shuffle->ashift & shuffle->amask);
+}
+
+static void pixel_get_rgba_scalar(const Uint32 *pixels, Uint8 *rgba, int n,
+                                  const PixelShuffle *shuffle) {
+    for (int i = 0; i < n; i++, rgba += 4) {
+        Uint32 p = pixels[i];
+        rgba[0] = (Uint8)(p >> shuffle->rshift);
+        rgba[1] = (Uint8)(p >> shuffle->gshift);
+        rgba[2] = (Uint8)(p >> shuffle->bshift);
+        rgba[3] = shuffle->amask ? (Uint8)(p >> shuffle->ashift) : 255;
+    }
+}
+
+static const PixelKernels pixel_kernels_scalar = {
+    "scalar",
+    pixel_fill_scalar,
+    pixel_blend_scalar,
+    pixel_premultiply_scalar,
+    pixel_unpremultiply_scalar,
+    pixel_swizzle_scalar,
+    pixel_grayscale_scalar,
+    pixel_map_rgba_scalar,
+    pixel_get_rgba_scalar};
+
+#ifdef BUNDLE_SSE2
+static inline __m128i pixel_div255_sse2(__m128i t) {
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// copies the alpha byte of every pixel into all four of its bytes
+static inline __m128i pixel_alpha_sse2(__m128i p, int ashift) {
+    __m128i a = _mm_and_si128(_mm_srl_epi32(p, _mm_cvtsi32_si128(ashift)), _mm_set1_epi32(0xFF));
+    a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+    return _mm_or_si128(a, _mm_slli_epi32(a, 16));
+}
+
+static void pixel_fill_sse2(Uint32 *dst, int n, Uint32 color) {
+    __m128i c = _mm_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_si128((__m128i *)(dst + i), c);
+    pixel_fill_scalar(dst + i, n - i, color);
+}
+
+static void pixel_blend_sse2(const Uint32 *src, Uint32 *dst, int n, int ashift) {
+    __m128i zero = _mm_setzero_si128(), full = _mm_set1_epi16(255),
+            amask = _mm_set1_epi32((int)(0xFFu << ashift));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i)),
+                d = _mm_loadu_si128((const __m128i *)(dst + i)), a = pixel_alpha_sse2(s, ashift);
+        s = _mm_or_si128(s, amask);
+        __m128i alo = _mm_unpacklo_epi8(a, zero), ahi = _mm_unpackhi_epi8(a, zero);
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), alo),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+                                                   _mm_sub_epi16(full, alo)));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), ahi),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+                                                   _mm_sub_epi16(full, ahi)));
+        _mm_storeu_si128((__m128i *)(dst + i),
+                         _mm_packus_epi16(pixel_div255_sse2(lo), pixel_div255_sse2(hi)));
+    }
+    pixel_blend_scalar(src + i, dst + i, n - i, ashift);
+}
+
+static void pixel_premultiply_sse2(Uint32 *pixels, int n, int ashift) {
+    __m128i zero = _mm_setzero_si128(), amask = _mm_set1_epi32((int)(0xFFu << ashift));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + i)), a = pixel_alpha_sse2(p, ashift);
+        p = _mm_or_si128(p, amask);
+        __m128i lo = _mm_mullo_epi16(_mm_unpacklo_epi8(p, zero), _mm_unpacklo_epi8(a, zero));
+        __m128i hi = _mm_mullo_epi16(_mm_unpackhi_epi8(p, zero), _mm_unpackhi_epi8(a, zero));
+        _mm_storeu_si128((__m128i *)(pixels + i),
+                         _mm_packus_epi16(pixel_div255_sse2(lo), pixel_div255_sse2(hi)));
+    }
+    pixel_premultiply_scalar(pixels + i, n - i, ashift);
+}
+
+// c * recip >> 8 for the colour lanes, c * 256 >> 8 for the alpha lane, clamped to 255
+static inline __m128i pixel_unpremultiply_sse2_half(__m128i c, Uint32 a0, Uint32 a1,
+                                                    __m128i alane) {
+    __m128i r = _mm_set_epi64x((long long)(pixel_recip[a1] * 0x0001000100010001ULL),
+                               (long long)(pixel_recip[a0] * 0x0001000100010001ULL));
+    r = _mm_or_si128(_mm_andnot_si128(alane, r), _mm_and_si128(alane, _mm_set1_epi16(256)));
+    __m128i x = _mm_mulhi_epu16(_mm_slli_epi16(c, 8), r);
+    return _mm_sub_epi16(x, _mm_subs_epu16(x, _mm_set1_epi16(255)));
+}
+
+static void pixel_unpremultiply_sse2(Uint32 *pixels, int n, int ashift) {
+    __m128i zero = _mm_setzero_si128(), amask = _mm_set1_epi32((int)(0xFFu << ashift));
+    __m128i alane = _mm_unpacklo_epi8(amask, amask);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + i));
+        const Uint32 *q = pixels + i;
+        __m128i lo = pixel_unpremultiply_sse2_half(_mm_unpacklo_epi8(p, zero),
+                                                   (q[0] >> ashift) & 0xFF,
+                                                   (q[1] >> ashift) & 0xFF, alane);
+        __m128i hi = pixel_unpremultiply_sse2_half(_mm_unpackhi_epi8(p, zero),
+                                                   (q[2] >> ashift) & 0xFF,
+                                                   (q[3] >> ashift) & 0xFF, alane);
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+    pixel_unpremultiply_scalar(pixels + i, n - i, ashift);
+}
+
+static void pixel_swizzle_sse2(const Uint32 *src, Uint32 *dst, int n, SDL_bool left) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+        p = left ? _mm_or_si128(_mm_slli_epi32(p, 8), _mm_srli_epi32(p, 24))
+                 : _mm_or_si128(_mm_srli_epi32(p, 8), _mm_slli_epi32(p, 24));
+        _mm_storeu_si128((__m128i *)(dst + i), p);
+    }
+    pixel_swizzle_scalar(src + i, dst + i, n - i, left);
+}
+
+static void pixel_grayscale_sse2(Uint32 *pixels, int n, const PixelGray *gray) {
+    __m128i rs = _mm_cvtsi32_si128(gray->rshift), gs = _mm_cvtsi32_si128(gray->gshift),
+            bs = _mm_cvtsi32_si128(gray->bshift), byte = _mm_set1_epi32(0xFF),
+            keep = _mm_set1_epi32((int)gray->keep);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + i));
+        // the channels sit in the low half of each 32-bit lane so 16-bit math cannot carry
+        __m128i y = _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi32(p, rs), byte), _mm_set1_epi32(77));
+        y = _mm_add_epi16(y, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi32(p, gs), byte),
+                                             _mm_set1_epi32(150)));
+        y = _mm_add_epi16(y, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi32(p, bs), byte),
+                                             _mm_set1_epi32(29)));
+        y = _mm_srli_epi32(_mm_add_epi16(y, _mm_set1_epi32(128)), 8);
+        p = _mm_or_si128(_mm_and_si128(p, keep),
+                         _mm_or_si128(_mm_sll_epi32(y, rs),
+                                      _mm_or_si128(_mm_sll_epi32(y, gs), _mm_sll_epi32(y, bs))));
+        _mm_storeu_si128((__m128i *)(pixels + i), p);
+    }
+    pixel_grayscale_scalar(pixels + i, n - i, gray);
+}
+
+// Loading four RGBA byte tuples as 32-bit lanes puts R in the low byte; x86 is little-endian
+static void pixel_map_rgba_sse2(const Uint8 *rgba, Uint32 *pixels, int n,
+                                const PixelShuffle *shuffle) {
+    __m128i rs = _mm_cvtsi32_si128(shuffle->rshift), gs = _mm_cvtsi32_si128(shuffle->gshift),
+            bs = _mm_cvtsi32_si128(shuffle->bshift), as = _mm_cvtsi32_si128(shuffle->ashift),
+            byte = _mm_set1_epi32(0xFF), amask = _mm_set1_epi32((int)shuffle->amask);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(rgba + i * 4));
+        __m128i p = _mm_or_si128(_mm_sll_epi32(_mm_and_si128(v, byte), rs),
+                                 _mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(v, 8), byte), gs));
+        p = _mm_or_si128(p, _mm_sll_epi32(_mm_and_si128(_mm_srli_epi32(v, 16), byte), bs));
+        p = _mm_or_si128(p, _mm_and_si128(_mm_sll_epi32(_mm_srli_epi32(v, 24), as), amask));
+        _mm_storeu_si128((__m128i *)(pixels + i), p);
+    }
+    pixel_map_rgba_scalar(rgba + i * 4, pixels + i, n - i, shuffle);
+}
+
+static void pixel_get_rgba_sse2(const Uint32 *pixels, Uint8 *rgba, int n,
+                                const PixelShuffle *shuffle) {
+    __m128i rs = _mm_cvtsi32_si128(shuffle->rshift), gs = _mm_cvtsi32_si128(shuffle->gshift),
+            bs = _mm_cvtsi32_si128(shuffle->bshift), as = _mm_cvtsi32_si128(shuffle->ashift),
+            byte = _mm_set1_epi32(0xFF), amask = _mm_set1_epi32((int)shuffle->amask),
+            opaque = _mm_set1_epi32(shuffle->amask ? 0 : 0xFF);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pixels + i));
+        __m128i v = _mm_or_si128(_mm_and_si128(_mm_srl_epi32(p, rs), byte),
+                                 _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(p, gs), byte), 8));
+        v = _mm_or_si128(v, _mm_slli_epi32(_mm_and_si128(_mm_srl_epi32(p, bs), byte), 16));
+        v = _mm_or_si128(
+            v, _mm_slli_epi32(_mm_or_si128(_mm_srl_epi32(_mm_and_si128(p, amask), as), opaque),
+                              24));
+        _mm_storeu_si128((__m128i *)(rgba + i * 4), v);
+    }
+    pixel_get_rgba_scalar(pixels + i, rgba + i * 4, n - i, shuffle);
+}
+
+static const PixelKernels pixel_kernels_sse2 = {
+    "sse2",
+    pixel_fill_sse2,
+    pixel_blend_sse2,
+    pixel_premultiply_sse2,
+    pixel_unpremultiply_sse2,
+    pixel_swizzle_sse2,
+    pixel_grayscale_sse2,
+    pixel_map_rgba_sse2,
+    pixel_get_rgba_sse2};
+#endif
+
+#ifdef BUNDLE_AVX2
+BUNDLE_TARGET_AVX2
+static inline __m256i pixel_div255_avx2(__m256i t) {
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+BUNDLE_TARGET_AVX2
+static inline __m256i pixel_alpha_avx2(__m256i p, int ashift) {
+    __m256i a = _mm256_and_si256(_mm256_srl_epi32(p, _mm_cvtsi32_si128(ashift)),
+                                 _mm256_set1_epi32(0xFF));
+    a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));
+    return _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_fill_avx2(Uint32 *dst, int n, Uint32 color) {
+    __m256i c = _mm256_set1_epi32((int)color);
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_si256((__m256i *)(dst + i), c);
+    pixel_fill_scalar(dst + i, n - i, color);
+}
+
+// unpack/pack work within each 128-bit half, so lo holds pixels 0, 1, 4, 5 and hi 2, 3, 6, 7
+BUNDLE_TARGET_AVX2
+static void pixel_blend_avx2(const Uint32 *src, Uint32 *dst, int n, int ashift) {
+    __m256i zero = _mm256_setzero_si256(), full = _mm256_set1_epi16(255),
+            amask = _mm256_set1_epi32((int)(0xFFu << ashift));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i)),
+                d = _mm256_loadu_si256((const __m256i *)(dst + i)),
+                a = pixel_alpha_avx2(s, ashift);
+        s = _mm256_or_si256(s, amask);
+        __m256i alo = _mm256_unpacklo_epi8(a, zero), ahi = _mm256_unpackhi_epi8(a, zero);
+        __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), alo),
+                                      _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero),
+                                                         _mm256_sub_epi16(full, alo)));
+        __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), ahi),
+                                      _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero),
+                                                         _mm256_sub_epi16(full, ahi)));
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_packus_epi16(pixel_div255_avx2(lo), pixel_div255_avx2(hi)));
+    }
+    pixel_blend_scalar(src + i, dst + i, n - i, ashift);
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_premultiply_avx2(Uint32 *pixels, int n, int ashift) {
+    __m256i zero = _mm256_setzero_si256(), amask = _mm256_set1_epi32((int)(0xFFu << ashift));
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + i)),
+                a = pixel_alpha_avx2(p, ashift);
+        p = _mm256_or_si256(p, amask);
+        __m256i lo =
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(p, zero), _mm256_unpacklo_epi8(a, zero));
+        __m256i hi =
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(p, zero), _mm256_unpackhi_epi8(a, zero));
+        _mm256_storeu_si256((__m256i *)(pixels + i),
+                            _mm256_packus_epi16(pixel_div255_avx2(lo), pixel_div255_avx2(hi)));
+    }
+    pixel_premultiply_scalar(pixels + i, n - i, ashift);
+}
+
+BUNDLE_TARGET_AVX2
+static inline __m256i pixel_unpremultiply_avx2_half(__m256i c, const Uint32 *q, int first,
+                                                    int ashift, __m256i alane) {
+#define PIXEL_RECIP4(k) (long long)(pixel_recip[(q[k] >> ashift) & 0xFF] * 0x0001000100010001ULL)
+    __m256i r = _mm256_set_epi64x(PIXEL_RECIP4(first + 5), PIXEL_RECIP4(first + 4),
+                                  PIXEL_RECIP4(first + 1), PIXEL_RECIP4(first));
+#undef PIXEL_RECIP4
+    r = _mm256_or_si256(_mm256_andnot_si256(alane, r),
+                        _mm256_and_si256(alane, _mm256_set1_epi16(256)));
+    __m256i x = _mm256_mulhi_epu16(_mm256_slli_epi16(c, 8), r);
+    return _mm256_min_epu16(x, _mm256_set1_epi16(255));
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_unpremultiply_avx2(Uint32 *pixels, int n, int ashift) {
+    __m256i zero = _mm256_setzero_si256(), amask = _mm256_set1_epi32((int)(0xFFu << ashift));
+    __m256i alane = _mm256_unpacklo_epi8(amask, amask);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + i));
+        __m256i lo = pixel_unpremultiply_avx2_half(_mm256_unpacklo_epi8(p, zero), pixels + i, 0,
+                                                   ashift, alane);
+        __m256i hi = pixel_unpremultiply_avx2_half(_mm256_unpackhi_epi8(p, zero), pixels + i, 2,
+                                                   ashift, alane);
+        _mm256_storeu_si256((__m256i *)(pixels + i), _mm256_packus_epi16(lo, hi));
+    }
+    pixel_unpremultiply_scalar(pixels + i, n - i, ashift);
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_swizzle_avx2(const Uint32 *src, Uint32 *dst, int n, SDL_bool left) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(src + i));
+        p = left ? _mm256_or_si256(_mm256_slli_epi32(p, 8), _mm256_srli_epi32(p, 24))
+                 : _mm256_or_si256(_mm256_srli_epi32(p, 8), _mm256_slli_epi32(p, 24));
+        _mm256_storeu_si256((__m256i *)(dst + i), p);
+    }
+    pixel_swizzle_scalar(src + i, dst + i, n - i, left);
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_grayscale_avx2(Uint32 *pixels, int n, const PixelGray *gray) {
+    __m128i rs = _mm_cvtsi32_si128(gray->rshift), gs = _mm_cvtsi32_si128(gray->gshift),
+            bs = _mm_cvtsi32_si128(gray->bshift);
+    __m256i byte = _mm256_set1_epi32(0xFF), keep = _mm256_set1_epi32((int)gray->keep);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + i));
+        __m256i y = _mm256_mullo_epi32(_mm256_and_si256(_mm256_srl_epi32(p, rs), byte),
+                                       _mm256_set1_epi32(77));
+        y = _mm256_add_epi32(y, _mm256_mullo_epi32(_mm256_and_si256(_mm256_srl_epi32(p, gs), byte),
+                                                   _mm256_set1_epi32(150)));
+        y = _mm256_add_epi32(y, _mm256_mullo_epi32(_mm256_and_si256(_mm256_srl_epi32(p, bs), byte),
+                                                   _mm256_set1_epi32(29)));
+        y = _mm256_srli_epi32(_mm256_add_epi32(y, _mm256_set1_epi32(128)), 8);
+        p = _mm256_or_si256(
+            _mm256_and_si256(p, keep),
+            _mm256_or_si256(_mm256_sll_epi32(y, rs),
+                            _mm256_or_si256(_mm256_sll_epi32(y, gs), _mm256_sll_epi32(y, bs))));
+        _mm256_storeu_si256((__m256i *)(pixels + i), p);
+    }
+    pixel_grayscale_scalar(pixels + i, n - i, gray);
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_map_rgba_avx2(const Uint8 *rgba, Uint32 *pixels, int n,
+                                const PixelShuffle *shuffle) {
+    __m128i rs = _mm_cvtsi32_si128(shuffle->rshift), gs = _mm_cvtsi32_si128(shuffle->gshift),
+            bs = _mm_cvtsi32_si128(shuffle->bshift), as = _mm_cvtsi32_si128(shuffle->ashift);
+    __m256i byte = _mm256_set1_epi32(0xFF), amask = _mm256_set1_epi32((int)shuffle->amask);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i *)(rgba + i * 4));
+        __m256i p =
+            _mm256_or_si256(_mm256_sll_epi32(_mm256_and_si256(v, byte), rs),
+                            _mm256_sll_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 8), byte), gs));
+        p = _mm256_or_si256(
+            p, _mm256_sll_epi32(_mm256_and_si256(_mm256_srli_epi32(v, 16), byte), bs));
+        p = _mm256_or_si256(
+            p, _mm256_and_si256(_mm256_sll_epi32(_mm256_srli_epi32(v, 24), as), amask));
+        _mm256_storeu_si256((__m256i *)(pixels + i), p);
+    }
+    pixel_map_rgba_scalar(rgba + i * 4, pixels + i, n - i, shuffle);
+}
+
+BUNDLE_TARGET_AVX2
+static void pixel_get_rgba_avx2(const Uint32 *pixels, Uint8 *rgba, int n,
+                                const PixelShuffle *shuffle) {
+    __m128i rs = _mm_cvtsi32_si128(shuffle->rshift), gs = _mm_cvtsi32_si128(shuffle->gshift),
+            bs = _mm_cvtsi32_si128(shuffle->bshift), as = _mm_cvtsi32_si128(shuffle->ashift);
+    __m256i byte = _mm256_set1_epi32(0xFF), amask = _mm256_set1_epi32((int)shuffle->amask),
+            opaque = _mm256_set1_epi32(shuffle->amask ? 0 : 0xFF);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pixels + i));
+        __m256i v = _mm256_or_si256(
+            _mm256_and_si256(_mm256_srl_epi32(p, rs), byte),
+            _mm256_slli_epi32(_mm256_and_si256(_mm256_srl_epi32(p, gs), byte), 8));
+        v = _mm256_or_si256(
+            v, _mm256_slli_epi32(_mm256_and_si256(_mm256_srl_epi32(p, bs), byte), 16));
+        v = _mm256_or_si256(
+            v, _mm256_slli_epi32(
+                   _mm256_or_si256(_mm256_srl_epi32(_mm256_and_si256(p, amask), as), opaque), 24));
+        _mm256_storeu_si256((__m256i *)(rgba + i * 4), v);
+    }
+    pixel_get_rgba_scalar(pixels + i, rgba + i * 4, n - i, shuffle);
+}
+
+static const PixelKernels pixel_kernels_avx2 = {
+    "avx2",
+    pixel_fill_avx2,
+    pixel_blend_avx2,
+    pixel_premultiply_avx2,
+    pixel_unpremultiply_avx2,
+    pixel_swizzle_avx2,
+    pixel_grayscale_avx2,
+    pixel_map_rgba_avx2,
+    pixel_get_rgba_avx2};
+#endif
+
+#ifdef BUNDLE_NEON
+static inline uint8x8_t pixel_div255_neon(uint16x8_t t) {
+    t = vaddq_u16(t, vdupq_n_u16(128));
+    return vmovn_u16(vshrq_n_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), 8));
+}
+
+static inline uint8x16_t pixel_alpha_neon(uint32x4_t p, int ashift) {
+    uint32x4_t a = vandq_u32(vshlq_u32(p, vdupq_n_s32(-ashift)), vdupq_n_u32(0xFF));
+    return vreinterpretq_u8_u32(vmulq_n_u32(a, 0x01010101));
+}
+
+static void pixel_fill_neon(Uint32 *dst, int n, Uint32 color) {
+    uint32x4_t c = vdupq_n_u32(color);
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        vst1q_u32(dst + i, c);
+    pixel_fill_scalar(dst + i, n - i, color);
+}
+
+static void pixel_blend_neon(const Uint32 *src, Uint32 *dst, int n, int ashift) {
+    uint32x4_t amask = vdupq_n_u32(0xFFu << ashift);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t s = vld1q_u32(src + i);
+        uint8x16_t a = pixel_alpha_neon(s, ashift), ia = vmvnq_u8(a);
+        uint8x16_t s8 = vreinterpretq_u8_u32(vorrq_u32(s, amask)),
+                   d8 = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(s8), vget_low_u8(a)), vget_low_u8(d8),
+                                 vget_low_u8(ia));
+        uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(s8), vget_high_u8(a)), vget_high_u8(d8),
+                                 vget_high_u8(ia));
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(
+                               vcombine_u8(pixel_div255_neon(lo), pixel_div255_neon(hi))));
+    }
+    pixel_blend_scalar(src + i, dst + i, n - i, ashift);
+}
+
+static void pixel_premultiply_neon(Uint32 *pixels, int n, int ashift) {
+    uint32x4_t amask = vdupq_n_u32(0xFFu << ashift);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t p = vld1q_u32(pixels + i);
+        uint8x16_t a = pixel_alpha_neon(p, ashift), p8 = vreinterpretq_u8_u32(vorrq_u32(p, amask));
+        uint16x8_t lo = vmull_u8(vget_low_u8(p8), vget_low_u8(a));
+        uint16x8_t hi = vmull_u8(vget_high_u8(p8), vget_high_u8(a));
+        vst1q_u32(pixels + i, vreinterpretq_u32_u8(
+                                  vcombine_u8(pixel_div255_neon(lo), pixel_div255_neon(hi))));
+    }
+    pixel_premultiply_scalar(pixels + i, n - i, ashift);
+}
+
+static inline uint8x8_t pixel_unpremultiply_neon_half(uint8x8_t c, Uint32 a0, Uint32 a1,
+                                                      uint16x8_t alane) {
+    uint16x8_t r = vcombine_u16(vdup_n_u16(pixel_recip[a0]), vdup_n_u16(pixel_recip[a1]));
+    r = vbslq_u16(alane, vdupq_n_u16(256), r);
+    uint16x8_t x = vshll_n_u8(c, 8);
+    x = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), vget_low_u16(r)), 16),
+                     vshrn_n_u32(vmull_u16(vget_high_u16(x), vget_high_u16(r)), 16));
+    return vmovn_u16(vminq_u16(x, vdupq_n_u16(255)));
+}
+
+static void pixel_unpremultiply_neon(Uint32 *pixels, int n, int ashift) {
+    uint8x8_t amask = vreinterpret_u8_u32(vdup_n_u32(0xFFu << ashift));
+    uint16x8_t alane = vceqq_u16(vmovl_u8(amask), vdupq_n_u16(0xFF));
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const Uint32 *q = pixels + i;
+        uint8x16_t p = vreinterpretq_u8_u32(vld1q_u32(q));
+        uint8x8_t lo = pixel_unpremultiply_neon_half(vget_low_u8(p), (q[0] >> ashift) & 0xFF,
+                                                     (q[1] >> ashift) & 0xFF, alane);
+        uint8x8_t hi = pixel_unpremultiply_neon_half(vget_high_u8(p), (q[2] >> ashift) & 0xFF,
+                                                     (q[3] >> ashift) & 0xFF, alane);
+        vst1q_u32(pixels + i, vreinterpretq_u32_u8(vcombine_u8(lo, hi)));
+    }
+    pixel_unpremultiply_scalar(pixels + i, n - i, ashift);
+}
+
+static void pixel_swizzle_neon(const Uint32 *src, Uint32 *dst, int n, SDL_bool left) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t p = vld1q_u32(src + i);
+        p = left ? vorrq_u32(vshlq_n_u32(p, 8), vshrq_n_u32(p, 24))
+                 : vorrq_u32(vshrq_n_u32(p, 8), vshlq_n_u32(p, 24));
+        vst1q_u32(dst + i, p);
+    }
+    pixel_swizzle_scalar(src + i, dst + i, n - i, left);
+}
+
+static void pixel_grayscale_neon(Uint32 *pixels, int n, const PixelGray *gray) {
+    int32x4_t rs = vdupq_n_s32(gray->rshift), gs = vdupq_n_s32(gray->gshift),
+              bs = vdupq_n_s32(gray->bshift);
+    uint32x4_t byte = vdupq_n_u32(0xFF), keep = vdupq_n_u32(gray->keep);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t p = vld1q_u32(pixels + i);
+        uint32x4_t y = vmulq_n_u32(vandq_u32(vshlq_u32(p, vnegq_s32(rs)), byte), 77);
+        y = vmlaq_n_u32(y, vandq_u32(vshlq_u32(p, vnegq_s32(gs)), byte), 150);
+        y = vmlaq_n_u32(y, vandq_u32(vshlq_u32(p, vnegq_s32(bs)), byte), 29);
+        y = vshrq_n_u32(vaddq_u32(y, vdupq_n_u32(128)), 8);
+        p = vorrq_u32(vandq_u32(p, keep),
+                      vorrq_u32(vshlq_u32(y, rs), vorrq_u32(vshlq_u32(y, gs), vshlq_u32(y, bs))));
+        vst1q_u32(pixels + i, p);
+    }
+    pixel_grayscale_scalar(pixels + i, n - i, gray);
+}
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+static void pixel_map_rgba_neon(const Uint8 *rgba, Uint32 *pixels, int n,
+                                const PixelShuffle *shuffle) {
+    int32x4_t rs = vdupq_n_s32(shuffle->rshift), gs = vdupq_n_s32(shuffle->gshift),
+              bs = vdupq_n_s32(shuffle->bshift), as = vdupq_n_s32(shuffle->ashift);
+    uint32x4_t byte = vdupq_n_u32(0xFF), amask = vdupq_n_u32(shuffle->amask);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t v = vreinterpretq_u32_u8(vld1q_u8(rgba + i * 4));
+        uint32x4_t p = vorrq_u32(vshlq_u32(vandq_u32(v, byte), rs),
+                                 vshlq_u32(vandq_u32(vshrq_n_u32(v, 8), byte), gs));
+        p = vorrq_u32(p, vshlq_u32(vandq_u32(vshrq_n_u32(v, 16), byte), bs));
+        p = vorrq_u32(p, vandq_u32(vshlq_u32(vshrq_n_u32(v, 24), as), amask));
+        vst1q_u32(pixels + i, p);
+    }
+    pixel_map_rgba_scalar(rgba + i * 4, pixels + i, n - i, shuffle);
+}
+
+static void pixel_get_rgba_neon(const Uint32 *pixels, Uint8 *rgba, int n,
+                                const PixelShuffle *shuffle) {
+    int32x4_t rs = vdupq_n_s32(-shuffle->rshift), gs = vdupq_n_s32(-shuffle->gshift),
+              bs = vdupq_n_s32(-shuffle->bshift), as = vdupq_n_s32(-shuffle->ashift);
+    uint32x4_t byte = vdupq_n_u32(0xFF), amask = vdupq_n_u32(shuffle->amask),
+               opaque = vdupq_n_u32(shuffle->amask ? 0 : 0xFF);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        uint32x4_t p = vld1q_u32(pixels + i);
+        uint32x4_t v = vorrq_u32(vandq_u32(vshlq_u32(p, rs), byte),
+                                 vshlq_n_u32(vandq_u32(vshlq_u32(p, gs), byte), 8));
+        v = vorrq_u32(v, vshlq_n_u32(vandq_u32(vshlq_u32(p, bs), byte), 16));
+        v = vorrq_u32(v, vshlq_n_u32(vorrq_u32(vshlq_u32(vandq_u32(p, amask), as), opaque), 24));
+        vst1q_u8(rgba + i * 4, vreinterpretq_u8_u32(v));
+    }
+    pixel_get_rgba_scalar(pixels + i, rgba + i * 4, n - i, shuffle);
+}
+#else
+#define pixel_map_rgba_neon pixel_map_rgba_scalar
+#define pixel_get_rgba_neon pixel_get_rgba_scalar
+#endif
+
+static const PixelKernels pixel_kernels_neon = {
+    "neon",
+    pixel_fill_neon,
+    pixel_blend_neon,
+    pixel_premultiply_neon,
+    pixel_unpremultiply_neon,
+    pixel_swizzle_neon,
+    pixel_grayscale_neon,
+    pixel_map_rgba_neon,
+    pixel_get_rgba_neon};
+#endif
+
+static const PixelKernels *pixel_kernels = NULL;
+
+static const PixelKernels *pixel_find_kernels(const char *name) {
+    if (SDL_strcmp(name, "scalar") == 0) return &pixel_kernels_scalar;
+#ifdef BUNDLE_SSE2
+    if (SDL_strcmp(name, "sse2") == 0) return &pixel_kernels_sse2;
+#endif
+#ifdef BUNDLE_AVX2
+    if (SDL_strcmp(name, "avx2") == 0 && SDL_HasAVX2()) return &pixel_kernels_avx2;
+#endif
+#ifdef BUNDLE_NEON
+    if (SDL_strcmp(name, "neon") == 0 && SDL_HasNEON()) return &pixel_kernels_neon;
+#endif
+    return NULL;
+}
+
+static void pixel_pick_kernels(void) {
+    if (pixel_kernels) return;
+    for (int a = 1; a < 256; a++)
+        pixel_recip[a] = (Uint16)((255 * 256 + a - 1) / a);
+    static const char *const order[] = {"avx2", "neon", "sse2", "scalar"};
+    for (int i = 0; !pixel_kernels; i++)
+        pixel_kernels = pixel_find_kernels(order[i]);
+}
+
+static int pixel_lock(SDL_Surface *surface, SDL_bool alpha) {
+    if (!surface) return SDL_InvalidParamError("surface");
+    const SDL_PixelFormat *f = surface->format;
+    if (f->BytesPerPixel != 4)
+        return SDL_SetError("Pixel kernels need a 32-bit surface; got %s",
+                            SDL_GetPixelFormatName(f->format));
+    if (alpha && f->Amask != 0xFFu << f->Ashift)
+        return SDL_SetError("Surface has no 8-bit alpha channel");
+    pixel_pick_kernels();
+    return SDL_MUSTLOCK(surface) ? SDL_LockSurface(surface) : 0;
+}
+
+// for surfaces about to be written: converted blit copies of them are out of date
+static inline int pixel_lock_write(SDL_Surface *surface, SDL_bool alpha) {
+    if (surface) blitcache_invalidate(surface);
+    return pixel_lock(surface, alpha);
+}
+
+static inline void pixel_unlock(SDL_Surface *surface) {
+    if (SDL_MUSTLOCK(surface)) SDL_UnlockSurface(surface);
+}
+
+// clips rect (or the whole surface) against the surface's clip rect
+static SDL_bool pixel_area(SDL_Surface *surface, const SDL_Rect *rect, SDL_Rect *area) {
+    SDL_Rect all = {0, 0, surface->w, surface->h};
+    return SDL_IntersectRect(rect ? rect : &all, &surface->clip_rect, area);
+}
+
+extern "C" const char *Bundle_SDL_GetPixelKernel(void) {
+    pixel_pick_kernels();
+    return pixel_kernels->name;
+}
+extern "C" int Bundle_SDL_SetPixelKernel(const char *name) {
+    pixel_pick_kernels();
+    const PixelKernels *kernels = pixel_find_kernels(name);
+    if (!kernels) return SDL_SetError("Pixel kernel '%s' is not available on this CPU", name);
+    pixel_kernels = kernels;
+    return 0;
+}
+extern "C" int Bundle_SDL_FillSurface(SDL_Surface *surface, int x, int y, int w, int h,
+                                      Uint32 color) {
+    SDL_Rect rect, area;
+    if (pixel_lock_write(surface, SDL_FALSE) < 0) return -1;
+    if (pixel_area(surface, xywh_rect(&rect, x, y, w, h), &area))
+        for (int row = 0; row < area.h; row++)
+            pixel_kernels->fill(tile_row(surface, area.y + row) + area.x, area.w, color);
+    pixel_unlock(surface);
+    return 0;
+}
+
+// Each byte of from and to is interpolated on its own, so the colours are in the surface's
+// own format and any 32-bit layout works.
+static Uint32 pixel_lerp(Uint32 from, Uint32 to, int i, int n) {
+    if (n <= 1) return from;
+    Uint32 out = 0;
+    for (int sh = 0; sh < 32; sh += 8) {
+        int a = (from >> sh) & 0xFF, b = (to >> sh) & 0xFF;
+        int d = (b - a) * i, half = (n - 1) / 2;
+        out |= (Uint32)(a + (d < 0 ? -((-d + half) / (n - 1)) : (d + half) / (n - 1))) << sh;
+    }
+    return out;
+}
+extern "C" int Bundle_SDL_FillSurfaceGradient(SDL_Surface *surface, int x, int y, int w, int h,
+                                              Uint32 from, Uint32 to, SDL_bool vertical) {
+    SDL_Rect rect, area;
+    if (pixel_lock_write(surface, SDL_FALSE) < 0) return -1;
+    const SDL_Rect *full = xywh_rect(&rect, x, y, w, h);
+    if (!full) full = xywh_rect(&rect, 0, 0, surface->w, surface->h);
+    if (pixel_area(surface, full, &area)) {
+        if (vertical)
+            for (int row = 0; row < area.h; row++)
+                pixel_kernels->fill(tile_row(surface, area.y + row) + area.x, area.w,
+                                    pixel_lerp(from, to, area.y + row - full->y, full->h));
+        else {
+            Uint32 *first = tile_row(surface, area.y) + area.x;
+            for (int col = 0; col < area.w; col++)
+                first[col] = pixel_lerp(from, to, area.x + col - full->x, full->w);
+            for (int row = 1; row < area.h; row++)
+                SDL_memcpy(tile_row(surface, area.y + row) + area.x, first, area.w * 4);
+        }
+    }
+    pixel_unlock(surface);
+    return 0;
+}
+// Source-over blend of src onto dst like SDL_BLENDMODE_BLEND, but with rounded integer math and
+// both surfaces in the same format.
+extern "C" int Bundle_SDL_BlendSurface(SDL_Surface *src, int sx, int sy, int sw, int sh,
+                                       SDL_Surface *dst, int dx, int dy) {
+    SDL_Rect rect, from, area;
+    if (!dst) return SDL_InvalidParamError("dst");
+    if ((src == dst ? pixel_lock_write : pixel_lock)(src, SDL_TRUE) < 0) return -1;
+    if (src != dst && pixel_lock_write(dst, SDL_FALSE) < 0) {
+        pixel_unlock(src);
+        return -1;
+    }
+    if (src->format->format != dst->format->format) {
+        if (src != dst) pixel_unlock(dst);
+        pixel_unlock(src);
+        return SDL_SetError("Cannot blend %s onto %s", SDL_GetPixelFormatName(src->format->format),
+                            SDL_GetPixelFormatName(dst->format->format));
+    }
+    SDL_Rect all = {0, 0, src->w, src->h};
+    if (SDL_IntersectRect(xywh_rect(&rect, sx, sy, sw, sh) ? &rect : &all, &all, &from)) {
+        SDL_Rect to = {dx + from.x - (sw > 0 && sh > 0 ? sx : 0),
+                       dy + from.y - (sw > 0 && sh > 0 ? sy : 0), from.w, from.h};
+        if (SDL_IntersectRect(&to, &dst->clip_rect, &area)) {
+            int ox = from.x + area.x - to.x, oy = from.y + area.y - to.y;
+            for (int row = 0; row < area.h; row++)
+                pixel_kernels->blend(tile_row(src, oy + row) + ox,
+                                     tile_row(dst, area.y + row) + area.x, area.w,
+                                     src->format->Ashift);
+        }
+    }
+    if (src != dst) pixel_unlock(dst);
+    pixel_unlock(src);
+    return 0;
+}
+static int pixel_premultiply(SDL_Surface *surface, SDL_bool reverse) {
+    if (pixel_lock_write(surface, SDL_TRUE) < 0) return -1;
+    for (int row = 0; row < surface->h; row++)
+        (reverse ? pixel_kernels->unpremultiply : pixel_kernels->premultiply)(
+            tile_row(surface, row), surface->w, surface->format->Ashift);
+    pixel_unlock(surface);
+    return 0;
+}
+extern "C" int Bundle_SDL_PremultiplySurfaceAlpha(SDL_Surface *surface) {
+    return pixel_premultiply(surface, SDL_FALSE);
+}
+extern "C" int Bundle_SDL_UnpremultiplySurfaceAlpha(SDL_Surface *surface) {
+    return pixel_premultiply(surface, SDL_TRUE);
+}
+// Moves the fourth byte from one end of each pixel to the other: ARGB8888 <-> RGBA8888 and
+// ABGR8888 <-> BGRA8888, plus their X variants.
+extern "C" int Bundle_SDL_SwizzleSurface(SDL_Surface *src, SDL_Surface *dst) {
+    static const Uint32 pairs[][2] = {
+        {SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGBA8888},
+        {SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGRA8888},
+        {SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_RGBX8888},
+        {SDL_PIXELFORMAT_XBGR8888, SDL_PIXELFORMAT_BGRX8888}};
+    if (!src) return SDL_InvalidParamError("src");
+    if (!dst) return SDL_InvalidParamError("dst");
+    int dir = 0; // 1 rotates left, -1 right
+    for (size_t i = 0; i < SDL_arraysize(pairs) && !dir; i++)
+        if (src->format->format == pairs[i][0] && dst->format->format == pairs[i][1])
+            dir = 1;
+        else if (src->format->format == pairs[i][1] && dst->format->format == pairs[i][0])
+            dir = -1;
+    if (!dir)
+        return SDL_SetError("Cannot swizzle %s to %s", SDL_GetPixelFormatName(src->format->format),
+                            SDL_GetPixelFormatName(dst->format->format));
+    if (src->w != dst->w || src->h != dst->h)
+        return SDL_SetError("Surfaces must be the same size; got %dx%d and %dx%d", src->w, src->h,
+                            dst->w, dst->h);
+    if (pixel_lock(src, SDL_FALSE) < 0) return -1;
+    if (pixel_lock_write(dst, SDL_FALSE) < 0) {
+        pixel_unlock(src);
+        return -1;
+    }
+    for (int row = 0; row < src->h; row++)
+        pixel_kernels->swizzle(tile_row(src, row), tile_row(dst, row), src->w,
+                               dir > 0 ? SDL_TRUE : SDL_FALSE);
+    pixel_unlock(dst);
+    pixel_unlock(src);
+    return 0;
+}
+// Rec. 601 luma in 8-bit fixed point; alpha (or the unused byte) is left alone
+extern "C" int Bundle_SDL_GrayscaleSurface(SDL_Surface *surface) {
+    if (pixel_lock_write(surface, SDL_FALSE) < 0) return -1;
+    const SDL_PixelFormat *f = surface->format;
+    PixelGray gray = {~(f->Rmask | f->Gmask | f->Bmask), f->Rshift, f->Gshift, f->Bshift};
+    for (int row = 0; row < surface->h; row++)
+        pixel_kernels->grayscale(tile_row(surface, row), surface->w, &gray);
+    pixel_unlock(surface);
+    return 0;
+}
+
+// Array forms of SDL_MapRGB(A)/SDL_GetRGB(A). RGB(A) tuples are packed bytes; pixel values are
+// always 32 bits wide whatever the format's depth. Formats with 8 bits per channel in 32-bit
+// pixels go through the pixel kernels; anything else loops over SDL's own functions.
+static SDL_bool pixel_shuffle(const SDL_PixelFormat *f, PixelShuffle *shuffle) {
+    if (f->BytesPerPixel != 4 || f->palette || f->Rloss || f->Gloss || f->Bloss ||
+        (f->Amask && f->Aloss))
+        return SDL_FALSE;
+    shuffle->rshift = f->Rshift;
+    shuffle->gshift = f->Gshift;
+    shuffle->bshift = f->Bshift;
+    shuffle->ashift = f->Ashift;
+    shuffle->amask = f->Amask;
+    return SDL_TRUE;
+}
+static int pixel_map_array(const SDL_PixelFormat *format, const Uint8 *tuples, int channels,
+                           Uint32 *pixels, int count) {
+    if (!format) return SDL_InvalidParamError("format");
+    PixelShuffle shuffle;
+    pixel_pick_kernels();
+    if (channels == 4 && pixel_shuffle(format, &shuffle))
+        pixel_kernels->map_rgba(tuples, pixels, count, &shuffle);
+    else
+        for (int i = 0; i < count; i++, tuples += channels)
+            pixels[i] = channels == 4
+                            ? SDL_MapRGBA(format, tuples[0], tuples[1], tuples[2], tuples[3])
+                            : SDL_MapRGB(format, tuples[0], tuples[1], tuples[2]);
+    return 0;
+}
+static int pixel_get_array(const Uint32 *pixels, int count, const SDL_PixelFormat *format,
+                           Uint8 *tuples, int channels) {
+    if (!format) return SDL_InvalidParamError("format");
+    PixelShuffle shuffle;
+    pixel_pick_kernels();
+    if (channels == 4 && pixel_shuffle(format, &shuffle))
+        pixel_kernels->get_rgba(pixels, tuples, count, &shuffle);
+    else
+        for (int i = 0; i < count; i++, tuples += channels)
+            if (channels == 4)
+                SDL_GetRGBA(pixels[i], format, &tuples[0], &tuples[1], &tuples[2], &tuples[3]);
+            else
+                SDL_GetRGB(pixels[i], format, &tuples[0], &tuples[1], &tuples[2]);
+    return 0;
+}
+extern "C" int Bundle_SDL_MapRGBArray(const SDL_PixelFormat *format, const Uint8 *rgb,
+                                      Uint32 *pixels, int count) {
+    return pixel_map_array(format, rgb, 3, pixels, count);
+}
+extern "C" int Bundle_SDL_MapRGBAArray(const SDL_PixelFormat *format, const Uint8 *rgba,
+                                       Uint32 *pixels, int count) {
+    return pixel_map_array(format, rgba, 4, pixels, count);
+}
+extern "C" int Bundle_SDL_GetRGBArray(const Uint32 *pixels, int count,
+                                      const SDL_PixelFormat *format, Uint8 *rgb) {
+    return pixel_get_array(pixels, count, format, rgb, 3);
+}
+extern "C" int Bundle_SDL_GetRGBAArray(const Uint32 *pixels, int count,
+                                       const SDL_PixelFormat *format, Uint8 *rgba) {
+    return pixel_get_array(pixels, count, format, rgba, 4);
+}
+
+// Pixel views. SDL_GetSurfacePixelsView aliases a perl scalar's string buffer to a surface's
+// pixels (SvLEN of 0 so perl never frees or reallocates it in place). Surfaces created from a
+// perl string go the other way: the surface takes over the string's buffer and holds a reference
+// to the scalar (a pin) until SDL_FreeSurface. The scalar's SvLEN is 0 for pins too, so an append
+// or assignment moves perl onto a copy instead of freeing or reallocating what the surface uses.
+// Either way, set magic copies the new value in, puts the buffer back, and croaks if the length
+// changed. Views are detached (left undef) when the surface's last lock is released; pins are
+// dropped when the surface is freed and the buffer is handed back to the scalar.
+typedef struct PixelsView
+{
+    SV *sv;
+    SDL_Surface *surface;
+    char *pixels;
+    STRLEN len, owned; // owned is the size of a pinned string's allocation: 0 for views
+    SDL_bool pinned;
+    struct PixelsView *next;
+} PixelsView;
+
+static PixelsView *pixels_views = NULL;
+
+static void pixels_view_alias(pTHX_ SV *sv, const PixelsView *view) {
+    SvPV_set(sv, view->pixels);
+    SvLEN_set(sv, 0);
+    SvCUR_set(sv, view->len);
+    SvPOK_only(sv);
+}
+
+static int pixels_view_set(pTHX_ SV *sv, MAGIC *mg) {
+    PixelsView *view = (PixelsView *)mg->mg_ptr;
+    blitcache_invalidate(view->surface);
+    if (SvPOK(sv) && SvPVX(sv) == view->pixels && SvCUR(sv) == view->len) return 0;
+    STRLEN len = 0;
+    const char *pv = SvOK(sv) ? SvPV_const(sv, len) : "";
+    if (pv != view->pixels) SDL_memmove(view->pixels, pv, SDL_min(len, view->len));
+    if (SvIsCOW(sv)) sv_force_normal_flags(sv, SV_COW_DROP_PV);
+    if (SvLEN(sv) && SvPVX(sv) != view->pixels) SvPV_free(sv);
+    pixels_view_alias(aTHX_ sv, view);
+    if (len != view->len)
+        croak("Pixel buffer of %" UVuf " bytes cannot be resized to %" UVuf, (UV)view->len,
+              (UV)len);
+    return 0;
+}
+
+static int pixels_view_free(pTHX_ SV *sv, MAGIC *mg) {
+    PERL_UNUSED_ARG(sv);
+    PixelsView *view = (PixelsView *)mg->mg_ptr;
+    for (PixelsView **at = &pixels_views; *at; at = &(*at)->next)
+        if (*at == view) {
+            *at = view->next;
+            break;
+        }
+    SDL_free(view);
+    return 0;
+}
+
+static MGVTBL pixels_view_vtbl = {NULL,             pixels_view_set, NULL, NULL,
+                                  pixels_view_free, NULL,            NULL, NULL};
+
+static int pixels_view_attach(pTHX_ SV *sv, SDL_Surface *surface, SDL_bool pinned) {
+    PixelsView *view = (PixelsView *)SDL_malloc(sizeof(PixelsView));
+    if (!view) return SDL_OutOfMemory();
+    view->sv = pinned ? SvREFCNT_inc_simple_NN(sv) : sv;
+    view->surface = surface;
+    view->pixels = (char *)surface->pixels;
+    view->len = pinned ? SvCUR(sv) : (STRLEN)surface->pitch * surface->h;
+    view->owned = pinned ? SvLEN(sv) : 0; // pixels_pin made sure SvPVX is the allocation
+    view->pinned = pinned;
+    view->next = pixels_views;
+    pixels_views = view;
+    SvUPGRADE(sv, SVt_PVMG);
+    if (!pinned && SvLEN(sv)) SvPV_free(sv);
+    pixels_view_alias(aTHX_ sv, view);
+    sv_magicext(sv, NULL, PERL_MAGIC_ext, &pixels_view_vtbl, (const char *)view, 0);
+    return 0;
+}
+
+static void pixels_views_invalidate(SDL_Surface *surface, SDL_bool freeing) {
+    dTHX;
+    PixelsView *view = pixels_views;
+    while (view) {
+        if (view->surface != surface || (view->pinned && !freeing)) {
+            view = view->next;
+            continue;
+        }
+        SV *sv = view->sv;
+        SDL_bool pinned = view->pinned;
+        if (!pinned) {
+            SvPV_set(sv, NULL);
+            SvCUR_set(sv, 0);
+            SvOK_off(sv);
+        }
+        else if (SvPVX(sv) != view->pixels)
+            Safefree(view->pixels); // Something bypassed set magic; the buffer is ours to free
+        else if (SvLEN(sv) == 0)
+            SvLEN_set(sv, view->owned); // The scalar owns its buffer again
+        sv_unmagicext(sv, PERL_MAGIC_ext, &pixels_view_vtbl); // frees view
+        if (pinned) SvREFCNT_dec(sv);
+        view = pixels_views;
+    }
+}
+
+// Finds the memory behind a pixels argument. The caller says which it is: is_pointer means sv
+// holds a native address (as a number or a string of digits); otherwise it is a string used in
+// place (made writable and unshared first). need is the smallest acceptable length; grow extends
+// shorter (or undefined) strings instead of failing.
+static char *pixels_buffer(pTHX_ SV *sv, SDL_bool is_pointer, STRLEN need, SDL_bool grow) {
+    if (SvROK(sv)) sv = SvRV(sv);
+    if (is_pointer) {
+        if (!SvOK(sv) || !looks_like_number(sv)) {
+            SDL_SetError("Pixels must be a pointer or a reference to a packed string");
+            return NULL;
+        }
+        char *pointer = INT2PTR(char *, SvUV(sv));
+        if (!pointer) SDL_InvalidParamError("pixels");
+        return pointer;
+    }
+    if (!SvPOK(sv) && !(grow && !SvOK(sv))) {
+        SDL_SetError("Pixels must be a pointer or a reference to a packed string");
+        return NULL;
+    }
+    if (SvREADONLY(sv)) {
+        SDL_SetError("Pixel buffer is read-only");
+        return NULL;
+    }
+    STRLEN len = 0;
+    if (!SvOK(sv)) sv_setpvs(sv, "");
+    if (SvUTF8(sv) && !sv_utf8_downgrade(sv, TRUE)) {
+        SDL_SetError("Pixel buffer contains wide characters");
+        return NULL;
+    }
+    char *pv = SvPV_force(sv, len);
+    if (len < need) {
+        if (!grow || SvLEN(sv) == 0 || SvMAGICAL(sv)) { // Views and pins cannot be resized
+            SDL_SetError("Pixel buffer is %" UVuf " bytes; %" UVuf " are needed", (UV)len,
+                         (UV)need);
+            return NULL;
+        }
+        pv = SvGROW(sv, need + 1);
+        SDL_memset(pv + len, 0, need + 1 - len);
+        SvCUR_set(sv, need);
+    }
+    return pv;
+}
+
+// A string that is already a view or pinned to another surface is copied so each surface owns
+// exactly one buffer.
+static SDL_Surface *pixels_pin(pTHX_ SV *sv, SDL_bool is_pointer,
+                               SDL_Surface *(*create)(void *, const void *), const void *args,
+                               STRLEN need) {
+    if (SvROK(sv)) sv = SvRV(sv);
+    SV *copy = NULL;
+    if (!is_pointer && SvPOK(sv) &&
+        (SvREADONLY(sv) || SvLEN(sv) == 0 ||
+         (SvTYPE(sv) >= SVt_PVMG && mg_findext(sv, PERL_MAGIC_ext, &pixels_view_vtbl))))
+        sv = copy = newSVpvn(SvPVX(sv), SvCUR(sv));
+    char *pixels = pixels_buffer(aTHX_ sv, is_pointer, need, SDL_FALSE);
+    if (pixels && !is_pointer && SvOOK(sv)) { // Chopped strings don't start at their
+        SvOOK_off(sv);                                   // allocation; move the data back
+        pixels = SvPVX(sv);
+    }
+    SDL_Surface *surface = pixels ? create(pixels, args) : NULL;
+    if (surface && !is_pointer && pixels_view_attach(aTHX_ sv, surface, SDL_TRUE) < 0) {
+        SDL_FreeSurface(surface);
+        surface = NULL;
+    }
+    if (copy) SvREFCNT_dec(copy);
+    return surface;
+}
+
+typedef struct PixelsFrom
+{
+    int width, height, depth, pitch;
+    Uint32 Rmask, Gmask, Bmask, Amask, format;
+} PixelsFrom;
+
+static SDL_Surface *pixels_create_masks(void *pixels, const void *args) {
+    const PixelsFrom *from = (const PixelsFrom *)args;
+    return SDL_CreateRGBSurfaceFrom(pixels, from->width, from->height, from->depth, from->pitch,
+                                    from->Rmask, from->Gmask, from->Bmask, from->Amask);
+}
+
+static SDL_Surface *pixels_create_format(void *pixels, const void *args) {
+    const PixelsFrom *from = (const PixelsFrom *)args;
+    return SDL_CreateRGBSurfaceWithFormatFrom(pixels, from->width, from->height, from->depth,
+                                              from->pitch, from->format);
+}
+
+extern "C" SDL_Surface *Bundle_SDL_CreateRGBSurfaceFrom(SV *pixels, SDL_bool is_pointer,
+                                                        int width, int height, int depth,
+                                                        int pitch, Uint32 Rmask, Uint32 Gmask,
+                                                        Uint32 Bmask, Uint32 Amask) {
+    dTHX;
+    PixelsFrom from = {width, height, depth, pitch, Rmask, Gmask, Bmask, Amask, 0};
+    return pixels_pin(aTHX_ pixels, is_pointer, pixels_create_masks, &from,
+                      (STRLEN)SDL_max(pitch, 0) * SDL_max(height, 0));
+}
+extern "C" SDL_Surface *Bundle_SDL_CreateRGBSurfaceWithFormatFrom(SV *pixels,
+                                                                  SDL_bool is_pointer, int width,
+                                                                  int height, int depth, int pitch,
+                                                                  Uint32 format) {
+    dTHX;
+    PixelsFrom from = {width, height, depth, pitch, 0, 0, 0, 0, format};
+    return pixels_pin(aTHX_ pixels, is_pointer, pixels_create_format, &from,
+                      (STRLEN)SDL_max(pitch, 0) * SDL_max(height, 0));
+}
+extern "C" int Bundle_SDL_ConvertPixels(int width, int height, Uint32 src_format, SV *src,
+                                        SDL_bool src_is_pointer, int src_pitch, Uint32 dst_format,
+                                        SV *dst, SDL_bool dst_is_pointer, int dst_pitch) {
+    dTHX;
+    STRLEN rows = (STRLEN)SDL_max(height, 0);
+    const char *from =
+        pixels_buffer(aTHX_ src, src_is_pointer, (STRLEN)SDL_max(src_pitch, 0) * rows, SDL_FALSE);
+    if (!from) return -1;
+    char *to =
+        pixels_buffer(aTHX_ dst, dst_is_pointer, (STRLEN)SDL_max(dst_pitch, 0) * rows, SDL_TRUE);
+    if (!to) return -1;
+    int ret =
+        SDL_ConvertPixels(width, height, src_format, from, src_pitch, dst_format, to, dst_pitch);
+    if (SvROK(dst)) dst = SvRV(dst);
+    if (!dst_is_pointer) SvSETMAGIC(dst); // Views and pins see the write
+    return ret;
+}
+extern "C" int Bundle_SDL_GetSurfacePixelsView(SDL_Surface *surface, SV *sv) {
+    dTHX;
+    if (!surface) return SDL_InvalidParamError("surface");
+    if (SDL_MUSTLOCK(surface) && !surface->locked)
+        return SDL_SetError("Surface must be locked with SDL_LockSurface( ) first");
+    if (!surface->pixels) return SDL_SetError("Surface has no pixels");
+    return pixels_view_attach(aTHX_ sv, surface, SDL_FALSE);
+}
+extern "C" void Bundle_SDL_UnlockSurface(SDL_Surface *surface) {
+    if (surface && surface->locked <= 1) pixels_views_invalidate(surface, SDL_FALSE);
+    SDL_UnlockSurface(surface);
+}
+extern "C" void Bundle_SDL_FreeSurface(SDL_Surface *surface) {
+    if (surface && surface->refcount <= 1) {
+        pixels_views_invalidate(surface, SDL_TRUE);
+        blitcache_invalidate(surface);
+    }
+    SDL_FreeSurface(surface);
+}
+
+// Surface pool. Scratch surfaces are handed out by (w, h, format) and kept on release instead of
+// freed. Idle surfaces sit in one array in release order: acquire takes the newest match (its
+// pixels are the most likely to still be in cache) and trimming frees from the oldest end.
+typedef struct SDL_SurfacePoolStats
+{
+    Uint32 hits;      // acquires served from an idle surface
+    Uint32 misses;    // acquires that created a surface
+    Uint32 releases;  // surfaces kept for reuse
+    Uint32 evictions; // idle surfaces freed to stay within budget
+    int idle;         // surfaces waiting to be reused
+    int outstanding;  // surfaces acquired and not yet released
+    Uint64 bytes;     // pixel memory held by idle surfaces
+    Uint64 budget;    // the limit for bytes
+    float hit_rate;   // hits / (hits + misses)
+} SDL_SurfacePoolStats;
+
+typedef struct SDL_SurfacePool
+{
+    SDL_Surface **idle;
+    int max_idle;
+    SDL_SurfacePoolStats stats;
+} SDL_SurfacePool;
+
+static Uint64 surfpool_bytes(SDL_Surface *surface) {
+    return (Uint64)surface->pitch * surface->h;
+}
+
+static SDL_Surface *surfpool_take(SDL_SurfacePool *pool, int index) {
+    SDL_Surface *surface = pool->idle[index];
+    pool->stats.bytes -= surfpool_bytes(surface);
+    SDL_memmove(&pool->idle[index], &pool->idle[index + 1],
+                (pool->stats.idle - index - 1) * sizeof(SDL_Surface *));
+    pool->stats.idle--;
+    return surface;
+}
+
+// Free the oldest idle surfaces until no more than keep bytes are held
+static void surfpool_trim(SDL_SurfacePool *pool, Uint64 keep) {
+    while (pool->stats.idle && pool->stats.bytes > keep) {
+        SDL_FreeSurface(surfpool_take(pool, 0));
+        pool->stats.evictions++;
+    }
+}
+
+extern "C" SDL_SurfacePool *Bundle_SDL_CreateSurfacePool(Uint64 budget) {
+    SDL_SurfacePool *pool = (SDL_SurfacePool *)SDL_calloc(1, sizeof(SDL_SurfacePool));
+    if (!pool) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    pool->stats.budget = budget;
+    return pool;
+}
+extern "C" void Bundle_SDL_DestroySurfacePool(SDL_SurfacePool *pool) {
+    if (!pool) return;
+    for (int i = 0; i < pool->stats.idle; i++)
+        SDL_FreeSurface(pool->idle[i]);
+    SDL_free(pool->idle);
+    SDL_free(pool);
+}
+extern "C" SDL_Surface *Bundle_SDL_SurfacePoolAcquire(SDL_SurfacePool *pool, int w, int h,
+                                                      Uint32 format, SDL_bool clear) {
+    for (int i = pool->stats.idle - 1; i >= 0; i--) {
+        SDL_Surface *surface = pool->idle[i];
+        if (surface->w != w || surface->h != h || surface->format->format != format) continue;
+        surfpool_take(pool, i);
+        pool->stats.hits++;
+        pool->stats.outstanding++;
+        if (clear) SDL_memset(surface->pixels, 0, (size_t)surfpool_bytes(surface));
+        return surface;
+    }
+    // New surfaces come back zeroed from SDL either way
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, format);
+    if (!surface) return NULL;
+    pool->stats.misses++;
+    pool->stats.outstanding++;
+    return surface;
+}
+extern "C" void Bundle_SDL_SurfacePoolRelease(SDL_SurfacePool *pool, SDL_Surface *surface) {
+    if (!surface) return;
+    pool->stats.outstanding = SDL_max(pool->stats.outstanding - 1, 0);
+    // Only plain, unshared surfaces that own their pixels are worth keeping. Palettes could have
+    // been edited and aren't worth resetting. RLE encoding may have freed the pixels in favour of
+    // the encoded copy, so those surfaces can't be handed back out as plain ones either.
+    Uint64 bytes = surfpool_bytes(surface);
+    if (surface->refcount != 1 || surface->locked || (surface->flags & SDL_PREALLOC) ||
+        (surface->flags & SDL_RLEACCEL) || SDL_ISPIXELFORMAT_INDEXED(surface->format->format) ||
+        (pool->stats.budget && bytes > pool->stats.budget)) {
+        Bundle_SDL_FreeSurface(surface);
+        return;
+    }
+    if (pool->stats.idle == pool->max_idle) {
+        int max_idle = pool->max_idle ? pool->max_idle * 2 : 16;
+        SDL_Surface **idle =
+            (SDL_Surface **)SDL_realloc(pool->idle, max_idle * sizeof(SDL_Surface *));
+        if (!idle) {
+            Bundle_SDL_FreeSurface(surface);
+            return;
+        }
+        pool->idle = idle;
+        pool->max_idle = max_idle;
+    }
+    // Hand it back out the way SDL_CreateRGBSurfaceWithFormat would have
+    pixels_views_invalidate(surface, SDL_TRUE);
+    blitcache_invalidate(surface);
+    SDL_SetSurfaceRLE(surface, 0);
+    SDL_SetColorKey(surface, SDL_FALSE, 0);
+    SDL_SetSurfaceColorMod(surface, 255, 255, 255);
+    SDL_SetSurfaceAlphaMod(surface, 255);
+    SDL_SetSurfaceBlendMode(surface,
+                            surface->format->Amask ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    SDL_SetClipRect(surface, NULL);
+    surface->userdata = NULL;
+    if (pool->stats.budget) surfpool_trim(pool, pool->stats.budget - bytes);
+    pool->idle[pool->stats.idle++] = surface;
+    pool->stats.bytes += bytes;
+    pool->stats.releases++;
+}
+extern "C" void Bundle_SDL_SurfacePoolTrim(SDL_SurfacePool *pool, Uint64 keep) {
+    surfpool_trim(pool, keep);
+}
+extern "C" void Bundle_SDL_SurfacePoolSetBudget(SDL_SurfacePool *pool, Uint64 budget) {
+    pool->stats.budget = budget;
+    if (budget) surfpool_trim(pool, budget);
+}
+extern "C" void Bundle_SDL_GetSurfacePoolStats(SDL_SurfacePool *pool, SDL_SurfacePoolStats *stats) {
+    *stats = pool->stats;
+    Uint32 acquires = stats->hits + stats->misses;
+    stats->hit_rate = acquires ? (float)stats->hits / acquires : 0.0f;
+}
+
+// Image filters for 32-bit surfaces with 8-bit channels: separable Gaussian and box blur,
+// Lanczos/bicubic/bilinear resampling, and 3x3 or 5x5 convolution. All four bytes of a pixel are
+// filtered alike, so any 8888 channel order works. Separable filters make one output row at a
+// time: a vertical pass accumulates the source rows under the row's taps into a float row, then
+// a horizontal pass gathers each output pixel's taps from it. Edges are clamped by folding the
+// weight of out-of-range taps onto the edge pixel when the taps are built. Row bands are shared
+// out to a pool of worker threads. The inner loops have scalar, SSE2, AVX2 and NEON versions
+// that follow SDL_SetPixelKernel; they add the same products in the same order, so the x86
+// versions produce the same pixels.
+#define FILTER_MAX_THREADS 64
+
+typedef enum SDL_ResampleFilter
+{
+    SDL_RESAMPLE_BILINEAR,
+    SDL_RESAMPLE_BICUBIC, // Catmull-Rom
+    SDL_RESAMPLE_LANCZOS3
+} SDL_ResampleFilter;
+
+typedef struct FilterTaps
+{
+    int *start, *count; // per output pixel: the first source pixel and how many follow
+    float *weights;     // stride floats per output pixel, normalized to sum to 1
+    int stride;
+} FilterTaps;
+
+typedef struct FilterKernels
+{
+    void (*axpy)(float *acc, const Uint8 *row, float w, int n); // acc += w * row, n pixels
+    void (*gather)(float *out, const float *in, const FilterTaps *taps, int n);
+    void (*store)(Uint8 *dst, const float *in, float bias, int n); // round and clamp
+} FilterKernels;
+
+typedef struct FilterJob
+{
+    const FilterKernels *fk;
+    const Uint8 *src;
+    int src_pitch, src_w, src_h;
+    Uint8 *dst;
+    int dst_pitch, dst_w, dst_h;
+    const FilterTaps *tx, *ty; // separable filters
+    const float *kernel;       // convolution: k * k weights, already divided
+    int k;
+    float bias;
+    Uint32 amask; // convolution copies these bits from the source
+    int ashift;   // separable filters: >= 0 when src was premultiplied and dst rows need undoing
+    void (*rows)(struct FilterJob *job, int y0, int y1);
+    int band, bands;
+    SDL_atomic_t next, failed;
+} FilterJob;
+
+static void filter_axpy_scalar(float *acc, const Uint8 *row, float w, int n) {
+    for (int i = 0; i < n * 4; i++)
+        acc[i] += w * row[i];
+}
+
+static void filter_gather_scalar(float *out, const float *in, const FilterTaps *taps, int n) {
+    for (int x = 0; x < n; x++) {
+        const float *w = taps->weights + x * taps->stride, *p = in + taps->start[x] * 4;
+        for (int c = 0; c < 4; c++) {
+            float acc = 0.0f;
+            for (int i = 0; i < taps->count[x]; i++)
+                acc += w[i] * p[i * 4 + c];
+            out[x * 4 + c] = acc;
+        }
+    }
+}
+
+static void filter_store_scalar(Uint8 *dst, const float *in, float bias, int n) {
+    for (int i = 0; i < n * 4; i++) // lrintf rounds half to even like cvtps2dq
+        dst[i] = (Uint8)lrintf(SDL_min(SDL_max(in[i] + bias, 0.0f), 255.0f));
+}
+
+static const FilterKernels filter_kernels_scalar = {
+    filter_axpy_scalar, filter_gather_scalar, filter_store_scalar};
+
+#ifdef BUNDLE_SSE2
+static void filter_axpy_sse2(float *acc, const Uint8 *row, float w, int n) {
+    const __m128 vw = _mm_set1_ps(w);
+    const __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= n * 4; i += 16) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(row + i));
+        __m128i lo = _mm_unpacklo_epi8(p, zero), hi = _mm_unpackhi_epi8(p, zero);
+        __m128i q[4] = {_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                        _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+        for (int j = 0; j < 4; j++)
+            _mm_storeu_ps(acc + i + j * 4,
+                          _mm_add_ps(_mm_loadu_ps(acc + i + j * 4),
+                                     _mm_mul_ps(vw, _mm_cvtepi32_ps(q[j]))));
+    }
+    for (; i < n * 4; i++)
+        acc[i] += w * row[i];
+}
+
+// A pixel's four channels fill one register, so each tap is a single multiply and add
+static void filter_gather_sse2(float *out, const float *in, const FilterTaps *taps, int n) {
+    for (int x = 0; x < n; x++) {
+        const float *w = taps->weights + x * taps->stride, *p = in + taps->start[x] * 4;
+        __m128 acc = _mm_setzero_ps();
+        for (int i = 0; i < taps->count[x]; i++)
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[i]), _mm_loadu_ps(p + i * 4)));
+        _mm_storeu_ps(out + x * 4, acc);
+    }
+}
+
+static void filter_store_sse2(Uint8 *dst, const float *in, float bias, int n) {
+    const __m128 vb = _mm_set1_ps(bias), lo = _mm_setzero_ps(), hi = _mm_set1_ps(255.0f);
+    int i = 0;
+    for (; i + 16 <= n * 4; i += 16) {
+        __m128i q[4];
+        for (int j = 0; j < 4; j++)
+            q[j] = _mm_cvtps_epi32(
+                _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_loadu_ps(in + i + j * 4), vb), lo), hi));
+        __m128i lo16 = _mm_packs_epi32(q[0], q[1]), hi16 = _mm_packs_epi32(q[2], q[3]);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo16, hi16));
+    }
+    filter_store_scalar(dst + i, in + i, bias, (n * 4 - i) / 4);
+}
+
+static const FilterKernels filter_kernels_sse2 = {
+    filter_axpy_sse2, filter_gather_sse2, filter_store_sse2};
+#endif
+
+#ifdef BUNDLE_AVX2
+BUNDLE_TARGET_AVX2 static void filter_axpy_avx2(float *acc, const Uint8 *row, float w, int n) {
+    const __m256 vw = _mm256_set1_ps(w);
+    int i = 0;
+    for (; i + 8 <= n * 4; i += 8) {
+        __m256 p = _mm256_cvtepi32_ps(
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(row + i))));
+        _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(vw, p)));
+    }
+    for (; i < n * 4; i++)
+        acc[i] += w * row[i];
+}
+
+// Gathers and stores are bound by their loads; the SSE2 versions are as fast
+static const FilterKernels filter_kernels_avx2 = {
+    filter_axpy_avx2, filter_gather_sse2, filter_store_sse2};
+#endif
+
+#ifdef BUNDLE_NEON
+static void filter_axpy_neon(float *acc, const Uint8 *row, float w, int n) {
+    const float32x4_t vw = vdupq_n_f32(w);
+    int i = 0;
+    for (; i + 8 <= n * 4; i += 8) {
+        uint16x8_t p = vmovl_u8(vld1_u8(row + i));
+        float32x4_t lo = vcvtq_f32_u32(vmovl_u16(vget_low_u16(p)));
+        float32x4_t hi = vcvtq_f32_u32(vmovl_u16(vget_high_u16(p)));
+        vst1q_f32(acc + i, vaddq_f32(vld1q_f32(acc + i), vmulq_f32(vw, lo)));
+        vst1q_f32(acc + i + 4, vaddq_f32(vld1q_f32(acc + i + 4), vmulq_f32(vw, hi)));
+    }
+    for (; i < n * 4; i++)
+        acc[i] += w * row[i];
+}
+
+static void filter_gather_neon(float *out, const float *in, const FilterTaps *taps, int n) {
+    for (int x = 0; x < n; x++) {
+        const float *w = taps->weights + x * taps->stride, *p = in + taps->start[x] * 4;
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (int i = 0; i < taps->count[x]; i++)
+            acc = vaddq_f32(acc, vmulq_f32(vdupq_n_f32(w[i]), vld1q_f32(p + i * 4)));
+        vst1q_f32(out + x * 4, acc);
+    }
+}
+
+static void filter_store_neon(Uint8 *dst, const float *in, float bias, int n) {
+    const float32x4_t vb = vdupq_n_f32(bias), lo = vdupq_n_f32(0.0f), hi = vdupq_n_f32(255.0f);
+    int i = 0;
+    for (; i + 8 <= n * 4; i += 8) {
+        uint32x4_t q[2];
+        for (int j = 0; j < 2; j++) {
+            float32x4_t v = vminq_f32(vmaxq_f32(vaddq_f32(vld1q_f32(in + i + j * 4), vb), lo), hi);
+#if defined(__aarch64__)
+            q[j] = vcvtnq_u32_f32(v);
+#else // No round-to-nearest conversion on 32-bit ARM; ties round up here
+            q[j] = vcvtq_u32_f32(vaddq_f32(v, vdupq_n_f32(0.5f)));
+#endif
+        }
+        vst1_u8(dst + i, vmovn_u16(vcombine_u16(vmovn_u32(q[0]), vmovn_u32(q[1]))));
+    }
+    filter_store_scalar(dst + i, in + i, bias, (n * 4 - i) / 4);
+}
+
+static const FilterKernels filter_kernels_neon = {
+    filter_axpy_neon, filter_gather_neon, filter_store_neon};
+#endif
+
+static const FilterKernels *filter_kernels(void) {
+    pixel_pick_kernels();
+#ifdef BUNDLE_AVX2
+    if (pixel_kernels == &pixel_kernels_avx2) return &filter_kernels_avx2;
+#endif
+#ifdef BUNDLE_NEON
+    if (pixel_kernels == &pixel_kernels_neon) return &filter_kernels_neon;
+#endif
+#ifdef BUNDLE_SSE2
+    if (pixel_kernels != &pixel_kernels_scalar) return &filter_kernels_sse2;
+#endif
+    return &filter_kernels_scalar;
+}
+
+static float filter_box(float, float) {
+    return 1.0f;
+}
+static float filter_gaussian(float x, float sigma) {
+    return SDL_expf(-x * x / (2 * sigma * sigma));
+}
+static float filter_triangle(float x, float) {
+    return SDL_max(1.0f - SDL_fabsf(x), 0.0f);
+}
+static float filter_catmull_rom(float x, float) {
+    x = SDL_fabsf(x);
+    if (x < 1.0f) return (1.5f * x - 2.5f) * x * x + 1.0f;
+    if (x < 2.0f) return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+    return 0.0f;
+}
+static float filter_lanczos3(float x, float) {
+    if (x == 0.0f) return 1.0f;
+    if (x <= -3.0f || x >= 3.0f) return 0.0f;
+    float px = (float)M_PI * x;
+    return 3.0f * SDL_sinf(px) * SDL_sinf(px / 3.0f) / (px * px);
+}
+
+static void filter_taps_free(FilterTaps *taps) {
+    SDL_free(taps->start);
+    SDL_free(taps->count);
+    SDL_free(taps->weights);
+}
+
+// Taps mapping src_n pixels onto dst_n with kernel(x, param) reaching support source pixels each
+// way (widened by the scale factor when shrinking so every source pixel contributes).
+static int filter_taps(FilterTaps *taps, int src_n, int dst_n, float (*kernel)(float, float),
+                       float param, float support) {
+    float scale = (float)src_n / dst_n, widen = SDL_max(scale, 1.0f), reach = support * widen;
+    taps->stride = (int)SDL_ceilf(reach * 2) + 2;
+    taps->start = (int *)SDL_malloc(dst_n * sizeof(int));
+    taps->count = (int *)SDL_malloc(dst_n * sizeof(int));
+    taps->weights = (float *)SDL_calloc((size_t)dst_n * taps->stride, sizeof(float));
+    if (!taps->start || !taps->count || !taps->weights) {
+        filter_taps_free(taps);
+        return SDL_OutOfMemory();
+    }
+    for (int o = 0; o < dst_n; o++) {
+        float center = (o + 0.5f) * scale - 0.5f, sum = 0.0f;
+        int lo = (int)SDL_floorf(center - reach) + 1, hi = (int)SDL_floorf(center + reach);
+        int first = SDL_min(SDL_max(lo, 0), src_n - 1), last = SDL_min(SDL_max(hi, 0), src_n - 1);
+        float *w = taps->weights + o * taps->stride;
+        for (int s = lo; s <= hi; s++) {
+            float v = kernel((s - center) / widen, param);
+            w[SDL_min(SDL_max(s, first), last) - first] += v;
+            sum += v;
+        }
+        taps->start[o] = first;
+        taps->count[o] = last - first + 1;
+        if (sum == 0.0f) { // Nothing in reach; take the nearest pixel
+            SDL_memset(w, 0, taps->count[o] * sizeof(float));
+            w[SDL_min(SDL_max((int)SDL_floorf(center + 0.5f), first), last) - first] = 1.0f;
+            continue;
+        }
+        for (int i = 0; i < taps->count[o]; i++)
+            w[i] /= sum;
+    }
+    return 0;
+}
+
+static void filter_separable_rows(FilterJob *job, int y0, int y1) {
+    float *acc = (float *)SDL_malloc(((size_t)job->src_w + job->dst_w) * 4 * sizeof(float));
+    if (!acc) {
+        SDL_AtomicSet(&job->failed, 1);
+        return;
+    }
+    float *out = acc + job->src_w * 4;
+    for (int y = y0; y < y1; y++) {
+        const float *w = job->ty->weights + y * job->ty->stride;
+        const Uint8 *row = job->src + (size_t)job->ty->start[y] * job->src_pitch;
+        SDL_memset(acc, 0, job->src_w * 4 * sizeof(float));
+        for (int j = 0; j < job->ty->count[y]; j++, row += job->src_pitch)
+            job->fk->axpy(acc, row, w[j], job->src_w);
+        job->fk->gather(out, acc, job->tx, job->dst_w);
+        Uint8 *dst = job->dst + (size_t)y * job->dst_pitch;
+        job->fk->store(dst, out, 0.0f, job->dst_w);
+        if (job->ashift >= 0) pixel_kernels->unpremultiply((Uint32 *)dst, job->dst_w, job->ashift);
+    }
+    SDL_free(acc);
+}
+
+// Each of the k source rows is copied with its edge pixels repeated, so the k taps along a row
+// are plain offsets into it.
+static void filter_convolve_rows(FilterJob *job, int y0, int y1) {
+    int r = job->k / 2, w = job->src_w, padded = w + 2 * r;
+    float *acc = (float *)SDL_malloc(w * 4 * sizeof(float));
+    Uint32 *pad = (Uint32 *)SDL_malloc(padded * sizeof(Uint32));
+    if (!acc || !pad) {
+        SDL_free(acc);
+        SDL_free(pad);
+        SDL_AtomicSet(&job->failed, 1);
+        return;
+    }
+    for (int y = y0; y < y1; y++) {
+        SDL_memset(acc, 0, w * 4 * sizeof(float));
+        for (int j = 0; j < job->k; j++) {
+            int sy = SDL_min(SDL_max(y + j - r, 0), job->src_h - 1);
+            const Uint32 *row = (const Uint32 *)(job->src + (size_t)sy * job->src_pitch);
+            for (int x = 0; x < padded; x++)
+                pad[x] = row[SDL_min(SDL_max(x - r, 0), w - 1)];
+            for (int i = 0; i < job->k; i++)
+                job->fk->axpy(acc, (const Uint8 *)(pad + i), job->kernel[j * job->k + i], w);
+        }
+        Uint32 *dst = (Uint32 *)(job->dst + (size_t)y * job->dst_pitch);
+        job->fk->store((Uint8 *)dst, acc, job->bias, w);
+        if (job->amask) {
+            const Uint32 *src = (const Uint32 *)(job->src + (size_t)y * job->src_pitch);
+            for (int x = 0; x < w; x++)
+                dst[x] = (dst[x] & ~job->amask) | (src[x] & job->amask);
+        }
+    }
+    SDL_free(acc);
+    SDL_free(pad);
+}
+
+// The worker pool is shared by every filter call; callers take turns using it.
+static struct
+{
+    SDL_mutex *lock;
+    SDL_sem *start, *done;
+    SDL_Thread *workers[FILTER_MAX_THREADS];
+    int threads; // including the calling thread; 0 until first used
+    SDL_atomic_t quit;
+    FilterJob *job;
+} filter_pool;
+static SDL_SpinLock filter_pool_init;
+
+static void filter_drain(FilterJob *job) {
+    int band;
+    while ((band = SDL_AtomicAdd(&job->next, 1)) < job->bands)
+        job->rows(job, band * job->band, SDL_min((band + 1) * job->band, job->dst_h));
+}
+
+static int SDLCALL filter_worker(void *) {
+    while (1) {
+        SDL_SemWait(filter_pool.start);
+        if (SDL_AtomicGet(&filter_pool.quit)) break;
+        filter_drain(filter_pool.job);
+        SDL_SemPost(filter_pool.done);
+    }
+    return 0;
+}
+
+// Stop the workers and start threads - 1 new ones. Called with the pool locked.
+static int filter_pool_resize(int threads) {
+    SDL_AtomicSet(&filter_pool.quit, 1);
+    for (int i = 1; i < filter_pool.threads; i++)
+        SDL_SemPost(filter_pool.start);
+    for (int i = 1; i < filter_pool.threads; i++)
+        SDL_WaitThread(filter_pool.workers[i], NULL);
+    SDL_AtomicSet(&filter_pool.quit, 0);
+    if (threads <= 0) threads = SDL_GetCPUCount();
+    threads = SDL_min(SDL_max(threads, 1), FILTER_MAX_THREADS);
+    for (filter_pool.threads = 1; filter_pool.threads < threads; filter_pool.threads++) {
+        SDL_Thread *thread = SDL_CreateThread(filter_worker, "SDL3::Filter", NULL);
+        if (!thread) return -1; // Keep the ones that did start
+        filter_pool.workers[filter_pool.threads] = thread;
+    }
+    return 0;
+}
+
+static int filter_pool_lock(void) {
+    SDL_AtomicLock(&filter_pool_init);
+    if (!filter_pool.lock) {
+        filter_pool.lock = SDL_CreateMutex();
+        filter_pool.start = SDL_CreateSemaphore(0);
+        filter_pool.done = SDL_CreateSemaphore(0);
+        if (!filter_pool.lock || !filter_pool.start || !filter_pool.done) {
+            if (filter_pool.lock) SDL_DestroyMutex(filter_pool.lock);
+            if (filter_pool.start) SDL_DestroySemaphore(filter_pool.start);
+            if (filter_pool.done) SDL_DestroySemaphore(filter_pool.done);
+            filter_pool.lock = NULL;
+            filter_pool.start = filter_pool.done = NULL;
+            SDL_AtomicUnlock(&filter_pool_init);
+            return -1;
+        }
+    }
+    SDL_AtomicUnlock(&filter_pool_init);
+    SDL_LockMutex(filter_pool.lock);
+    if (!filter_pool.threads) filter_pool_resize(0);
+    return 0;
+}
+
+static int filter_run(FilterJob *job) {
+    if (filter_pool_lock() < 0) return -1;
+    int threads = filter_pool.threads;
+    // A few bands per thread so an uneven split still keeps everyone busy
+    job->band = SDL_max(4, job->dst_h / (threads * 4));
+    job->bands = (job->dst_h + job->band - 1) / job->band;
+    threads = SDL_min(threads, job->bands);
+    SDL_AtomicSet(&job->next, 0);
+    SDL_AtomicSet(&job->failed, 0);
+    filter_pool.job = job;
+    for (int i = 1; i < threads; i++)
+        SDL_SemPost(filter_pool.start);
+    filter_drain(job);
+    for (int i = 1; i < threads; i++)
+        SDL_SemWait(filter_pool.done);
+    filter_pool.job = NULL;
+    SDL_UnlockMutex(filter_pool.lock);
+    return SDL_AtomicGet(&job->failed) ? SDL_OutOfMemory() : 0;
+}
+
+// Lock both surfaces and fill in the job's pixels. When filtering in place the source is a copy.
+// With premultiply, a source with alpha is always copied and premultiplied so transparent pixels
+// don't lend their color to their neighbours; the rows function undoes it on the way out.
+static int filter_begin(FilterJob *job, SDL_Surface *src, SDL_Surface *dst, Uint8 **copy,
+                        SDL_bool premultiply) {
+    if (!src) return SDL_InvalidParamError("src");
+    if (!dst) return SDL_InvalidParamError("dst");
+    const SDL_PixelFormat *f = src->format;
+    if (f->BytesPerPixel != 4 || f->Rloss || f->Gloss || f->Bloss || (f->Amask && f->Aloss))
+        return SDL_SetError("Filters need 8-bit channels in 32-bit pixels; got %s",
+                            SDL_GetPixelFormatName(f->format));
+    if (dst->format->format != f->format)
+        return SDL_SetError("Cannot filter %s into %s", SDL_GetPixelFormatName(f->format),
+                            SDL_GetPixelFormatName(dst->format->format));
+    if (pixel_lock(src, SDL_FALSE) < 0) return -1;
+    if (src != dst && pixel_lock_write(dst, SDL_FALSE) < 0) {
+        pixel_unlock(src);
+        return -1;
+    }
+    *copy = NULL;
+    job->fk = filter_kernels();
+    job->src = (const Uint8 *)src->pixels;
+    job->src_pitch = src->pitch;
+    job->src_w = src->w;
+    job->src_h = src->h;
+    job->dst = (Uint8 *)dst->pixels;
+    job->dst_pitch = dst->pitch;
+    job->dst_w = dst->w;
+    job->dst_h = dst->h;
+    job->ashift = premultiply && f->Amask ? f->Ashift : -1;
+    if (src == dst) blitcache_invalidate(dst);
+    if (src == dst || job->ashift >= 0) {
+        *copy = (Uint8 *)SDL_malloc((size_t)src->pitch * src->h);
+        if (!*copy) {
+            if (src != dst) pixel_unlock(dst);
+            pixel_unlock(src);
+            return SDL_OutOfMemory();
+        }
+        SDL_memcpy(*copy, src->pixels, (size_t)src->pitch * src->h);
+        job->src = *copy;
+        if (job->ashift >= 0)
+            for (int y = 0; y < src->h; y++)
+                pixel_kernels->premultiply((Uint32 *)(*copy + (size_t)y * src->pitch), src->w,
+                                           job->ashift);
+    }
+    return 0;
+}
+
+static void filter_end(SDL_Surface *src, SDL_Surface *dst, Uint8 *copy) {
+    SDL_free(copy);
+    if (src != dst) pixel_unlock(dst);
+    pixel_unlock(src);
+}
+
+static int filter_separable(SDL_Surface *src, SDL_Surface *dst, float (*kernel)(float, float),
+                            float param, float support) {
+    FilterJob job;
+    FilterTaps tx, ty;
+    Uint8 *copy;
+    SDL_zero(job);
+    if (filter_begin(&job, src, dst, &copy, SDL_TRUE) < 0) return -1;
+    int ret = filter_taps(&tx, job.src_w, job.dst_w, kernel, param, support);
+    if (ret == 0) {
+        ret = filter_taps(&ty, job.src_h, job.dst_h, kernel, param, support);
+        if (ret == 0) {
+            job.tx = &tx;
+            job.ty = &ty;
+            job.rows = filter_separable_rows;
+            ret = filter_run(&job);
+            filter_taps_free(&ty);
+        }
+        filter_taps_free(&tx);
+    }
+    filter_end(src, dst, copy);
+    return ret;
+}
+
+static int filter_same_size(SDL_Surface *src, SDL_Surface *dst) {
+    if (src && dst && (src->w != dst->w || src->h != dst->h))
+        return SDL_SetError("Source and destination must be the same size");
+    return 0;
+}
+
+extern "C" int Bundle_SDL_GaussianBlurSurface(SDL_Surface *src, SDL_Surface *dst, float sigma) {
+    if (filter_same_size(src, dst) < 0) return -1;
+    if (!(sigma > 0.0f)) return SDL_InvalidParamError("sigma");
+    return filter_separable(src, dst, filter_gaussian, sigma, SDL_ceilf(3.0f * sigma) + 0.5f);
+}
+extern "C" int Bundle_SDL_BoxBlurSurface(SDL_Surface *src, SDL_Surface *dst, int radius) {
+    if (filter_same_size(src, dst) < 0) return -1;
+    if (radius < 1) return SDL_InvalidParamError("radius");
+    return filter_separable(src, dst, filter_box, 0.0f, radius + 0.5f);
+}
+extern "C" int Bundle_SDL_ResampleSurface(SDL_Surface *src, SDL_Surface *dst,
+                                          SDL_ResampleFilter filter) {
+    if (src == dst) return SDL_SetError("Cannot resample a surface onto itself");
+    switch (filter) {
+    case SDL_RESAMPLE_BILINEAR:
+        return filter_separable(src, dst, filter_triangle, 0.0f, 1.0f);
+    case SDL_RESAMPLE_BICUBIC:
+        return filter_separable(src, dst, filter_catmull_rom, 0.0f, 2.0f);
+    case SDL_RESAMPLE_LANCZOS3:
+        return filter_separable(src, dst, filter_lanczos3, 0.0f, 3.0f);
+    }
+    return SDL_InvalidParamError("filter");
+}
+// kernel is k * k weights, row by row; each output is sum(weight * pixel) / divisor + bias. Alpha
+// is left alone and the color channels are used as they are: premultiplying would turn the bias
+// of an emboss or edge kernel into a different amount for every alpha.
+extern "C" int Bundle_SDL_ConvolveSurface(SDL_Surface *src, SDL_Surface *dst, const float *kernel,
+                                          int k, float divisor, float bias) {
+    if (filter_same_size(src, dst) < 0) return -1;
+    if (k != 3 && k != 5) return SDL_SetError("Convolution kernels must be 3x3 or 5x5");
+    if (divisor == 0.0f) return SDL_InvalidParamError("divisor");
+    float weights[25];
+    for (int i = 0; i < k * k; i++)
+        weights[i] = kernel[i] / divisor;
+    FilterJob job;
+    Uint8 *copy;
+    SDL_zero(job);
+    if (filter_begin(&job, src, dst, &copy, SDL_FALSE) < 0) return -1;
+    job.kernel = weights;
+    job.k = k;
+    job.bias = bias;
+    job.amask = src->format->Amask;
+    job.rows = filter_convolve_rows;
+    int ret = filter_run(&job);
+    filter_end(src, dst, copy);
+    return ret;
+}
+extern "C" int Bundle_SDL_SetFilterThreads(int threads) {
+    if (filter_pool_lock() < 0) return -1;
+    int ret = filter_pool_resize(threads);
+    SDL_UnlockMutex(filter_pool.lock);
+    return ret;
+}
+extern "C" int Bundle_SDL_GetFilterThreads(void) {
+    if (filter_pool_lock() < 0) return -1;
+    int threads = filter_pool.threads;
+    SDL_UnlockMutex(filter_pool.lock);
+    return threads;
+}
+
+// Anti-aliased primitives in the spirit of SDL2_gfx: lines of any width, circles, ellipses, arcs,
+// rounded rects and polygons, filled or outlined, for 32-bit surfaces and for renderers. Every
+// shape becomes triangles whose edge is a one pixel wide ramp from full to no coverage, so one
+// tessellator serves both targets: renderers get the triangles as SDL_RenderGeometryRaw batches,
+// surfaces get them from a scanline rasterizer that interpolates coverage and blends. Points name
+// pixels like SDL_RenderDrawPointF does, so (0, 0) is the center of the top left pixel; rects
+// cover the pixels they name. Colors are 0xRRGGBBAA. A width of 0 fills the shape; lines and
+// outlines thinner than a pixel are drawn a pixel wide and fainter.
+#define GFX_FLUSH_VERTICES 16384
+#define GFX_MITER_LIMIT 4.0f
+
+typedef struct GFX_Line
+{
+    float x1, y1, x2, y2, width;
+    Uint32 color;
+} GFX_Line;
+
+typedef struct GFX_Circle
+{
+    float x, y, r, width;
+    Uint32 color;
+} GFX_Circle;
+
+typedef struct GFX_Ellipse
+{
+    float x, y, rx, ry, width;
+    Uint32 color;
+} GFX_Ellipse;
+
+typedef struct GFX_Arc
+{
+    float x, y, r, start, end, width; // degrees, clockwise from 3 o'clock
+    Uint32 color;
+} GFX_Arc;
+
+typedef struct GFX_RoundedRect
+{
+    float x, y, w, h, radius, width;
+    Uint32 color;
+} GFX_RoundedRect;
+
+typedef struct GFX_Polygon
+{
+    int count; // points taken from the shared point list
+    float width;
+    Uint32 color;
+} GFX_Polygon;
+
+typedef struct GFXVertex
+{
+    float x, y;
+    SDL_Color color;
+} GFXVertex;
+
+typedef struct GFXBatch
+{
+    SDL_Surface *surface;
+    SDL_Renderer *renderer;
+    SDL_BlendMode blend; // the renderer's, put back afterwards
+    GFXVertex *verts;
+    int *indices;
+    int num_verts, num_indices, max_verts, max_indices;
+    float *pts, *miters; // the outline being built, x/y pairs
+    int num_pts, max_pts, max_miters;
+    int *ears, max_ears;
+    SDL_Color color;
+    SDL_bool failed;
+} GFXBatch;
+
+static SDL_bool gfx_grow(void **buf, int *max, int need, size_t size) {
+    if (need <= *max) return SDL_TRUE;
+    int n = SDL_max(need, SDL_max(*max * 2, 256));
+    void *p = SDL_realloc(*buf, n * size);
+    if (!p) return SDL_FALSE;
+    *buf = p;
+    *max = n;
+    return SDL_TRUE;
+}
+
+static void gfx_color(GFXBatch *b, Uint32 rgba, float scale) {
+    b->color.r = (Uint8)(rgba >> 24);
+    b->color.g = (Uint8)(rgba >> 16);
+    b->color.b = (Uint8)(rgba >> 8);
+    b->color.a = (Uint8)((rgba & 0xFF) * SDL_min(scale, 1.0f) + 0.5f);
+}
+
+static int gfx_vertex(GFXBatch *b, float x, float y, float coverage) {
+    if (!gfx_grow((void **)&b->verts, &b->max_verts, b->num_verts + 1, sizeof(GFXVertex))) {
+        b->failed = SDL_TRUE;
+        return 0;
+    }
+    GFXVertex *v = &b->verts[b->num_verts];
+    v->x = x;
+    v->y = y;
+    v->color = b->color;
+    v->color.a = (Uint8)(b->color.a * coverage + 0.5f);
+    return b->num_verts++;
+}
+
+static void gfx_triangle(GFXBatch *b, int i, int j, int k) {
+    if (b->failed) return;
+    if (!gfx_grow((void **)&b->indices, &b->max_indices, b->num_indices + 3, sizeof(int))) {
+        b->failed = SDL_TRUE;
+        return;
+    }
+    b->indices[b->num_indices++] = i;
+    b->indices[b->num_indices++] = j;
+    b->indices[b->num_indices++] = k;
+}
+
+static void gfx_point(GFXBatch *b, float x, float y) {
+    if (!gfx_grow((void **)&b->pts, &b->max_pts, (b->num_pts + 1) * 2, sizeof(float))) {
+        b->failed = SDL_TRUE;
+        return;
+    }
+    const float *last = b->num_pts ? b->pts + (b->num_pts - 1) * 2 : NULL;
+    if (last && SDL_fabsf(last[0] - x) < 1e-3f && SDL_fabsf(last[1] - y) < 1e-3f) return;
+    b->pts[b->num_pts * 2] = x;
+    b->pts[b->num_pts * 2 + 1] = y;
+    b->num_pts++;
+}
+
+// Segments for a curve of radius r turning through sweep radians, keeping the chords within an
+// eighth of a pixel of the curve.
+static int gfx_segments(float r, float sweep) {
+    float step = r > 0.25f ? 2.0f * SDL_acosf(1.0f - 0.125f / r) : (float)M_PI / 2;
+    return SDL_min(SDL_max((int)SDL_ceilf(sweep / step), 2), 4096);
+}
+
+// Offset at each outline point for moving its edges out by a pixel: the average of the
+// neighbouring edges' normals, lengthened so offset edges stay parallel. Returns the number of
+// points left once a closing duplicate is dropped, or 0 if there is nothing to draw.
+static int gfx_miters(GFXBatch *b, SDL_bool closed) {
+    int n = b->num_pts;
+    const float *p = b->pts;
+    if (closed && n > 1 && SDL_fabsf(p[0] - p[n * 2 - 2]) < 1e-3f &&
+        SDL_fabsf(p[1] - p[n * 2 - 1]) < 1e-3f)
+        n--;
+    if (n < (closed ? 3 : 2) || b->failed) return 0;
+    if (!gfx_grow((void **)&b->miters, &b->max_miters, n * 2, sizeof(float))) {
+        b->failed = SDL_TRUE;
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        float nx[2], ny[2];
+        for (int e = 0; e < 2; e++) { // the edges before and after point i
+            int a = e ? i : i - 1, c = a + 1;
+            if (!closed) a = SDL_min(SDL_max(a, 0), n - 2), c = a + 1;
+            a = (a + n) % n;
+            c %= n;
+            float dx = p[c * 2] - p[a * 2], dy = p[c * 2 + 1] - p[a * 2 + 1];
+            float len = SDL_sqrtf(dx * dx + dy * dy);
+            nx[e] = dy / len;
+            ny[e] = -dx / len;
+        }
+        float mx = nx[0] + nx[1], my = ny[0] + ny[1], dot = (mx * nx[1] + my * ny[1]) / 2;
+        float scale = dot > 1.0f / GFX_MITER_LIMIT ? 0.5f / dot : GFX_MITER_LIMIT / 2;
+        if (mx * mx + my * my < 1e-6f) mx = nx[1], my = ny[1], scale = 1.0f; // Turned back
+        b->miters[i * 2] = mx * scale;
+        b->miters[i * 2 + 1] = my * scale;
+    }
+    return n;
+}
+
+static float gfx_area(const float *p, int n) {
+    float area = 0.0f;
+    for (int i = 0, j = n - 1; i < n; j = i++)
+        area += p[j * 2] * p[i * 2 + 1] - p[i * 2] * p[j * 2 + 1];
+    return area / 2;
+}
+
+static float gfx_cross(const GFXVertex *a, const GFXVertex *b, const GFXVertex *c) {
+    return (b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x);
+}
+
+// Triangulate a simple polygon of n vertices starting at base by clipping ears. Self-intersecting
+// leftovers are fanned.
+static void gfx_ear_clip(GFXBatch *b, int base, int n, float sign) {
+    if (!gfx_grow((void **)&b->ears, &b->max_ears, n, sizeof(int))) {
+        b->failed = SDL_TRUE;
+        return;
+    }
+    int *idx = b->ears;
+    for (int i = 0; i < n; i++)
+        idx[i] = base + i * 2;
+    for (int i = 0, misses = 0; n > 3 && misses < n;) {
+        const GFXVertex *v = b->verts;
+        int a = idx[(i + n - 1) % n], c = idx[i % n], d = idx[(i + 1) % n];
+        SDL_bool ear = gfx_cross(&v[a], &v[c], &v[d]) * sign > 0.0f ? SDL_TRUE : SDL_FALSE;
+        for (int j = 0; ear && j < n; j++) {
+            int o = idx[j];
+            if (o == a || o == c || o == d) continue;
+            if (gfx_cross(&v[a], &v[c], &v[o]) * sign >= 0.0f &&
+                gfx_cross(&v[c], &v[d], &v[o]) * sign >= 0.0f &&
+                gfx_cross(&v[d], &v[a], &v[o]) * sign >= 0.0f)
+                ear = SDL_FALSE;
+        }
+        if (!ear) {
+            i = (i + 1) % n;
+            misses++;
+            continue;
+        }
+        gfx_triangle(b, a, c, d);
+        SDL_memmove(idx + i % n, idx + i % n + 1, (n - i % n - 1) * sizeof(int));
+        n--;
+        i %= n;
+        misses = 0;
+    }
+    for (int i = 1; i + 1 < n; i++)
+        gfx_triangle(b, idx[0], idx[i], idx[i + 1]);
+}
+
+// Fill the outline in pts: its inside shrunk by half a pixel at full coverage plus a ramp out to
+// half a pixel past the edge. fan says a fan from the first point covers the inside.
+static void gfx_fill(GFXBatch *b, SDL_bool fan) {
+    int n = gfx_miters(b, SDL_TRUE);
+    float area = n ? gfx_area(b->pts, n) : 0.0f;
+    if (SDL_fabsf(area) < 1e-6f) return;
+    float sign = area > 0.0f ? 1.0f : -1.0f;
+    int base = b->num_verts;
+    for (int i = 0; i < n; i++) {
+        float x = b->pts[i * 2], y = b->pts[i * 2 + 1];
+        float mx = b->miters[i * 2] * sign / 2, my = b->miters[i * 2 + 1] * sign / 2;
+        gfx_vertex(b, x - mx, y - my, 1.0f);
+        gfx_vertex(b, x + mx, y + my, 0.0f);
+    }
+    for (int i = 0; i < n; i++) {
+        int in = base + i * 2, next = base + (i + 1) % n * 2;
+        gfx_triangle(b, in, in + 1, next + 1);
+        gfx_triangle(b, in, next + 1, next);
+    }
+    if (!fan) return gfx_ear_clip(b, base, n, sign);
+    for (int i = 1; i + 1 < n; i++)
+        gfx_triangle(b, base, base + i * 2, base + i * 2 + 2);
+}
+
+// Stroke the outline in pts, width pixels wide and centered on it: four offset copies at
+// coverage 0, 1, 1, 0 joined by quads. Open ends fade out over a pixel.
+static void gfx_stroke(GFXBatch *b, SDL_bool closed, float width) {
+    static const float coverage[4] = {0.0f, 1.0f, 1.0f, 0.0f};
+    float half = SDL_max(width, 1.0f) / 2, offset[4] = {-half - 0.5f, 0.5f - half, half - 0.5f,
+                                                        half + 0.5f};
+    int n = gfx_miters(b, closed), base = b->num_verts;
+    if (!n) return;
+    for (int i = 0; i < n; i++)
+        for (int r = 0; r < 4; r++)
+            gfx_vertex(b, b->pts[i * 2] + b->miters[i * 2] * offset[r],
+                       b->pts[i * 2 + 1] + b->miters[i * 2 + 1] * offset[r], coverage[r]);
+    for (int i = 0; i < (closed ? n : n - 1); i++) {
+        int v = base + i * 4, w = base + (i + 1) % n * 4;
+        for (int r = 0; r < 3; r++) {
+            gfx_triangle(b, v + r, v + r + 1, w + r + 1);
+            gfx_triangle(b, v + r, w + r + 1, w + r);
+        }
+    }
+    if (closed) return;
+    for (int end = 0; end < 2; end++) {
+        int i = end ? n - 1 : 0, j = end ? n - 2 : 1, v = base + i * 4;
+        float tx = b->pts[i * 2] - b->pts[j * 2], ty = b->pts[i * 2 + 1] - b->pts[j * 2 + 1];
+        float len = SDL_sqrtf(tx * tx + ty * ty);
+        int c1 = gfx_vertex(b, b->verts[v + 1].x + tx / len, b->verts[v + 1].y + ty / len, 0.0f);
+        int c2 = gfx_vertex(b, b->verts[v + 2].x + tx / len, b->verts[v + 2].y + ty / len, 0.0f);
+        gfx_triangle(b, v + 1, c1, c2);
+        gfx_triangle(b, v + 1, c2, v + 2);
+        gfx_triangle(b, v, v + 1, c1);
+        gfx_triangle(b, v + 3, v + 2, c2);
+    }
+}
+
+static void gfx_outline(GFXBatch *b, float width, SDL_bool fan) {
+    if (width > 0.0f)
+        gfx_stroke(b, SDL_TRUE, width);
+    else
+        gfx_fill(b, fan);
+}
+
+static void gfx_line(GFXBatch *b, const void *item) {
+    const GFX_Line *l = (const GFX_Line *)item;
+    float width = l->width > 0.0f ? l->width : 1.0f, half = SDL_max(width, 1.0f) / 2;
+    float dx = l->x2 - l->x1, dy = l->y2 - l->y1, len = SDL_sqrtf(dx * dx + dy * dy);
+    float tx = len > 1e-4f ? dx / len / 2 : 0.5f, ty = len > 1e-4f ? dy / len / 2 : 0.0f;
+    float nx = -ty * 2 * half, ny = tx * 2 * half; // half a pixel past each end, like a pixel
+    gfx_color(b, l->color, width);
+    b->num_pts = 0;
+    gfx_point(b, l->x1 + 0.5f - tx + nx, l->y1 + 0.5f - ty + ny);
+    gfx_point(b, l->x2 + 0.5f + tx + nx, l->y2 + 0.5f + ty + ny);
+    gfx_point(b, l->x2 + 0.5f + tx - nx, l->y2 + 0.5f + ty - ny);
+    gfx_point(b, l->x1 + 0.5f - tx - nx, l->y1 + 0.5f - ty - ny);
+    gfx_fill(b, SDL_TRUE);
+}
+
+// Filled shapes reach half a pixel past their radius, so they cover what their outline does
+static void gfx_ellipse_points(GFXBatch *b, float x, float y, float rx, float ry, float width) {
+    float grow = width > 0.0f ? 0.0f : 0.5f;
+    int n = gfx_segments(SDL_max(rx, ry) + grow, 2 * (float)M_PI);
+    b->num_pts = 0;
+    for (int i = 0; i < n; i++) {
+        float a = 2 * (float)M_PI * i / n;
+        gfx_point(b, x + 0.5f + (rx + grow) * SDL_cosf(a), y + 0.5f + (ry + grow) * SDL_sinf(a));
+    }
+}
+
+static void gfx_circle(GFXBatch *b, const void *item) {
+    const GFX_Circle *c = (const GFX_Circle *)item;
+    gfx_color(b, c->color, c->width > 0.0f ? c->width : 1.0f);
+    gfx_ellipse_points(b, c->x, c->y, c->r, c->r, c->width);
+    gfx_outline(b, c->width, SDL_TRUE);
+}
+
+static void gfx_ellipse(GFXBatch *b, const void *item) {
+    const GFX_Ellipse *e = (const GFX_Ellipse *)item;
+    gfx_color(b, e->color, e->width > 0.0f ? e->width : 1.0f);
+    gfx_ellipse_points(b, e->x, e->y, e->rx, e->ry, e->width);
+    gfx_outline(b, e->width, SDL_TRUE);
+}
+
+// An outline arc, or a pie slice when filled
+static void gfx_arc(GFXBatch *b, const void *item) {
+    const GFX_Arc *a = (const GFX_Arc *)item;
+    float sweep = SDL_fmodf(a->end - a->start, 360.0f);
+    if (sweep <= 0.0f) sweep += 360.0f;
+    float start = a->start * (float)M_PI / 180, radians = sweep * (float)M_PI / 180;
+    float r = a->width > 0.0f ? a->r : a->r + 0.5f, cx = a->x + 0.5f, cy = a->y + 0.5f;
+    int n = gfx_segments(r, radians);
+    gfx_color(b, a->color, a->width > 0.0f ? a->width : 1.0f);
+    b->num_pts = 0;
+    if (a->width <= 0.0f && sweep < 360.0f) gfx_point(b, cx, cy);
+    for (int i = 0; i <= n; i++) {
+        float t = start + radians * i / n;
+        gfx_point(b, cx + r * SDL_cosf(t), cy + r * SDL_sinf(t));
+    }
+    if (a->width > 0.0f)
+        gfx_stroke(b, sweep >= 360.0f ? SDL_TRUE : SDL_FALSE, a->width);
+    else
+        gfx_fill(b, SDL_TRUE);
+}
+
+static void gfx_rounded_rect(GFXBatch *b, const void *item) {
+    const GFX_RoundedRect *rr = (const GFX_RoundedRect *)item;
+    float inset = rr->width > 0.0f ? SDL_max(rr->width, 1.0f) / 2 : 0.0f;
+    float x0 = rr->x + inset, y0 = rr->y + inset, x1 = rr->x + rr->w - inset,
+          y1 = rr->y + rr->h - inset;
+    if (x1 <= x0 || y1 <= y0) return;
+    float r = SDL_min(SDL_max(rr->radius - inset, 0.0f), SDL_min(x1 - x0, y1 - y0) / 2);
+    int n = r > 0.0f ? gfx_segments(r, (float)M_PI / 2) : 0;
+    const float corner[4][3] = {
+        {x0 + r, y0 + r, 180.0f}, {x1 - r, y0 + r, 270.0f}, {x1 - r, y1 - r, 0.0f},
+        {x0 + r, y1 - r, 90.0f}};
+    gfx_color(b, rr->color, rr->width > 0.0f ? rr->width : 1.0f);
+    b->num_pts = 0;
+    for (int c = 0; c < 4; c++)
+        for (int i = 0; i <= n; i++) {
+            float t = (corner[c][2] + 90.0f * i / SDL_max(n, 1)) * (float)M_PI / 180;
+            gfx_point(b, corner[c][0] + r * SDL_cosf(t), corner[c][1] + r * SDL_sinf(t));
+        }
+    gfx_outline(b, rr->width, SDL_TRUE);
+}
+
+static void gfx_polygon(GFXBatch *b, const GFX_Polygon *polygon, const float *points) {
+    gfx_color(b, polygon->color, polygon->width > 0.0f ? polygon->width : 1.0f);
+    b->num_pts = 0;
+    for (int i = 0; i < polygon->count; i++)
+        gfx_point(b, points[i * 2] + 0.5f, points[i * 2 + 1] + 0.5f);
+    gfx_outline(b, polygon->width, SDL_FALSE);
+}
+
+// Blend the batch's triangles into the surface. Pixels whose centers fall inside are drawn;
+// pixels exactly on an edge belong to the triangle to the edge's right or below so shared edges
+// are drawn once.
+static void gfx_raster(GFXBatch *b) {
+    SDL_Surface *s = b->surface;
+    const SDL_PixelFormat *f = s->format;
+    const SDL_Rect *clip = &s->clip_rect;
+    Uint32 keep = ~(f->Rmask | f->Gmask | f->Bmask | f->Amask);
+    for (int t = 0; t < b->num_indices; t += 3) {
+        const GFXVertex *v[3] = {&b->verts[b->indices[t]], &b->verts[b->indices[t + 1]],
+                                 &b->verts[b->indices[t + 2]]};
+        float area = gfx_cross(v[0], v[1], v[2]);
+        if (area == 0.0f || (!v[0]->color.a && !v[1]->color.a && !v[2]->color.a)) continue;
+        if (area < 0.0f) {
+            const GFXVertex *swap = v[1];
+            v[1] = v[2];
+            v[2] = swap;
+            area = -area;
+        }
+        float top = SDL_min(v[0]->y, SDL_min(v[1]->y, v[2]->y));
+        float bottom = SDL_max(v[0]->y, SDL_max(v[1]->y, v[2]->y));
+        int y0 = SDL_max((int)SDL_ceilf(top - 0.5f), clip->y);
+        int y1 = SDL_min((int)SDL_floorf(bottom - 0.5f), clip->y + clip->h - 1);
+        SDL_bool flat = v[0]->color.a == v[1]->color.a && v[1]->color.a == v[2]->color.a
+                            ? SDL_TRUE
+                            : SDL_FALSE;
+        const SDL_Color color = v[0]->color;
+        for (int y = y0; y <= y1; y++) {
+            float cy = y + 0.5f, left = 1e30f, right = -1e30f;
+            for (int e = 0; e < 3; e++) { // Where the row crosses the edges bounds the span
+                const GFXVertex *a = v[e], *c = v[(e + 1) % 3];
+                if ((cy < a->y && cy < c->y) || (cy > a->y && cy > c->y) || a->y == c->y) continue;
+                float x = a->x + (cy - a->y) * (c->x - a->x) / (c->y - a->y);
+                left = SDL_min(left, x);
+                right = SDL_max(right, x);
+            }
+            if (left > right) continue;
+            int x0 = SDL_max((int)SDL_floorf(left - 0.5f), clip->x);
+            int x1 = SDL_min((int)SDL_ceilf(right - 0.5f), clip->x + clip->w - 1);
+            Uint32 *row = (Uint32 *)((Uint8 *)s->pixels + (size_t)y * s->pitch);
+            for (int x = x0; x <= x1; x++) {
+                GFXVertex p;
+                float w[3];
+                p.x = x + 0.5f;
+                p.y = cy;
+                SDL_bool inside = SDL_TRUE;
+                for (int e = 0; e < 3 && inside; e++) {
+                    const GFXVertex *a = v[(e + 1) % 3], *c = v[(e + 2) % 3];
+                    float dx = c->x - a->x, dy = c->y - a->y;
+                    w[e] = gfx_cross(a, c, &p);
+                    if (w[e] < 0.0f || (w[e] == 0.0f && !(dy < 0.0f || (dy == 0.0f && dx > 0.0f))))
+                        inside = SDL_FALSE;
+                }
+                if (!inside) continue;
+                int alpha = flat ? color.a
+                                 : (int)((w[0] * v[0]->color.a + w[1] * v[1]->color.a +
+                                          w[2] * v[2]->color.a) /
+                                             area +
+                                         0.5f);
+                if (alpha <= 0) continue;
+                alpha = SDL_min(alpha, 255);
+                Uint32 px = row[x], out = px & keep;
+                const Uint8 src[3] = {color.r, color.g, color.b};
+                const Uint8 shift[3] = {f->Rshift, f->Gshift, f->Bshift};
+                for (int c = 0; c < 3; c++) {
+                    Uint32 d = (px >> shift[c]) & 0xFF;
+                    out |= ((src[c] * alpha + d * (255 - alpha) + 127) / 255) << shift[c];
+                }
+                if (f->Amask) {
+                    Uint32 d = (px >> f->Ashift) & 0xFF;
+                    out |= (alpha + (d * (255 - alpha) + 127) / 255) << f->Ashift;
+                }
+                row[x] = out;
+            }
+        }
+    }
+}
+
+static int gfx_flush(GFXBatch *b) {
+    int ret = 0;
+    if (b->failed)
+        ret = SDL_OutOfMemory();
+    else if (b->num_indices && b->renderer) {
+#if HAVE_RENDER_GEOMETRY
+        ret = SDL_RenderGeometryRaw(b->renderer, NULL, &b->verts->x, sizeof(GFXVertex),
+                                    &b->verts->color, sizeof(GFXVertex), NULL, 0, b->num_verts,
+                                    b->indices, b->num_indices, sizeof(int));
+#endif
+    }
+    else if (b->num_indices)
+        gfx_raster(b);
+    b->num_verts = b->num_indices = 0;
+    return ret;
+}
+
+// Exactly one of surface and renderer is used
+static int gfx_begin(GFXBatch *b, SDL_Surface *surface, SDL_Renderer *renderer) {
+    SDL_zerop(b);
+    if (renderer) {
+#if HAVE_RENDER_GEOMETRY
+        b->renderer = renderer;
+        if (SDL_GetRenderDrawBlendMode(renderer, &b->blend) < 0) return -1;
+        return SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+#else
+        return SDL_Unsupported();
+#endif
+    }
+    if (!surface) return SDL_InvalidParamError("target");
+    const SDL_PixelFormat *f = surface->format;
+    if (f->BytesPerPixel != 4 || f->Rloss || f->Gloss || f->Bloss || (f->Amask && f->Aloss))
+        return SDL_SetError("Primitives need 8-bit channels in 32-bit pixels; got %s",
+                            SDL_GetPixelFormatName(f->format));
+    b->surface = surface;
+    return pixel_lock_write(surface, SDL_FALSE);
+}
+
+static int gfx_end(GFXBatch *b, int ret) {
+    int flushed = gfx_flush(b);
+    if (b->renderer)
+        SDL_SetRenderDrawBlendMode(b->renderer, b->blend);
+    else
+        pixel_unlock(b->surface);
+    SDL_free(b->verts);
+    SDL_free(b->indices);
+    SDL_free(b->pts);
+    SDL_free(b->miters);
+    SDL_free(b->ears);
+    return ret < 0 ? ret : flushed;
+}
+
+static int gfx_draw(SDL_Surface *surface, SDL_Renderer *renderer, const void *items, size_t size,
+                    int count, void (*shape)(GFXBatch *, const void *)) {
+    GFXBatch b;
+    if (count < 0) return SDL_InvalidParamError("count");
+    if (gfx_begin(&b, surface, renderer) < 0) return -1;
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < count; i++) {
+        shape(&b, (const Uint8 *)items + i * size);
+        if (b.failed || b.num_verts > GFX_FLUSH_VERTICES) ret = gfx_flush(&b);
+    }
+    return gfx_end(&b, ret);
+}
+
+extern "C" int Bundle_GFX_Lines(SDL_Surface *surface, SDL_Renderer *renderer,
+                                const GFX_Line *lines, int count) {
+    return gfx_draw(surface, renderer, lines, sizeof(GFX_Line), count, gfx_line);
+}
+extern "C" int Bundle_GFX_Circles(SDL_Surface *surface, SDL_Renderer *renderer,
+                                  const GFX_Circle *circles, int count) {
+    return gfx_draw(surface, renderer, circles, sizeof(GFX_Circle), count, gfx_circle);
+}
+extern "C" int Bundle_GFX_Ellipses(SDL_Surface *surface, SDL_Renderer *renderer,
+                                   const GFX_Ellipse *ellipses, int count) {
+    return gfx_draw(surface, renderer, ellipses, sizeof(GFX_Ellipse), count, gfx_ellipse);
+}
+extern "C" int Bundle_GFX_Arcs(SDL_Surface *surface, SDL_Renderer *renderer, const GFX_Arc *arcs,
+                               int count) {
+    return gfx_draw(surface, renderer, arcs, sizeof(GFX_Arc), count, gfx_arc);
+}
+extern "C" int Bundle_GFX_RoundedRects(SDL_Surface *surface, SDL_Renderer *renderer,
+                                       const GFX_RoundedRect *rects, int count) {
+    return gfx_draw(surface, renderer, rects, sizeof(GFX_RoundedRect), count, gfx_rounded_rect);
+}
+// points holds the num_points x/y pairs of every polygon in turn
+extern "C" int Bundle_GFX_Polygons(SDL_Surface *surface, SDL_Renderer *renderer,
+                                   const GFX_Polygon *polygons, int count, const float *points,
+                                   int num_points) {
+    GFXBatch b;
+    if (count < 0) return SDL_InvalidParamError("count");
+    Sint64 needed = 0;
+    for (int i = 0; i < count; i++) {
+        if (polygons[i].count < 0) return SDL_SetError("Polygon %d has a negative point count", i);
+        needed += polygons[i].count;
+    }
+    if (needed > num_points)
+        return SDL_SetError("Polygons need more than the %d points given", num_points);
+    if (gfx_begin(&b, surface, renderer) < 0) return -1;
+    int ret = 0;
+    for (int i = 0; ret == 0 && i < count; points += polygons[i++].count * 2) {
+        gfx_polygon(&b, &polygons[i], points);
+        if (b.failed || b.num_verts > GFX_FLUSH_VERTICES) ret = gfx_flush(&b);
+    }
+    return gfx_end(&b, ret);
+}
+extern "C" int Bundle_GFX_Line(SDL_Surface *surface, SDL_Renderer *renderer, float x1, float y1,
+                               float x2, float y2, float width, Uint32 color) {
+    GFX_Line line = {x1, y1, x2, y2, width, color};
+    return Bundle_GFX_Lines(surface, renderer, &line, 1);
+}
+extern "C" int Bundle_GFX_Circle(SDL_Surface *surface, SDL_Renderer *renderer, float x, float y,
+                                 float r, float width, Uint32 color) {
+    GFX_Circle circle = {x, y, r, width, color};
+    return Bundle_GFX_Circles(surface, renderer, &circle, 1);
+}
+extern "C" int Bundle_GFX_Ellipse(SDL_Surface *surface, SDL_Renderer *renderer, float x, float y,
+                                  float rx, float ry, float width, Uint32 color) {
+    GFX_Ellipse ellipse = {x, y, rx, ry, width, color};
+    return Bundle_GFX_Ellipses(surface, renderer, &ellipse, 1);
+}
+extern "C" int Bundle_GFX_Arc(SDL_Surface *surface, SDL_Renderer *renderer, float x, float y,
+                              float r, float start, float end, float width, Uint32 color) {
+    GFX_Arc arc = {x, y, r, start, end, width, color};
+    return Bundle_GFX_Arcs(surface, renderer, &arc, 1);
+}
+extern "C" int Bundle_GFX_RoundedRect(SDL_Surface *surface, SDL_Renderer *renderer, float x,
+                                      float y, float w, float h, float radius, float width,
+                                      Uint32 color) {
+    GFX_RoundedRect rect = {x, y, w, h, radius, width, color};
+    return Bundle_GFX_RoundedRects(surface, renderer, &rect, 1);
+}
+extern "C" int Bundle_GFX_Polygon(SDL_Surface *surface, SDL_Renderer *renderer,
+                                  const float *points, int count, float width, Uint32 color) {
+    GFX_Polygon polygon = {count, width, color};
+    return Bundle_GFX_Polygons(surface, renderer, &polygon, 1, points, count);
+}
+
+// Palette cycling. A cycler keeps the palette's colors as they were drawn and, on each update,
+// rotates ranges of them (forward, backward or back and forth, optionally blending between
+// steps) and writes only the ranges whose step changed with SDL_SetPaletteColors. The step
+// depends only on the time passed in, so every cycler agrees and nothing drifts.
+#define PALETTE_MAX_CYCLES 64
+
+typedef enum SDL_PaletteCycleFlags
+{
+    SDL_PALETTECYCLE_FORWARD = 0,
+    SDL_PALETTECYCLE_REVERSE = 0x1,
+    SDL_PALETTECYCLE_PINGPONG = 0x2,
+    SDL_PALETTECYCLE_BLEND = 0x4
+} SDL_PaletteCycleFlags;
+
+typedef struct PaletteCycle
+{
+    int first, count;
+    float rate; // steps per second
+    Uint32 flags;
+    int shown; // the step (in 256ths when blending) last written; -1 if none
+} PaletteCycle;
+
+typedef struct SDL_PaletteCycler
+{
+    SDL_Palette *palette;
+    SDL_Color base[256];
+    PaletteCycle cycles[PALETTE_MAX_CYCLES];
+    int count;
+} SDL_PaletteCycler;
+
+static void cycler_stale(SDL_PaletteCycler *pc) {
+    for (int i = 0; i < pc->count; i++)
+        pc->cycles[i].shown = -1;
+}
+
+extern "C" SDL_PaletteCycler *Bundle_SDL_CreatePaletteCycler(SDL_Palette *palette) {
+    if (!palette) {
+        SDL_InvalidParamError("palette");
+        return NULL;
+    }
+    SDL_PaletteCycler *pc = (SDL_PaletteCycler *)SDL_calloc(1, sizeof(SDL_PaletteCycler));
+    if (!pc) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    pc->palette = palette;
+    palette->refcount++; // Released by SDL_FreePalette in Destroy
+    SDL_memcpy(pc->base, palette->colors, SDL_min(palette->ncolors, 256) * sizeof(SDL_Color));
+    return pc;
+}
+extern "C" void Bundle_SDL_DestroyPaletteCycler(SDL_PaletteCycler *pc) {
+    if (!pc) return;
+    SDL_FreePalette(pc->palette);
+    SDL_free(pc);
+}
+// Returns the cycle's index
+extern "C" int Bundle_SDL_AddPaletteCycle(SDL_PaletteCycler *pc, int first, int count,
+                                          float rate, Uint32 flags) {
+    if (pc->count == PALETTE_MAX_CYCLES)
+        return SDL_SetError("No more than %d cycles per palette", PALETTE_MAX_CYCLES);
+    if (first < 0 || count < 2 || first + count > SDL_min(pc->palette->ncolors, 256))
+        return SDL_SetError("Cycle of %d colors from %d does not fit a %d color palette", count,
+                            first, pc->palette->ncolors);
+    PaletteCycle *cycle = &pc->cycles[pc->count];
+    cycle->first = first;
+    cycle->count = count;
+    cycle->rate = rate;
+    cycle->flags = flags;
+    cycle->shown = -1;
+    return pc->count++;
+}
+extern "C" void Bundle_SDL_ClearPaletteCycles(SDL_PaletteCycler *pc) {
+    pc->count = 0;
+}
+// Put the uncycled colors back
+extern "C" int Bundle_SDL_ResetPaletteCycler(SDL_PaletteCycler *pc) {
+    cycler_stale(pc);
+    return SDL_SetPaletteColors(pc->palette, pc->base, 0, SDL_min(pc->palette->ncolors, 256));
+}
+// Change the uncycled colors, for fades and the like; cycled ranges pick them up next update
+extern "C" int Bundle_SDL_SetPaletteCyclerColors(SDL_PaletteCycler *pc, const SDL_Color *colors,
+                                                 int first, int count) {
+    if (first < 0 || count < 0 || first + count > SDL_min(pc->palette->ncolors, 256))
+        return SDL_SetError("Colors %d to %d are outside the palette", first, first + count - 1);
+    SDL_memcpy(pc->base + first, colors, count * sizeof(SDL_Color));
+    cycler_stale(pc);
+    return SDL_SetPaletteColors(pc->palette, colors, first, count);
+}
+// Returns 1 if any colors changed, 0 if none did
+extern "C" int Bundle_SDL_UpdatePaletteCycler(SDL_PaletteCycler *pc, Uint32 ticks) {
+    int changed = 0;
+    for (int c = 0; c < pc->count; c++) {
+        PaletteCycle *cycle = &pc->cycles[c];
+        int n = cycle->count;
+        // Out over n - 1 steps and back again when ping-ponging
+        SDL_bool pingpong = cycle->flags & SDL_PALETTECYCLE_PINGPONG ? SDL_TRUE : SDL_FALSE;
+        double period = pingpong ? 2.0 * (n - 1) : n;
+        double pos = SDL_fmod((double)ticks * cycle->rate / 1000, period);
+        if (pos < 0) pos += period;
+        if (pingpong && pos > n - 1) pos = period - pos;
+        if (cycle->flags & SDL_PALETTECYCLE_REVERSE) pos = n - pos;
+        SDL_bool blend = cycle->flags & SDL_PALETTECYCLE_BLEND ? SDL_TRUE : SDL_FALSE;
+        int shown = blend ? (int)(pos * 256) % (n * 256) : (int)pos % n;
+        if (shown == cycle->shown) continue;
+        SDL_Color colors[256];
+        const SDL_Color *base = pc->base + cycle->first;
+        int step = blend ? shown >> 8 : shown, f = blend ? shown & 0xFF : 0;
+        for (int i = 0; i < n; i++) { // Colors move towards higher indices as pos grows
+            const SDL_Color *a = &base[(i - step + n) % n], *b = &base[(i - step - 1 + 2 * n) % n];
+            colors[i].r = (Uint8)((a->r * (256 - f) + b->r * f + 128) >> 8);
+            colors[i].g = (Uint8)((a->g * (256 - f) + b->g * f + 128) >> 8);
+            colors[i].b = (Uint8)((a->b * (256 - f) + b->b * f + 128) >> 8);
+            colors[i].a = (Uint8)((a->a * (256 - f) + b->a * f + 128) >> 8);
+        }
+        if (SDL_SetPaletteColors(pc->palette, colors, cycle->first, n) < 0) return -1;
+        cycle->shown = shown;
+        changed = 1;
+    }
+    return changed;
+}
+
+// Expanding 8-bit indexed pixels to 32 bits through a 256 entry lookup table. AVX2 gathers eight
+// entries at a time; SSE2 and NEON have no table lookup that wide, so everything else uses the
+// unrolled scalar loop.
+static void indexed_expand_scalar(Uint32 *dst, const Uint8 *src, int n, const Uint32 *lut) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        dst[i] = lut[src[i]];
+        dst[i + 1] = lut[src[i + 1]];
+        dst[i + 2] = lut[src[i + 2]];
+        dst[i + 3] = lut[src[i + 3]];
+    }
+    for (; i < n; i++)
+        dst[i] = lut[src[i]];
+}
+
+#ifdef BUNDLE_AVX2
+BUNDLE_TARGET_AVX2 static void indexed_expand_avx2(Uint32 *dst, const Uint8 *src, int n,
+                                                   const Uint32 *lut) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + i)));
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_i32gather_epi32((const int *)lut, idx, 4));
+    }
+    indexed_expand_scalar(dst + i, src + i, n - i, lut);
+}
+#endif
+
+typedef void (*IndexedExpand)(Uint32 *dst, const Uint8 *src, int n, const Uint32 *lut);
+
+static IndexedExpand indexed_expand(void) {
+    pixel_pick_kernels();
+#ifdef BUNDLE_AVX2
+    if (pixel_kernels == &pixel_kernels_avx2) return indexed_expand_avx2;
+#endif
+    return indexed_expand_scalar;
+}
+
+// Expand the rect of an 8-bit indexed surface through its palette into the same rect of a
+// texture with 32-bit pixels. Streaming textures are written in place through SDL_LockTexture.
+extern "C" int Bundle_SDL_UpdateTextureIndexed(SDL_Texture *texture, int x, int y, int w, int h,
+                                               SDL_Surface *surface) {
+    Uint32 format;
+    int access, tw, th;
+    if (!surface) return SDL_InvalidParamError("surface");
+    const SDL_PixelFormat *f = surface->format;
+    if (f->BitsPerPixel != 8 || !f->palette)
+        return SDL_SetError("Surface must be 8-bit indexed; got %s",
+                            SDL_GetPixelFormatName(f->format));
+    if (SDL_QueryTexture(texture, &format, &access, &tw, &th) < 0) return -1;
+    if (SDL_BYTESPERPIXEL(format) != 4 || SDL_ISPIXELFORMAT_FOURCC(format))
+        return SDL_SetError("Texture must have 32-bit pixels; got %s",
+                            SDL_GetPixelFormatName(format));
+    SDL_Rect area = {x, y, w, h};
+    if (w <= 0 || h <= 0) {
+        area.x = area.y = 0;
+        area.w = surface->w;
+        area.h = surface->h;
+    }
+    if (area.x < 0 || area.y < 0 || area.x + area.w > SDL_min(surface->w, tw) ||
+        area.y + area.h > SDL_min(surface->h, th))
+        return SDL_SetError("Update rect must lie inside both the surface and the texture");
+    Uint32 lut[256];
+    SDL_PixelFormat *tf = SDL_AllocFormat(format);
+    if (!tf) return -1;
+    const SDL_Palette *palette = f->palette;
+    for (int i = 0; i < 256; i++) { // Indices past the palette's end come out opaque black
+        SDL_Color c = {0, 0, 0, SDL_ALPHA_OPAQUE};
+        if (i < palette->ncolors) c = palette->colors[i];
+        lut[i] = SDL_MapRGBA(tf, c.r, c.g, c.b, c.a);
+    }
+    SDL_FreeFormat(tf);
+    void *pixels;
+    int pitch, ret = 0;
+    Uint32 *scratch = NULL;
+    if (access == SDL_TEXTUREACCESS_STREAMING) {
+        if (SDL_LockTexture(texture, &area, &pixels, &pitch) < 0) return -1;
+    }
+    else {
+        scratch = (Uint32 *)SDL_malloc((size_t)area.w * area.h * sizeof(Uint32));
+        if (!scratch) return SDL_OutOfMemory();
+        pixels = scratch;
+        pitch = area.w * sizeof(Uint32);
+    }
+    if (SDL_MUSTLOCK(surface)) SDL_LockSurface(surface);
+    IndexedExpand expand = indexed_expand();
+    const Uint8 *src = (const Uint8 *)surface->pixels + area.y * surface->pitch + area.x;
+    for (int row = 0; row < area.h; row++)
+        expand((Uint32 *)((Uint8 *)pixels + (size_t)row * pitch), src + row * surface->pitch,
+               area.w, lut);
+    if (SDL_MUSTLOCK(surface)) SDL_UnlockSurface(surface);
+    if (scratch) {
+        ret = SDL_UpdateTexture(texture, &area, scratch, pitch);
+        SDL_free(scratch);
+    }
+    else
+        SDL_UnlockTexture(texture);
+    return ret;
+}
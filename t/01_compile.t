@@ -2,9 +2,13 @@ use strict;
 use warnings;
 use Test2::V0;
 use lib 'lib', 'blib/lib';
+use SDL3;    # Plain, as most scripts load it; every module must attach its own natives
 use SDL3 qw[:version];
 #
 SDL_GetVersion( my $ver = SDL3::Version->new );
 is $ver->major, 2, sprintf 'SDL v%d.%d.%d', $ver->major, $ver->minor, $ver->patch;
+ok( SDL3->can($_), "$_ is attached" )
+    for qw[SDL_MapRGBArray SDL_CreatePaletteCycler SDL_BlitSurfaceMany SDL_GetBlitCacheStats
+    SDL_CreateDamageTracker SDL_CreateRenderThread];
 #
 done_testing;
@@ -0,0 +1,197 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+use SDL3 qw[:all];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use experimental 'signatures';
+$|++;
+#
+# Every SIMD kernel must produce exactly the same pixels as the scalar one. The surfaces are
+# an odd width so the scalar tail of each row is covered too.
+my ( $w, $h ) = ( 37, 13 );
+my @kernels = grep { SDL_SetPixelKernel($_) == 0 } qw[scalar sse2 avx2 neon];
+diag 'Testing pixel kernels: ' . join ', ', @kernels;
+is SDL_SetPixelKernel('mmx'), -1, 'SDL_SetPixelKernel( ... ) rejects unknown kernels';
+srand 1234;
+my %input = map { $_ => join '', map { chr int rand 256 } 1 .. $w * $h * 4 } qw[src dst];
+
+# a few fully transparent and fully opaque pixels to hit the fast paths
+substr $input{src}, $_ * 20 + 3, 1, "\0" for 0 .. 20;
+substr $input{src}, $_ * 28 + 3, 1, "\xFF" for 0 .. 15;
+
+sub surface ( $bytes, $w = $w, $h = $h ) {
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    for my $y ( 0 .. $h - 1 ) {
+        my $row = substr $bytes, $y * $w * 4, $w * 4;
+        SDL_memcpy( $surface->pixels + $y * $surface->pitch, \$row, $w * 4 );
+    }
+    $surface;
+}
+
+sub pixels ($surface) {
+    join '', map { buffer_to_scalar( $surface->pixels + $_ * $surface->pitch, $surface->w * 4 ) }
+        0 .. $surface->h - 1;
+}
+my %ops = (
+    fill     => sub ($dst) { SDL_FillSurface( $dst, [ 3, 2, 30, 9 ], 0x80C0FFEE ) },
+    gradient => sub ($dst) {
+        SDL_FillSurfaceGradient( $dst, [ -4, 1, 40, 20 ], 0xFF102030, 0x20F0E0D0 );
+    },
+    vertical => sub ($dst) { SDL_FillSurfaceGradient( $dst, undef, 0, 0xFFFFFFFF, 1 ) },
+    blend    => sub ($dst) {
+        my $src = surface( $input{src} );
+        my $ret = SDL_BlendSurface( $src, [ 1, 1, 35, 12 ], $dst, [ 2, -1 ] );
+        SDL_FreeSurface($src);
+        $ret;
+    },
+    premultiply   => sub ($dst) { SDL_PremultiplySurfaceAlpha($dst) },
+    unpremultiply => sub ($dst) { SDL_UnpremultiplySurfaceAlpha($dst) },
+    swizzle       => sub ($dst) {
+        my $rgba = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_RGBA8888 );
+        my $ret  = SDL_SwizzleSurface( $dst, $rgba );
+        SDL_memcpy( $dst->pixels, $rgba->pixels, $dst->pitch * $h );
+        SDL_FreeSurface($rgba);
+        $ret;
+    },
+    grayscale => sub ($dst) { SDL_GrayscaleSurface($dst) },
+    map_rgba  => sub ($dst) {
+        my $pixels = SDL_MapRGBAArray( $dst->format, $input{src} );
+        SDL_memcpy( $dst->pixels, \$pixels, length $pixels );
+        0;
+    },
+    get_rgba => sub ($dst) {
+        my $rgba = SDL_GetRGBAArray( pixels($dst), $dst->format );
+        SDL_memcpy( $dst->pixels, \$rgba, length $rgba );
+        0;
+    }
+);
+my %expect;
+for my $kernel (@kernels) {
+    SDL_SetPixelKernel($kernel);
+    is SDL_GetPixelKernel(), $kernel, "SDL_SetPixelKernel( '$kernel' )";
+    for my $op ( sort keys %ops ) {
+        my $dst = surface( $input{dst} );
+        is $ops{$op}->($dst), 0, "$kernel: $op returned 0";
+        my $out = pixels($dst);
+        SDL_FreeSurface($dst);
+        if ( $kernel eq 'scalar' ) { $expect{$op} = $out; next }
+        ok $out eq $expect{$op}, "$kernel: $op matches scalar";
+    }
+}
+#
+# The image filters must match the scalar kernel on one thread for every kernel and thread
+# count. Neither width is a multiple of any vector width, and 5 is narrower than most vectors.
+my %filters = (
+    gaussian => [ sub ( $src, $dst ) { SDL_GaussianBlurSurface( $src, $dst, 1.7 ) } ],
+    box      => [ sub ( $src, $dst ) { SDL_BoxBlurSurface( $src, $dst, 2 ) } ],
+    sharpen  => [
+        sub ( $src, $dst ) {
+            SDL_ConvolveSurface( $src, $dst, [ 0, -1, 0, -1, 5, -1, 0, -1, 0 ] );
+        }
+    ],
+    convolve5x5 => [
+        sub ( $src, $dst ) {
+            SDL_ConvolveSurface( $src, $dst, [ map { $_ % 7 - 3 } 0 .. 24 ], 9, 64 );
+        }
+    ],
+    bilinear => [ sub ( $src, $dst ) { SDL_ResampleSurface( $src, $dst, SDL_RESAMPLE_BILINEAR ) },
+        0.6, 1.7 ],
+    bicubic => [ sub ( $src, $dst ) { SDL_ResampleSurface( $src, $dst, SDL_RESAMPLE_BICUBIC ) },
+        1.5, 0.5 ],
+    lanczos3 =>
+        [ sub ( $src, $dst ) { SDL_ResampleSurface( $src, $dst, SDL_RESAMPLE_LANCZOS3 ) }, 0.4, 2 ]
+);
+my %expect_filter;
+for my $size ( [ $w, $h ], [ 5, 7 ] ) {
+    my ( $fw, $fh ) = @$size;
+    my $input = join '', map { chr int rand 256 } 1 .. $fw * $fh * 4;
+    for my $threads ( 1, 4 ) {
+        is SDL_SetFilterThreads($threads), 0, "SDL_SetFilterThreads( $threads )";
+        is SDL_GetFilterThreads(), $threads, 'SDL_GetFilterThreads( )';
+        for my $kernel (@kernels) {
+            SDL_SetPixelKernel($kernel);
+            for my $name ( sort keys %filters ) {
+                my ( $filter, $sx, $sy ) = @{ $filters{$name} };
+                my $src = surface( $input, $fw, $fh );
+                my $dst = SDL_CreateRGBSurfaceWithFormat( 0, int( $fw * ( $sx // 1 ) ) || 1,
+                    int( $fh * ( $sy // 1 ) ) || 1, 32, SDL_PIXELFORMAT_ARGB8888 );
+                my $test = "${fw}x$fh, $threads thread(s), $kernel: $name";
+                is $filter->( $src, $dst ), 0, "$test returned 0";
+                my $out = pixels($dst);
+                SDL_FreeSurface($_) for $src, $dst;
+                $expect_filter{"$fw/$name"} //= $out;    # scalar on 1 thread comes first
+                ok $out eq $expect_filter{"$fw/$name"}, "$test matches scalar on 1 thread";
+            }
+        }
+    }
+}
+SDL_SetFilterThreads(0);
+#
+SDL_SetPixelKernel('scalar');
+{
+    my $dst = surface( pack( 'L', 0xFFC08040 ) x ( $w * $h ) );
+    SDL_PremultiplySurfaceAlpha($dst);
+    SDL_UnpremultiplySurfaceAlpha($dst);
+    is unpack( 'L', pixels($dst) ), 0xFFC08040, 'opaque pixels survive premultiply round trip';
+    SDL_FreeSurface($dst);
+}
+{
+    my $dst = surface( pack( 'L', 0x80FFFFFF ) x ( $w * $h ) );
+    SDL_PremultiplySurfaceAlpha($dst);
+    is unpack( 'L', pixels($dst) ), 0x80808080, 'premultiply rounds to nearest';
+    SDL_FreeSurface($dst);
+}
+{
+    my $src = surface( pack( 'L', 0x80FFFFFF ) x ( $w * $h ) );
+    my $dst = surface( pack( 'L', 0xFF000000 ) x ( $w * $h ) );
+    SDL_BlendSurface( $src, undef, $dst );
+    is unpack( 'L', pixels($dst) ), 0xFF808080, 'half transparent white over black';
+    SDL_FreeSurface($_) for $src, $dst;
+}
+{
+    my $format = SDL_AllocFormat(SDL_PIXELFORMAT_RGB565);
+    is [ unpack 'L*', SDL_MapRGBArray( $format, pack 'C*', 255, 0, 0, 0, 255, 0 ) ],
+        [ SDL_MapRGB( $format, 255, 0, 0 ), SDL_MapRGB( $format, 0, 255, 0 ) ],
+        'SDL_MapRGBArray( ... ) matches SDL_MapRGB( ... ) for 16-bit formats';
+    is [ unpack 'C*', SDL_GetRGBAArray( pack( 'L*', 0xF800 ), $format ) ], [ 255, 0, 0, 255 ],
+        'SDL_GetRGBAArray( ... ) expands 16-bit pixels';
+    SDL_FreeFormat($format);
+}
+{
+    # Transparent green around opaque red: the green must not bleed into the edge of the red.
+    my ( $bw, $bh ) = ( 11, 9 );
+    my $input = join '', map {
+        my $y = $_;
+        map { pack 'L', $_ >= 4 && $_ < 7 && $y >= 3 && $y < 6 ? 0xFFFF0000 : 0x0000FF00 }
+            0 .. $bw - 1
+    } 0 .. $bh - 1;
+    for my $case (
+        [ gaussian => sub ( $src, $dst ) { SDL_GaussianBlurSurface( $src, $dst, 1.2 ) } ],
+        [ box      => sub ( $src, $dst ) { SDL_BoxBlurSurface( $src, $dst, 1 ) } ],
+        [   bilinear => sub ( $src, $dst ) {
+                SDL_ResampleSurface( $src, $dst, SDL_RESAMPLE_BILINEAR );
+            },
+            2
+        ]
+    ) {
+        my ( $name, $filter, $scale ) = @$case;
+        my $src = surface( $input, $bw, $bh );
+        my $dst = SDL_CreateRGBSurfaceWithFormat( 0, $bw * ( $scale // 1 ), $bh * ( $scale // 1 ),
+            32, SDL_PIXELFORMAT_ARGB8888 );
+        is $filter->( $src, $dst ), 0, "$name over a transparent border";
+        my @edge = grep { $_ >> 24 } unpack 'L*', pixels($dst);
+        ok @edge > 9 * ( $scale // 1 )**2, '...spreads alpha past the opaque pixels';
+        is [ grep { ( $_ & 0xFFFF ) || ( $_ >> 16 & 0xFF ) < 0xFC } @edge ], [],
+            '...and every visible pixel stays red';
+        SDL_FreeSurface($_) for $src, $dst;
+    }
+}
+{
+    my $dst = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 24, SDL_PIXELFORMAT_RGB24 );
+    isnt SDL_GrayscaleSurface($dst), 0, 'non-32-bit surfaces are rejected';
+    SDL_FreeSurface($dst);
+}
+#
+done_testing;
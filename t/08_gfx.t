@@ -0,0 +1,129 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+#
+use SDL3      qw[:all];
+use SDL3::GFX qw[:gfx];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use experimental 'signatures';
+#
+$|++;
+#
+# Everything is drawn into ARGB8888 surfaces so no window or renderer is needed
+my ( $w, $h ) = ( 64, 64 );
+
+sub surface ( $fill = 0 ) {
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_FillRect( $surface, undef, $fill );
+    $surface;
+}
+
+sub pixels ($surface) {
+    join '', map { buffer_to_scalar( $surface->pixels + $_ * $surface->pitch, $w * 4 ) }
+        0 .. $h - 1;
+}
+
+sub pixel ( $surface, $x, $y ) {
+    unpack 'L', buffer_to_scalar( $surface->pixels + $y * $surface->pitch + $x * 4, 4 );
+}
+is GFX_RGBA( 255, 128, 0 ), 0xFF8000FF, 'GFX_RGBA( ... )';
+#
+{
+    my $surface = surface();
+    is GFX_Circle( $surface, 32, 32, 10, 0, 0xFF0000FF ), 0, 'GFX_Circle( ... ) filled';
+    is pixel( $surface, 32, 32 ), 0xFFFF0000, 'center is solid';
+    is pixel( $surface, 41, 32 ), 0xFFFF0000, 'just inside the edge is solid';
+    is pixel( $surface, 0,  0 ),  0,          'far outside is untouched';
+    is pixel( $surface, 44, 32 ), 0,          'just past the edge is untouched';
+    for my $edge ( [ 42, 32 ], [ 22, 32 ], [ 32, 42 ], [ 32, 22 ] ) {
+        my $p = pixel( $surface, @$edge );
+        ok $p && $p != 0xFFFF0000, "edge pixel (@$edge) is anti-aliased";
+    }
+    is pixel( $surface, 32, 22 ), pixel( $surface, 32, 42 ), 'top and bottom edges match';
+    SDL_FreeSurface($surface);
+}
+#
+# The two triangles of a rect share a diagonal; with half transparent paint a pixel drawn twice
+# would come out brighter than the rest
+{
+    my $surface = surface(0xFF000000);
+    is GFX_RoundedRect( $surface, 8, 8, 16, 16, 0, 0, 0xFFFFFF80 ), 0, 'GFX_RoundedRect( ... )';
+    my $inside = pixel( $surface, 8, 8 );
+    is $inside, 0xFF808080, 'a half transparent rect is blended once';
+    my @wrong = grep {
+        my ( $x, $y ) = @$_;
+        pixel( $surface, $x, $y ) != ( $x >= 8 && $x < 24 && $y >= 8 && $y < 24 ? $inside :
+                0xFF000000 )
+    } map {
+        my $y = $_;
+        map { [ $_, $y ] } 0 .. $w - 1
+    } 0 .. $h - 1;
+    is scalar @wrong, 0, 'every pixel of the rect, diagonal included, is blended exactly once';
+    SDL_FreeSurface($surface);
+}
+#
+{
+    my $surface = surface();
+    is GFX_Polygon( $surface, [ 4, 4, 28, 4, 28, 28, 16, 12, 4, 28 ], 0, 0xFFFFFFFF ), 0,
+        'GFX_Polygon( ... ) concave';
+    is pixel( $surface, 16, 8 ),  0xFFFFFFFF, 'body is filled';
+    is pixel( $surface, 6,  20 ), 0xFFFFFFFF, 'left arm is filled';
+    is pixel( $surface, 26, 20 ), 0xFFFFFFFF, 'right arm is filled';
+    is pixel( $surface, 16, 18 ), 0,          'notch is empty';
+    is pixel( $surface, 16, 24 ), 0,          '...all the way down';
+    SDL_FreeSurface($surface);
+}
+#
+# Single item and batch forms must draw exactly the same pixels
+my @triangle = ( 40, 40, 60, 40, 50, 58 );
+my @square   = ( [ 4, 40 ], [ 20, 40 ], [ 20, 56 ], [ 4, 56 ] );
+my %shapes   = (
+    Line        => [ [ 1, 2, 60, 50, 1, 0xFFFFFFFF ], [ 3, 60, 50, 5, 4.5, 0x00FF0080 ] ],
+    Circle      => [ [ 20, 20, 8, 0, 0xFF000080 ], [ 30, 25, 12, 2, 0x0000FFFF ] ],
+    Ellipse     => [ [ 32, 32, 20, 8, 0, 0x80FF00C0 ], [ 32, 32, 6, 25, 1.5, 0xFFFFFF40 ] ],
+    Arc => [ [ 32, 32, 20, 0, 135, 0, 0xFF8000FF ], [ 32, 32, 14, -90, 90, 3, 0x8080FFFF ] ],
+    RoundedRect => [ [ 4, 4, 30, 20, 6, 0, 0x00FFFF80 ], [ 20, 30, 40, 30, 10, 2, 0xFF00FFFF ] ]
+);
+my %template
+    = ( Line => 'f5L', Circle => 'f4L', Ellipse => 'f5L', Arc => 'f6L', RoundedRect => 'f6L' );
+my $blank = do {
+    my $surface = surface(0xFF202020);
+    my $pixels  = pixels($surface);
+    SDL_FreeSurface($surface);
+    $pixels;
+};
+for my $shape ( sort keys %shapes ) {
+    my ( $single, $list, $packed, $ref ) = map { surface(0xFF202020) } 1 .. 4;
+    no strict 'refs';
+    is &{"GFX_$shape"}( $single, @$_ ), 0, "GFX_$shape( ... )" for @{ $shapes{$shape} };
+    is &{"GFX_${shape}s"}( $list, $shapes{$shape} ), 0, "GFX_${shape}s( ... ) with a list";
+    my $items = join '', map { pack $template{$shape}, @$_ } @{ $shapes{$shape} };
+    is &{"GFX_${shape}s"}( $packed, $items ), 0, "GFX_${shape}s( ... ) with a packed string";
+    is &{"GFX_${shape}s"}( $ref, \$items ), 0, "GFX_${shape}s( ... ) with a reference";
+    my $expect = pixels($single);
+    ok $expect ne $blank, "GFX_$shape( ... ) drew something";
+    ok pixels($_) eq $expect, "GFX_${shape}s( ... ) draws what GFX_$shape( ... ) does"
+        for $list, $packed, $ref;
+    SDL_FreeSurface($_) for $single, $list, $packed, $ref;
+}
+{
+    my ( $single, $list, $pair, $args ) = map { surface(0xFF202020) } 1 .. 4;
+    GFX_Polygon( $single, \@triangle, 0, 0xFF0000FF );
+    GFX_Polygon( $single, \@square,   2, 0xFFFFFF80 );
+    is GFX_Polygons( $list, [ [ \@triangle, 0, 0xFF0000FF ], [ \@square, 2, 0xFFFFFF80 ] ] ), 0,
+        'GFX_Polygons( ... ) with a list';
+    my $items  = pack '(lfL)*', 3, 0, 0xFF0000FF, 4, 2, 0xFFFFFF80;
+    my $points = pack 'f*', @triangle, map {@$_} @square;
+    is GFX_Polygons( $pair, [ $items, $points ] ), 0, 'GFX_Polygons( ... ) with a packed pair';
+    is GFX_Polygons( $args, \$items, \$points ), 0, 'GFX_Polygons( ... ) with references';
+    my $expect = pixels($single);
+    ok pixels($_) eq $expect, 'GFX_Polygons( ... ) draws what GFX_Polygon( ... ) does'
+        for $list, $pair, $args;
+    isnt GFX_Polygons( $args, $items, substr $points, 0, 8 ), 0,
+        'GFX_Polygons( ... ) fails when the items want more points than were given';
+    SDL_FreeSurface($_) for $single, $list, $pair, $args;
+}
+#
+done_testing;
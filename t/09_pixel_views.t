@@ -0,0 +1,120 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+use SDL3 qw[:all];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use experimental 'signatures';
+$|++;
+#
+# A view aliases a perl scalar to a surface's pixels until the surface is unlocked.
+my ( $w, $h ) = ( 4, 4 );
+{
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    is SDL_LockSurface($surface), 0, 'SDL_LockSurface( ... )';
+    my $view = SDL_GetSurfacePixelsView($surface);
+    ok $view, 'SDL_GetSurfacePixelsView( ... )';
+    is length $$view, $surface->pitch * $h, 'view covers every row';
+    substr $$view, 0, 4, pack 'L', 0xFF112233;
+    is unpack( 'L', buffer_to_scalar( $surface->pixels, 4 ) ), 0xFF112233,
+        'writes through the view reach the surface';
+    vec( $$view, 1, 32 ) = 0xFF445566;
+    is unpack( 'N', buffer_to_scalar( $surface->pixels + 4, 4 ) ), 0xFF445566, '...even with vec';
+    like dies { $$view = 'short' }, qr/cannot be resized/, 'assigning a different length croaks';
+    is length $$view, $surface->pitch * $h, '...and the view keeps its length';
+    is substr( $$view, 0, 5 ), 'short', '...after copying in what fit';
+    $$view = pack 'L*', (0xFF000000) x ( $w * $h );
+    is unpack( 'L', buffer_to_scalar( $surface->pixels, 4 ) ), 0xFF000000,
+        'assigning the same length copies into the surface';
+    SDL_UnlockSurface($surface);
+    ok !defined $$view, 'unlocking the surface leaves the view undef';
+    $$view = 'anything';
+    is unpack( 'L', buffer_to_scalar( $surface->pixels, 4 ) ), 0xFF000000,
+        '...and detached from the surface';
+    SDL_FreeSurface($surface);
+}
+#
+# A surface created from a string takes over its buffer; perl must never free or move it.
+sub first_pixel ($surface) {
+    my $dst = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_BlitSurface( $surface, undef, $dst, undef );
+    my $pixel = unpack 'L', buffer_to_scalar( $dst->pixels, 4 );
+    SDL_FreeSurface($dst);
+    $pixel;
+}
+{
+    my $pixels  = pack 'L*', (0xFF336699) x ( $w * $h );
+    my $surface = SDL_CreateRGBSurfaceWithFormatFrom( \$pixels, $w, $h, 32, $w * 4,
+        SDL_PIXELFORMAT_ARGB8888 );
+    ok $surface, 'SDL_CreateRGBSurfaceWithFormatFrom( ... )';
+    SDL_SetSurfaceBlendMode( $surface, SDL_BLENDMODE_NONE );
+    is first_pixel($surface), 0xFF336699, 'blit from a pinned string';
+    like dies { $pixels .= 'x' }, qr/cannot be resized/, 'appending to a pinned string croaks';
+    is length $pixels, $w * $h * 4, '...and it keeps its length';
+    is first_pixel($surface), 0xFF336699, 'blit after the append';
+    $pixels = pack 'L*', (0xFF00FF00) x ( $w * $h );
+    is first_pixel($surface), 0xFF00FF00, 'blit after assigning a new string of the same length';
+    like dies { $pixels = pack 'L*', 0xFFFF0000 }, qr/cannot be resized/,
+        'assigning a shorter string croaks';
+    is first_pixel($surface), 0xFFFF0000, '...after copying in what fit';
+    substr $pixels, 4, 4, pack 'L', 0xFF0000FF;
+    is unpack( 'L', buffer_to_scalar( $surface->pixels + 4, 4 ) ), 0xFF0000FF,
+        'substr writes reach the surface';
+    SDL_FreeSurface($surface);
+    is length $pixels, $w * $h * 4, 'freeing the surface hands the buffer back';
+    is unpack( 'L', $pixels ), 0xFFFF0000, '...with its contents';
+    $pixels .= 'x';
+    is length $pixels, $w * $h * 4 + 1, '...and it can be resized again';
+}
+#
+# SDL_ConvertPixels( ... ) writes through set magic and never resizes a buffer it doesn't own.
+{
+    my $argb = pack 'L*', (0xFF112233) x ( $w * $h );
+    my $rgba;
+    is SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, \$argb, $w * 4,
+        SDL_PIXELFORMAT_RGBA8888, \$rgba, $w * 4 ), 0, 'SDL_ConvertPixels( ... ) into undef';
+    is length $rgba, $w * $h * 4, '...grows the scalar';
+    is unpack( 'L', $rgba ), 0x112233FF, '...and converts';
+    my $small   = pack 'L*', (0) x $w;
+    my $surface = SDL_CreateRGBSurfaceWithFormatFrom( \$small, $w, 1, 32, $w * 4,
+        SDL_PIXELFORMAT_RGBA8888 );
+    isnt SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, \$argb, $w * 4,
+        SDL_PIXELFORMAT_RGBA8888, \$small, $w * 4 ), 0, 'pinned strings are not grown';
+    is length $small, $w * 4, '...and keep their length';
+    is SDL_ConvertPixels( $w, 1, SDL_PIXELFORMAT_ARGB8888, \$argb, $w * 4,
+        SDL_PIXELFORMAT_RGBA8888, \$small, $w * 4 ), 0, 'converting into a pinned string';
+    is unpack( 'L', buffer_to_scalar( $surface->pixels, 4 ) ), 0x112233FF, '...reaches the surface';
+    SDL_FreeSurface($surface);
+    like dies {
+        SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, \$argb, $w * 4,
+            SDL_PIXELFORMAT_RGBA8888, [], $w * 4 )
+    }, qr/array reference/, 'array references are rejected as dst';
+}
+#
+# Anything that isn't a reference is a pointer, even after it has been used as a string.
+{
+    my $src = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_FillRect( $src, undef, 0xFF445566 );
+    my $ptr = $src->pixels;
+    my $str = "$ptr";
+    my $out;
+    is SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, $ptr, $src->pitch,
+        SDL_PIXELFORMAT_RGBA8888, \$out, $w * 4 ), 0, 'SDL_ConvertPixels( ... ) from a pointer';
+    is unpack( 'L', $out ), 0x445566FF, '...reads the surface';
+    is SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, $str, $src->pitch,
+        SDL_PIXELFORMAT_RGBA8888, \$out, $w * 4 ), 0, '...and from a stringified pointer';
+    is unpack( 'L', $out ), 0x445566FF, '...which is still read as a pointer';
+    my $alias = SDL_CreateRGBSurfaceWithFormatFrom( $str, $w, $h, 32, $src->pitch,
+        SDL_PIXELFORMAT_ARGB8888 );
+    is $alias->pixels, $ptr, 'SDL_CreateRGBSurfaceWithFormatFrom( ... ) uses a stringified pointer';
+    is length $str, length "$ptr", '...and leaves the string alone';
+    SDL_FreeSurface($alias);
+    isnt SDL_ConvertPixels( $w, $h, SDL_PIXELFORMAT_ARGB8888, pack( 'L*', (0) x ( $w * $h ) ),
+        $w * 4, SDL_PIXELFORMAT_RGBA8888, \$out, $w * 4 ), 0,
+        'a packed string not passed by reference is refused';
+    like SDL_GetError(), qr/reference to a packed string/, '...with a hint';
+    SDL_FreeSurface($src);
+}
+#
+done_testing;
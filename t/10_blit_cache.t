@@ -0,0 +1,127 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+use SDL3 qw[:all];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use experimental 'signatures';
+$|++;
+#
+my ( $w, $h ) = ( 64, 64 );
+
+sub surface ( $format, $r, $g, $b, $w = 64, $h = 64 ) {
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, $format );
+    SDL_FillRect( $surface, undef, SDL_MapRGBA( $surface->format, $r, $g, $b, 255 ) );
+    $surface;
+}
+
+sub first_pixel ($surface) { unpack 'L', buffer_to_scalar( $surface->pixels, 4 ) }
+
+sub color ( $r, $g, $b ) { SDL3::Color->new( { r => $r, g => $g, b => $b, a => 255 } ) }
+my $dst = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+#
+# Off by default, so writes through the raw pointer always show up
+{
+    my $src    = surface( SDL_PIXELFORMAT_ABGR8888, 255, 0, 0 );
+    my $before = SDL_GetBlitCacheStats();
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFFFF0000, 'source blitted with the cache off';
+    is SDL_GetBlitCacheStats()->conversions, $before->conversions, '...without a copy';
+    my $blue = pack 'L*', (0xFFFF0000) x ( $w * $h );    # ABGR
+    SDL_memcpy( $src->pixels, \$blue, length $blue );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF0000FF, 'a raw pixel write shows up on the next blit';
+    SDL_SetBlitCacheEnabled(1);
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is SDL_GetBlitCacheStats()->entries, 1, 'SDL_SetBlitCacheEnabled( 1 ) keeps copies';
+    my $green = pack 'L*', (0xFF00FF00) x ( $w * $h );
+    SDL_memcpy( $src->pixels, \$green, length $green );
+    SDL_InvalidateBlitCache($src);
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF00FF00, '...and a raw write shows up after SDL_InvalidateBlitCache';
+    SDL_FreeSurface($src);
+}
+#
+# Palette changes must not be hidden by a converted copy
+{
+    SDL_InvalidateBlitCache();
+    my $src     = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 8, SDL_PIXELFORMAT_INDEX8 );
+    my $palette = $src->format->palette;
+    SDL_SetPaletteColors( $palette, color( 255, 0, 0 ), 0, 1 );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFFFF0000, 'indexed source blitted through the cache';
+    is SDL_GetBlitCacheStats()->entries, 1, '...and a copy is kept';
+    SDL_SetPaletteColors( $palette, color( 0, 255, 0 ), 0, 1 );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF00FF00, 'new palette colors show up on the next blit';
+    SDL_FreeSurface($src);
+}
+#
+# ...including the ones a palette cycler makes
+{
+    SDL_InvalidateBlitCache();
+    my $src    = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 8, SDL_PIXELFORMAT_INDEX8 );
+    my $cycler = SDL_CreatePaletteCycler( $src->format->palette );
+    is SDL_SetPaletteCyclerColors( $cycler, [ [ 255, 0, 0 ], [ 0, 255, 0 ], [ 0, 0, 255 ] ] ), 0,
+        'SDL_SetPaletteCyclerColors( ... )';
+    ok SDL_AddPaletteCycle( $cycler, 0, 3, 1 ) >= 0, 'SDL_AddPaletteCycle( ... )';
+    SDL_UpdatePaletteCycler( $cycler, 0 );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFFFF0000, 'indexed source blitted before cycling';
+    is SDL_UpdatePaletteCycler( $cycler, 1000 ), 1, 'SDL_UpdatePaletteCycler( ... ) one step on';
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF0000FF, 'the cycled color shows up on the next blit';
+    SDL_DestroyPaletteCycler($cycler);
+    SDL_FreeSurface($src);
+}
+#
+# The lower level blits don't use the cache but must drop copies of what they write to
+{
+    SDL_InvalidateBlitCache();
+    my $src = surface( SDL_PIXELFORMAT_ABGR8888, 255, 0, 0 );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFFFF0000, 'source blitted through the cache';
+    my $blue = surface( SDL_PIXELFORMAT_ABGR8888, 0, 0, 255 );
+    my $all  = SDL3::Rect->new( { x => 0, y => 0, w => $w, h => $h } );
+    SDL_LowerBlit( $blue, $all, $src, SDL3::Rect->new( { x => 0, y => 0, w => $w, h => $h } ) );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF0000FF, 'SDL_LowerBlit( ... ) onto a cached source is seen';
+    my $green = surface( SDL_PIXELFORMAT_ABGR8888, 0, 255, 0 );
+    SDL_SoftStretch( $green, undef, $src, undef );
+    SDL_BlitSurface( $src, undef, $dst, undef );
+    is first_pixel($dst), 0xFF00FF00, 'SDL_SoftStretch( ... ) onto a cached source is seen';
+    SDL_FreeSurface($_) for $src, $blue, $green;
+}
+#
+# Copies beyond the budget are evicted least recently used first
+{
+    SDL_InvalidateBlitCache();
+    SDL_SetBlitCacheBudget( 3 * $w * $h * 4 );
+    my $before  = SDL_GetBlitCacheStats();
+    my @sources = map { surface( SDL_PIXELFORMAT_ABGR8888, $_ * 40, 0, 0 ) } 1 .. 5;
+    SDL_BlitSurface( $_, undef, $dst, undef ) for @sources;
+    my $stats = SDL_GetBlitCacheStats();
+    is $stats->budget,  3 * $w * $h * 4, 'SDL_SetBlitCacheBudget( ... )';
+    is $stats->entries, 3,               'copies are limited by the budget';
+    ok $stats->bytes <= $stats->budget, '...in bytes';
+    is $stats->evictions - $before->evictions, 2, '...by evicting the oldest';
+    SDL_BlitSurface( $sources[-1], undef, $dst, undef );
+    is SDL_GetBlitCacheStats()->hits - $stats->hits, 1, 'the newest copy is still there';
+    SDL_BlitSurface( $sources[0], undef, $dst, undef );
+    is SDL_GetBlitCacheStats()->conversions - $stats->conversions, 1,
+        'the oldest had to be converted again';
+    my $big = surface( SDL_PIXELFORMAT_ABGR8888, 1, 2, 3, $w * 2, $h * 2 );
+    $stats = SDL_GetBlitCacheStats();
+    SDL_BlitSurface( $big, undef, $dst, undef );
+    is SDL_GetBlitCacheStats()->conversions, $stats->conversions,
+        'a source too large for the budget is blitted directly';
+    is SDL_GetBlitCacheStats()->entries, 3, '...without evicting anything';
+    SDL_SetBlitCacheBudget( $w * $h * 4 );
+    is SDL_GetBlitCacheStats()->entries, 1, 'lowering the budget trims right away';
+    SDL_SetBlitCacheBudget( 64 * 1024 * 1024 );
+    SDL_FreeSurface($_) for @sources, $big;
+}
+SDL_FreeSurface($dst);
+#
+done_testing;
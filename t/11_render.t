@@ -0,0 +1,137 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+use SDL3 qw[:all];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use File::Temp;
+use experimental 'signatures';
+$|++;
+#
+# A software renderer drawing into a surface needs no window
+my ( $w, $h ) = ( 16, 16 );
+my $target   = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+my $renderer = SDL_CreateSoftwareRenderer($target);
+ok $renderer, 'SDL_CreateSoftwareRenderer( ... )';
+
+sub pixels ($surface) {
+    join '', map { buffer_to_scalar( $surface->pixels + $_ * $surface->pitch, $surface->w * 4 ) }
+        0 .. $surface->h - 1;
+}
+
+sub rect ( $x, $y, $w, $h ) { SDL3::Rect->new( { x => $x, y => $y, w => $w, h => $h } ) }
+
+sub clear () {
+    SDL_SetRenderDrawColor( $renderer, 0, 0, 0, 255 );
+    SDL_RenderClear($renderer);
+}
+#
+# Plain array and hash rects take the XYWH fast paths but keep SDL's meaning for an empty rect
+{
+    my $white = SDL_CreateRGBSurfaceWithFormat( 0, 4, 4, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_FillRect( $white, undef, 0xFFFFFFFF );
+    my $texture = SDL_CreateTextureFromSurface( $renderer, $white );
+    clear();
+    SDL_RenderPresent($renderer);
+    my $black = pixels($target);
+    is SDL_RenderCopy( $renderer, $texture, undef, [ 0, 0, 0, 0 ] ), 0,
+        'SDL_RenderCopy( ... ) onto an empty array rect';
+    is SDL_RenderCopy( $renderer, $texture, { x => 0, y => 0, w => 0, h => 4 }, undef ), 0,
+        'SDL_RenderCopy( ... ) from an empty hash rect';
+    SDL_SetRenderDrawColor( $renderer, 255, 255, 255, 255 );
+    is SDL_RenderFillRect( $renderer, [ 0, 0, 0, 0 ] ), 0, 'SDL_RenderFillRect( ... ) empty';
+    SDL_RenderPresent($renderer);
+    ok pixels($target) eq $black, '...none of which draw anything';
+    is SDL_RenderCopy( $renderer, $texture, undef, [ 2, 2, 4, 4 ] ), 0,
+        'SDL_RenderCopy( ... ) onto an array rect';
+    SDL_RenderPresent($renderer);
+    is scalar( grep { $_ == 0xFFFFFFFF } unpack 'L*', pixels($target) ), 16, '...fills just it';
+    SDL_DestroyTexture($texture);
+    SDL_FreeSurface($white);
+}
+#
+{
+    my $st = SDL_CreateStreamingTexture( $renderer, SDL_PIXELFORMAT_ARGB8888, $w, $h );
+    ok $st, 'SDL_CreateStreamingTexture( ... )';
+    my $frame = pack 'L*', (0xFF336699) x ( $w * $h );
+    is SDL_UpdateStreamingTexture( $st, undef, \$frame ), 0, 'SDL_UpdateStreamingTexture( ... )';
+    clear();
+    SDL_RenderCopy( $renderer, SDL_GetStreamingTexture($st), undef, undef );
+    SDL_RenderPresent($renderer);
+    is pixels($target), $frame, '...reaches the screen';
+    isnt SDL_UpdateStreamingTexture( $st, undef, \'' ), 0, 'an empty scalar is too small';
+    isnt SDL_UpdateStreamingTexture( $st, undef, \undef ), 0, '...and so is undef';
+    my $short = substr $frame, 4;
+    isnt SDL_UpdateStreamingTexture( $st, undef, \$short ), 0, '...and a buffer one pixel short';
+    isnt SDL_UpdateStreamingTexture( $st, [ 0, 0, 4, 4 ], \$frame, 8 ), 0,
+        'a pitch shorter than a row is rejected';
+    is SDL_UpdateStreamingTexture( $st, [ 0, 0, 4, 4 ], \$frame, $w * 4 ), 0,
+        '...while a longer one is fine';
+    SDL_DestroyStreamingTexture($st);
+}
+#
+# Tile renderer copies are clipped and sampled like SDL_BlitScaled( ... ), whatever the tiling
+{
+    my ( $tw, $th ) = ( 61, 47 );
+    my $source = SDL_CreateRGBSurfaceWithFormat( 0, 20, 12, 32, SDL_PIXELFORMAT_ARGB8888 );
+    my $pixels = pack 'L*', map { 0xFF000000 | $_ * 0x010203 } 0 .. 20 * 12 - 1;
+    SDL_memcpy( $source->pixels, \$pixels, length $pixels );
+    SDL_SetSurfaceBlendMode( $source, SDL_BLENDMODE_NONE );
+    my @copies = (
+        [ [ 0, 0, 0, 0 ], [ 0, 0, $tw, $th ] ],         # whole source, whole target
+        [ [ 0, 0, 0, 0 ], [ 5, 3, 20, 12 ] ],           # unscaled
+        [ [ 2, 1, 7, 5 ], [ -9, -4, 30, 23 ] ],         # crossing the top left corner
+        [ [ 0, 0, 0, 0 ], [ 40, 30, 45, 29 ] ],         # crossing the bottom right corner
+        [ [ -6, -3, 26, 15 ], [ 10, 6, 33, 19 ] ],      # a source rect larger than the source
+        [ [ 15, 8, 10, 10 ], [ 20, 20, 17, 13 ] ],      # ...and hanging off its far edges
+        [ [ 3, 2, 13, 7 ], [ 58, 1, 11, 40 ] ],         # shrunk across the right edge
+        [ [ 1, 1, 18, 10 ], [ 7, 44, 50, 9 ] ]          # and across the bottom
+    );
+    for my $copy (@copies) {
+        my ( $src, $dst ) = @$copy;
+        my $expect = SDL_CreateRGBSurfaceWithFormat( 0, $tw, $th, 32, SDL_PIXELFORMAT_ARGB8888 );
+        SDL_FillRect( $expect, undef, 0xFF000000 );
+        SDL_BlitScaled( $source, $src->[2] ? rect(@$src) : undef, $expect, rect(@$dst) );
+        for my $tiling ( [ 1, 64 ], [ 4, 8 ], [ 3, 13 ] ) {
+            my $got = SDL_CreateRGBSurfaceWithFormat( 0, $tw, $th, 32, SDL_PIXELFORMAT_ARGB8888 );
+            my $tr  = SDL_CreateTileRenderer( $got, @$tiling );
+            my $tex = SDL_TileRendererCreateTexture( $tr, $source );
+            SDL_TileRendererSetDrawColor( $tr, 0, 0, 0, 255 );
+            SDL_TileRendererClear($tr);
+            SDL_TileRendererCopy( $tr, $tex, @$src, @$dst );
+            is SDL_TileRendererPresent($tr), 0, "SDL_TileRendererPresent( ... ) [@$src] => [@$dst]";
+            ok pixels($got) eq pixels($expect),
+                sprintf '...matches SDL_BlitScaled( ... ) on %d threads with %dpx tiles', @$tiling;
+            SDL_DestroyTileRenderer($tr);
+            SDL_FreeSurface($got);
+        }
+        SDL_FreeSurface($expect);
+    }
+    SDL_FreeSurface($source);
+}
+#
+# Atlas layouts keep names of any length and refuse ones that would split a line
+{
+    my $dir   = File::Temp::tempdir( CLEANUP => 1 );
+    my $atlas = SDL_CreateAtlas( 64, 64 );
+    my $long    = 'sprite' x 1000;
+    my $sprite  = SDL_CreateRGBSurfaceWithFormat( 0, 8, 8, 32, SDL_PIXELFORMAT_ARGB8888 );
+    my @handles = map { SDL_AtlasAdd( $atlas, $sprite, $_ ) } 'short', $long;
+    is SDL_AtlasPack($atlas), 0, 'SDL_AtlasPack( ... )';
+    is SDL_SaveAtlas( $atlas, "$dir/sprites.atlas" ), 0, 'SDL_SaveAtlas( ... ) with a long name';
+    my $loaded = SDL_LoadAtlas("$dir/sprites.atlas");
+    ok $loaded, 'SDL_LoadAtlas( ... )';
+    is [ map { SDL_GetAtlasHandle( $loaded, $_ ) } 'short', $long ], \@handles,
+        '...finds every name it was saved with';
+    SDL_DestroyAtlas($loaded);
+    SDL_AtlasAdd( $atlas, $sprite, "two\nlines" );
+    isnt SDL_SaveAtlas( $atlas, "$dir/broken.atlas" ), 0, 'a name with a line break is refused';
+    SDL_DestroyAtlas($atlas);
+    SDL_FreeSurface($sprite);
+}
+#
+SDL_DestroyRenderer($renderer);
+SDL_FreeSurface($target);
+#
+done_testing;
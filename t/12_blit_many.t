@@ -0,0 +1,51 @@
+use strict;
+use warnings;
+use Test2::V0;
+use lib -d '../t' ? './lib' : 't/lib';
+use lib '../lib', 'lib';
+use SDL3 qw[:all];
+use FFI::Platypus::Buffer qw[buffer_to_scalar];
+use experimental 'signatures';
+$|++;
+#
+my ( $w, $h ) = ( 16, 16 );
+
+sub surface ( $color, $w = 16, $h = 16 ) {
+    my $surface = SDL_CreateRGBSurfaceWithFormat( 0, $w, $h, 32, SDL_PIXELFORMAT_ARGB8888 );
+    SDL_FillRect( $surface, undef, $color );
+    SDL_SetSurfaceBlendMode( $surface, SDL_BLENDMODE_NONE );
+    $surface;
+}
+
+sub painted ($surface) {
+    scalar grep { $_ != 0xFF000000 } unpack 'L*', join '',
+        map { buffer_to_scalar( $surface->pixels + $_ * $surface->pitch, $w * 4 ) } 0 .. $h - 1;
+}
+my $src = surface( 0xFFFFFFFF, 4, 4 );
+#
+# Empty rects draw nothing, as they do for SDL_BlitSurface( ... ); undef is the whole surface
+for my $many ( \&SDL_BlitSurfaceMany, \&SDL_BlitScaledMany ) {
+    my $dst  = surface(0xFF000000);
+    my @empty = ( [ [ 0, 0, 0, 0 ], [ 0, 0, 8, 8 ] ],
+        [ { x => 1, y => 1, w => 2, h => 0 }, [ 8, 8, 8, 8 ] ] );
+    my $mask = $many->( $src, $dst, \@empty );
+    is unpack( 'b*', $mask ), '00000000', 'empty source rects do not fail';
+    is painted($dst), 0, '...and draw nothing';
+    $many->( $src, $dst, [ [ undef, [ 2, 2, 4, 4 ] ] ] );
+    is painted($dst), 16, 'an undef source rect is the whole surface';
+    SDL_FreeSurface($dst);
+}
+{
+    my $dst = surface(0xFF000000);
+    SDL_BlitScaledMany( $src, $dst, [ [ undef, [ 4, 4, 0, 8 ] ] ] );
+    is painted($dst), 0, 'an empty destination draws nothing when scaling';
+    SDL_BlitScaledMany( $src, $dst, [ [ undef, undef ] ] );
+    is painted($dst), $w * $h, '...and undef fills it';
+    SDL_FillRect( $dst, undef, 0xFF000000 );
+    SDL_BlitSurfaceMany( $src, $dst, \pack( 'i*', 0, 0, -1, -1, 3, 3, 0, 0 ) );
+    is painted($dst), 16, 'a packed negative size is the whole surface';
+    SDL_FreeSurface($dst);
+}
+SDL_FreeSurface($src);
+#
+done_testing;